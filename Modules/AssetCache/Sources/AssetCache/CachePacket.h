@@ -5,6 +5,7 @@
 #include "AssetCache/AssetCacheConstants.h"
 
 #include <FileSystem/DynamicMemoryFile.h>
+#include <Functional/Function.h>
 
 #include <memory>
 
@@ -135,6 +136,12 @@ class GetChunkResponsePacket : public DataChunkPacket
 public:
     GetChunkResponsePacket();
     GetChunkResponsePacket(const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const Vector<uint8>& chunkData);
+
+    /**
+        Creates packet which chunk data is read by `readChunkData` straight into sending buffer.
+        Returns nullptr if data can't be read. Can be called from any thread, but packet should be sent from network thread.
+    */
+    static std::unique_ptr<GetChunkResponsePacket> Create(const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, uint32 chunkDataSize, const Function<bool(uint8*)>& readChunkData);
 };
 
 //////////////////////////////////////////////////////////////////////////
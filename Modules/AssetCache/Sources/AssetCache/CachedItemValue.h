@@ -16,6 +16,8 @@ namespace AssetCache
 {
 class CachedItemValue final
 {
+    friend class CachedItemValueStream;
+
     using ValueData = std::shared_ptr<Vector<uint8>>;
     using ValueDataContainer = Map<String, ValueData>;
 
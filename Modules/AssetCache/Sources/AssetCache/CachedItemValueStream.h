@@ -0,0 +1,49 @@
+#pragma once
+
+#include <Base/BaseTypes.h>
+#include <FileSystem/FilePath.h>
+
+namespace DAVA
+{
+namespace AssetCache
+{
+class CachedItemValue;
+
+/**
+    Serialized CachedItemValue, which files are stored in folder.
+    Gives the same bytes as CachedItemValue::Serialize(File*) does, but data of files is read from disk
+    on demand, so any range of serialized value can be read without fetching the whole value into memory.
+    Stream doesn't change after Open, so Read can be called from several threads at once.
+*/
+class CachedItemValueStream final
+{
+public:
+    bool Open(const CachedItemValue& value, const FilePath& folder);
+
+    uint64 GetSize() const;
+    bool Read(uint64 offset, uint8* buffer, uint32 bufferSize) const;
+
+private:
+    struct Segment
+    {
+        uint64 offset = 0; // offset in serialized value
+        uint64 size = 0;
+        Vector<uint8> data; // serialized fields of value
+        FilePath filePath; // or file with data
+    };
+
+    void AppendData(const void* data, uint32 dataSize);
+    void AppendString(const String& string);
+    void AppendFile(const FilePath& filePath, uint32 fileSize);
+
+    Vector<Segment> segments;
+    uint64 size = 0;
+};
+
+inline uint64 CachedItemValueStream::GetSize() const
+{
+    return size;
+}
+
+} // namespace AssetCache
+} // namespace DAVA
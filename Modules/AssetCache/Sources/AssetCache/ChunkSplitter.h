@@ -9,6 +9,8 @@ namespace AssetCache
 namespace ChunkSplitter
 {
 uint32 GetNumberOfChunks(uint64 overallSize);
+uint64 GetChunkOffset(uint32 chunkNumber);
+uint32 GetChunkSize(uint64 overallSize, uint32 chunkNumber);
 Vector<uint8> GetChunk(const Vector<uint8>& dataVector, uint32 chunkNumber);
 }
 } // namespace AssetCache
@@ -35,7 +35,7 @@ AssetCache::Error AssetCacheClient::ConnectSynchronously(const ConnectionParams&
     isActive = true;
     timeoutMs = connectionParams.timeoutms;
 
-    client.Connect(connectionParams.ip, AssetCache::ASSET_SERVER_PORT);
+    client.Connect(connectionParams.ip, connectionParams.port);
 
     {
         LockGuard<Mutex> guard(connectEstablishLocker);
@@ -253,6 +253,40 @@ GetChunkResponsePacket::GetChunkResponsePacket()
 {
 }
 
+std::unique_ptr<GetChunkResponsePacket> GetChunkResponsePacket::Create(const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, uint32 chunkDataSize, const Function<bool(uint8*)>& readChunkData)
+{
+    // same layout as DataChunkPacket writes
+    const CachePacketHeader header(PACKET_HEADER, PACKET_VERSION, PACKET_GET_CHUNK_RESPONSE);
+    const size_t fieldsSize = sizeof(header) + key.size() + sizeof(dataSize) + sizeof(numOfChunks) + sizeof(chunkNumber) + sizeof(chunkDataSize);
+
+    Vector<uint8> buffer(fieldsSize + chunkDataSize);
+    uint8* dst = buffer.data();
+    auto WriteField = [&dst](const void* field, size_t fieldSize) {
+        Memcpy(dst, field, fieldSize);
+        dst += fieldSize;
+    };
+
+    WriteField(&header, sizeof(header));
+    WriteField(key.data(), key.size());
+    WriteField(&dataSize, sizeof(dataSize));
+    WriteField(&numOfChunks, sizeof(numOfChunks));
+    WriteField(&chunkNumber, sizeof(chunkNumber));
+    WriteField(&chunkDataSize, sizeof(chunkDataSize));
+
+    if (chunkDataSize > 0 && !readChunkData(dst))
+    {
+        return nullptr;
+    }
+
+    std::unique_ptr<GetChunkResponsePacket> packet(new GetChunkResponsePacket());
+    packet->key = key;
+    packet->dataSize = dataSize;
+    packet->numOfChunks = numOfChunks;
+    packet->chunkNumber = chunkNumber;
+    packet->serializationBuffer.reset(DynamicMemoryFile::Create(std::move(buffer), File::CREATE | File::WRITE, FilePath()));
+    return packet;
+}
+
 //////////////////////////////////////////////////////////////////////////
 WarmupRequestPacket::WarmupRequestPacket(const CacheItemKey& key_)
     : CachePacket(PACKET_WARMING_UP_REQUEST, CREATE_SENDING_BUFFER)
@@ -0,0 +1,139 @@
+#include "AssetCache/CachedItemValueStream.h"
+#include "AssetCache/CachedItemValue.h"
+
+#include <FileSystem/File.h>
+#include <FileSystem/FileSystem.h>
+#include <Debug/DVAssert.h>
+#include <Logger/Logger.h>
+
+namespace DAVA
+{
+namespace AssetCache
+{
+bool CachedItemValueStream::Open(const CachedItemValue& value, const FilePath& folder)
+{
+    DVASSERT(folder.IsDirectoryPathname());
+
+    segments.clear();
+    size = 0;
+
+    // layout should be the same as in CachedItemValue::Serialize(File*)
+    AppendData(&value.size, sizeof(value.size));
+
+    uint64 count = value.dataContainer.size();
+    AppendData(&count, sizeof(count));
+
+    uint64 filesSize = 0;
+    for (const auto& entry : value.dataContainer)
+    {
+        FilePath filePath = folder + entry.first;
+
+        uint64 fileSize = 0;
+        if (!FileSystem::Instance()->GetFileSize(filePath, fileSize) || fileSize == 0 || fileSize > std::numeric_limits<uint32>::max())
+        {
+            Logger::Error("[CachedItemValueStream::%s] Cannot read file %s", __FUNCTION__, filePath.GetStringValue().c_str());
+            return false;
+        }
+
+        uint32 dataSize = static_cast<uint32>(fileSize);
+        AppendString(entry.first);
+        AppendData(&dataSize, sizeof(dataSize));
+        AppendFile(filePath, dataSize);
+
+        filesSize += fileSize;
+    }
+
+    if (filesSize != value.size)
+    {
+        Logger::Error("[CachedItemValueStream::%s] Files size %llu differs from stored %llu", __FUNCTION__, filesSize, value.size);
+        return false;
+    }
+
+    AppendString(value.description.machineName);
+    AppendString(value.description.creationDate);
+    AppendString(value.description.addingChain);
+    AppendString(value.description.receivingChain);
+    AppendString(value.description.comment);
+
+    AppendData(&value.validationDetails.filesCount, sizeof(value.validationDetails.filesCount));
+    AppendData(&value.validationDetails.filesDataSize, sizeof(value.validationDetails.filesDataSize));
+
+    return true;
+}
+
+bool CachedItemValueStream::Read(uint64 offset, uint8* buffer, uint32 bufferSize) const
+{
+    if (offset > size || bufferSize > size - offset)
+    {
+        return false;
+    }
+
+    auto it = std::upper_bound(segments.begin(), segments.end(), offset, [](uint64 value, const Segment& segment) {
+        return value < segment.offset;
+    });
+
+    while (bufferSize > 0)
+    {
+        DVASSERT(it != segments.begin());
+        const Segment& segment = *(it - 1);
+
+        uint64 offsetInSegment = offset - segment.offset;
+        uint32 readSize = static_cast<uint32>(std::min(static_cast<uint64>(bufferSize), segment.size - offsetInSegment));
+
+        if (segment.filePath.IsEmpty())
+        {
+            Memcpy(buffer, segment.data.data() + offsetInSegment, readSize);
+        }
+        else
+        {
+            ScopedPtr<File> file(File::Create(segment.filePath, File::OPEN | File::READ));
+            if (!file || !file->Seek(static_cast<int64>(offsetInSegment), File::SEEK_FROM_START) || file->Read(buffer, readSize) != readSize)
+            {
+                Logger::Error("[CachedItemValueStream::%s] Cannot read file %s", __FUNCTION__, segment.filePath.GetStringValue().c_str());
+                return false;
+            }
+        }
+
+        buffer += readSize;
+        offset += readSize;
+        bufferSize -= readSize;
+        ++it;
+    }
+
+    return true;
+}
+
+void CachedItemValueStream::AppendData(const void* data, uint32 dataSize)
+{
+    if (segments.empty() || !segments.back().filePath.IsEmpty())
+    {
+        segments.emplace_back();
+        segments.back().offset = size;
+    }
+
+    Segment& segment = segments.back();
+    const uint8* bytes = static_cast<const uint8*>(data);
+    segment.data.insert(segment.data.end(), bytes, bytes + dataSize);
+    segment.size += dataSize;
+    size += dataSize;
+}
+
+void CachedItemValueStream::AppendString(const String& string)
+{
+    // with terminating null, as File::WriteString does
+    AppendData(string.c_str(), static_cast<uint32>(string.length() + 1));
+}
+
+void CachedItemValueStream::AppendFile(const FilePath& filePath, uint32 fileSize)
+{
+    segments.emplace_back();
+
+    Segment& segment = segments.back();
+    segment.offset = size;
+    segment.size = fileSize;
+    segment.filePath = filePath;
+    size += fileSize;
+}
+
+} // namespace AssetCache
+} // namespace DAVA
@@ -160,6 +160,16 @@ bool ServerNetProxy::SendChunk(const std::shared_ptr<Net::IChannel>& channel, co
     return false;
 }
 
+bool ServerNetProxy::SendChunk(const std::shared_ptr<Net::IChannel>& channel, GetChunkResponsePacket& packet)
+{
+    if (channel)
+    {
+        return packet.SendTo(channel);
+    }
+
+    return false;
+}
+
 bool ServerNetProxy::SendStatus(const std::shared_ptr<Net::IChannel>& channel)
 {
     if (channel)
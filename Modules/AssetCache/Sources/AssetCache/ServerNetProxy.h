@@ -13,6 +13,7 @@ namespace DAVA
 namespace AssetCache
 {
 class CachedItemValue;
+class GetChunkResponsePacket;
 
 class ServerNetProxyListener
 {
@@ -47,6 +48,7 @@ public:
     bool SendRemovedFromCache(const std::shared_ptr<Net::IChannel>& channel, const CacheItemKey& key, bool removed);
     bool SendCleared(const std::shared_ptr<Net::IChannel>& channel, bool cleared);
     bool SendChunk(const std::shared_ptr<Net::IChannel>& channel, const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const Vector<uint8>& chunkData);
+    bool SendChunk(const std::shared_ptr<Net::IChannel>& channel, GetChunkResponsePacket& packet);
     bool SendStatus(const std::shared_ptr<Net::IChannel>& channel);
 
     //Net::IChannelListener
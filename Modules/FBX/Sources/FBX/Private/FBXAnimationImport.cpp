@@ -1,5 +1,6 @@
 #include "FBXAnimationImport.h"
 
+#include "Animation/AnimationChannelWriter.h"
 #include "Animation/AnimationClip.h"
 #include "FileSystem/File.h"
 #include "Logger/Logger.h"
@@ -20,6 +21,8 @@ Set<FbxTime> GetAnimationSamples(FbxPropertyT<FbxDouble3>& fbxProperty, FbxAnimL
 Vector<FBXImporterDetails::FBXAnimationKey> GetAnimationKeys(FbxNode* fbxNode, const Set<FbxTime>& keyTimes, AnimationTrack::eChannelTarget channel);
 FBXImporterDetails::FBXNodeAnimationData GetNodeAnimationData(FbxNode* fbxNode, FbxAnimLayer* fbxAnimLayer);
 void ProcessNodeAnimationRecursive(FbxNode* fbxNode, FbxAnimLayer* fbxAnimLayer, Vector<FBXImporterDetails::FBXNodeAnimationData>* outNodesAnimations);
+bool GetChannelFormat(AnimationTrack::eChannelTarget target, uint8* outDimension, AnimationChannel::eInterpolation* outInterpolation);
+bool IsChannelExported(const FBXImporterDetails::FBXAnimationChannelData& fbxChannelData);
 };
 
 namespace FBXImporterDetails
@@ -79,19 +82,15 @@ void SaveAnimation(const FBXAnimationStackData& fbxStackAnimationData, const Fil
     using namespace FBXAnimationImportDetails;
 
     //binary file format described in 'AnimationBinaryFormat.md'
-    struct ChannelHeader
+    struct TrackChannelHeader
     {
-        //Track part
         uint8 target;
         uint8 pad0[3];
+    } trackChannelHeader;
 
-        //Channel part
-        uint32 signature = AnimationChannel::ANIMATION_CHANNEL_DATA_SIGNATURE;
-        uint8 dimension = 0;
-        uint8 interpolation = 0;
-        uint16 compression = 0;
-        uint32 keyCount = 0;
-    } channelHeader;
+    AnimationChannelWriter::Settings channelSettings;
+    Vector<float32> keyTimes;
+    Vector<float32> keyValues;
 
     ScopedPtr<File> file(File::Create(filePath, File::CREATE | File::WRITE));
     if (file)
@@ -122,61 +121,42 @@ void SaveAnimation(const FBXAnimationStackData& fbxStackAnimationData, const Fil
             uint32 channelsCount = 0;
             for (auto& fbxChannelData : fbxNodeData.animationTrackData)
             {
-                if (!fbxChannelData.animationKeys.empty())
+                if (IsChannelExported(fbxChannelData))
                     ++channelsCount;
+                else if (!fbxChannelData.animationKeys.empty())
+                    Logger::Warning("[FBXImporter] Animation channel with unknown target %u of node '%s' is skipped", uint32(fbxChannelData.channel), nodeName.c_str());
             }
 
             WriteToBuffer(animationData, &channelsCount);
 
             for (auto& fbxChannelData : fbxNodeData.animationTrackData)
             {
-                if (!fbxChannelData.animationKeys.empty())
+                if (IsChannelExported(fbxChannelData))
                 {
-                    channelHeader.target = fbxChannelData.channel;
-                    channelHeader.keyCount = uint32(fbxChannelData.animationKeys.size());
+                    trackChannelHeader.target = fbxChannelData.channel;
 
-                    if (channelHeader.target == AnimationTrack::CHANNEL_TARGET_POSITION)
-                    {
-                        channelHeader.dimension = 3;
-                        channelHeader.interpolation = uint8(AnimationChannel::INTERPOLATION_LINEAR);
-                    }
-                    else if (channelHeader.target == AnimationTrack::CHANNEL_TARGET_ORIENTATION)
-                    {
-                        channelHeader.dimension = 4;
-                        channelHeader.interpolation = uint8(AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR);
-                    }
-                    else if (channelHeader.target == AnimationTrack::CHANNEL_TARGET_SCALE)
-                    {
-                        channelHeader.dimension = 1;
-                        channelHeader.interpolation = uint8(AnimationChannel::INTERPOLATION_LINEAR);
-                    }
+                    uint8 dimension = 0;
+                    AnimationChannel::eInterpolation interpolation = AnimationChannel::INTERPOLATION_LINEAR;
+                    GetChannelFormat(fbxChannelData.channel, &dimension, &interpolation);
 
-                    WriteToBuffer(animationData, &channelHeader);
-
-                    for (uint32 k = 0; k < channelHeader.keyCount; ++k)
+                    keyTimes.clear();
+                    keyValues.clear();
+                    for (const FBXAnimationKey& key : fbxChannelData.animationKeys)
                     {
-                        const FBXAnimationKey& key = fbxChannelData.animationKeys[k];
-
-                        float32 relativeKeyTime = key.time - fbxStackAnimationData.minTimeStamp;
-                        WriteToBuffer(animationData, &relativeKeyTime);
+                        keyTimes.push_back(key.time - fbxStackAnimationData.minTimeStamp);
 
-                        if (channelHeader.target == AnimationTrack::CHANNEL_TARGET_POSITION)
-                        {
-                            Vector3 position = Vector3(key.value.data);
-                            WriteToBuffer(animationData, &position);
-                        }
-                        else if (channelHeader.target == AnimationTrack::CHANNEL_TARGET_ORIENTATION)
+                        Vector4 value = key.value;
+                        if (trackChannelHeader.target == AnimationTrack::CHANNEL_TARGET_ORIENTATION)
                         {
                             Quaternion orientation = Quaternion(key.value.data);
                             orientation.Normalize();
-                            WriteToBuffer(animationData, &orientation);
-                        }
-                        else if (channelHeader.target == AnimationTrack::CHANNEL_TARGET_SCALE)
-                        {
-                            float32 scale = key.value.x;
-                            WriteToBuffer(animationData, &scale);
+                            value = Vector4(orientation.data);
                         }
+                        keyValues.insert(keyValues.end(), value.data, value.data + dimension);
                     }
+
+                    WriteToBuffer(animationData, &trackChannelHeader);
+                    AnimationChannelWriter::Write(animationData, dimension, interpolation, keyTimes, keyValues, channelSettings);
                 }
             }
         }
@@ -317,6 +297,35 @@ void ProcessNodeAnimationRecursive(FbxNode* fbxNode, FbxAnimLayer* fbxAnimLayer,
         ProcessNodeAnimationRecursive(fbxNode->GetChild(child), fbxAnimLayer, outNodesAnimations);
 }
 
+bool GetChannelFormat(AnimationTrack::eChannelTarget target, uint8* outDimension, AnimationChannel::eInterpolation* outInterpolation)
+{
+    switch (target)
+    {
+    case AnimationTrack::CHANNEL_TARGET_POSITION:
+        *outDimension = 3;
+        *outInterpolation = AnimationChannel::INTERPOLATION_LINEAR;
+        return true;
+    case AnimationTrack::CHANNEL_TARGET_ORIENTATION:
+        *outDimension = 4;
+        *outInterpolation = AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR;
+        return true;
+    case AnimationTrack::CHANNEL_TARGET_SCALE:
+        *outDimension = 1;
+        *outInterpolation = AnimationChannel::INTERPOLATION_LINEAR;
+        return true;
+    default:
+        return false;
+    }
+}
+
+//channels without keys or with unknown target are not written, so they are not counted in track too
+bool IsChannelExported(const FBXImporterDetails::FBXAnimationChannelData& fbxChannelData)
+{
+    uint8 dimension = 0;
+    AnimationChannel::eInterpolation interpolation = AnimationChannel::INTERPOLATION_LINEAR;
+    return !fbxChannelData.animationKeys.empty() && GetChannelFormat(fbxChannelData.channel, &dimension, &interpolation);
+}
+
 }; //ns FBXAnimationImportDetails
 
 }; //ns DAVA
\ No newline at end of file
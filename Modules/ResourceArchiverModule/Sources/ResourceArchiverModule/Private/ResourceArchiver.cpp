@@ -594,12 +594,6 @@ bool Pack(const Vector<CollectedFile>& collectedFiles,
                                         useBuffers[fileIndex] = std::move(useBuffer);
                                         ++countLoadedFiles;
                                     });
-
-        //HACK wait jobs executed (internaly 1024 max jobs)
-        if (fileIndex > 0 && fileIndex % 1000 == 0)
-        {
-            jobManager->WaitWorkerJobs();
-        }
     } // end for fileIndex
 
     jobManager->WaitWorkerJobs();
@@ -4,6 +4,7 @@
 #include "GetRequest.h"
 #include "RemoveRequest.h"
 #include "ClearRequest.h"
+#include "LoadTestRequest.h"
 
 ClientApplication::ClientApplication()
 {
@@ -11,6 +12,7 @@ ClientApplication::ClientApplication()
     requests.emplace_back(std::unique_ptr<CacheRequest>(new GetRequest()));
     requests.emplace_back(std::unique_ptr<CacheRequest>(new RemoveRequest()));
     requests.emplace_back(std::unique_ptr<CacheRequest>(new ClearRequest()));
+    requests.emplace_back(std::unique_ptr<CacheRequest>(new LoadTestRequest()));
 }
 
 ClientApplication::~ClientApplication()
@@ -0,0 +1,300 @@
+#include "LoadTestRequest.h"
+
+#include <AssetCache/AssetCacheClient.h>
+
+#include <Logger/Logger.h>
+#include <Network/NetCore.h>
+#include <Time/SystemTimer.h>
+#include <Utils/MD5.h>
+#include <Utils/StringFormat.h>
+
+#include <algorithm>
+
+using namespace DAVA;
+
+namespace LoadTestRequestDetails
+{
+/**
+    Connection that requests items in a loop. All connections are processed on current thread,
+    so server sees them as independent clients while test doesn't need any synchronization.
+*/
+class LoadClient : public AssetCache::ClientNetProxyListener
+{
+public:
+    LoadClient(Dispatcher<Function<void()>>* dispatcher, const Vector<AssetCache::CacheItemKey>& keys, uint32 index)
+        : proxy(dispatcher)
+        , keys(keys)
+        , nextKeyIndex(index)
+    {
+        proxy.AddListener(this);
+    }
+
+    ~LoadClient()
+    {
+        proxy.RemoveListener(this);
+    }
+
+    void Connect(const String& ip, uint16 port)
+    {
+        proxy.Connect(ip, port);
+    }
+
+    void Disconnect()
+    {
+        proxy.DisconnectBlocked();
+    }
+
+    bool IsConnected() const
+    {
+        return proxy.ChannelIsOpened();
+    }
+
+    // doesn't interrupt request in progress
+    void Stop()
+    {
+        stopRequested = true;
+    }
+
+    bool IsRequesting() const
+    {
+        return isRequesting;
+    }
+
+    void OnClientProxyStateChanged() override
+    {
+        if (proxy.ChannelIsOpened())
+        {
+            if (!isRequesting)
+            {
+                StartNextRequest();
+            }
+        }
+        else if (isRequesting)
+        {
+            isRequesting = false;
+            ++failedRequests;
+        }
+    }
+
+    void OnReceivedFromCache(const AssetCache::CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const Vector<uint8>& chunkData) override
+    {
+        if (!isRequesting || key != requestedKey || chunkNumber != requestedChunk)
+        {
+            return;
+        }
+
+        if (numOfChunks == 0 || chunkData.empty())
+        {
+            ++failedRequests;
+            StartNextRequest();
+        }
+        else if (chunkNumber + 1 < numOfChunks)
+        {
+            RequestChunk(chunkNumber + 1);
+        }
+        else
+        {
+            latenciesUs.push_back(SystemTimer::GetUs() - requestStartUs);
+            StartNextRequest();
+        }
+    }
+
+    Vector<int64> latenciesUs;
+    uint32 failedRequests = 0;
+
+private:
+    void StartNextRequest()
+    {
+        isRequesting = false;
+        if (stopRequested)
+        {
+            return;
+        }
+
+        requestedKey = keys[nextKeyIndex++ % keys.size()];
+        requestStartUs = SystemTimer::GetUs();
+        RequestChunk(0);
+    }
+
+    void RequestChunk(uint32 chunkNumber)
+    {
+        requestedChunk = chunkNumber;
+        isRequesting = proxy.RequestGetNextChunk(requestedKey, chunkNumber);
+        if (!isRequesting)
+        {
+            ++failedRequests;
+        }
+    }
+
+    AssetCache::ClientNetProxy proxy;
+    const Vector<AssetCache::CacheItemKey>& keys;
+    size_t nextKeyIndex = 0;
+
+    AssetCache::CacheItemKey requestedKey;
+    uint32 requestedChunk = 0;
+    int64 requestStartUs = 0;
+    bool isRequesting = false;
+    bool stopRequested = false;
+};
+
+int64 GetPercentile(const Vector<int64>& sortedValues, uint32 percentile)
+{
+    DVASSERT(!sortedValues.empty());
+    size_t index = (sortedValues.size() - 1) * percentile / 100;
+    return sortedValues[index];
+}
+}
+
+LoadTestRequest::LoadTestRequest()
+    : CacheRequest("loadtest")
+{
+    options.AddOption("-c", VariantType(static_cast<uint32>(64)), "Count of concurrent connections");
+    options.AddOption("-d", VariantType(static_cast<uint32>(10)), "Test duration in seconds");
+    options.AddOption("-s", VariantType(static_cast<uint32>(1024 * 1024)), "Size of each requested item in bytes");
+    options.AddOption("-i", VariantType(static_cast<uint32>(16)), "Count of items added into cache and requested");
+}
+
+AssetCache::Error LoadTestRequest::SendRequest(AssetCacheClient& cacheClient)
+{
+    using namespace LoadTestRequestDetails;
+
+    const uint32 clientsCount = options.GetOption("-c").AsUInt32();
+    const uint32 duration = options.GetOption("-d").AsUInt32();
+    const uint32 itemSize = options.GetOption("-s").AsUInt32();
+    const uint32 itemsCount = options.GetOption("-i").AsUInt32();
+
+    Vector<AssetCache::CacheItemKey> keys(itemsCount);
+    for (uint32 i = 0; i < itemsCount; ++i)
+    {
+        std::shared_ptr<Vector<uint8>> data = std::make_shared<Vector<uint8>>(itemSize);
+        for (uint32 b = 0; b < itemSize; ++b)
+        {
+            (*data)[b] = static_cast<uint8>(b * 31 + i);
+        }
+
+        MD5::MD5Digest digest;
+        MD5::ForData(data->data(), itemSize, digest);
+        keys[i].SetPrimaryKey(digest);
+        String name = Format("loadtest_%u", i);
+        MD5::ForData(reinterpret_cast<const uint8*>(name.data()), static_cast<uint32>(name.size()), digest);
+        keys[i].SetSecondaryKey(digest);
+
+        AssetCache::CachedItemValue value;
+        value.Add(name, data);
+
+        AssetCache::CachedItemValue::Description description;
+        description.comment = "Asset Cache Client load test";
+        value.SetDescription(description);
+        value.UpdateValidationData();
+
+        AssetCache::Error result = cacheClient.AddToCacheSynchronously(keys[i], value);
+        if (result != AssetCache::Error::NO_ERRORS)
+        {
+            Logger::Error("[LoadTestRequest::%s] Cannot add test item #%u", __FUNCTION__, i);
+            return result;
+        }
+    }
+
+    Dispatcher<Function<void()>> dispatcher([](const Function<void()>& fn) { fn(); });
+    dispatcher.LinkToCurrentThread();
+
+    auto processNetwork = [&dispatcher]() {
+        Net::NetCore::Instance()->Update();
+        if (dispatcher.HasEvents())
+        {
+            dispatcher.ProcessEvents();
+        }
+    };
+
+    const String ip = options.GetOption("-ip").AsString();
+    const uint16 port = static_cast<uint16>(options.GetOption("-p").AsUInt32());
+    const uint64 timeoutMs = options.GetOption("-t").AsUInt64() * 1000;
+
+    Vector<std::unique_ptr<LoadClient>> clients;
+    clients.reserve(clientsCount);
+    for (uint32 i = 0; i < clientsCount; ++i)
+    {
+        clients.emplace_back(new LoadClient(&dispatcher, keys, i));
+        clients.back()->Connect(ip, port);
+    }
+
+    auto allClients = [&clients](const Function<bool(const LoadClient&)>& fn) {
+        return std::all_of(clients.begin(), clients.end(), [&fn](const std::unique_ptr<LoadClient>& c) { return fn(*c); });
+    };
+
+    AssetCache::Error result = AssetCache::Error::NO_ERRORS;
+
+    int64 startMs = SystemTimer::GetMs();
+    while (!allClients([](const LoadClient& c) { return c.IsConnected(); }))
+    {
+        processNetwork();
+        if (SystemTimer::GetMs() - startMs > static_cast<int64>(timeoutMs))
+        {
+            Logger::Error("[LoadTestRequest::%s] Timeout on connecting %u clients", __FUNCTION__, clientsCount);
+            result = AssetCache::Error::OPERATION_TIMEOUT;
+            break;
+        }
+    }
+
+    if (result == AssetCache::Error::NO_ERRORS)
+    {
+        startMs = SystemTimer::GetMs();
+        while (SystemTimer::GetMs() - startMs < static_cast<int64>(duration) * 1000)
+        {
+            processNetwork();
+        }
+
+        for (std::unique_ptr<LoadClient>& c : clients)
+        {
+            c->Stop();
+        }
+
+        // let requests in progress finish, so they are counted in latencies
+        int64 stopMs = SystemTimer::GetMs();
+        while (!allClients([](const LoadClient& c) { return !c.IsRequesting(); }) && SystemTimer::GetMs() - stopMs < static_cast<int64>(timeoutMs))
+        {
+            processNetwork();
+        }
+        int64 elapsedMs = std::max<int64>(SystemTimer::GetMs() - startMs, 1);
+
+        Vector<int64> latencies;
+        uint32 failedRequests = 0;
+        for (const std::unique_ptr<LoadClient>& c : clients)
+        {
+            latencies.insert(latencies.end(), c->latenciesUs.begin(), c->latenciesUs.end());
+            failedRequests += c->failedRequests;
+        }
+        std::sort(latencies.begin(), latencies.end());
+
+        printf("Clients: %u, item size: %u bytes, items: %u\n", clientsCount, itemSize, itemsCount);
+        printf("Requests: %u done, %u failed in %.2f s\n", static_cast<uint32>(latencies.size()), failedRequests, elapsedMs / 1000.0);
+        printf("Requests/sec: %.1f\n", latencies.size() * 1000.0 / elapsedMs);
+        if (!latencies.empty())
+        {
+            printf("Latency ms: p50 %.2f, p99 %.2f, max %.2f\n", GetPercentile(latencies, 50) / 1000.0, GetPercentile(latencies, 99) / 1000.0, latencies.back() / 1000.0);
+        }
+
+        if (failedRequests > 0)
+        {
+            result = AssetCache::Error::SERVER_ERROR;
+        }
+    }
+
+    for (std::unique_ptr<LoadClient>& c : clients)
+    {
+        c->Disconnect();
+    }
+
+    return result;
+}
+
+AssetCache::Error LoadTestRequest::CheckOptionsInternal() const
+{
+    if (options.GetOption("-c").AsUInt32() == 0 || options.GetOption("-i").AsUInt32() == 0 || options.GetOption("-s").AsUInt32() == 0)
+    {
+        Logger::Error("[LoadTestRequest::%s] Clients count, items count and item size should be positive", __FUNCTION__);
+        return AssetCache::Error::WRONG_COMMAND_LINE;
+    }
+
+    return AssetCache::Error::NO_ERRORS;
+}
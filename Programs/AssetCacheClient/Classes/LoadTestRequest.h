@@ -0,0 +1,25 @@
+#ifndef __LOAD_TEST_REQUEST_H__
+#define __LOAD_TEST_REQUEST_H__
+
+#include "CacheRequest.h"
+
+namespace DAVA
+{
+class AssetCacheClient;
+}
+
+/**
+    Adds generated items into cache and then requests them by several concurrent connections.
+    Prints requests per second and latency percentiles.
+*/
+class LoadTestRequest : public CacheRequest
+{
+public:
+    LoadTestRequest();
+
+protected:
+    DAVA::AssetCache::Error SendRequest(DAVA::AssetCacheClient& cacheClient) override;
+    DAVA::AssetCache::Error CheckOptionsInternal() const override;
+};
+
+#endif //__LOAD_TEST_REQUEST_H__
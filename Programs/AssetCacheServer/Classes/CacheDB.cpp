@@ -4,20 +4,38 @@
 
 #include <AssetCache/CachedItemValue.h>
 
+#include <FileSystem/DynamicMemoryFile.h>
 #include <FileSystem/File.h>
+#include <FileSystem/FileList.h>
 #include <FileSystem/FileSystem.h>
 #include <FileSystem/KeyedArchive.h>
 #include <Debug/DVAssert.h>
 #include <Time/SystemTimer.h>
+#include <Utils/CRC32.h>
 #include <Utils/StringFormat.h>
 #include <Logger/Logger.h>
 
 const DAVA::String CacheDB::DB_FILE_NAME = "cache.dat";
+const DAVA::String CacheDB::JOURNAL_FILE_NAME = "cache.journal";
+const DAVA::String CacheDB::INCOMING_FOLDER_NAME = "incoming/";
 const DAVA::uint32 CacheDB::VERSION = 1;
 
+namespace CacheDBDetails
+{
+// journal record is [payload size][payload crc32][payload], payload is [record type][key][record data]
+const DAVA::uint32 JOURNAL_HEADER_SIZE = sizeof(DAVA::uint32) * 2;
+const DAVA::uint32 JOURNAL_MIN_PAYLOAD_SIZE = sizeof(DAVA::uint8) + DAVA::AssetCache::HASH_SIZE;
+
+const DAVA::uint64 JOURNAL_FLUSH_TIMEOUT_MS = 1000;
+const size_t JOURNAL_BUFFER_LIMIT = 4 * 1024 * 1024;
+
+// journal is compacted into snapshot when it has more records than snapshot would have items
+const DAVA::uint64 JOURNAL_MIN_RECORDS_TO_COMPACT = 10000;
+const DAVA::uint64 JOURNAL_RECORDS_PER_ITEM_TO_COMPACT = 2;
+}
+
 CacheDB::CacheDB(CacheDBOwner& _owner)
     : owner(_owner)
-    , dbStateChanged(false)
 {
 }
 
@@ -33,8 +51,6 @@ void CacheDB::NotifySizeChanged()
 
 void CacheDB::UpdateSettings(const DAVA::FilePath& folderPath, const DAVA::uint64 size, const DAVA::uint32 newMaxItemsInMemory, const DAVA::uint64 _autoSaveTimeout)
 {
-    bool fullCacheChanged = false;
-
     DAVA::FilePath newCacheRootFolder = folderPath;
     newCacheRootFolder.MakeDirectoryPathname();
 
@@ -48,15 +64,14 @@ void CacheDB::UpdateSettings(const DAVA::FilePath& folderPath, const DAVA::uint6
 
         cacheRootFolder = newCacheRootFolder;
         cacheSettings = cacheRootFolder + DB_FILE_NAME;
+        cacheJournal = cacheRootFolder + JOURNAL_FILE_NAME;
 
         Load();
-        fullCacheChanged = true;
     }
 
     if (maxStorageSize != size)
     {
         ReduceFullCacheToSize(size);
-        fullCacheChanged = true;
 
         maxStorageSize = size;
         NotifySizeChanged();
@@ -76,10 +91,14 @@ void CacheDB::UpdateSettings(const DAVA::FilePath& folderPath, const DAVA::uint6
 
     autoSaveTimeout = _autoSaveTimeout;
 
-    if (fullCacheChanged)
+    if (IsJournalCompactionNeeded())
     {
         Save();
     }
+    else
+    {
+        FlushJournal();
+    }
 }
 
 void CacheDB::Load()
@@ -87,6 +106,23 @@ void CacheDB::Load()
     DVASSERT(fastCache.empty());
     DVASSERT(fullCache.empty());
 
+    occupiedSize = 0;
+
+    // files of items, which weren't inserted before server was stopped
+    DAVA::FileSystem::Instance()->DeleteDirectory(cacheRootFolder + INCOMING_FOLDER_NAME);
+
+    LoadSnapshot();
+    ReplayJournal();
+    BuildAccessMaps();
+
+    NotifySizeChanged();
+
+    lastSaveTime = DAVA::SystemTimer::GetMs();
+    lastJournalFlushTime = lastSaveTime;
+}
+
+void CacheDB::LoadSnapshot()
+{
     DAVA::ScopedPtr<DAVA::File> file(DAVA::File::Create(cacheSettings, DAVA::File::OPEN | DAVA::File::READ));
     if (!file)
     {
@@ -118,7 +154,6 @@ void CacheDB::Load()
         return;
     }
 
-    occupiedSize = 0;
     for (DAVA::uint64 index = 0; index < cacheSize; ++index)
     {
         DAVA::KeyedArchive* itemArchieve = cache->GetArchive(DAVA::Format("item_%d", index));
@@ -133,14 +168,171 @@ void CacheDB::Load()
         occupiedSize += entry.GetValue().GetSize();
         fullCache[key] = std::move(entry);
     }
+}
 
-    NotifySizeChanged();
-    dbStateChanged = false;
+void CacheDB::ReplayJournal()
+{
+    using namespace CacheDBDetails;
+
+    DAVA::ScopedPtr<DAVA::File> file(DAVA::File::Create(cacheJournal, DAVA::File::OPEN | DAVA::File::READ));
+    if (!file)
+    {
+        return;
+    }
+
+    const DAVA::uint64 fileSize = file->GetSize();
+    DAVA::uint64 position = 0;
+    DAVA::Vector<DAVA::uint8> payload;
+    while (fileSize - position >= JOURNAL_HEADER_SIZE)
+    {
+        DAVA::uint32 header[2] = {};
+        if (file->Read(header, JOURNAL_HEADER_SIZE) != JOURNAL_HEADER_SIZE)
+        {
+            break;
+        }
+
+        const DAVA::uint32 payloadSize = header[0];
+        if (payloadSize < JOURNAL_MIN_PAYLOAD_SIZE || payloadSize > fileSize - position - JOURNAL_HEADER_SIZE)
+        {
+            break;
+        }
+
+        payload.resize(payloadSize);
+        if (file->Read(payload.data(), payloadSize) != payloadSize || DAVA::CRC32::ForBuffer(payload.data(), payloadSize) != header[1])
+        {
+            break;
+        }
+
+        if (!ApplyJournalRecord(payload))
+        {
+            break;
+        }
+
+        position += JOURNAL_HEADER_SIZE + payloadSize;
+        ++journalRecordsCount;
+    }
+
+    if (position != fileSize)
+    {
+        // tail of journal is lost when server is killed in the middle of write,
+        // records after it can't be trusted, so db is saved to snapshot and journal is started again
+        DAVA::Logger::Warning("[CacheDB::%s] Journal is damaged at offset %llu of %llu, rest of it is skipped", __FUNCTION__, position, fileSize);
+        compactionRequested = true;
+    }
+}
+
+bool CacheDB::ApplyJournalRecord(const DAVA::Vector<DAVA::uint8>& payload)
+{
+    using namespace CacheDBDetails;
+
+    DAVA::AssetCache::CacheItemKey key;
+    std::copy(payload.begin() + 1, payload.begin() + JOURNAL_MIN_PAYLOAD_SIZE, key.begin());
+
+    const DAVA::uint8* data = payload.data() + JOURNAL_MIN_PAYLOAD_SIZE;
+    const DAVA::uint32 dataSize = static_cast<DAVA::uint32>(payload.size() - JOURNAL_MIN_PAYLOAD_SIZE);
+
+    // data of items is already on disk, so journal changes only in-memory state
+    switch (payload[0])
+    {
+    case RECORD_INSERT:
+    {
+        DAVA::ScopedPtr<DAVA::KeyedArchive> itemArchieve(new DAVA::KeyedArchive());
+        if (!itemArchieve->Load(data, dataSize))
+        {
+            return false;
+        }
+
+        ServerCacheEntry entry;
+        entry.Deserialize(itemArchieve);
+
+        ServerCacheEntry& insertedEntry = fullCache[key];
+        occupiedSize -= insertedEntry.GetValue().GetSize();
+        occupiedSize += entry.GetValue().GetSize();
+        insertedEntry = std::move(entry);
+        return true;
+    }
+    case RECORD_REMOVE:
+    {
+        auto found = fullCache.find(key);
+        if (found != fullCache.end())
+        {
+            occupiedSize -= found->second.GetValue().GetSize();
+            fullCache.erase(found);
+        }
+        return true;
+    }
+    case RECORD_ACCESS:
+    {
+        DAVA::uint64 timestamp = 0;
+        if (dataSize != sizeof(timestamp))
+        {
+            return false;
+        }
+
+        auto found = fullCache.find(key);
+        if (found != fullCache.end())
+        {
+            memcpy(&timestamp, data, sizeof(timestamp));
+            found->second.SetAccessTimestamp(timestamp);
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+void CacheDB::BuildAccessMaps()
+{
+    DVASSERT(fastCacheAccess.empty());
+
+    fullCacheAccess.clear();
+
+    bool uniqueTimestamps = true;
+    for (const auto& item : fullCache)
+    {
+        uniqueTimestamps &= fullCacheAccess.emplace(item.second.GetTimestamp(), item.first).second;
+    }
+
+    if (!uniqueTimestamps)
+    {
+        // previous versions stored clock values as timestamps. Entries are renumbered keeping their order
+        DAVA::Vector<CacheMap::value_type*> entries;
+        entries.reserve(fullCache.size());
+        for (auto& item : fullCache)
+        {
+            entries.push_back(&item);
+        }
+
+        std::stable_sort(entries.begin(), entries.end(), [](const CacheMap::value_type* left, const CacheMap::value_type* right) {
+            return left->second.GetTimestamp() < right->second.GetTimestamp();
+        });
+
+        fullCacheAccess.clear();
+        DAVA::uint64 timestamp = 0;
+        for (CacheMap::value_type* item : entries)
+        {
+            item->second.SetAccessTimestamp(timestamp);
+            fullCacheAccess.emplace_hint(fullCacheAccess.end(), timestamp, item->first);
+            ++timestamp;
+        }
+
+        compactionRequested = true;
+    }
+
+    nextItemID = fullCacheAccess.empty() ? 0 : fullCacheAccess.rbegin()->first + 1;
 }
 
 void CacheDB::Unload()
 {
-    Save();
+    if (IsJournalCompactionNeeded())
+    {
+        Save();
+    }
+    else
+    {
+        FlushJournal();
+    }
 
     for (auto& entry : fastCache)
     {
@@ -149,6 +341,10 @@ void CacheDB::Unload()
 
     fastCache.clear();
     fullCache.clear();
+    fastCacheAccess.clear();
+    fullCacheAccess.clear();
+    journalRecordsCount = 0;
+    compactionRequested = false;
     occupiedSize = 0;
     NotifySizeChanged();
 }
@@ -157,76 +353,163 @@ void CacheDB::Save()
 {
     DAVA::FileSystem::Instance()->CreateDirectory(cacheRootFolder, true);
 
-    DAVA::ScopedPtr<DAVA::File> file(DAVA::File::Create(cacheSettings, DAVA::File::CREATE | DAVA::File::WRITE));
-    if (!file)
+    // snapshot is written aside and replaces previous one only when completed
+    DAVA::FilePath tempSettings = cacheRootFolder + (DB_FILE_NAME + ".tmp");
+
     {
-        DAVA::Logger::Error("[CacheDB::%s] Cannot create file %s", __FUNCTION__, cacheSettings.GetStringValue().c_str());
+        DAVA::ScopedPtr<DAVA::File> file(DAVA::File::Create(tempSettings, DAVA::File::CREATE | DAVA::File::WRITE));
+        if (!file)
+        {
+            DAVA::Logger::Error("[CacheDB::%s] Cannot create file %s", __FUNCTION__, tempSettings.GetStringValue().c_str());
+            return;
+        }
+
+        DAVA::ScopedPtr<DAVA::KeyedArchive> header(new DAVA::KeyedArchive());
+        header->SetString("signature", "cache");
+        header->SetUInt32("version", VERSION);
+        header->SetUInt64("itemsCount", fullCache.size());
+        header->Save(file);
+
+        DAVA::ScopedPtr<DAVA::KeyedArchive> cache(new DAVA::KeyedArchive());
+        DAVA::uint64 index = 0;
+        for (auto& item : fullCache)
+        {
+            DAVA::ScopedPtr<DAVA::KeyedArchive> itemArchieve(new DAVA::KeyedArchive());
+            item.first.Serialize(itemArchieve);
+            item.second.Serialize(itemArchieve);
+
+            cache->SetArchive(DAVA::Format("item_%d", index++), itemArchieve);
+        }
+
+        if (!cache->Save(file))
+        {
+            DAVA::Logger::Error("[CacheDB::%s] Cannot write file %s", __FUNCTION__, tempSettings.GetStringValue().c_str());
+            return;
+        }
+    }
+
+    if (!DAVA::FileSystem::Instance()->MoveFile(tempSettings, cacheSettings, true))
+    {
+        DAVA::Logger::Error("[CacheDB::%s] Cannot replace file %s", __FUNCTION__, cacheSettings.GetStringValue().c_str());
         return;
     }
 
-    DAVA::ScopedPtr<DAVA::KeyedArchive> header(new DAVA::KeyedArchive());
-    header->SetString("signature", "cache");
-    header->SetUInt32("version", VERSION);
-    header->SetUInt64("itemsCount", fullCache.size());
-    header->Save(file);
+    // all changes from journal are in snapshot now. If journal isn't deleted, replaying it once more gives the same state
+    DAVA::FileSystem::Instance()->DeleteFile(cacheJournal);
+    journalBuffer.clear();
+    journalRecordsCount = 0;
+    compactionRequested = false;
 
-    DAVA::ScopedPtr<DAVA::KeyedArchive> cache(new DAVA::KeyedArchive());
-    DAVA::uint64 index = 0;
-    for (auto& item : fullCache)
+    lastSaveTime = DAVA::SystemTimer::GetMs();
+    lastJournalFlushTime = lastSaveTime;
+}
+
+void CacheDB::AppendJournalRecord(eJournalRecord type, const DAVA::AssetCache::CacheItemKey& key, const DAVA::uint8* data, DAVA::uint32 dataSize)
+{
+    using namespace CacheDBDetails;
+
+    const DAVA::uint32 payloadSize = JOURNAL_MIN_PAYLOAD_SIZE + dataSize;
+    const size_t recordOffset = journalBuffer.size();
+    journalBuffer.resize(recordOffset + JOURNAL_HEADER_SIZE + payloadSize);
+
+    DAVA::uint8* record = journalBuffer.data() + recordOffset;
+    DAVA::uint8* payload = record + JOURNAL_HEADER_SIZE;
+    payload[0] = type;
+    std::copy(key.begin(), key.end(), payload + 1);
+    if (dataSize > 0)
     {
-        DAVA::ScopedPtr<DAVA::KeyedArchive> itemArchieve(new DAVA::KeyedArchive());
-        item.first.Serialize(itemArchieve);
-        item.second.Serialize(itemArchieve);
+        memcpy(payload + JOURNAL_MIN_PAYLOAD_SIZE, data, dataSize);
+    }
+
+    const DAVA::uint32 crc = DAVA::CRC32::ForBuffer(payload, payloadSize);
+    memcpy(record, &payloadSize, sizeof(payloadSize));
+    memcpy(record + sizeof(payloadSize), &crc, sizeof(crc));
+
+    ++journalRecordsCount;
+}
 
-        cache->SetArchive(DAVA::Format("item_%d", index++), itemArchieve);
+void CacheDB::AppendInsertRecord(const DAVA::AssetCache::CacheItemKey& key, const ServerCacheEntry& entry)
+{
+    DAVA::ScopedPtr<DAVA::KeyedArchive> itemArchieve(new DAVA::KeyedArchive());
+    entry.Serialize(itemArchieve);
+
+    DAVA::ScopedPtr<DAVA::DynamicMemoryFile> buffer(DAVA::DynamicMemoryFile::Create(DAVA::File::CREATE | DAVA::File::WRITE));
+    itemArchieve->Save(buffer);
+
+    const DAVA::Vector<DAVA::uint8>& data = buffer->GetDataVector();
+    AppendJournalRecord(RECORD_INSERT, key, data.data(), static_cast<DAVA::uint32>(data.size()));
+}
+
+void CacheDB::FlushJournal()
+{
+    if (journalBuffer.empty())
+    {
+        return;
     }
-    cache->Save(file);
 
-    dbStateChanged = false;
-    lastSaveTime = DAVA::SystemTimer::GetMs();
+    DAVA::FileSystem::Instance()->CreateDirectory(cacheRootFolder, true);
+
+    DAVA::ScopedPtr<DAVA::File> file(DAVA::File::Create(cacheJournal, DAVA::File::APPEND | DAVA::File::WRITE));
+    if (!file || file->Write(journalBuffer.data(), static_cast<DAVA::uint32>(journalBuffer.size())) != journalBuffer.size())
+    {
+        // changes are kept in memory and will be stored with next snapshot
+        DAVA::Logger::Error("[CacheDB::%s] Cannot write journal %s", __FUNCTION__, cacheJournal.GetStringValue().c_str());
+        compactionRequested = true;
+    }
+
+    journalBuffer.clear();
+    lastJournalFlushTime = DAVA::SystemTimer::GetMs();
+}
+
+bool CacheDB::IsJournalCompactionNeeded() const
+{
+    using namespace CacheDBDetails;
+
+    if (compactionRequested)
+    {
+        return true;
+    }
+
+    return (journalRecordsCount > JOURNAL_MIN_RECORDS_TO_COMPACT) && (journalRecordsCount > fullCache.size() * JOURNAL_RECORDS_PER_ITEM_TO_COMPACT);
 }
 
 void CacheDB::ReduceFullCacheToSize(DAVA::uint64 toSize)
 {
-    while (occupiedSize > toSize)
+    while (occupiedSize > toSize && !fullCacheAccess.empty())
     {
-        const auto& found = std::min_element(fullCache.begin(), fullCache.end(), [](const CacheMap::value_type& left, const CacheMap::value_type& right) -> bool
-                                             {
-                                                 return left.second.GetTimestamp() < right.second.GetTimestamp();
-                                             });
+        auto found = fullCache.find(fullCacheAccess.begin()->second);
         if (found != fullCache.end())
         {
             Remove(found);
         }
         else
         {
-            if (occupiedSize > 0)
-            {
-                DAVA::Logger::Warning("Occupied size is %u, should be 0", occupiedSize);
-                occupiedSize = 0;
-                NotifySizeChanged();
-                break;
-            }
+            DVASSERT(false, "Access map is out of sync with full cache");
+            fullCacheAccess.erase(fullCacheAccess.begin());
         }
     }
+
+    if (occupiedSize > toSize && fullCache.empty())
+    {
+        DAVA::Logger::Warning("Occupied size is %u, should be 0", occupiedSize);
+        occupiedSize = 0;
+        NotifySizeChanged();
+    }
 }
 
 void CacheDB::ReduceFastCacheByCount(DAVA::uint32 countToRemove)
 {
-    for (; countToRemove > 0; --countToRemove)
+    for (; countToRemove > 0 && !fastCacheAccess.empty(); --countToRemove)
     {
-        const auto& oldestFound = std::min_element(fastCache.begin(), fastCache.end(), [](const FastCacheMap::value_type& left, const FastCacheMap::value_type& right) -> bool
-                                                   {
-                                                       return left.second->GetTimestamp() < right.second->GetTimestamp();
-                                                   });
-
+        auto oldestFound = fastCache.find(fastCacheAccess.begin()->second);
         if (oldestFound != fastCache.end())
         {
             RemoveFromFastCache(oldestFound);
         }
         else
         {
-            return;
+            DVASSERT(false, "Access map is out of sync with fast cache");
+            fastCacheAccess.erase(fastCacheAccess.begin());
         }
     }
 }
@@ -258,11 +541,18 @@ ServerCacheEntry* CacheDB::Get(const DAVA::AssetCache::CacheItemKey& key)
         }
     }
 
-    UpdateAccessTimestamp(entry);
+    UpdateAccessTimestamp(key, entry);
 
     return entry;
 }
 
+ServerCacheEntry* CacheDB::Find(const DAVA::AssetCache::CacheItemKey& key)
+{
+    ServerCacheEntry* entry = FindInFullCache(key);
+    UpdateAccessTimestamp(key, entry);
+    return entry;
+}
+
 ServerCacheEntry* CacheDB::FindInFastCache(const DAVA::AssetCache::CacheItemKey& key) const
 {
     auto found = fastCache.find(key);
@@ -304,10 +594,18 @@ void CacheDB::ClearStorage()
 void CacheDB::Insert(const DAVA::AssetCache::CacheItemKey& key, const DAVA::AssetCache::CachedItemValue& value)
 {
     ServerCacheEntry entry(value);
-    Insert(key, std::forward<ServerCacheEntry>(entry));
+    Insert(key, std::forward<ServerCacheEntry>(entry), DAVA::FilePath());
+}
+
+void CacheDB::Insert(const DAVA::AssetCache::CacheItemKey& key, const DAVA::AssetCache::CachedItemValue& value, const DAVA::FilePath& exportedFolder)
+{
+    DVASSERT(!exportedFolder.IsEmpty());
+
+    ServerCacheEntry entry(value);
+    Insert(key, std::forward<ServerCacheEntry>(entry), exportedFolder);
 }
 
-void CacheDB::Insert(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry&& entry)
+void CacheDB::Insert(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry&& entry, const DAVA::FilePath& exportedFolder)
 {
     if (entry.GetValue().GetSize() > maxStorageSize)
     {
@@ -315,6 +613,11 @@ void CacheDB::Insert(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry
         {
             DAVA::Logger::Warning("Inserted data size %llu is bigger than max storage size %llu", entry.GetValue().GetSize(), maxStorageSize);
         }
+
+        if (!exportedFolder.IsEmpty())
+        {
+            DAVA::FileSystem::Instance()->DeleteDirectory(exportedFolder);
+        }
         return;
     }
 
@@ -328,8 +631,17 @@ void CacheDB::Insert(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry
     fullCache[key] = std::move(entry);
     ServerCacheEntry* insertedEntry = &fullCache[key];
     DAVA::FilePath savedPath = CreateFolderPath(key);
-    insertedEntry->GetValue().ExportToFolder(savedPath);
-    insertedEntry->UpdateAccessTimestamp();
+    if (exportedFolder.IsEmpty())
+    {
+        insertedEntry->GetValue().ExportToFolder(savedPath);
+    }
+    else
+    {
+        MoveExportedFiles(exportedFolder, savedPath);
+    }
+    insertedEntry->SetAccessTimestamp(nextItemID++);
+    fullCacheAccess.emplace_hint(fullCacheAccess.end(), insertedEntry->GetTimestamp(), key);
+    AppendInsertRecord(key, *insertedEntry);
     occupiedSize += insertedEntry->GetValue().GetSize();
     NotifySizeChanged();
 
@@ -340,8 +652,23 @@ void CacheDB::Insert(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry
         ReduceFullCacheToSize(maxStorageSize);
         DVASSERT(fullCache.find(key) != fullCache.end());
     }
+}
 
-    dbStateChanged = true;
+void CacheDB::MoveExportedFiles(const DAVA::FilePath& exportedFolder, const DAVA::FilePath& folder) const
+{
+    DAVA::FileSystem* fileSystem = DAVA::FileSystem::Instance();
+    fileSystem->CreateDirectory(folder, true);
+
+    DAVA::ScopedPtr<DAVA::FileList> files(new DAVA::FileList(exportedFolder));
+    for (DAVA::uint32 i = 0; i < files->GetCount(); ++i)
+    {
+        if (!files->IsDirectory(i))
+        {
+            fileSystem->MoveFile(files->GetPathname(i), folder + files->GetFilename(i), true);
+        }
+    }
+
+    fileSystem->DeleteDirectory(exportedFolder);
 }
 
 void CacheDB::InsertInFastCache(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry* entry)
@@ -359,6 +686,7 @@ void CacheDB::InsertInFastCache(const DAVA::AssetCache::CacheItemKey& key, Serve
     DVASSERT(entry->GetValue().IsFetched() == true);
 
     fastCache[key] = entry;
+    fastCacheAccess.emplace(entry->GetTimestamp(), key);
 }
 
 void CacheDB::UpdateAccessTimestamp(const DAVA::AssetCache::CacheItemKey& key)
@@ -369,15 +697,27 @@ void CacheDB::UpdateAccessTimestamp(const DAVA::AssetCache::CacheItemKey& key)
         entry = FindInFullCache(key);
     }
 
-    UpdateAccessTimestamp(entry);
+    UpdateAccessTimestamp(key, entry);
 }
 
-void CacheDB::UpdateAccessTimestamp(ServerCacheEntry* entry)
+void CacheDB::UpdateAccessTimestamp(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry* entry)
 {
     if (nullptr != entry)
     {
-        entry->UpdateAccessTimestamp();
-        dbStateChanged = true;
+        const DAVA::uint64 oldTimestamp = entry->GetTimestamp();
+        const DAVA::uint64 newTimestamp = nextItemID++;
+        entry->SetAccessTimestamp(newTimestamp);
+
+        // new token is the greatest one, so entry moves to the end of eviction order
+        fullCacheAccess.erase(oldTimestamp);
+        fullCacheAccess.emplace_hint(fullCacheAccess.end(), newTimestamp, key);
+
+        if (fastCacheAccess.erase(oldTimestamp) != 0)
+        {
+            fastCacheAccess.emplace_hint(fastCacheAccess.end(), newTimestamp, key);
+        }
+
+        AppendJournalRecord(RECORD_ACCESS, key, reinterpret_cast<const DAVA::uint8*>(&newTimestamp), sizeof(newTimestamp));
     }
 }
 
@@ -402,13 +742,14 @@ void CacheDB::Remove(const CacheMap::iterator& it)
     }
 
     RemoveFromFullCache(it);
-    dbStateChanged = true;
 }
 
 void CacheDB::RemoveFromFullCache(const CacheMap::iterator& it)
 {
     DVASSERT(it != fullCache.end());
 
+    owner.OnEntryRemoved(it->first);
+
     DAVA::FilePath dataPath = CreateFolderPath(it->first);
     DAVA::FileSystem::Instance()->DeleteDirectory(dataPath);
 
@@ -416,6 +757,8 @@ void CacheDB::RemoveFromFullCache(const CacheMap::iterator& it)
     DVASSERT(itemSize <= occupiedSize);
     occupiedSize -= itemSize;
     DAVA::Logger::Debug("Removing from full cache: key %s", Brief(it->first).c_str());
+    AppendJournalRecord(RECORD_REMOVE, it->first, nullptr, 0);
+    fullCacheAccess.erase(it->second.GetTimestamp());
     fullCache.erase(it);
     NotifySizeChanged();
 }
@@ -426,6 +769,7 @@ void CacheDB::RemoveFromFastCache(const FastCacheMap::iterator& it)
 
     DVASSERT(it->second->GetValue().IsFetched() == true);
     it->second->Free();
+    fastCacheAccess.erase(it->second->GetTimestamp());
     fastCache.erase(it);
 }
 
@@ -437,17 +781,30 @@ DAVA::FilePath CacheDB::CreateFolderPath(const DAVA::AssetCache::CacheItemKey& k
     return (cacheRootFolder + (keyString.substr(0, 2) + "/" + keyString.substr(2) + "/"));
 }
 
+DAVA::FilePath CacheDB::CreateIncomingFolderPath(const DAVA::AssetCache::CacheItemKey& key)
+{
+    return (cacheRootFolder + (INCOMING_FOLDER_NAME + DAVA::Format("%s_%u/", key.ToString().c_str(), incomingFoldersCount++)));
+}
+
 void CacheDB::Update()
 {
-    if (dbStateChanged && (autoSaveTimeout != 0))
+    using namespace CacheDBDetails;
+
+    // zero timeout disables autosave, changes are stored on unload or when buffer is full
+    auto curTime = DAVA::SystemTimer::GetMs();
+    if (!journalBuffer.empty())
     {
-        auto curTime = DAVA::SystemTimer::GetMs();
-        if (curTime - lastSaveTime > autoSaveTimeout)
+        bool flushByTime = (autoSaveTimeout != 0) && (curTime - lastJournalFlushTime > JOURNAL_FLUSH_TIMEOUT_MS);
+        if (flushByTime || journalBuffer.size() > JOURNAL_BUFFER_LIMIT)
         {
-            Save();
-            lastSaveTime = curTime;
+            FlushJournal();
         }
     }
+
+    if ((autoSaveTimeout != 0) && (curTime - lastSaveTime > autoSaveTimeout) && IsJournalCompactionNeeded())
+    {
+        Save();
+    }
 }
 
 const DAVA::uint64 CacheDB::GetAvailableSize() const
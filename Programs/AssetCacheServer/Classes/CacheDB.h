@@ -5,8 +5,6 @@
 #include <Base/BaseTypes.h>
 #include <FileSystem/FilePath.h>
 
-#include <atomic>
-
 namespace DAVA
 {
 namespace AssetCache
@@ -20,15 +18,27 @@ class ServerCacheEntry;
 struct CacheDBOwner
 {
     virtual void OnStorageSizeChanged(DAVA::uint64 occupied, DAVA::uint64 overall) = 0;
+    // called before files of entry are deleted: on remove, on replace by insert and on eviction
+    virtual void OnEntryRemoved(const DAVA::AssetCache::CacheItemKey& key) = 0;
 };
 
 class CacheDB final
 {
     static const DAVA::String DB_FILE_NAME;
+    static const DAVA::String JOURNAL_FILE_NAME;
+    static const DAVA::String INCOMING_FOLDER_NAME;
     static const DAVA::uint32 VERSION;
 
     using CacheMap = DAVA::UnorderedMap<DAVA::AssetCache::CacheItemKey, ServerCacheEntry>;
     using FastCacheMap = DAVA::UnorderedMap<DAVA::AssetCache::CacheItemKey, ServerCacheEntry*>;
+    using AccessMap = DAVA::Map<DAVA::uint64, DAVA::AssetCache::CacheItemKey>; //access token -> key, oldest first
+
+    enum eJournalRecord : DAVA::uint8
+    {
+        RECORD_INSERT = 1,
+        RECORD_REMOVE,
+        RECORD_ACCESS
+    };
 
 public:
     CacheDB(CacheDBOwner& owner);
@@ -36,17 +46,36 @@ public:
 
     void UpdateSettings(const DAVA::FilePath& folderPath, const DAVA::uint64 size, const DAVA::uint32 itemsInMemory, const DAVA::uint64 autoSaveTimeout);
 
+    /**
+        Writes full snapshot of db and truncates journal.
+        Changes between snapshots are appended to journal, so it's only needed to compact the journal.
+    */
     void Save();
+    /**
+        Loads last snapshot and replays journal on top of it.
+    */
     void Load();
 
     ServerCacheEntry* Get(const DAVA::AssetCache::CacheItemKey& key);
+    /**
+        Finds entry without fetching its data, data can be read from files in CreateFolderPath(key).
+        Access timestamp of entry is updated.
+    */
+    ServerCacheEntry* Find(const DAVA::AssetCache::CacheItemKey& key);
 
     void Insert(const DAVA::AssetCache::CacheItemKey& key, const DAVA::AssetCache::CachedItemValue& value);
+    /**
+        Inserts value which files were already exported to `exportedFolder`, files are moved from there to the folder of entry.
+        Allows to write files on other thread and then insert them without blocking.
+    */
+    void Insert(const DAVA::AssetCache::CacheItemKey& key, const DAVA::AssetCache::CachedItemValue& value, const DAVA::FilePath& exportedFolder);
     bool Remove(const DAVA::AssetCache::CacheItemKey& key);
     void ClearStorage();
     void UpdateAccessTimestamp(const DAVA::AssetCache::CacheItemKey& key);
 
     const DAVA::FilePath& GetPath() const;
+    DAVA::FilePath CreateFolderPath(const DAVA::AssetCache::CacheItemKey& key) const;
+    DAVA::FilePath CreateIncomingFolderPath(const DAVA::AssetCache::CacheItemKey& key);
     const DAVA::uint64 GetStorageSize() const;
     const DAVA::uint64 GetAvailableSize() const;
     const DAVA::uint64 GetOccupiedSize() const;
@@ -54,9 +83,8 @@ public:
     void Update();
 
 private:
-    void Insert(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry&& entry);
-
-    DAVA::FilePath CreateFolderPath(const DAVA::AssetCache::CacheItemKey& key) const;
+    void Insert(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry&& entry, const DAVA::FilePath& exportedFolder);
+    void MoveExportedFiles(const DAVA::FilePath& exportedFolder, const DAVA::FilePath& folder) const;
 
     void Unload();
 
@@ -66,7 +94,17 @@ private:
 
     void InsertInFastCache(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry* entry);
 
-    void UpdateAccessTimestamp(ServerCacheEntry* entry);
+    void UpdateAccessTimestamp(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry* entry);
+
+    void LoadSnapshot();
+    void ReplayJournal();
+    bool ApplyJournalRecord(const DAVA::Vector<DAVA::uint8>& payload);
+    void BuildAccessMaps();
+
+    void AppendJournalRecord(eJournalRecord type, const DAVA::AssetCache::CacheItemKey& key, const DAVA::uint8* data, DAVA::uint32 dataSize);
+    void AppendInsertRecord(const DAVA::AssetCache::CacheItemKey& key, const ServerCacheEntry& entry);
+    void FlushJournal();
+    bool IsJournalCompactionNeeded() const;
 
     void ReduceFullCacheToSize(DAVA::uint64 toSize);
     void ReduceFastCacheByCount(DAVA::uint32 countToRemove);
@@ -83,6 +121,7 @@ private:
 
     DAVA::FilePath cacheRootFolder; //path to folder with settings and cache of files
     DAVA::FilePath cacheSettings; //path to settings
+    DAVA::FilePath cacheJournal; //path to journal of changes made after last save of settings
 
     DAVA::uint64 maxStorageSize = 0; //maximum cache size
     DAVA::uint32 maxItemsInMemory = 0; //count of items in memory, to use for fast access
@@ -92,11 +131,19 @@ private:
 
     DAVA::uint64 autoSaveTimeout = 0;
     DAVA::uint64 lastSaveTime = 0;
+    DAVA::uint64 lastJournalFlushTime = 0;
+
+    DAVA::uint32 incomingFoldersCount = 0;
 
     FastCacheMap fastCache; //runtime, week storage
     CacheMap fullCache; //stored on disk, strong storage
 
-    std::atomic<bool> dbStateChanged; //flag about changes in db
+    AccessMap fastCacheAccess; //eviction order of fastCache
+    AccessMap fullCacheAccess; //eviction order of fullCache
+
+    DAVA::Vector<DAVA::uint8> journalBuffer; //records not flushed to journal file yet
+    DAVA::uint64 journalRecordsCount = 0; //records in journal file and buffer
+    bool compactionRequested = false; //journal can't be appended, snapshot should be saved
 };
 
 inline const DAVA::FilePath& CacheDB::GetPath() const
@@ -2,7 +2,6 @@
 
 #include <AssetCache/CachedItemValue.h>
 #include <Base/BaseTypes.h>
-#include <chrono>
 
 namespace DAVA
 {
@@ -28,7 +27,7 @@ public:
     void Serialize(DAVA::KeyedArchive* archieve) const;
     void Deserialize(DAVA::KeyedArchive* archieve);
 
-    void UpdateAccessTimestamp();
+    void SetAccessTimestamp(DAVA::uint64 timestamp);
     DAVA::uint64 GetTimestamp() const;
 
     DAVA::AssetCache::CachedItemValue& GetValue();
@@ -40,12 +39,12 @@ private:
     DAVA::AssetCache::CachedItemValue value;
 
 private:
-    DAVA::uint64 accessTimestamp = 0;
+    DAVA::uint64 accessTimestamp = 0; //unique token, greater for later accessed entries
 };
 
-inline void ServerCacheEntry::UpdateAccessTimestamp()
+inline void ServerCacheEntry::SetAccessTimestamp(DAVA::uint64 timestamp)
 {
-    accessTimestamp = std::chrono::steady_clock::now().time_since_epoch().count();
+    accessTimestamp = timestamp;
 }
 
 inline DAVA::uint64 ServerCacheEntry::GetTimestamp() const
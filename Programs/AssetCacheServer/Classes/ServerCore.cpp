@@ -435,6 +435,11 @@ void ServerCore::OnStorageSizeChanged(DAVA::uint64 occupied, DAVA::uint64 overal
     emit StorageSizeChanged(occupied, overall);
 }
 
+void ServerCore::OnEntryRemoved(const DAVA::AssetCache::CacheItemKey& key)
+{
+    serverLogics.OnEntryRemoved(key);
+}
+
 void ServerCore::SetApplicationPath(const DAVA::String& path)
 {
     appPath = path;
@@ -65,6 +65,7 @@ public:
 
     // CacheDBOwner
     void OnStorageSizeChanged(DAVA::uint64 occupied, DAVA::uint64 overall) override;
+    void OnEntryRemoved(const DAVA::AssetCache::CacheItemKey& key) override;
 
 signals:
     void ServerStateChanged(const ServerCore* serverCore) const;
@@ -2,12 +2,35 @@
 #include "ServerCacheEntry.h"
 #include "PrintHelpers.h"
 
+#include <AssetCache/CachedItemValueStream.h>
+#include <AssetCache/CachePacket.h>
 #include <AssetCache/ChunkSplitter.h>
 
 #include <Concurrency/LockGuard.h>
+#include <Engine/Engine.h>
+#include <Engine/EngineContext.h>
+#include <FileSystem/FileSystem.h>
+#include <Job/JobManager.h>
 #include <Logger/Logger.h>
 #include <Utils/StringFormat.h>
 
+namespace ServerLogicsDetails
+{
+// limits memory held by chunks being read or written, the rest of requests waits in queue
+const DAVA::uint32 MAX_IO_JOBS_IN_FLIGHT = 8;
+}
+
+ServerLogics::~ServerLogics()
+{
+    // jobs refer to this object, their completions are dropped.
+    // Files of not inserted items are cleaned by db on next load
+    DAVA::JobManager* jobManager = DAVA::GetEngineContext()->jobManager;
+    if (jobManager != nullptr)
+    {
+        jobManager->WaitWorkerJob(ioJobs);
+    }
+}
+
 void ServerLogics::Init(DAVA::AssetCache::ServerNetProxy* server_, const DAVA::String& serverName_, DAVA::AssetCache::ClientNetProxy* client_, CacheDB* dataBase_)
 {
     serverProxy = server_;
@@ -38,6 +61,12 @@ void ServerLogics::OnAddChunkToCache(const std::shared_ptr<DAVA::Net::IChannel>&
         DiscardTask();
     };
 
+    if (task.isWriting)
+    {
+        Error("all chunks were already received");
+        return;
+    }
+
     if (chunkNumber == 0)
     {
         if (dataSize == 0 || numOfChunks == 0)
@@ -92,30 +121,9 @@ void ServerLogics::OnAddChunkToCache(const std::shared_ptr<DAVA::Net::IChannel>&
             return;
         }
 
-        AssetCache::CachedItemValue value;
-        task.receivedData->Seek(0, File::SEEK_FROM_START);
-        value.Deserialize(task.receivedData);
-        if (value.IsEmpty() || !value.IsValid())
-        {
-            Error("Received data is empty or invalid");
-            return;
-        }
-
-        AssetCache::CachedItemValue::Description description = value.GetDescription();
-        description.addingChain += "/" + serverName;
-        value.SetDescription(description);
-
-        if (value.GetSize() > dataBase->GetStorageSize())
-        {
-            Logger::Warning("Inserted data size %u is bigger than max storage size %u", value.GetSize(), dataBase->GetStorageSize());
-            DiscardTask();
-            return;
-        }
-
-        dataBase->Insert(key, value);
-        dataAddTasks.erase(it);
-        dataRemoteAddTasks.emplace(key, DataRemoteAddTask());
-        DAVA::Logger::Debug("Adding remote add task. Tasks now: %u", dataRemoteAddTasks.size());
+        // response is sent when data is written
+        WriteReceivedData(it);
+        return;
     }
 
     DAVA::Logger::Debug("Sending 'chunk successfully added' response");
@@ -141,6 +149,81 @@ DAVA::List<ServerLogics::DataAddTask>::iterator ServerLogics::GetOrCreateAddTask
     return it;
 }
 
+void ServerLogics::WriteReceivedData(DAVA::List<DataAddTask>::iterator taskIt)
+{
+    using namespace DAVA;
+
+    DataAddTask& task = *taskIt;
+    task.isWriting = true;
+
+    ScopedPtr<DynamicMemoryFile> receivedData(task.receivedData);
+    std::shared_ptr<Net::IChannel> channel = task.channel;
+    AssetCache::CacheItemKey key = task.key;
+    FilePath folder = dataBase->CreateIncomingFolderPath(key);
+    String addingChain = "/" + serverName;
+
+    RunIOJob([this, receivedData, channel, key, folder, addingChain]() {
+        std::shared_ptr<AssetCache::CachedItemValue> value = std::make_shared<AssetCache::CachedItemValue>();
+        receivedData->Seek(0, File::SEEK_FROM_START);
+        value->Deserialize(receivedData);
+        if (value->IsEmpty() || !value->IsValid())
+        {
+            Logger::Error("Wrong request: Received data is empty or invalid. Client %p, key %s", channel.get(), Brief(key).c_str());
+            value.reset();
+        }
+        else
+        {
+            AssetCache::CachedItemValue::Description description = value->GetDescription();
+            description.addingChain += addingChain;
+            value->SetDescription(description);
+
+            if (!value->ExportToFolder(folder))
+            {
+                Logger::Error("Cannot write received data. Client %p, key %s", channel.get(), Brief(key).c_str());
+                FileSystem::Instance()->DeleteDirectory(folder);
+                value.reset();
+            }
+        }
+
+        return Function<void()>([this, channel, key, value, folder]() {
+            OnReceivedDataWritten(channel, key, value, folder);
+        });
+    });
+}
+
+void ServerLogics::OnReceivedDataWritten(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::AssetCache::CacheItemKey& key, const std::shared_ptr<DAVA::AssetCache::CachedItemValue>& value, const DAVA::FilePath& folder)
+{
+    using namespace DAVA;
+
+    bool added = false;
+    if (value)
+    {
+        if (value->GetSize() > dataBase->GetStorageSize())
+        {
+            Logger::Warning("Inserted data size %u is bigger than max storage size %u", value->GetSize(), dataBase->GetStorageSize());
+            FileSystem::Instance()->DeleteDirectory(folder);
+        }
+        else
+        {
+            dataBase->Insert(key, *value, folder);
+            dataRemoteAddTasks.emplace(key, DataRemoteAddTask());
+            Logger::Debug("Adding remote add task. Tasks now: %u", dataRemoteAddTasks.size());
+            added = true;
+        }
+    }
+
+    auto taskIt = std::find_if(dataAddTasks.begin(), dataAddTasks.end(), [&](const DataAddTask& task) {
+        return (task.channel == channel && task.key == key && task.isWriting);
+    });
+
+    if (taskIt != dataAddTasks.end()) // otherwise client is already disconnected
+    {
+        dataAddTasks.erase(taskIt);
+        Logger::Debug(added ? "Sending 'chunk successfully added' response" : "Sending 'add data chunk failed' response");
+        serverProxy->SendAddedToCache(channel, key, added);
+    }
+}
+
 ServerLogics::DataGetMap::iterator ServerLogics::GetOrCreateGetTask(const DAVA::AssetCache::CacheItemKey& key)
 {
     using namespace DAVA;
@@ -148,21 +231,34 @@ ServerLogics::DataGetMap::iterator ServerLogics::GetOrCreateGetTask(const DAVA::
     DataGetMap::iterator taskIter = dataGetTasks.find(key);
     if (taskIter == dataGetTasks.end())
     {
-        ServerCacheEntry* entry = dataBase->Get(key);
-        if (nullptr != entry)
-        { // Found in db.
-            Logger::Debug("Creating get task using local data");
-            taskIter = dataGetTasks.emplace(key, DataGetTask()).first;
-            DataGetTask& task = taskIter->second;
-            task.serializedData = DynamicMemoryFile::Create(File::CREATE | File::READ | File::WRITE);
+        std::shared_ptr<AssetCache::CachedItemValueStream> localData;
 
+        ServerCacheEntry* entry = dataBase->Find(key);
+        if (nullptr != entry)
+        {
             AssetCache::CachedItemValue& value = entry->GetValue();
             AssetCache::CachedItemValue::Description description = value.GetDescription();
             description.receivingChain += "/" + serverName;
             value.SetDescription(description);
-            value.Serialize(task.serializedData);
+
+            localData = std::make_shared<AssetCache::CachedItemValueStream>();
+            if (!localData->Open(value, dataBase->CreateFolderPath(key)))
+            {
+                Logger::Error("[ServerLogics::%s] Data of entry '%s' can't be read. Entry will be removed from cache", __FUNCTION__, Brief(key).c_str());
+                dataBase->Remove(key);
+                localData.reset();
+            }
+        }
+
+        if (localData)
+        { // Found in db.
+            Logger::Debug("Creating get task using local data");
+            taskIter = dataGetTasks.emplace(key, DataGetTask()).first;
+            DataGetTask& task = taskIter->second;
+            task.id = nextGetTaskID++;
+            task.localData = localData;
             task.dataStatus = DataGetTask::READY;
-            task.bytesOverall = task.bytesReady = task.serializedData->GetSize();
+            task.bytesOverall = task.bytesReady = localData->GetSize();
             task.chunksOverall = task.chunksReady = AssetCache::ChunkSplitter::GetNumberOfChunks(task.bytesOverall);
         }
         else if (IsRemoteServerConnected() && clientProxy->RequestGetNextChunk(key, 0))
@@ -170,6 +266,7 @@ ServerLogics::DataGetMap::iterator ServerLogics::GetOrCreateGetTask(const DAVA::
             Logger::Debug("Creating get task. Requesting data from remote");
             taskIter = dataGetTasks.emplace(key, DataGetTask()).first;
             DataGetTask& task = taskIter->second;
+            task.id = nextGetTaskID++;
             task.serializedData = DynamicMemoryFile::Create(File::CREATE | File::READ | File::WRITE);
             task.dataStatus = DataGetTask::WAITING_NEXT_CHUNK;
         }
@@ -192,13 +289,34 @@ void ServerLogics::OnChunkRequestedFromCache(const std::shared_ptr<DAVA::Net::IC
         serverProxy->SendChunk(clientChannel, key, 0, 0, 0, empty);
     };
 
+    if (chunkNumber != 0)
+    {
+        // task was canceled or entry was replaced after previous chunks were sent,
+        // so rest of data can't be taken from new task
+        DataGetMap::iterator taskIter = dataGetTasks.find(key);
+        if (taskIter == dataGetTasks.end() || taskIter->second.clients.count(clientChannel) == 0)
+        {
+            Error("download was interrupted");
+            return;
+        }
+    }
+
     DataGetMap::iterator taskIter = GetOrCreateGetTask(key);
     if (taskIter != dataGetTasks.end())
     {
         DataGetTask& task = taskIter->second;
         DataGetTask::ClientStatus& client = task.clients[clientChannel];
 
-        if (task.chunksReady > chunkNumber) // task has such chunk
+        if (task.chunksReady > chunkNumber && task.localData) // chunk will be read from disk
+        {
+            if (chunkNumber == 0)
+            {
+                DAVA::Logger::Debug("Requested data will be sent: %u chunks, %u bytes", task.chunksOverall, task.bytesOverall);
+            }
+
+            ReadLocalChunk(taskIter, clientChannel, chunkNumber);
+        }
+        else if (task.chunksReady > chunkNumber) // task has such chunk
         {
             Vector<uint8> chunk = AssetCache::ChunkSplitter::GetChunk(task.serializedData->GetDataVector(), chunkNumber);
             if (chunk.empty())
@@ -289,6 +407,25 @@ void ServerLogics::OnRemoteDisconnecting()
     CancelRemoteTasks();
 }
 
+void ServerLogics::OnEntryRemoved(const DAVA::AssetCache::CacheItemKey& key)
+{
+    // files are deleted or replaced right after this call, so chunks which are not read yet
+    // would mix bytes of different values. Clients which are receiving data get empty chunk
+    DataGetMap::iterator getTaskIter = dataGetTasks.find(key);
+    if (getTaskIter != dataGetTasks.end() && getTaskIter->second.localData)
+    {
+        DAVA::Logger::Debug("Entry %s is removed while it is being sent to clients", Brief(key).c_str());
+        CancelGetTask(getTaskIter);
+    }
+
+    DataRemoteAddMap::iterator addTaskIter = dataRemoteAddTasks.find(key);
+    if (addTaskIter != dataRemoteAddTasks.end())
+    {
+        // next SendChunkToRemote fails and task is removed
+        addTaskIter->second.localData.reset();
+    }
+}
+
 void ServerLogics::OnClientProxyStateChanged()
 {
     DVASSERT(clientProxy);
@@ -465,13 +602,85 @@ void ServerLogics::RequestNextChunk(ServerLogics::DataGetMap::iterator it)
     task.dataStatus = DataGetTask::WAITING_NEXT_CHUNK;
 }
 
-void ServerLogics::SendChunkToClient(DataGetMap::iterator taskIt, const std::shared_ptr<DAVA::Net::IChannel>& clientChannel, DAVA::uint32 chunkNumber, const DAVA::Vector<DAVA::uint8>& chunk)
+void ServerLogics::ReadLocalChunk(DataGetMap::iterator taskIt, const std::shared_ptr<DAVA::Net::IChannel>& clientChannel, DAVA::uint32 chunkNumber)
 {
+    using namespace DAVA;
+
     DataGetTask& task = taskIt->second;
     DataGetTask::ClientStatus& client = task.clients[clientChannel];
+    client.status = DataGetTask::WAITING_NEXT_CHUNK;
+    client.waitingChunk = chunkNumber;
+
+    std::shared_ptr<const AssetCache::CachedItemValueStream> localData = task.localData;
+    AssetCache::CacheItemKey key = taskIt->first;
+    uint64 taskID = task.id;
+    uint64 dataSize = task.bytesOverall;
+    uint32 numOfChunks = task.chunksOverall;
+
+    RunIOJob([this, localData, key, taskID, clientChannel, dataSize, numOfChunks, chunkNumber]() {
+        uint64 offset = AssetCache::ChunkSplitter::GetChunkOffset(chunkNumber);
+        uint32 chunkSize = AssetCache::ChunkSplitter::GetChunkSize(dataSize, chunkNumber);
+
+        // chunk is read from files straight into buffer of network packet
+        std::shared_ptr<AssetCache::GetChunkResponsePacket> packet = AssetCache::GetChunkResponsePacket::Create(key, dataSize, numOfChunks, chunkNumber, chunkSize, [&](uint8* chunkData) {
+            return localData->Read(offset, chunkData, chunkSize);
+        });
+
+        return Function<void()>([this, key, taskID, clientChannel, chunkNumber, packet]() {
+            OnLocalChunkRead(key, taskID, clientChannel, chunkNumber, packet);
+        });
+    });
+}
+
+void ServerLogics::OnLocalChunkRead(const DAVA::AssetCache::CacheItemKey& key, DAVA::uint64 taskID, const std::shared_ptr<DAVA::Net::IChannel>& clientChannel, DAVA::uint32 chunkNumber, const std::shared_ptr<DAVA::AssetCache::GetChunkResponsePacket>& packet)
+{
+    DataGetMap::iterator taskIter = dataGetTasks.find(key);
+    if (taskIter == dataGetTasks.end() || taskIter->second.id != taskID)
+    {
+        return; // task is canceled, files could be changed while chunk was read
+    }
+
+    DataGetTask& task = taskIter->second;
+    auto clientIter = task.clients.find(clientChannel);
+    if (clientIter == task.clients.end() || clientIter->second.status != DataGetTask::WAITING_NEXT_CHUNK || clientIter->second.waitingChunk != chunkNumber)
+    {
+        return; // client is disconnected
+    }
+
+    if (packet)
+    {
+        SendChunkToClient(taskIter, clientChannel, chunkNumber, *packet);
+        RemoveTaskIfChunksAreSent(taskIter);
+    }
+    else
+    {
+        // task is canceled whenever entry is removed or replaced, so entry in db is the one stream was opened on
+        DAVA::Logger::Error("[ServerLogics::%s] Chunk #%u of entry '%s' can't be read. Entry will be removed from cache", __FUNCTION__, chunkNumber, Brief(key).c_str());
+        CancelGetTask(taskIter);
+        dataBase->Remove(key);
+    }
+}
+
+void ServerLogics::SendChunkToClient(DataGetMap::iterator taskIt, const std::shared_ptr<DAVA::Net::IChannel>& clientChannel, DAVA::uint32 chunkNumber, const DAVA::Vector<DAVA::uint8>& chunk)
+{
+    DataGetTask& task = taskIt->second;
 
     DAVA::Logger::Debug("Sending chunk #%u: %u bytes", chunkNumber, chunk.size());
     serverProxy->SendChunk(clientChannel, taskIt->first, task.bytesOverall, task.chunksOverall, chunkNumber, chunk);
+    OnClientChunkSent(taskIt, clientChannel, chunkNumber);
+}
+
+void ServerLogics::SendChunkToClient(DataGetMap::iterator taskIt, const std::shared_ptr<DAVA::Net::IChannel>& clientChannel, DAVA::uint32 chunkNumber, DAVA::AssetCache::GetChunkResponsePacket& packet)
+{
+    DAVA::Logger::Debug("Sending chunk #%u", chunkNumber);
+    serverProxy->SendChunk(clientChannel, packet);
+    OnClientChunkSent(taskIt, clientChannel, chunkNumber);
+}
+
+void ServerLogics::OnClientChunkSent(DataGetMap::iterator taskIt, const std::shared_ptr<DAVA::Net::IChannel>& clientChannel, DAVA::uint32 chunkNumber)
+{
+    DataGetTask& task = taskIt->second;
+    DataGetTask::ClientStatus& client = task.clients[clientChannel];
     client.status = DataGetTask::READY;
 
     if (chunkNumber + 1 == task.chunksOverall)
@@ -522,13 +731,18 @@ bool ServerLogics::SendFirstChunkToRemote(DataRemoteAddMap::iterator taskIt)
     const AssetCache::CacheItemKey& key = taskIt->first;
     DataRemoteAddTask& task = taskIt->second;
 
-    ServerCacheEntry* entry = dataBase->Get(key);
+    ServerCacheEntry* entry = dataBase->Find(key);
     if (entry)
     {
-        task.serializedData = DynamicMemoryFile::Create(File::CREATE | File::READ | File::WRITE);
-        AssetCache::CachedItemValue& value = entry->GetValue();
-        value.Serialize(task.serializedData);
-        task.bytesOverall = task.serializedData->GetSize();
+        std::shared_ptr<AssetCache::CachedItemValueStream> localData = std::make_shared<AssetCache::CachedItemValueStream>();
+        if (!localData->Open(entry->GetValue(), dataBase->CreateFolderPath(key)))
+        {
+            Logger::Warning("Data with key %s can't be read", Brief(key).c_str());
+            return false;
+        }
+
+        task.localData = localData;
+        task.bytesOverall = localData->GetSize();
         task.chunksOverall = AssetCache::ChunkSplitter::GetNumberOfChunks(task.bytesOverall);
         task.chunksSent = 0;
         return SendChunkToRemote(taskIt);
@@ -548,8 +762,19 @@ bool ServerLogics::SendChunkToRemote(DataRemoteAddMap::iterator taskIt)
 
     const AssetCache::CacheItemKey& key = taskIt->first;
     DataRemoteAddTask& task = taskIt->second;
+    if (!task.localData)
+    {
+        Logger::Warning("Data with key %s was removed while it was sent", Brief(key).c_str());
+        return false;
+    }
+
+    Vector<uint8> chunk(AssetCache::ChunkSplitter::GetChunkSize(task.bytesOverall, task.chunksSent));
+    if (!task.localData->Read(AssetCache::ChunkSplitter::GetChunkOffset(task.chunksSent), chunk.data(), static_cast<uint32>(chunk.size())))
+    {
+        Logger::Warning("Data with key %s can't be read", Brief(key).c_str());
+        return false;
+    }
 
-    Vector<uint8> chunk = AssetCache::ChunkSplitter::GetChunk(task.serializedData->GetDataVector(), task.chunksSent);
     DAVA::Logger::Debug("Sending add chunk %u/%u to remote, key %s", task.chunksSent, task.chunksOverall, Brief(key).c_str());
     return clientProxy->RequestAddNextChunk(key, task.bytesOverall, task.chunksOverall, task.chunksSent++, chunk);
 }
@@ -675,8 +900,55 @@ void ServerLogics::ProcessFirstRemoteAddDataTask()
     }
 }
 
+void ServerLogics::RunIOJob(const IOJob& job)
+{
+    if (ioJobsInFlight < ServerLogicsDetails::MAX_IO_JOBS_IN_FLIGHT)
+    {
+        StartIOJob(job);
+    }
+    else
+    {
+        queuedIOJobs.push_back(job);
+    }
+}
+
+void ServerLogics::StartIOJob(const IOJob& job)
+{
+    ++ioJobsInFlight;
+    ioJobs = DAVA::GetEngineContext()->jobManager->CreateWorkerJob([this, job]() {
+        DAVA::Function<void()> completion = job();
+
+        DAVA::LockGuard<DAVA::Mutex> lock(completedIOJobsMutex);
+        completedIOJobs.push_back(completion);
+    }, ioJobs);
+}
+
+void ServerLogics::ProcessCompletedIOJobs()
+{
+    DAVA::Vector<DAVA::Function<void()>> completed;
+    {
+        DAVA::LockGuard<DAVA::Mutex> lock(completedIOJobsMutex);
+        completed.swap(completedIOJobs);
+    }
+
+    for (const DAVA::Function<void()>& completion : completed)
+    {
+        DVASSERT(ioJobsInFlight > 0);
+        --ioJobsInFlight;
+        completion();
+    }
+
+    while (ioJobsInFlight < ServerLogicsDetails::MAX_IO_JOBS_IN_FLIGHT && !queuedIOJobs.empty())
+    {
+        StartIOJob(queuedIOJobs.front());
+        queuedIOJobs.pop_front();
+    }
+}
+
 void ServerLogics::Update()
 {
+    ProcessCompletedIOJobs();
+
     if (dataBase)
     {
         dataBase->Update();
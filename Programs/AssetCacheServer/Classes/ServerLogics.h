@@ -4,17 +4,33 @@
 
 #include <AssetCache/AssetCache.h>
 
+#include <Concurrency/Mutex.h>
 #include <FileSystem/DynamicMemoryFile.h>
+#include <Functional/Function.h>
+#include <Job/JobHandle.h>
+
+namespace DAVA
+{
+namespace AssetCache
+{
+class CachedItemValueStream;
+class GetChunkResponsePacket;
+}
+}
 
 class ServerLogics : public DAVA::AssetCache::ServerNetProxyListener,
                      public DAVA::AssetCache::ClientNetProxyListener
 {
 public:
+    ~ServerLogics();
+
     void Init(DAVA::AssetCache::ServerNetProxy* server, const DAVA::String& serverName, DAVA::AssetCache::ClientNetProxy* client, CacheDB* dataBase);
     void Update();
     void LazyUpdate();
 
     void OnRemoteDisconnecting();
+    /** Stops reading files of entry, which are going to be deleted or replaced. */
+    void OnEntryRemoved(const DAVA::AssetCache::CacheItemKey& key);
 
     //ServerNetProxyListener
     void OnAddChunkToCache(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::AssetCache::CacheItemKey& key, DAVA::uint64 dataSize, DAVA::uint32 numOfChunks, DAVA::uint32 chunkNumber, const DAVA::Vector<DAVA::uint8>& chunkData) override;
@@ -51,8 +67,10 @@ private:
         };
 
         DAVA::UnorderedMap<std::shared_ptr<DAVA::Net::IChannel>, ClientStatus> clients;
-        DAVA::ScopedPtr<DAVA::DynamicMemoryFile> serializedData;
+        DAVA::ScopedPtr<DAVA::DynamicMemoryFile> serializedData; // data received from remote cache
+        std::shared_ptr<const DAVA::AssetCache::CachedItemValueStream> localData; // or data stored in db, read from disk by chunks
         DataRequestStatus dataStatus = READY;
+        DAVA::uint64 id = 0; // unique, to drop completions of I/O jobs started by canceled task
 
         DAVA::uint64 bytesReady = 0;
         DAVA::uint64 bytesOverall = 0;
@@ -71,11 +89,12 @@ private:
         size_t bytesOverall = 0;
         DAVA::uint32 chunksReceived = 0;
         DAVA::uint32 chunksOverall = 0;
+        bool isWriting = false; // all chunks are received, value is being written to disk
     };
 
     struct DataRemoteAddTask
     {
-        DAVA::ScopedPtr<DAVA::DynamicMemoryFile> serializedData;
+        std::shared_ptr<const DAVA::AssetCache::CachedItemValueStream> localData;
         DAVA::uint32 chunksSent = 0;
         DAVA::uint32 chunksOverall = 0;
         DAVA::uint64 bytesOverall = 0;
@@ -98,6 +117,12 @@ private:
     DataGetMap::iterator GetOrCreateGetTask(const DAVA::AssetCache::CacheItemKey& key);
     void RequestNextChunk(DataGetMap::iterator it);
     void SendChunkToClient(DataGetMap::iterator taskIt, const std::shared_ptr<DAVA::Net::IChannel>& clientChannel, DAVA::uint32 chunkNumber, const DAVA::Vector<DAVA::uint8>& chunk);
+    void SendChunkToClient(DataGetMap::iterator taskIt, const std::shared_ptr<DAVA::Net::IChannel>& clientChannel, DAVA::uint32 chunkNumber, DAVA::AssetCache::GetChunkResponsePacket& packet);
+    void OnClientChunkSent(DataGetMap::iterator taskIt, const std::shared_ptr<DAVA::Net::IChannel>& clientChannel, DAVA::uint32 chunkNumber);
+    void ReadLocalChunk(DataGetMap::iterator taskIt, const std::shared_ptr<DAVA::Net::IChannel>& clientChannel, DAVA::uint32 chunkNumber);
+    void OnLocalChunkRead(const DAVA::AssetCache::CacheItemKey& key, DAVA::uint64 taskID, const std::shared_ptr<DAVA::Net::IChannel>& clientChannel, DAVA::uint32 chunkNumber, const std::shared_ptr<DAVA::AssetCache::GetChunkResponsePacket>& packet);
+    void WriteReceivedData(DAVA::List<DataAddTask>::iterator taskIt);
+    void OnReceivedDataWritten(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::AssetCache::CacheItemKey& key, const std::shared_ptr<DAVA::AssetCache::CachedItemValue>& value, const DAVA::FilePath& folder);
     void SendChunkToClients(DataGetMap::iterator taskIt, DAVA::uint32 chunkNumber, const DAVA::Vector<DAVA::uint8>& chunk);
     bool SendFirstChunkToRemote(DataRemoteAddMap::iterator taskIt);
     bool SendChunkToRemote(DataRemoteAddMap::iterator taskIt);
@@ -110,15 +135,28 @@ private:
 
     void ProcessFirstRemoteAddDataTask();
 
+    // I/O job is run on worker thread and returns completion, which is run on main thread in Update
+    using IOJob = DAVA::Function<DAVA::Function<void()>()>;
+    void RunIOJob(const IOJob& job);
+    void StartIOJob(const IOJob& job);
+    void ProcessCompletedIOJobs();
+
 private:
     DAVA::AssetCache::ServerNetProxy* serverProxy = nullptr;
     DAVA::AssetCache::ClientNetProxy* clientProxy = nullptr;
     CacheDB* dataBase = nullptr;
 
     DataGetMap dataGetTasks;
+    DAVA::uint64 nextGetTaskID = 1;
     DAVA::List<DataAddTask> dataAddTasks;
     DAVA::List<DataWarmupTask> dataWarmupTasks;
     DataRemoteAddMap dataRemoteAddTasks;
     DAVA::String serverName;
     bool hasIncomingRequestsRecently = false; // any incoming request has been received after last lazy update
+
+    DAVA::JobHandle ioJobs;
+    DAVA::Deque<IOJob> queuedIOJobs; // waiting while too many jobs are in flight
+    DAVA::uint32 ioJobsInFlight = 0;
+    DAVA::Mutex completedIOJobsMutex;
+    DAVA::Vector<DAVA::Function<void()>> completedIOJobs;
 };
@@ -0,0 +1,423 @@
+#include <Base/ScopedPtr.h>
+#include <CommandLine/ProgramOptions.h>
+#include <Debug/DVAssertDefaultHandlers.h>
+#include <Engine/Engine.h>
+#include <FileSystem/FilePath.h>
+#include <FileSystem/KeyedArchive.h>
+#include <FileSystem/VariantType.h>
+#include <Logger/Logger.h>
+#include <Particles/ParticleEmitter.h>
+#include <Particles/ParticleGroup.h>
+#include <Particles/ParticleRenderObject.h>
+#include <Particles/ParticlesRandom.h>
+#include <Render/Highlevel/Camera.h>
+#include <Render/RHI/rhi_Type.h>
+#include <Render/Renderer.h>
+#include <Scene3D/Components/ParticleEffectComponent.h>
+#include <Scene3D/Entity.h>
+#include <Scene3D/Scene.h>
+#include <Scene3D/Systems/ParticleEffectSystem.h>
+#include <Scene3D/Systems/QualitySettingsSystem.h>
+#include <Time/SystemTimer.h>
+#include <Utils/StringFormat.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+/*
+    Headless particles benchmark.
+
+    Loads effects (*.yaml) and scenes (*.sc2), steps them with fixed time step and fixed ParticlesRandom seed
+    against the null renderer, and prints per-phase timings, allocations and checksum of simulation result.
+    Simulation is deterministic, so equal checksums of several runs (see `--runs`) are checked as well.
+
+    Usage:
+        ParticleBenchmark --file fire.yaml --file smoke.yaml --instances 50 --frames 600 --seed 1
+*/
+
+#if !defined(DAVA_MEMORY_PROFILING_ENABLE)
+namespace ParticleBenchmarkDetails
+{
+std::atomic<DAVA::uint64> allocationsCount(0);
+std::atomic<DAVA::uint64> allocatedBytes(0);
+}
+
+void* operator new(size_t size)
+{
+    ParticleBenchmarkDetails::allocationsCount.fetch_add(1, std::memory_order_relaxed);
+    ParticleBenchmarkDetails::allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+    void* ptr = std::malloc(size > 0 ? size : 1);
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void* ptr) DAVA_NOEXCEPT
+{
+    std::free(ptr);
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete[](void* ptr) DAVA_NOEXCEPT
+{
+    std::free(ptr);
+}
+#endif
+
+namespace ParticleBenchmarkDetails
+{
+enum eReturnCode : DAVA::int32
+{
+    SUCCESS = 0,
+    ERROR = 1,
+};
+
+struct BenchmarkParams
+{
+    DAVA::Vector<DAVA::FilePath> files;
+    DAVA::uint32 instances = 1;
+    DAVA::uint32 warmupFrames = 0;
+    DAVA::uint32 frames = 0;
+    DAVA::float32 timeStep = 0.0f;
+    DAVA::uint64 seed = 0;
+};
+
+struct BenchmarkResult
+{
+    DAVA::uint32 effectsCount = 0;
+    DAVA::uint64 updateNs = 0;
+    DAVA::uint64 renderDataNs = 0;
+    DAVA::uint64 allocationsCount = 0;
+    DAVA::uint64 allocatedBytes = 0;
+    DAVA::uint64 checksum = 0;
+    DAVA::ParticleEffectSystem::Statistics statistics;
+};
+
+DAVA::uint64 GetAllocationsCount()
+{
+#if !defined(DAVA_MEMORY_PROFILING_ENABLE)
+    return allocationsCount.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+DAVA::uint64 GetAllocatedBytes()
+{
+#if !defined(DAVA_MEMORY_PROFILING_ENABLE)
+    return allocatedBytes.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+void HashValue(DAVA::uint64& hash, const void* data, DAVA::uint32 size)
+{
+    // FNV-1a
+    const DAVA::uint8* bytes = static_cast<const DAVA::uint8*>(data);
+    for (DAVA::uint32 i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+}
+
+bool AddEffects(DAVA::Scene* scene, const BenchmarkParams& params)
+{
+    using namespace DAVA;
+
+    // effects are placed on a grid, so every instance has its own world position
+    const float32 gridStep = 10.0f;
+    uint32 placedCount = 0;
+    for (const FilePath& path : params.files)
+    {
+        if (path.IsEqualToExtension(".sc2"))
+        {
+            if (scene->LoadScene(path) != SceneFileV2::ERROR_NO_ERROR)
+            {
+                Logger::Error("Can't load scene %s", path.GetStringValue().c_str());
+                return false;
+            }
+            continue;
+        }
+
+        ScopedPtr<ParticleEmitter> emitter(ParticleEmitter::LoadEmitter(path));
+        if (emitter->layers.empty())
+        {
+            Logger::Error("Can't load effect %s", path.GetStringValue().c_str());
+            return false;
+        }
+
+        for (uint32 i = 0; i < params.instances; ++i, ++placedCount)
+        {
+            ScopedPtr<Entity> entity(new Entity());
+            ParticleEffectComponent* effect = new ParticleEffectComponent();
+            effect->AddEmitterInstance(emitter);
+            entity->AddComponent(effect);
+
+            Matrix4 transform;
+            transform.BuildTranslation(Vector3(gridStep * (placedCount % 16), gridStep * (placedCount / 16), 0.0f));
+            entity->SetLocalTransform(transform);
+            scene->AddNode(entity);
+        }
+    }
+    return true;
+}
+
+bool RunBenchmark(const BenchmarkParams& params, BenchmarkResult& result)
+{
+    using namespace DAVA;
+
+    ParticlesRandom::SetSeed(params.seed);
+
+    ScopedPtr<Scene> scene(new Scene());
+    if (!AddEffects(scene, params))
+        return false;
+
+    Vector<Entity*> entities;
+    scene->GetChildEntitiesWithComponent(entities, Type::Instance<ParticleEffectComponent>());
+    Vector<ParticleEffectComponent*> effects;
+    for (Entity* entity : entities)
+    {
+        for (uint32 i = 0, count = entity->GetComponentCount<ParticleEffectComponent>(); i < count; ++i)
+        {
+            ParticleEffectComponent* effect = entity->GetComponent<ParticleEffectComponent>(i);
+            effect->Start();
+            effects.push_back(effect);
+        }
+    }
+
+    ScopedPtr<Camera> camera(new Camera());
+    camera->SetupPerspective(70.0f, 1.0f, 1.0f, 5000.0f);
+    camera->SetUp(Vector3(0.0f, 0.0f, 1.0f));
+    camera->SetPosition(Vector3(80.0f, -100.0f, 60.0f));
+    camera->SetTarget(Vector3(80.0f, 40.0f, 0.0f));
+
+    ParticleEffectSystem* particleSystem = scene->particleEffectSystem;
+    particleSystem->ResetStatistics();
+    particleSystem->SetStatisticsEnabled(false);
+
+    uint64 allocationsCountStart = 0;
+    uint64 allocatedBytesStart = 0;
+    for (uint32 frame = 0, framesCount = params.warmupFrames + params.frames; frame < framesCount; ++frame)
+    {
+        if (frame == params.warmupFrames)
+        {
+            particleSystem->SetStatisticsEnabled(true);
+            allocationsCountStart = GetAllocationsCount();
+            allocatedBytesStart = GetAllocatedBytes();
+        }
+        bool isMeasured = (frame >= params.warmupFrames);
+
+        Renderer::BeginFrame();
+
+        int64 updateStart = SystemTimer::GetNs();
+        scene->Update(params.timeStep);
+        int64 updateEnd = SystemTimer::GetNs();
+
+        for (ParticleEffectComponent* effect : effects)
+        {
+            effect->GetRenderObject()->PrepareToRender(camera);
+        }
+        int64 renderDataEnd = SystemTimer::GetNs();
+
+        Renderer::EndFrame();
+
+        if (isMeasured)
+        {
+            result.updateNs += updateEnd - updateStart;
+            result.renderDataNs += renderDataEnd - updateEnd;
+        }
+    }
+
+    result.effectsCount = static_cast<uint32>(effects.size());
+    result.allocationsCount = GetAllocationsCount() - allocationsCountStart;
+    result.allocatedBytes = GetAllocatedBytes() - allocatedBytesStart;
+    result.statistics = particleSystem->GetStatistics();
+
+    // checksum covers particles amount, bounds of every effect and position, size and color of every alive particle
+    result.checksum = 14695981039346656037ull;
+    HashValue(result.checksum, &result.statistics.particlesEmitted, sizeof(result.statistics.particlesEmitted));
+    HashValue(result.checksum, &result.statistics.particlesSimulated, sizeof(result.statistics.particlesSimulated));
+    for (ParticleEffectComponent* effect : effects)
+    {
+        const AABBox3& bbox = effect->GetRenderObject()->GetBoundingBox();
+        HashValue(result.checksum, bbox.min.data, sizeof(bbox.min.data));
+        HashValue(result.checksum, bbox.max.data, sizeof(bbox.max.data));
+
+        for (const ParticleGroup& group : effect->GetEffectData().groups)
+        {
+            const ParticleStorage& particles = group.particles;
+            for (uint32 i = 0, count = particles.GetCount(); i < count; ++i)
+            {
+                Vector3 position = particles.GetPosition(i);
+                HashValue(result.checksum, position.data, sizeof(position.data));
+                HashValue(result.checksum, particles.currSize[i].data, sizeof(particles.currSize[i].data));
+                HashValue(result.checksum, particles.color[i].color, sizeof(particles.color[i].color));
+            }
+        }
+    }
+
+    particleSystem->SetStatisticsEnabled(false);
+    return true;
+}
+
+DAVA::float64 PerItem(DAVA::uint64 ns, DAVA::uint64 count)
+{
+    return count > 0 ? static_cast<DAVA::float64>(ns) / static_cast<DAVA::float64>(count) : 0.0;
+}
+
+void PrintResult(const BenchmarkParams& params, const BenchmarkResult& result, bool teamcityOutput)
+{
+    using namespace DAVA;
+
+    const ParticleEffectSystem::Statistics& statistics = result.statistics;
+    float64 totalSeconds = static_cast<float64>(result.updateNs + result.renderDataNs) * 1e-9;
+    float64 particlesPerSecond = totalSeconds > 0.0 ? static_cast<float64>(statistics.particlesSimulated) / totalSeconds : 0.0;
+
+    std::cout << Format("effects: %u, frames: %u, time step: %.4f, seed: %llu", result.effectsCount, params.frames, params.timeStep, params.seed) << std::endl;
+    std::cout << Format("particles simulated: %llu, emitted: %llu", statistics.particlesSimulated, statistics.particlesEmitted) << std::endl;
+    std::cout << Format("particles/sec: %.0f", particlesPerSecond) << std::endl;
+    std::cout << Format("emit: %.2f ns/particle", PerItem(statistics.emitNs, statistics.particlesEmitted)) << std::endl;
+    std::cout << Format("simulation: %.2f ns/particle", PerItem(statistics.simulationNs, statistics.particlesSimulated)) << std::endl;
+    std::cout << Format("forces: %.2f ns/particle", PerItem(statistics.forcesNs, statistics.particlesSimulated)) << std::endl;
+    std::cout << Format("render data: %.2f ns/particle", PerItem(result.renderDataNs, statistics.particlesSimulated)) << std::endl;
+    std::cout << Format("scene update: %.3f ms/frame", PerItem(result.updateNs, params.frames) * 1e-6) << std::endl;
+    std::cout << Format("allocations: %.1f/frame, %.1f bytes/frame", PerItem(result.allocationsCount, params.frames), PerItem(result.allocatedBytes, params.frames)) << std::endl;
+    std::cout << Format("checksum: %016llx", result.checksum) << std::endl;
+
+    if (teamcityOutput)
+    {
+        auto printStatistic = [](const char* key, float64 value) {
+            std::cout << Format("##teamcity[buildStatisticValue key='ParticleBenchmark.%s' value='%.3f']", key, value) << std::endl;
+        };
+        printStatistic("ParticlesPerSecond", particlesPerSecond);
+        printStatistic("EmitNsPerParticle", PerItem(statistics.emitNs, statistics.particlesEmitted));
+        printStatistic("SimulationNsPerParticle", PerItem(statistics.simulationNs, statistics.particlesSimulated));
+        printStatistic("ForcesNsPerParticle", PerItem(statistics.forcesNs, statistics.particlesSimulated));
+        printStatistic("RenderDataNsPerParticle", PerItem(result.renderDataNs, statistics.particlesSimulated));
+        printStatistic("AllocationsPerFrame", PerItem(result.allocationsCount, params.frames));
+    }
+}
+
+DAVA::int32 ProcessBenchmark(DAVA::Engine& e)
+{
+    using namespace DAVA;
+
+    ProgramOptions helpOption("--help");
+    ProgramOptions benchmarkOption("", false);
+    benchmarkOption.AddOption("--file", VariantType(String()), "Path to effect (*.yaml) or scene (*.sc2), can be set several times", true);
+    benchmarkOption.AddOption("--instances", VariantType(int32(1)), "Number of instances of every effect (*.yaml)");
+    benchmarkOption.AddOption("--frames", VariantType(int32(600)), "Number of measured frames");
+    benchmarkOption.AddOption("--warmup", VariantType(int32(60)), "Number of frames simulated before measurement");
+    benchmarkOption.AddOption("--dt", VariantType(float32(1.0f / 60.0f)), "Fixed time step in seconds");
+    benchmarkOption.AddOption("--seed", VariantType(int32(0)), "Seed of particles random generators");
+    benchmarkOption.AddOption("--runs", VariantType(int32(1)), "Number of runs, results of all runs should have equal checksum");
+    benchmarkOption.AddOption("--quality", VariantType(String("accurate")), "Property lines quality: accurate or performance");
+    benchmarkOption.AddOption("--teamcity", VariantType(false), "Print results as Teamcity build statistics");
+
+    const Vector<String>& cmdLine = e.GetCommandLine();
+    if (helpOption.Parse(cmdLine) == true)
+    {
+        std::cout << benchmarkOption.GetUsageString() << std::endl;
+        return eReturnCode::SUCCESS;
+    }
+
+    if (benchmarkOption.Parse(cmdLine) == false)
+    {
+        std::cerr << "[error] Wrong command line, see ParticleBenchmark --help" << std::endl;
+        return eReturnCode::ERROR;
+    }
+
+    BenchmarkParams params;
+    for (uint32 i = 0, count = benchmarkOption.GetOptionValuesCount("--file"); i < count; ++i)
+    {
+        String path = benchmarkOption.GetOption("--file", i).AsString();
+        if (!path.empty())
+            params.files.emplace_back(path);
+    }
+    params.instances = static_cast<uint32>(Max(benchmarkOption.GetOption("--instances").AsInt32(), 1));
+    params.warmupFrames = static_cast<uint32>(Max(benchmarkOption.GetOption("--warmup").AsInt32(), 0));
+    params.frames = static_cast<uint32>(Max(benchmarkOption.GetOption("--frames").AsInt32(), 1));
+    params.timeStep = benchmarkOption.GetOption("--dt").AsFloat();
+    params.seed = static_cast<uint64>(benchmarkOption.GetOption("--seed").AsInt32());
+    uint32 runsCount = static_cast<uint32>(Max(benchmarkOption.GetOption("--runs").AsInt32(), 1));
+    bool teamcityOutput = benchmarkOption.GetOption("--teamcity").AsBool();
+
+    if (params.files.empty() || params.timeStep <= 0.0f)
+    {
+        std::cerr << "[error] Effect files and positive time step should be set" << std::endl;
+        return eReturnCode::ERROR;
+    }
+
+    String quality = benchmarkOption.GetOption("--quality").AsString();
+    ParticlesQualitySettings& qualitySettings = QualitySettingsSystem::Instance()->GetParticlesQualitySettings();
+    if (quality == "accurate")
+    {
+        qualitySettings.SetPropertyLinesQuality(ParticlesQualitySettings::PropertyLinesQuality::ACCURATE);
+    }
+    else if (quality == "performance")
+    {
+        qualitySettings.SetPropertyLinesQuality(ParticlesQualitySettings::PropertyLinesQuality::PERFORMANCE);
+    }
+    else
+    {
+        std::cerr << "[error] Unknown quality " << quality << std::endl;
+        return eReturnCode::ERROR;
+    }
+
+    int32 retCode = eReturnCode::SUCCESS;
+    uint64 firstChecksum = 0;
+    for (uint32 run = 0; run < runsCount; ++run)
+    {
+        BenchmarkResult result;
+        if (!RunBenchmark(params, result))
+            return eReturnCode::ERROR;
+
+        PrintResult(params, result, teamcityOutput);
+        if (run == 0)
+        {
+            firstChecksum = result.checksum;
+        }
+        else if (result.checksum != firstChecksum)
+        {
+            std::cerr << Format("[error] Run %u is not equal to the first one, simulation is not deterministic", run) << std::endl;
+            retCode = eReturnCode::ERROR;
+        }
+    }
+    return retCode;
+}
+}
+
+int DAVAMain(DAVA::Vector<DAVA::String> cmdLine)
+{
+    using namespace DAVA;
+
+    Assert::AddHandler(Assert::DefaultLoggerHandler);
+
+    KeyedArchive* appOptions = new KeyedArchive();
+    appOptions->SetInt32("renderer", rhi::RHI_NULL_RENDERER);
+
+    Engine e;
+    Vector<String> modules = { "JobManager" };
+    e.Init(eEngineRunMode::CONSOLE_MODE, modules, appOptions);
+
+    Logger* logger = e.GetContext()->logger;
+    logger->SetLogLevel(Logger::LEVEL_WARNING);
+    logger->EnableConsoleMode();
+
+    e.update.Connect([&e](float32)
+                     {
+                         DAVA::int32 retCode = ParticleBenchmarkDetails::ProcessBenchmark(e);
+                         e.QuitAsync(retCode);
+                     });
+
+    return e.Run();
+}
@@ -108,12 +108,6 @@ int ArchiveUnpackTool::ProcessInternal()
                                                 Logger::Error("failed extract file: %s, from archive: %s", fileInfo.relativeFilePath.c_str(), packFilename.GetAbsolutePathname().c_str());
                                             }
                                         });
-
-            if (i > 0 && i % 1000 == 0)
-            {
-                //HACK wait jobs executed (internaly 1024 max jobs)
-                jobManager->WaitWorkerJobs();
-            }
         }
 
         jobManager->WaitWorkerJobs();
@@ -5,6 +5,7 @@
 #include "Classes/Collada/ColladaToSc2Importer/ImportSettings.h"
 
 #include <Animation/AnimationChannel.h>
+#include <Animation/AnimationChannelWriter.h>
 #include <Animation/AnimationClip.h>
 #include <Animation/AnimationTrack.h>
 #include <FileSystem/DynamicMemoryFile.h>
@@ -428,19 +429,15 @@ void WriteToBuffer(Vector<uint8>& buffer, const String& string)
 eColladaErrorCodes ColladaImporter::SaveAnimations(ColladaScene* colladaScene, const FilePath& dir)
 {
     //binary file format described in 'AnimationBinaryFormat.md'
-    struct ChannelHeader
+    struct TrackChannelHeader
     {
-        //Track part
         uint8 target;
         uint8 pad0[3];
+    } trackChannelHeader;
 
-        //Channel part
-        uint32 signature = AnimationChannel::ANIMATION_CHANNEL_DATA_SIGNATURE;
-        uint8 dimension = 0;
-        uint8 interpolation = 0;
-        uint16 compression = 0;
-        uint32 keyCount = 0;
-    } channelHeader;
+    AnimationChannelWriter::Settings channelSettings;
+    Vector<float32> keyTimes;
+    Vector<float32> keyValues;
 
     for (auto canimation : colladaScene->colladaAnimations)
     {
@@ -481,49 +478,49 @@ eColladaErrorCodes ColladaImporter::SaveAnimations(ColladaScene* colladaScene, c
                 if (!animationData.translations.empty())
                 {
                     //Write position channel
-                    channelHeader.dimension = 3;
-                    channelHeader.interpolation = uint8(AnimationChannel::INTERPOLATION_LINEAR);
-                    channelHeader.target = AnimationTrack::CHANNEL_TARGET_POSITION;
-                    channelHeader.keyCount = uint32(animationData.translations.size());
-                    WriteToBuffer(animationClipData, &channelHeader);
-
+                    keyTimes.clear();
+                    keyValues.clear();
                     for (auto& t : animationData.translations)
                     {
-                        WriteToBuffer(animationClipData, &t.first); //time
-                        WriteToBuffer(animationClipData, &t.second); //position
+                        keyTimes.push_back(t.first);
+                        keyValues.insert(keyValues.end(), t.second.data, t.second.data + 3);
                     }
+
+                    trackChannelHeader.target = AnimationTrack::CHANNEL_TARGET_POSITION;
+                    WriteToBuffer(animationClipData, &trackChannelHeader);
+                    AnimationChannelWriter::Write(animationClipData, 3, AnimationChannel::INTERPOLATION_LINEAR, keyTimes, keyValues, channelSettings);
                 }
 
                 //Write orientation channel
                 if (!animationData.rotations.empty())
                 {
-                    channelHeader.dimension = 4;
-                    channelHeader.interpolation = uint8(AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR);
-                    channelHeader.target = AnimationTrack::CHANNEL_TARGET_ORIENTATION;
-                    channelHeader.keyCount = uint32(animationData.rotations.size());
-                    WriteToBuffer(animationClipData, &channelHeader);
-
+                    keyTimes.clear();
+                    keyValues.clear();
                     for (auto& r : animationData.rotations)
                     {
-                        WriteToBuffer(animationClipData, &r.first); //time
-                        WriteToBuffer(animationClipData, &r.second); //rotation
+                        keyTimes.push_back(r.first);
+                        keyValues.insert(keyValues.end(), r.second.data, r.second.data + 4);
                     }
+
+                    trackChannelHeader.target = AnimationTrack::CHANNEL_TARGET_ORIENTATION;
+                    WriteToBuffer(animationClipData, &trackChannelHeader);
+                    AnimationChannelWriter::Write(animationClipData, 4, AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR, keyTimes, keyValues, channelSettings);
                 }
 
                 //Write scale channel
                 if (!animationData.scales.empty())
                 {
-                    channelHeader.dimension = 1;
-                    channelHeader.interpolation = uint8(AnimationChannel::INTERPOLATION_LINEAR);
-                    channelHeader.target = AnimationTrack::CHANNEL_TARGET_SCALE;
-                    channelHeader.keyCount = uint32(animationData.scales.size());
-                    WriteToBuffer(animationClipData, &channelHeader);
-
+                    keyTimes.clear();
+                    keyValues.clear();
                     for (auto& s : animationData.scales)
                     {
-                        WriteToBuffer(animationClipData, &s.first); //time
-                        WriteToBuffer(animationClipData, &s.second.x); //scale
+                        keyTimes.push_back(s.first);
+                        keyValues.push_back(s.second.x);
                     }
+
+                    trackChannelHeader.target = AnimationTrack::CHANNEL_TARGET_SCALE;
+                    WriteToBuffer(animationClipData, &trackChannelHeader);
+                    AnimationChannelWriter::Write(animationClipData, 1, AnimationChannel::INTERPOLATION_LINEAR, keyTimes, keyValues, channelSettings);
                 }
             }
 
@@ -0,0 +1,334 @@
+#include "UnitTests/UnitTests.h"
+#include "Animation/AnimationChannel.h"
+#include "Animation/AnimationChannelWriter.h"
+#include "Base/BaseMath.h"
+#include "Job/ParallelFor.h"
+#include "Time/SystemTimer.h"
+#include "Logger/Logger.h"
+
+#include <random>
+
+using namespace DAVA;
+
+namespace AnimationChannelTestDetails
+{
+// Builds channel data with linear interpolation: signature, dimension, interpolation, compression, keys count, keys
+Vector<uint8> BuildLinearChannelData(const Vector<float32>& times, uint32 dimension)
+{
+    Vector<uint8> data;
+    auto append = [&data](const void* value, size_t size) {
+        const uint8* bytes = static_cast<const uint8*>(value);
+        data.insert(data.end(), bytes, bytes + size);
+    };
+
+    uint32 signature = AnimationChannel::ANIMATION_CHANNEL_DATA_SIGNATURE;
+    uint8 dim = static_cast<uint8>(dimension);
+    uint8 interpolation = AnimationChannel::INTERPOLATION_LINEAR;
+    uint16 compression = 0;
+    uint32 keysCount = static_cast<uint32>(times.size());
+    append(&signature, sizeof(signature));
+    append(&dim, sizeof(dim));
+    append(&interpolation, sizeof(interpolation));
+    append(&compression, sizeof(compression));
+    append(&keysCount, sizeof(keysCount));
+
+    for (uint32 k = 0; k < keysCount; ++k)
+    {
+        append(&times[k], sizeof(float32));
+        for (uint32 d = 0; d < dimension; ++d)
+        {
+            float32 value = static_cast<float32>(k * 10 + d);
+            append(&value, sizeof(float32));
+        }
+    }
+    return data;
+}
+
+// Value of channel built with `BuildLinearChannelData` for component `d`, evaluated with linear search
+float32 EvaluateReference(const Vector<float32>& times, uint32 d, float32 time)
+{
+    uint32 k = 0;
+    while (k < times.size() && times[k] <= time)
+        ++k;
+
+    if (k == 0)
+        return static_cast<float32>(d);
+    if (k == times.size())
+        return static_cast<float32>((k - 1) * 10 + d);
+
+    float32 t = (time - times[k - 1]) / (times[k] - times[k - 1]);
+    return Lerp(static_cast<float32>((k - 1) * 10 + d), static_cast<float32>(k * 10 + d), t);
+}
+
+// Sampled motion of a joint: smooth position curve and rotation around changing axis, sampled at 30 fps
+void BuildJointMotion(uint32 keysCount, Vector<float32>& times, Vector<float32>& positions, Vector<float32>& orientations)
+{
+    for (uint32 k = 0; k < keysCount; ++k)
+    {
+        float32 time = static_cast<float32>(k) / 30.0f;
+        times.push_back(time);
+
+        positions.push_back(std::sin(time * 2.0f) * 0.5f);
+        positions.push_back(1.0f + time * 0.1f);
+        positions.push_back((k < keysCount / 2) ? 0.0f : std::cos(time) * 0.2f);
+
+        Vector3 axis(std::sin(time * 0.7f), std::cos(time * 0.3f), 0.5f);
+        axis.Normalize();
+        Quaternion orientation;
+        orientation.Construct(axis, std::sin(time * 1.5f) * PI);
+        orientations.insert(orientations.end(), orientation.data, orientation.data + 4);
+    }
+}
+
+float32 GetAngleBetween(const float32* q0, const float32* q1)
+{
+    float32 cosHalfAngle = Min(std::abs(Quaternion(q0).DotProduct(Quaternion(q1))), 1.0f);
+    return 2.0f * std::acos(cosHalfAngle);
+}
+}
+
+DAVA_TESTCLASS (AnimationChannelTest)
+{
+    DAVA_TEST (EvaluateMatchesLinearSearch)
+    {
+        using namespace AnimationChannelTestDetails;
+
+        const uint32 dimension = 3;
+        Vector<float32> times;
+        for (uint32 k = 0; k < 50; ++k)
+        {
+            times.push_back(static_cast<float32>(k) * 0.1f);
+        }
+
+        Vector<uint8> data = BuildLinearChannelData(times, dimension);
+        AnimationChannel channel;
+        TEST_VERIFY(channel.Bind(data.data()) == static_cast<uint32>(data.size()));
+
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float32> randomTime(-1.0f, 6.0f);
+
+        // random times, forward playback with cursor, and backward jumps with cursor
+        Vector<float32> sampleTimes;
+        for (uint32 i = 0; i < 200; ++i)
+            sampleTimes.push_back(randomTime(rng));
+        for (uint32 i = 0; i < 200; ++i)
+            sampleTimes.push_back(static_cast<float32>(i) * 0.027f);
+        for (uint32 i = 0; i < 50; ++i)
+            sampleTimes.push_back(5.0f - static_cast<float32>(i) * 0.3f);
+
+        uint32 cursor = 0;
+        for (float32 time : sampleTimes)
+        {
+            float32 value[dimension];
+            float32 valueWithCursor[dimension];
+            channel.Evaluate(time, value, dimension);
+            channel.Evaluate(time, &cursor, valueWithCursor, dimension);
+
+            for (uint32 d = 0; d < dimension; ++d)
+            {
+                float32 expected = EvaluateReference(times, d, time);
+                TEST_VERIFY(FLOAT_EQUAL(value[d], expected));
+                TEST_VERIFY(value[d] == valueWithCursor[d]);
+            }
+        }
+    }
+
+    DAVA_TEST (ConcurrentEvaluation)
+    {
+        using namespace AnimationChannelTestDetails;
+
+        Vector<float32> times;
+        for (uint32 k = 0; k < 100; ++k)
+        {
+            times.push_back(static_cast<float32>(k) * 0.05f);
+        }
+
+        Vector<uint8> data = BuildLinearChannelData(times, 1);
+        AnimationChannel channel;
+        channel.Bind(data.data());
+
+        // every instance plays the same channel with own time offset and own cursor
+        const uint32 instancesCount = 256;
+        Vector<float32> results(instancesCount);
+        ParallelFor(0, instancesCount, 16, [&](uint32 begin, uint32 end) {
+            for (uint32 i = begin; i < end; ++i)
+            {
+                uint32 cursor = 0;
+                for (uint32 frame = 0; frame < 100; ++frame)
+                {
+                    float32 time = static_cast<float32>(i % 17) * 0.1f + static_cast<float32>(frame) * 0.01f;
+                    channel.Evaluate(time, &cursor, &results[i], 1);
+                }
+            }
+        });
+
+        bool allEqual = true;
+        for (uint32 i = 0; i < instancesCount; ++i)
+        {
+            float32 time = static_cast<float32>(i % 17) * 0.1f + 99.0f * 0.01f;
+            allEqual = allEqual && FLOAT_EQUAL(results[i], EvaluateReference(times, 0, time));
+        }
+        TEST_VERIFY(allEqual);
+    }
+
+    DAVA_TEST (CompressedChannelWithinTolerance)
+    {
+        using namespace AnimationChannelTestDetails;
+
+        Vector<float32> times, positions, orientations;
+        BuildJointMotion(300, times, positions, orientations);
+
+        AnimationChannelWriter::Settings settings;
+        Vector<uint8> data;
+        uint32 positionKeys = AnimationChannelWriter::Write(data, 3, AnimationChannel::INTERPOLATION_LINEAR, times, positions, settings);
+        uint32 orientationKeys = AnimationChannelWriter::Write(data, 4, AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR, times, orientations, settings);
+        TEST_VERIFY(positionKeys < 300);
+        TEST_VERIFY(orientationKeys <= 300);
+        TEST_VERIFY(data.size() % 4 == 0);
+
+        AnimationChannel positionChannel;
+        AnimationChannel orientationChannel;
+        uint32 positionSize = positionChannel.Bind(data.data());
+        uint32 orientationSize = orientationChannel.Bind(data.data() + positionSize);
+        TEST_VERIFY(positionSize + orientationSize == static_cast<uint32>(data.size()));
+
+        // tolerance of keys reduction plus quantization error
+        const float32 positionRange = 1.0f;
+        const float32 positionError = settings.valueTolerance + positionRange / 65535.0f;
+        const float32 angleError = settings.angleTolerance + 0.001f;
+
+        float32 maxPositionError = 0.0f;
+        float32 maxAngleError = 0.0f;
+        uint32 positionCursor = 0, orientationCursor = 0;
+        for (uint32 k = 0; k < static_cast<uint32>(times.size()); ++k)
+        {
+            float32 position[3];
+            float32 orientation[4];
+            positionChannel.Evaluate(times[k], &positionCursor, position, 3);
+            orientationChannel.Evaluate(times[k], &orientationCursor, orientation, 4);
+
+            for (uint32 d = 0; d < 3; ++d)
+            {
+                maxPositionError = Max(maxPositionError, std::abs(position[d] - positions[k * 3 + d]));
+            }
+            maxAngleError = Max(maxAngleError, GetAngleBetween(orientation, &orientations[k * 4]));
+        }
+        TEST_VERIFY(maxPositionError <= positionError);
+        TEST_VERIFY(maxAngleError <= angleError);
+
+        // constant channel is reduced to a single key
+        Vector<float32> scales(times.size(), 1.0f);
+        Vector<uint8> scaleData;
+        TEST_VERIFY(AnimationChannelWriter::Write(scaleData, 1, AnimationChannel::INTERPOLATION_LINEAR, times, scales, settings) == 1);
+
+        AnimationChannel scaleChannel;
+        TEST_VERIFY(scaleChannel.Bind(scaleData.data()) == static_cast<uint32>(scaleData.size()));
+
+        float32 scale = 0.0f;
+        scaleChannel.Evaluate(3.0f, &scale, 1);
+        TEST_VERIFY(scale == 1.0f);
+    }
+
+    DAVA_TEST (CompressionPerformance)
+    {
+// used only for manual performance testing
+// change to `#if 1` to run this test
+#if 0
+        using namespace AnimationChannelTestDetails;
+
+        Vector<float32> times, positions, orientations;
+        BuildJointMotion(3000, times, positions, orientations);
+
+        AnimationChannelWriter::Settings rawSettings;
+        rawSettings.compression = AnimationChannel::COMPRESSION_NONE;
+        rawSettings.valueTolerance = 0.0f;
+        rawSettings.angleTolerance = 0.0f;
+
+        AnimationChannelWriter::Settings compressedSettings;
+
+        for (const AnimationChannelWriter::Settings& settings : { rawSettings, compressedSettings })
+        {
+            Vector<uint8> data;
+            AnimationChannelWriter::Write(data, 3, AnimationChannel::INTERPOLATION_LINEAR, times, positions, settings);
+            AnimationChannelWriter::Write(data, 4, AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR, times, orientations, settings);
+
+            AnimationChannel positionChannel;
+            AnimationChannel orientationChannel;
+            orientationChannel.Bind(data.data() + positionChannel.Bind(data.data()));
+
+            const uint32 samplesCount = 1000000;
+            const float32 duration = times.back();
+            float32 position[3];
+            float32 orientation[4];
+            float32 checksum = 0.0f;
+            uint32 positionCursor = 0, orientationCursor = 0;
+
+            int64 begin = SystemTimer::GetUs();
+            for (uint32 i = 0; i < samplesCount; ++i)
+            {
+                float32 time = std::fmod(static_cast<float32>(i) * 0.0037f, duration);
+                positionChannel.Evaluate(time, &positionCursor, position, 3);
+                orientationChannel.Evaluate(time, &orientationCursor, orientation, 4);
+                checksum += position[0] + std::abs(orientation[0]);
+            }
+            int64 time = SystemTimer::GetUs() - begin;
+
+            Logger::Info("AnimationChannel %s: %u bytes, %u samples in %lld us (checksum %f)",
+                         (settings.compression == AnimationChannel::COMPRESSION_NONE) ? "raw" : "compressed",
+                         static_cast<uint32>(data.size()), samplesCount, time, checksum);
+        }
+
+        // skeleton-like workload: every joint has own channels and instances are sampled at different times,
+        // so channels data doesn't stay in cache and its size matters as much as decoding cost
+        for (const AnimationChannelWriter::Settings& settings : { rawSettings, compressedSettings })
+        {
+            const uint32 jointsCount = 64;
+            const uint32 instancesCount = 200;
+            const uint32 framesCount = 100;
+
+            Vector<Vector<uint8>> jointsData(jointsCount);
+            Vector<AnimationChannel> positionChannels(jointsCount);
+            Vector<AnimationChannel> orientationChannels(jointsCount);
+            uint32 dataSize = 0;
+            for (uint32 j = 0; j < jointsCount; ++j)
+            {
+                Vector<float32> jointPositions = positions;
+                for (float32& value : jointPositions)
+                    value += static_cast<float32>(j) * 0.01f;
+
+                AnimationChannelWriter::Write(jointsData[j], 3, AnimationChannel::INTERPOLATION_LINEAR, times, jointPositions, settings);
+                AnimationChannelWriter::Write(jointsData[j], 4, AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR, times, orientations, settings);
+                orientationChannels[j].Bind(jointsData[j].data() + positionChannels[j].Bind(jointsData[j].data()));
+                dataSize += static_cast<uint32>(jointsData[j].size());
+            }
+
+            const float32 duration = times.back();
+            Vector<uint32> cursors(instancesCount * jointsCount * 2, 0);
+            float32 position[3];
+            float32 orientation[4];
+            float32 checksum = 0.0f;
+
+            int64 begin = SystemTimer::GetUs();
+            for (uint32 frame = 0; frame < framesCount; ++frame)
+            {
+                for (uint32 i = 0; i < instancesCount; ++i)
+                {
+                    float32 time = std::fmod(static_cast<float32>(i) * 0.37f + static_cast<float32>(frame) * 0.033f, duration);
+                    uint32* instanceCursors = cursors.data() + i * jointsCount * 2;
+                    for (uint32 j = 0; j < jointsCount; ++j)
+                    {
+                        positionChannels[j].Evaluate(time, instanceCursors + j * 2, position, 3);
+                        orientationChannels[j].Evaluate(time, instanceCursors + j * 2 + 1, orientation, 4);
+                        checksum += position[0] + std::abs(orientation[0]);
+                    }
+                }
+            }
+            int64 time = SystemTimer::GetUs() - begin;
+
+            Logger::Info("AnimationChannel skeletons %s: %u bytes, %u joints x %u instances x %u frames in %lld us (checksum %f)",
+                         (settings.compression == AnimationChannel::COMPRESSION_NONE) ? "raw" : "compressed",
+                         dataSize, jointsCount, instancesCount, framesCount, time, checksum);
+        }
+#endif
+    }
+};
@@ -2,7 +2,10 @@
 #include <FileSystem/Private/PackArchive.h>
 #include <FileSystem/Private/ZipArchive.h>
 #include <FileSystem/FileSystem.h>
+#include <Compression/LZ4Compressor.h>
+#include <Concurrency/Thread.h>
 #include <Logger/Logger.h>
+#include <Utils/CRC32.h>
 
 #include <cstring>
 
@@ -10,6 +13,50 @@ using namespace DAVA;
 
 DAVA_TESTCLASS (ArchiveTest)
 {
+    Vector<uint8> ReadFile(const FilePath& filePath)
+    {
+        ScopedPtr<File> file(File::Create(filePath, File::OPEN | File::READ));
+        Vector<uint8> content(static_cast<size_t>(file->GetSize()), 0);
+        file->Read(content.data(), static_cast<uint32>(content.size()));
+        return content;
+    }
+
+    // Pack with single uncompressed file, only uncompressed files have zero-copy views
+    void WriteUncompressedPack(const FilePath& packPath, const String& fileName, const Vector<uint8>& content, uint32 crc32)
+    {
+        using namespace PackFormat;
+
+        String names = fileName + '\0';
+        Vector<uint8> compressedNames;
+        LZ4HCCompressor().Compress(Vector<uint8>(names.begin(), names.end()), compressedNames);
+
+        FileTableEntry entry = {};
+        entry.startPosition = 0;
+        entry.compressedSize = static_cast<uint32>(content.size());
+        entry.originalSize = static_cast<uint32>(content.size());
+        entry.compressedCrc32 = crc32;
+        entry.type = Compressor::Type::None;
+        entry.originalCrc32 = crc32;
+
+        Vector<uint8> filesTable(reinterpret_cast<const uint8*>(&entry), reinterpret_cast<const uint8*>(&entry + 1));
+        filesTable.insert(filesTable.end(), compressedNames.begin(), compressedNames.end());
+
+        PackFile::FooterBlock footer;
+        footer.info.numFiles = 1;
+        footer.info.namesSizeCompressed = static_cast<uint32>(compressedNames.size());
+        footer.info.namesSizeOriginal = static_cast<uint32>(names.size());
+        footer.info.filesTableSize = static_cast<uint32>(filesTable.size());
+        footer.info.filesTableCrc32 = CRC32::ForBuffer(filesTable);
+        footer.info.packArchiveMarker = FILE_MARKER;
+        footer.infoCrc32 = CRC32::ForBuffer(&footer.info, sizeof(footer.info));
+
+        FileSystem::Instance()->CreateDirectory(packPath.GetDirectory(), true);
+        ScopedPtr<File> file(File::Create(packPath, File::CREATE | File::WRITE));
+        file->Write(content.data(), static_cast<uint32>(content.size()));
+        file->Write(filesTable.data(), static_cast<uint32>(filesTable.size()));
+        file->Write(&footer, sizeof(footer));
+    }
+
     DAVA_TEST (TestDavaArchive)
     {
         FilePath baseDir("~res:/TestData/FileListTest/");
@@ -58,6 +105,141 @@ DAVA_TESTCLASS (ArchiveTest)
 #endif // __DAVAENGINE_IPHONE__
     }
 
+    DAVA_TEST (TestDavaArchiveConcurrentLoad)
+    {
+#if !defined(__DAVAENGINE_IPHONE__) && !defined(__DAVAENGINE_ANDROID__)
+        try
+        {
+            RefPtr<File> fileDvpk(File::Create("~res:/TestData/ArchiveTest/archive.dvpk", File::OPEN | File::READ));
+            PackArchive archive(fileDvpk, "~res:/TestData/ArchiveTest/archive.dvpk");
+
+            const char* filename = "Utf8Test/utf16le.txt";
+            Vector<uint8> expected;
+            TEST_VERIFY(archive.LoadFile(filename, expected));
+
+            const size_t threadsNum = 8;
+            Array<Thread*, threadsNum> threads;
+            Array<bool, threadsNum> results;
+            results.fill(false);
+
+            for (size_t i = 0; i < threadsNum; ++i)
+            {
+                threads[i] = Thread::Create([i, &archive, &expected, &results, filename]() {
+                    bool allEqual = true;
+                    Vector<uint8> content;
+                    for (uint32 j = 0; j < 100; ++j)
+                    {
+                        allEqual &= archive.LoadFile(filename, content) && content == expected;
+                    }
+                    results[i] = allEqual;
+                });
+                threads[i]->Start();
+            }
+
+            for (Thread* thread : threads)
+            {
+                thread->Join();
+                thread->Release();
+            }
+
+            for (bool result : results)
+            {
+                TEST_VERIFY(result);
+            }
+
+            // compressed content has no zero-copy view
+            const uint8* data = nullptr;
+            uint32 size = 0;
+            TEST_VERIFY(!archive.GetFileView(filename, data, size));
+        }
+        catch (std::exception& ex)
+        {
+            Logger::Info(ex.what());
+        }
+#endif
+    }
+
+    DAVA_TEST (TestDavaArchiveFileView)
+    {
+#if !defined(__DAVAENGINE_IPHONE__) && !defined(__DAVAENGINE_ANDROID__)
+        const FilePath packPath("~doc:/TestData/ArchiveTest_Temp/uncompressed.dvpk");
+        const char* filename = "Utf8Test/utf16le.txt";
+        Vector<uint8> fileFromHDD = ReadFile("~res:/TestData/Utf8Test/utf16le.txt");
+        WriteUncompressedPack(packPath, filename, fileFromHDD, CRC32::ForBuffer(fileFromHDD));
+
+        try
+        {
+            // mapped pack: view points to the same bytes as source file, repeated views return the same memory
+            {
+                RefPtr<File> fileDvpk(File::Create(packPath, File::OPEN | File::READ));
+                PackArchive archive(fileDvpk, packPath);
+
+                const uint8* data = nullptr;
+                uint32 size = 0;
+                TEST_VERIFY(archive.GetFileView(filename, data, size));
+                TEST_VERIFY(size == fileFromHDD.size());
+                TEST_VERIFY(data != nullptr && std::equal(fileFromHDD.begin(), fileFromHDD.end(), data));
+
+                const uint8* dataAgain = nullptr;
+                uint32 sizeAgain = 0;
+                TEST_VERIFY(archive.GetFileView(filename, dataAgain, sizeAgain));
+                TEST_VERIFY(dataAgain == data && sizeAgain == size);
+
+                Vector<uint8> fileFromArchive;
+                TEST_VERIFY(archive.LoadFile(filename, fileFromArchive));
+                TEST_VERIFY(fileFromArchive == fileFromHDD);
+            }
+
+            // pack which can't be mapped (e.g. inside APK) has no views, but its files are still read from file
+            {
+                RefPtr<File> fileDvpk(File::Create(packPath, File::OPEN | File::READ));
+                PackArchive archive(fileDvpk, "~doc:/TestData/ArchiveTest_Temp/not_mapped.dvpk");
+
+                const uint8* data = nullptr;
+                uint32 size = 0;
+                TEST_VERIFY(!archive.GetFileView(filename, data, size));
+
+                Vector<uint8> fileFromArchive;
+                TEST_VERIFY(archive.LoadFile(filename, fileFromArchive));
+                TEST_VERIFY(fileFromArchive == fileFromHDD);
+            }
+        }
+        catch (std::exception& ex)
+        {
+            Logger::Error("%s", ex.what());
+            TEST_VERIFY(false && "can't open uncompressed pack");
+        }
+
+        // content which doesn't match crc32 is not viewed
+        WriteUncompressedPack(packPath, filename, fileFromHDD, CRC32::ForBuffer(fileFromHDD) + 1);
+        try
+        {
+            RefPtr<File> fileDvpk(File::Create(packPath, File::OPEN | File::READ));
+            PackArchive archive(fileDvpk, packPath);
+
+            const uint8* data = nullptr;
+            uint32 size = 0;
+            bool crc32Mismatch = false;
+            try
+            {
+                archive.GetFileView(filename, data, size);
+            }
+            catch (FileCrc32FromPackNotMatch&)
+            {
+                crc32Mismatch = true;
+            }
+            TEST_VERIFY(crc32Mismatch);
+        }
+        catch (std::exception& ex)
+        {
+            Logger::Error("%s", ex.what());
+            TEST_VERIFY(false && "can't open uncompressed pack");
+        }
+
+        FileSystem::Instance()->DeleteFile(packPath);
+#endif
+    }
+
     DAVA_TEST (TestZipArchive)
     {
         try
@@ -0,0 +1,332 @@
+#include <DAVAEngine.h>
+#include <UnitTests/UnitTests.h>
+
+#if defined(__DAVAENGINE_WIN32__) || defined(__DAVAENGINE_MACOS__)
+
+#include <CacheDB.h>
+#include <ServerCacheEntry.h>
+
+#include <AssetCache/CacheItemKey.h>
+#include <AssetCache/CachedItemValue.h>
+
+#include <Engine/EngineContext.h>
+#include <FileSystem/File.h>
+#include <FileSystem/FileSystem.h>
+#include <FileSystem/KeyedArchive.h>
+#include <Utils/StringFormat.h>
+
+namespace CacheDBTestDetails
+{
+using DAVA::AssetCache::CacheItemKey;
+using DAVA::AssetCache::CachedItemValue;
+
+struct TestOwner : public CacheDBOwner
+{
+    void OnStorageSizeChanged(DAVA::uint64 occupied, DAVA::uint64 overall) override
+    {
+    }
+
+    void OnEntryRemoved(const CacheItemKey& key) override
+    {
+        removedKeys.push_back(key);
+    }
+
+    DAVA::Vector<CacheItemKey> removedKeys;
+};
+
+CacheItemKey CreateKey(DAVA::uint8 index)
+{
+    CacheItemKey key;
+    key.fill(index);
+    return key;
+}
+
+CachedItemValue CreateValue(DAVA::uint32 size)
+{
+    CachedItemValue value;
+    value.Add("data.bin", std::make_shared<DAVA::Vector<DAVA::uint8>>(size, static_cast<DAVA::uint8>(size)));
+    return value;
+}
+
+// removes everything from db in eviction order and returns removed keys
+DAVA::Vector<CacheItemKey> EvictAll(const DAVA::FilePath& folder)
+{
+    TestOwner owner;
+    CacheDB db(owner);
+    db.UpdateSettings(folder, 1000, 0, 0);
+    db.ClearStorage();
+    return owner.removedKeys;
+}
+}
+
+DAVA_TESTCLASS (CacheDBTest)
+{
+    DEDUCE_COVERED_FILES_FROM_TESTCLASS()
+
+    const DAVA::FilePath rootDir = "~doc:/TestData/CacheDBTest/";
+    const DAVA::FilePath snapshotPath = rootDir + "cache.dat";
+    const DAVA::FilePath journalPath = rootDir + "cache.journal";
+
+    void SetUp(const DAVA::String& testName) override
+    {
+        DAVA::GetEngineContext()->fileSystem->DeleteDirectory(rootDir, true);
+    }
+
+    void TearDown(const DAVA::String& testName) override
+    {
+        DAVA::GetEngineContext()->fileSystem->DeleteDirectory(rootDir, true);
+    }
+
+    DAVA::Vector<DAVA::uint8> ReadJournal()
+    {
+        DAVA::Vector<DAVA::uint8> journal;
+        DAVA::GetEngineContext()->fileSystem->ReadFileContents(journalPath, journal);
+        return journal;
+    }
+
+    void WriteJournal(const DAVA::Vector<DAVA::uint8>& journal)
+    {
+        DAVA::ScopedPtr<DAVA::File> file(DAVA::File::Create(journalPath, DAVA::File::CREATE | DAVA::File::WRITE));
+        TEST_VERIFY(file && file->Write(journal.data(), static_cast<DAVA::uint32>(journal.size())) == journal.size());
+    }
+
+    // five items of 10 bytes are in snapshot, 10-th and 11-th items are only in journal
+    void FillSnapshotAndJournal()
+    {
+        using namespace CacheDBTestDetails;
+
+        TestOwner owner;
+        CacheDB db(owner);
+        db.UpdateSettings(rootDir, 1000, 2, 0);
+        for (DAVA::uint8 i = 0; i < 5; ++i)
+        {
+            db.Insert(CreateKey(i), CreateValue(10));
+        }
+        db.Save();
+
+        db.Insert(CreateKey(10), CreateValue(20));
+        db.Insert(CreateKey(11), CreateValue(30));
+    }
+
+    DAVA_TEST (JournalReplayTest)
+    {
+        using namespace CacheDBTestDetails;
+
+        DAVA::Vector<CacheItemKey> expectedOrder;
+        DAVA::uint64 expectedSize = 0;
+        {
+            TestOwner owner;
+            CacheDB db(owner);
+            db.UpdateSettings(rootDir, 1000, 2, 0);
+            for (DAVA::uint8 i = 0; i < 5; ++i)
+            {
+                db.Insert(CreateKey(i), CreateValue(10 * (i + 1)));
+            }
+            db.Save();
+            TEST_VERIFY(DAVA::GetEngineContext()->fileSystem->Exists(snapshotPath));
+            TEST_VERIFY(DAVA::GetEngineContext()->fileSystem->Exists(journalPath) == false);
+
+            // changes after snapshot are kept in journal only
+            TEST_VERIFY(db.Get(CreateKey(0)) != nullptr);
+            db.UpdateAccessTimestamp(CreateKey(1));
+            TEST_VERIFY(db.Remove(CreateKey(2)));
+            db.Insert(CreateKey(3), CreateValue(5));
+            db.Insert(CreateKey(5), CreateValue(60));
+
+            expectedOrder = { CreateKey(4), CreateKey(0), CreateKey(1), CreateKey(3), CreateKey(5) };
+            expectedSize = 50 + 10 + 20 + 5 + 60;
+            TEST_VERIFY(db.GetOccupiedSize() == expectedSize);
+        }
+        TEST_VERIFY(DAVA::GetEngineContext()->fileSystem->Exists(journalPath));
+
+        {
+            TestOwner owner;
+            CacheDB db(owner);
+            db.UpdateSettings(rootDir, 1000, 2, 0);
+            TEST_VERIFY(db.GetOccupiedSize() == expectedSize);
+            TEST_VERIFY(db.Find(CreateKey(2)) == nullptr);
+
+            // finding entries in eviction order keeps this order
+            const DAVA::uint64 expectedSizes[] = { 50, 10, 20, 5, 60 };
+            for (size_t i = 0; i < expectedOrder.size(); ++i)
+            {
+                ServerCacheEntry* entry = db.Find(expectedOrder[i]);
+                TEST_VERIFY(entry != nullptr && entry->GetValue().GetSize() == expectedSizes[i]);
+            }
+            TEST_VERIFY(owner.removedKeys.empty());
+        }
+
+        TEST_VERIFY(EvictAll(rootDir) == expectedOrder);
+    }
+
+    DAVA_TEST (TornJournalTest)
+    {
+        using namespace CacheDBTestDetails;
+
+        FillSnapshotAndJournal();
+
+        // last record is written partially
+        DAVA::Vector<DAVA::uint8> journal = ReadJournal();
+        TEST_VERIFY(journal.size() > 3);
+        journal.resize(journal.size() - 3);
+        WriteJournal(journal);
+
+        {
+            TestOwner owner;
+            CacheDB db(owner);
+            db.UpdateSettings(rootDir, 1000, 2, 0);
+            TEST_VERIFY(db.GetOccupiedSize() == 5 * 10 + 20);
+            TEST_VERIFY(db.Find(CreateKey(10)) != nullptr);
+            TEST_VERIFY(db.Find(CreateKey(11)) == nullptr);
+
+            // damaged journal is compacted into snapshot right after load
+            TEST_VERIFY(DAVA::GetEngineContext()->fileSystem->Exists(journalPath) == false);
+        }
+
+        TestOwner owner;
+        CacheDB db(owner);
+        db.UpdateSettings(rootDir, 1000, 2, 0);
+        TEST_VERIFY(db.GetOccupiedSize() == 5 * 10 + 20);
+    }
+
+    DAVA_TEST (DamagedJournalCrcTest)
+    {
+        using namespace CacheDBTestDetails;
+
+        FillSnapshotAndJournal();
+
+        // first byte of key in payload of first record is changed, so crc32 of record doesn't match
+        const size_t journalHeaderSize = sizeof(DAVA::uint32) * 2;
+        DAVA::Vector<DAVA::uint8> journal = ReadJournal();
+        TEST_VERIFY(journal.size() > journalHeaderSize + 1);
+        journal[journalHeaderSize + 1] ^= 0xff;
+        WriteJournal(journal);
+
+        {
+            TestOwner owner;
+            CacheDB db(owner);
+            db.UpdateSettings(rootDir, 1000, 2, 0);
+            TEST_VERIFY(db.GetOccupiedSize() == 5 * 10);
+            TEST_VERIFY(db.Find(CreateKey(10)) == nullptr);
+            TEST_VERIFY(db.Find(CreateKey(11)) == nullptr);
+            TEST_VERIFY(DAVA::GetEngineContext()->fileSystem->Exists(journalPath) == false);
+        }
+
+        TestOwner owner;
+        CacheDB db(owner);
+        db.UpdateSettings(rootDir, 1000, 2, 0);
+        TEST_VERIFY(db.GetOccupiedSize() == 5 * 10);
+    }
+
+    DAVA_TEST (LegacySnapshotTest)
+    {
+        using namespace CacheDBTestDetails;
+
+        // previous versions stored clock values as access timestamps, they may be equal
+        const DAVA::uint64 clockTimestamps[] = { 5000, 3000, 7000, 1000, 3000 };
+        const DAVA::uint8 itemsCount = static_cast<DAVA::uint8>(std::extent<decltype(clockTimestamps)>::value);
+        {
+            DAVA::GetEngineContext()->fileSystem->CreateDirectory(rootDir, true);
+            DAVA::ScopedPtr<DAVA::File> file(DAVA::File::Create(snapshotPath, DAVA::File::CREATE | DAVA::File::WRITE));
+            TEST_VERIFY(file);
+
+            DAVA::ScopedPtr<DAVA::KeyedArchive> header(new DAVA::KeyedArchive());
+            header->SetString("signature", "cache");
+            header->SetUInt32("version", 1);
+            header->SetUInt64("itemsCount", itemsCount);
+            header->Save(file);
+
+            DAVA::ScopedPtr<DAVA::KeyedArchive> cache(new DAVA::KeyedArchive());
+            for (DAVA::uint8 i = 0; i < itemsCount; ++i)
+            {
+                ServerCacheEntry entry(CreateValue(10));
+                entry.SetAccessTimestamp(clockTimestamps[i]);
+
+                DAVA::ScopedPtr<DAVA::KeyedArchive> itemArchieve(new DAVA::KeyedArchive());
+                CreateKey(i).Serialize(itemArchieve);
+                entry.Serialize(itemArchieve);
+                cache->SetArchive(DAVA::Format("item_%d", i), itemArchieve);
+            }
+            cache->Save(file);
+        }
+
+        {
+            TestOwner owner;
+            CacheDB db(owner);
+            db.UpdateSettings(rootDir, 1000, 2, 0);
+            TEST_VERIFY(db.GetOccupiedSize() == itemsCount * 10);
+        }
+
+        // renumbered entries are saved to snapshot right after load
+        DAVA::Map<CacheItemKey, DAVA::uint64> savedTimestamps;
+        {
+            DAVA::ScopedPtr<DAVA::File> file(DAVA::File::Create(snapshotPath, DAVA::File::OPEN | DAVA::File::READ));
+            TEST_VERIFY(file);
+
+            DAVA::ScopedPtr<DAVA::KeyedArchive> header(new DAVA::KeyedArchive());
+            header->Load(file);
+            TEST_VERIFY(header->GetUInt64("itemsCount") == itemsCount);
+
+            DAVA::ScopedPtr<DAVA::KeyedArchive> cache(new DAVA::KeyedArchive());
+            cache->Load(file);
+            for (DAVA::uint8 i = 0; i < itemsCount; ++i)
+            {
+                DAVA::KeyedArchive* itemArchieve = cache->GetArchive(DAVA::Format("item_%d", i));
+                TEST_VERIFY(itemArchieve != nullptr);
+                if (itemArchieve != nullptr)
+                {
+                    CacheItemKey key;
+                    key.Deserialize(itemArchieve);
+                    ServerCacheEntry entry;
+                    entry.Deserialize(itemArchieve);
+                    savedTimestamps[key] = entry.GetTimestamp();
+                }
+            }
+        }
+
+        // entries with equal clock values may go in any order, others keep order of clock
+        TEST_VERIFY(savedTimestamps.size() == itemsCount);
+        TEST_VERIFY(savedTimestamps[CreateKey(3)] == 0);
+        TEST_VERIFY((savedTimestamps[CreateKey(1)] == 1 && savedTimestamps[CreateKey(4)] == 2) || (savedTimestamps[CreateKey(1)] == 2 && savedTimestamps[CreateKey(4)] == 1));
+        TEST_VERIFY(savedTimestamps[CreateKey(0)] == 3);
+        TEST_VERIFY(savedTimestamps[CreateKey(2)] == 4);
+
+        DAVA::Vector<CacheItemKey> removedKeys = EvictAll(rootDir);
+        TEST_VERIFY(removedKeys.size() == itemsCount);
+        for (size_t i = 0; i < removedKeys.size(); ++i)
+        {
+            TEST_VERIFY(savedTimestamps[removedKeys[i]] == i);
+        }
+    }
+
+    DAVA_TEST (EvictionOrderTest)
+    {
+        using namespace CacheDBTestDetails;
+
+        TestOwner owner;
+        CacheDB db(owner);
+        db.UpdateSettings(rootDir, 100, 2, 0);
+        for (DAVA::uint8 i = 0; i < 4; ++i)
+        {
+            db.Insert(CreateKey(i), CreateValue(20));
+        }
+        TEST_VERIFY(owner.removedKeys.empty());
+
+        TEST_VERIFY(db.Get(CreateKey(0)) != nullptr);
+        db.UpdateAccessTimestamp(CreateKey(1));
+
+        // least recently accessed entry is evicted first
+        db.Insert(CreateKey(4), CreateValue(30));
+        TEST_VERIFY(owner.removedKeys == DAVA::Vector<CacheItemKey>({ CreateKey(2) }));
+        TEST_VERIFY(db.GetOccupiedSize() == 90);
+
+        TEST_VERIFY(db.Find(CreateKey(3)) != nullptr);
+        db.UpdateSettings(rootDir, 50, 2, 0);
+        TEST_VERIFY(owner.removedKeys == DAVA::Vector<CacheItemKey>({ CreateKey(2), CreateKey(0), CreateKey(1) }));
+        TEST_VERIFY(db.GetOccupiedSize() == 50);
+        TEST_VERIFY(db.Find(CreateKey(3)) != nullptr);
+        TEST_VERIFY(db.Find(CreateKey(4)) != nullptr);
+    }
+};
+
+#endif // defined(__DAVAENGINE_WIN32__) || defined(__DAVAENGINE_MACOS__)
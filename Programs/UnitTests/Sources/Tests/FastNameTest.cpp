@@ -4,6 +4,10 @@
 #include "Base/FastName.h"
 #include "Concurrency/Thread.h"
 #include "Concurrency/SyncBarrier.h"
+#include "Logger/Logger.h"
+#include "Time/SystemTimer.h"
+
+#include <atomic>
 
 using namespace DAVA;
 
@@ -152,4 +156,86 @@ DAVA_TESTCLASS (FastNameTest)
             TEST_VERIFY(strcmp(fns[i].back().c_str(), std::to_string(i).c_str()) == 0);
         }
     }
+
+    DAVA_TEST (ManyNamesTest)
+    {
+        // enough names to fill several arena blocks, with long names stored separately
+        const size_t namesCount = 20000;
+
+        Vector<String> strings;
+        Vector<FastName> names;
+        for (size_t i = 0; i < namesCount; ++i)
+        {
+            strings.push_back("many_names_" + std::to_string(i) + String(i % 7 == 0 ? 2000 : i % 50, 'x'));
+            names.emplace_back(strings.back());
+        }
+
+        bool allEqual = true;
+        for (size_t i = 0; i < namesCount; ++i)
+        {
+            FastName again(strings[i].c_str());
+            allEqual &= (again == names[i]);
+            allEqual &= (strcmp(again.c_str(), strings[i].c_str()) == 0);
+        }
+        TEST_VERIFY(allEqual);
+
+        // same prefix with different length must not match cached name
+        FastName prefix("many_names_1");
+        TEST_VERIFY(strcmp(prefix.c_str(), "many_names_1") == 0);
+        TEST_VERIFY(prefix != FastName("many_names_1x"));
+    }
+
+    DAVA_TEST (ContentionPerformanceTest)
+    {
+// used only for manual performance testing
+// change to `#if 1` to run this test
+#if 0
+        const size_t threadsNum = 8;
+        const size_t namesNum = 4096;
+        const size_t iterationsNum = 200;
+
+        Vector<String> strings(namesNum);
+        for (size_t i = 0; i < namesNum; ++i)
+        {
+            strings[i] = "contention_name_" + std::to_string(i * 7919);
+        }
+
+        Array<Thread*, threadsNum> threads;
+        SyncBarrier barrier(threadsNum + 1);
+        std::atomic<size_t> checksum(0);
+
+        for (size_t i = 0; i < threads.size(); ++i)
+        {
+            threads[i] = Thread::Create([i, &strings, &barrier, &checksum]() {
+                size_t localChecksum = 0;
+                barrier.Wait();
+                for (size_t iteration = 0; iteration < iterationsNum; ++iteration)
+                {
+                    // threads walk the names with different strides to mix hot and cold lookups
+                    for (size_t j = 0; j < strings.size(); ++j)
+                    {
+                        FastName fn(strings[(j * (2 * i + 1) + iteration) % strings.size()]);
+                        localChecksum += reinterpret_cast<size_t>(fn.c_str()) & 0xff;
+                    }
+                }
+                checksum += localChecksum;
+            });
+            threads[i]->Start();
+        }
+
+        int64 begin = SystemTimer::GetUs();
+        barrier.Wait();
+        for (Thread* thread : threads)
+        {
+            thread->Join();
+            thread->Release();
+        }
+        int64 time = SystemTimer::GetUs() - begin;
+
+        size_t constructions = threadsNum * namesNum * iterationsNum;
+        Logger::Info("FastName contention: %u threads, %u constructions in %lld us (%.1f ns per name, checksum %u)",
+                     static_cast<uint32>(threadsNum), static_cast<uint32>(constructions), time,
+                     time * 1000.0 / constructions, static_cast<uint32>(checksum.load()));
+#endif
+    }
 };
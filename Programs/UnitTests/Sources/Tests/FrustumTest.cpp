@@ -0,0 +1,56 @@
+#include "UnitTests/UnitTests.h"
+#include "Render/Highlevel/Frustum.h"
+
+#include <random>
+
+using namespace DAVA;
+
+DAVA_TESTCLASS (FrustumTest)
+{
+    DAVA_TEST (BlockIsInsideMatchesScalar)
+    {
+        Matrix4 view, projection;
+        view.BuildLookAtMatrix(Vector3(0.0f, 0.0f, 0.0f), Vector3(10.0f, 5.0f, 1.0f), Vector3(0.0f, 0.0f, 1.0f));
+        projection.BuildPerspective(-1.0f, 1.0f, -0.75f, 0.75f, 1.0f, 500.0f, false);
+
+        Frustum* frustum = new Frustum();
+        SCOPE_EXIT
+        {
+            SafeRelease(frustum);
+        };
+        frustum->Build(view * projection, false);
+
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float32> position(-300.0f, 300.0f);
+        std::uniform_real_distribution<float32> size(0.1f, 30.0f);
+        std::uniform_int_distribution<uint32> plane(0, 5);
+        std::uniform_int_distribution<uint32> mask(1, 0x3f);
+
+        for (uint32 iteration = 0; iteration < 2000; ++iteration)
+        {
+            uint32 count = 1 + iteration % AABBox3Block::SIZE;
+            uint8 planeMask = static_cast<uint8>(mask(rng));
+
+            AABBox3 boxes[AABBox3Block::SIZE];
+            AABBox3Block block = AABBox3Block();
+            uint8 scalarPlanes[AABBox3Block::SIZE];
+            uint8 blockPlanes[AABBox3Block::SIZE];
+            for (uint32 i = 0; i < count; ++i)
+            {
+                Vector3 min(position(rng), position(rng), position(rng) * 0.1f);
+                boxes[i] = AABBox3(min, min + Vector3(size(rng), size(rng), size(rng)));
+                block.Set(i, boxes[i]);
+                scalarPlanes[i] = blockPlanes[i] = static_cast<uint8>(plane(rng));
+            }
+
+            uint32 insideMask = frustum->IsInside(block, count, planeMask, blockPlanes);
+            for (uint32 i = 0; i < count; ++i)
+            {
+                bool inside = frustum->IsInside(boxes[i], planeMask, scalarPlanes[i]);
+                TEST_VERIFY(inside == ((insideMask & (1u << i)) != 0));
+                TEST_VERIFY(scalarPlanes[i] == blockPlanes[i]);
+            }
+            TEST_VERIFY((insideMask >> count) == 0);
+        }
+    }
+};
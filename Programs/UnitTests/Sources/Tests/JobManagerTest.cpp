@@ -1,5 +1,8 @@
 #include "DAVAEngine.h"
 #include "UnitTests/UnitTests.h"
+#include "Job/JobThread.h"
+#include "Job/ParallelFor.h"
+#include "Job/TaskGraph.h"
 
 using namespace DAVA;
 
@@ -83,8 +86,162 @@ DAVA_TESTCLASS (JobManagerTest)
 
     DAVA_TEST (TestWorkerJobs)
     {
-        // TODO:
-        // ...
+        JobManager* jobManager = GetEngineContext()->jobManager;
+
+        // more jobs than old fixed-size queue could hold
+        const uint32 jobsCount = 10000;
+        Atomic<uint32> counter(0);
+        for (uint32 i = 0; i < jobsCount; ++i)
+        {
+            jobManager->CreateWorkerJob([&counter]() { counter++; });
+        }
+        jobManager->WaitWorkerJobs();
+
+        TEST_VERIFY(counter == jobsCount);
+        TEST_VERIFY(!jobManager->HasWorkerJobs());
+    }
+
+    DAVA_TEST (TestWorkerJobHandles)
+    {
+        JobManager* jobManager = GetEngineContext()->jobManager;
+
+        TEST_VERIFY(JobHandle().IsDone());
+
+        Atomic<uint32> groupCounter(0);
+        JobHandle group;
+        for (uint32 i = 0; i < JOBS_COUNT; ++i)
+        {
+            group = jobManager->CreateWorkerJob([&groupCounter]() { groupCounter++; }, group);
+        }
+
+        // jobs spawned from worker jobs and waited inside worker thread
+        Atomic<uint32> nestedCounter(0);
+        JobHandle parent = jobManager->CreateWorkerJob([jobManager, &nestedCounter]() {
+            JobHandle children;
+            for (uint32 i = 0; i < JOBS_COUNT; ++i)
+            {
+                children = jobManager->CreateWorkerJob([&nestedCounter]() { nestedCounter++; }, children);
+            }
+            jobManager->WaitWorkerJob(children);
+            TEST_VERIFY(nestedCounter == JOBS_COUNT);
+        });
+
+        jobManager->WaitWorkerJob(group);
+        TEST_VERIFY(group.IsDone());
+        TEST_VERIFY(groupCounter == JOBS_COUNT);
+
+        jobManager->WaitWorkerJob(parent);
+        TEST_VERIFY(parent.IsDone());
+        TEST_VERIFY(nestedCounter == JOBS_COUNT);
+    }
+
+    DAVA_TEST (TestParallelFor)
+    {
+        JobManager* jobManager = GetEngineContext()->jobManager;
+
+        const uint32 count = 100000;
+        Vector<uint32> values(count, 0);
+        ParallelFor(jobManager, 0, count, 1000, [&values](uint32 begin, uint32 end) {
+            for (uint32 i = begin; i < end; ++i)
+            {
+                values[i] += i;
+            }
+        });
+
+        bool allProcessedOnce = true;
+        for (uint32 i = 0; i < count; ++i)
+        {
+            allProcessedOnce &= (values[i] == i);
+        }
+        TEST_VERIFY(allProcessedOnce);
+
+        // empty and single-chunk ranges are processed on calling thread
+        uint32 calls = 0;
+        ParallelFor(jobManager, 10, 10, 1, [&calls](uint32, uint32) { calls++; });
+        ParallelFor(jobManager, 0, 10, 100, [&calls](uint32 begin, uint32 end) { calls += end - begin; });
+        TEST_VERIFY(calls == 10);
+    }
+
+    DAVA_TEST (TestTaskGraph)
+    {
+        ComponentMask maskA;
+        ComponentMask maskB;
+        maskA.set(0);
+        maskB.set(1);
+
+        Vector<uint32> order;
+        Mutex orderMutex;
+        auto makeTask = [&order, &orderMutex](uint32 index) {
+            return [&order, &orderMutex, index]() {
+                LockGuard<Mutex> lock(orderMutex);
+                order.push_back(index);
+            };
+        };
+
+        TaskGraph graph;
+        TaskGraph::TaskId writerA = graph.AddTask(makeTask(0), ComponentMask(), maskA);
+        TaskGraph::TaskId readerA = graph.AddTask(makeTask(1), maskA, maskB);
+        TaskGraph::TaskId writerB = graph.AddTask(makeTask(2), ComponentMask(), maskB);
+        TEST_VERIFY(graph.GetTasksCount() == 3);
+
+        graph.Execute(GetEngineContext()->jobManager);
+        TEST_VERIFY(order.size() == 3);
+
+        auto position = [&order](uint32 index) {
+            return std::find(order.begin(), order.end(), index) - order.begin();
+        };
+        // read-after-write and write-after-write are ordered
+        TEST_VERIFY(position(writerA) < position(readerA));
+        TEST_VERIFY(position(readerA) < position(writerB));
+
+        graph.Clear();
+        TEST_VERIFY(graph.IsEmpty());
+    }
+
+    DAVA_TEST (WorkerJobsThroughput)
+    {
+// used only for manual performance testing
+// change to `#if 1` to run this test
+#if 0
+        const uint32 jobsCount = 1000000;
+        const uint32 maxWorkers = static_cast<uint32>(DeviceInfo::GetCpuCount());
+
+        for (uint32 workers = 1; workers <= maxWorkers; ++workers)
+        {
+            Semaphore doneSem;
+            JobQueueWorker queue(workers, &doneSem);
+
+            Vector<JobThread*> threads;
+            for (uint32 i = 0; i < workers; ++i)
+            {
+                threads.push_back(new JobThread(&queue, i, &doneSem));
+            }
+
+            Atomic<uint32> counter(0);
+            int64 begin = SystemTimer::GetUs();
+            for (uint32 i = 0; i < jobsCount; ++i)
+            {
+                queue.Push([&counter]() { counter++; });
+                queue.Signal();
+            }
+            while (queue.PopAndExec())
+            {
+            }
+            while (!queue.IsEmpty())
+            {
+                Thread::Yield();
+            }
+            int64 time = SystemTimer::GetUs() - begin;
+
+            Logger::Info("WorkerJobsThroughput: %u workers, %u jobs in %lld us, %.2f Mjobs/s",
+                         workers, jobsCount, time, static_cast<float64>(jobsCount) / static_cast<float64>(time));
+
+            for (JobThread* thread : threads)
+            {
+                delete thread;
+            }
+        }
+#endif
     }
 
     void ThreadFunc(JobManagerTestData * data)
@@ -3,13 +3,119 @@
 #include "Logger/Logger.h"
 #include "Concurrency/Thread.h"
 #include "Concurrency/Atomic.h"
+#include "Engine/Engine.h"
+#include "Time/SystemTimer.h"
 
 #include <algorithm>
+#include <atomic>
 #include <numeric>
 #include <random>
 
 using namespace DAVA;
 
+namespace LoggerConcurrentTestDetails
+{
+// Checks that messages "<prefix> <thread> <index>" of every thread come in order
+class SequenceOutput : public LoggerOutput
+{
+public:
+    SequenceOutput(const char8* prefix_, size_t threadsCount)
+        : prefix(prefix_)
+        , nextIndices(threadsCount, 0)
+    {
+    }
+
+    ~SequenceOutput() override = default;
+
+    void Output(Logger::eLogLevel ll, const char8* text) override
+    {
+        size_t prefixLength = strlen(prefix);
+        if (strncmp(text, prefix, prefixLength) != 0)
+        {
+            return;
+        }
+
+        uint32 thread = 0;
+        uint32 index = 0;
+        if (sscanf(text + prefixLength, " %u %u", &thread, &index) != 2 || thread >= nextIndices.size() || nextIndices[thread] != index)
+        {
+            inOrder = false;
+            return;
+        }
+
+        ++nextIndices[thread];
+        ++received;
+    }
+
+    const char8* prefix;
+    Vector<uint32> nextIndices;
+    std::atomic<uint32> received{ 0 };
+    bool inOrder = true;
+};
+
+// Only counts messages, so benchmark measures logger itself
+class NullOutput : public LoggerOutput
+{
+public:
+    ~NullOutput() override = default;
+
+    void Output(Logger::eLogLevel ll, const char8* text) override
+    {
+        ++received;
+    }
+
+    std::atomic<uint32> received{ 0 };
+};
+
+// Every `longMessagePeriod`-th message is too long for async buffer and is written synchronously
+int64 LogFromThreads(uint32 threadsCount, uint32 messagesCount, uint32 longMessagePeriod = 0)
+{
+    const String padding(2048, '.');
+
+    Vector<Thread*> threads(threadsCount);
+    std::atomic<uint32> threadsStarted{ 0 };
+    std::atomic<bool> go{ false };
+
+    for (uint32 i = 0; i < threadsCount; ++i)
+    {
+        threads[i] = Thread::Create([i, messagesCount, longMessagePeriod, &padding, &threadsStarted, &go] {
+            ++threadsStarted;
+            while (!go)
+            {
+                Thread::Yield();
+            }
+
+            for (uint32 j = 0; j < messagesCount; ++j)
+            {
+                if (longMessagePeriod != 0 && j % longMessagePeriod == 0)
+                {
+                    Logger::Debug("async %u %u %s", i, j, padding.c_str());
+                }
+                else
+                {
+                    Logger::Debug("async %u %u", i, j);
+                }
+            }
+        });
+        threads[i]->Start();
+    }
+
+    while (threadsStarted != threadsCount)
+    {
+        Thread::Yield();
+    }
+
+    int64 begin = SystemTimer::GetUs();
+    go = true;
+    for (Thread* t : threads)
+    {
+        t->Join();
+        SafeRelease(t);
+    }
+    return SystemTimer::GetUs() - begin;
+}
+}
+
 DAVA_TESTCLASS (LoggerConcurrentTest)
 {
     DAVA_TEST (ConcurrentLoggerTest)
@@ -62,4 +168,118 @@ DAVA_TESTCLASS (LoggerConcurrentTest)
 
         TEST_VERIFY(threadsFinished == threadsNumber);
     }
+
+    DAVA_TEST (AsyncLoggerTest)
+    {
+        using namespace LoggerConcurrentTestDetails;
+
+        const uint32 threadsCount = 4;
+        const uint32 messagesCount = 2000;
+
+        Logger* logger = GetEngineContext()->logger;
+        Logger::eLogLevel logLevel = logger->GetLogLevel();
+        logger->SetLogLevel(Logger::LEVEL_ERROR); // custom outputs still receive all messages
+
+        SequenceOutput* output = new SequenceOutput("async", threadsCount);
+        Logger::AddCustomOutput(output);
+
+        // small buffers make logging threads wait for writer and wrap buffers many times
+        logger->EnableAsyncMode(1024, Logger::OVERFLOW_BLOCK);
+        TEST_VERIFY(logger->IsAsyncModeEnabled());
+
+        LogFromThreads(threadsCount, messagesCount);
+        logger->Flush();
+
+        TEST_VERIFY(output->received == threadsCount * messagesCount);
+        TEST_VERIFY(output->inOrder);
+
+        logger->DisableAsyncMode();
+        TEST_VERIFY(!logger->IsAsyncModeEnabled());
+
+        Logger::RemoveCustomOutput(output);
+        delete output;
+        logger->SetLogLevel(logLevel);
+    }
+
+    DAVA_TEST (AsyncLoggerSyncFallbackTest)
+    {
+        using namespace LoggerConcurrentTestDetails;
+
+        const uint32 threadsCount = 4;
+        const uint32 messagesCount = 500;
+
+        Logger* logger = GetEngineContext()->logger;
+        Logger::eLogLevel logLevel = logger->GetLogLevel();
+        logger->SetLogLevel(Logger::LEVEL_ERROR);
+
+        SequenceOutput* output = new SequenceOutput("async", threadsCount);
+        Logger::AddCustomOutput(output);
+
+        // long messages are written synchronously after messages posted by the same thread before them
+        logger->EnableAsyncMode(1024, Logger::OVERFLOW_BLOCK);
+        LogFromThreads(threadsCount, messagesCount, 7);
+        logger->Flush();
+
+        TEST_VERIFY(output->received == threadsCount * messagesCount);
+        TEST_VERIFY(output->inOrder);
+
+        // threads started one after another reuse buffers of exited ones
+        output->received = 0;
+        for (uint32 i = 0; i < 10; ++i)
+        {
+            output->nextIndices[0] = 0;
+            LogFromThreads(1, 100);
+            logger->Flush();
+            TEST_VERIFY(output->nextIndices[0] == 100);
+        }
+
+        TEST_VERIFY(output->received == 1000);
+        TEST_VERIFY(output->inOrder);
+
+        logger->DisableAsyncMode();
+        Logger::RemoveCustomOutput(output);
+        delete output;
+        logger->SetLogLevel(logLevel);
+    }
+
+    DAVA_TEST (AsyncLoggerPerformanceTest)
+    {
+// used only for manual performance testing
+// change to `#if 1` to run this test
+#if 0
+        using namespace LoggerConcurrentTestDetails;
+
+        const uint32 threadsCount = 8;
+        const uint32 messagesCount = 1000000 / threadsCount;
+
+        Logger* logger = GetEngineContext()->logger;
+        Logger::eLogLevel logLevel = logger->GetLogLevel();
+        logger->SetLogLevel(Logger::LEVEL__DISABLE);
+
+        NullOutput* output = new NullOutput();
+        Logger::AddCustomOutput(output);
+
+        int64 syncTime = LogFromThreads(threadsCount, messagesCount);
+
+        const Logger::eOverflowPolicy policies[] = { Logger::OVERFLOW_BLOCK, Logger::OVERFLOW_DROP };
+        for (Logger::eOverflowPolicy policy : policies)
+        {
+            output->received = 0;
+            logger->EnableAsyncMode(64 * 1024, policy);
+            int64 asyncTime = LogFromThreads(threadsCount, messagesCount);
+            int64 flushBegin = SystemTimer::GetUs();
+            logger->Flush();
+            int64 flushTime = SystemTimer::GetUs() - flushBegin;
+            logger->DisableAsyncMode();
+
+            Logger::Info("Async logger (%s): %u threads, %u messages, logging %lld us, flush %lld us (sync %lld us), received %u",
+                         policy == Logger::OVERFLOW_BLOCK ? "block" : "drop", threadsCount, threadsCount * messagesCount,
+                         asyncTime, flushTime, syncTime, output->received.load());
+        }
+
+        Logger::RemoveCustomOutput(output);
+        delete output;
+        logger->SetLogLevel(logLevel);
+#endif
+    }
 };
\ No newline at end of file
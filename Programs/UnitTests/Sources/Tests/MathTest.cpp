@@ -1,5 +1,6 @@
 #include "DAVAEngine.h"
 #include "UnitTests/UnitTests.h"
+#include "Math/BatchMath.h"
 
 using namespace DAVA;
 
@@ -14,6 +15,51 @@ float32 SquareDist(const Matrix4& m1, const Matrix4& m2)
 
     return result;
 }
+
+Matrix4 ScalarMatrixMul(const Matrix4& a, const Matrix4& b)
+{
+    Matrix4 res;
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        for (uint32 j = 0; j < 4; ++j)
+        {
+            res._data[i][j] = a._data[i][0] * b._data[0][j] + a._data[i][1] * b._data[1][j] + a._data[i][2] * b._data[2][j] + a._data[i][3] * b._data[3][j];
+        }
+    }
+    return res;
+}
+
+Vector3 ScalarTransformPoint(const Vector3& v, const Matrix4& m)
+{
+    return Vector3(v.x * m._00 + v.y * m._10 + v.z * m._20 + m._30,
+                   v.x * m._01 + v.y * m._11 + v.z * m._21 + m._31,
+                   v.x * m._02 + v.y * m._12 + v.z * m._22 + m._32);
+}
+
+AABBox3 ScalarTransformBox(const AABBox3& box, const Matrix4& m)
+{
+    AABBox3 res(m.GetTranslationVector(), m.GetTranslationVector());
+    for (int32 i = 0; i < 3; ++i)
+    {
+        for (int32 j = 0; j < 3; ++j)
+        {
+            float32 a = m._data[j][i] * box.min.data[j];
+            float32 b = m._data[j][i] * box.max.data[j];
+            res.min.data[i] += (a < b) ? a : b;
+            res.max.data[i] += (a < b) ? b : a;
+        }
+    }
+    return res;
+}
+
+Matrix4 MakeTestMatrix(uint32 seed)
+{
+    Vector3 axis(1.0f, static_cast<float32>(seed % 7), static_cast<float32>(seed % 5) - 2.0f);
+    axis.Normalize();
+    return Matrix4::MakeScale(Vector3(1.0f + seed * 0.01f, 2.0f, 0.5f)) *
+    Matrix4::MakeRotation(axis, seed * 0.1f) *
+    Matrix4::MakeTranslation(Vector3(static_cast<float32>(seed), -3.0f, seed * 0.25f));
+}
 }
 
 DAVA_TESTCLASS (MathTest)
@@ -43,5 +89,113 @@ DAVA_TESTCLASS (MathTest)
         reconstructedMatrix.SetTranslationVector(position);
         return SquareDist(reconstructedMatrix, mat);
     }
+
+    DAVA_TEST (SIMDMatchesScalar)
+    {
+        const uint32 count = 33;
+
+        Vector<Matrix4> a, b, products(count), sharedProducts(count);
+        Vector<Vector3> points, transformedPoints(count);
+        Vector<AABBox3> boxes, transformedBoxes(count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            a.push_back(MakeTestMatrix(i));
+            b.push_back(MakeTestMatrix(i * 3 + 1));
+            points.emplace_back(i * 0.5f, 1.0f - i, i * i * 0.01f);
+            boxes.emplace_back(Vector3(-1.0f * i, 0.5f, -2.0f), Vector3(1.0f, 0.5f + i, 3.0f * i));
+        }
+        boxes[5].Empty();
+
+        BatchMath::MultiplyMatrices(a.data(), b.data(), products.data(), count);
+        BatchMath::MultiplyMatrices(a.data(), b[0], sharedProducts.data(), count);
+        BatchMath::TransformPoints(a[1], points.data(), transformedPoints.data(), count);
+        BatchMath::TransformBoxes(a[1], boxes.data(), transformedBoxes.data(), count);
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            // SIMD path keeps order of operations, so results should be bitwise equal
+            Matrix4 expected = ScalarMatrixMul(a[i], b[i]);
+            TEST_VERIFY(Memcmp(&expected, &products[i], sizeof(Matrix4)) == 0);
+            TEST_VERIFY(a[i] * b[i] == expected);
+
+            expected = ScalarMatrixMul(a[i], b[0]);
+            TEST_VERIFY(Memcmp(&expected, &sharedProducts[i], sizeof(Matrix4)) == 0);
+
+            Vector3 expectedPoint = ScalarTransformPoint(points[i], a[1]);
+            TEST_VERIFY(expectedPoint == transformedPoints[i]);
+            TEST_VERIFY(points[i] * a[1] == expectedPoint);
+
+            if (i != 5)
+            {
+                AABBox3 expectedBox = ScalarTransformBox(boxes[i], a[1]);
+                TEST_VERIFY(expectedBox.min == transformedBoxes[i].min && expectedBox.max == transformedBoxes[i].max);
+
+                AABBox3 box;
+                boxes[i].GetTransformedBox(a[1], box);
+                TEST_VERIFY(expectedBox.min == box.min && expectedBox.max == box.max);
+            }
+        }
+        TEST_VERIFY(transformedBoxes[5].IsEmpty());
+    }
+
+    DAVA_TEST (SIMDPerformance)
+    {
+// used only for manual performance testing
+// change to `#if 1` to run this test
+#if 0
+        const uint32 count = 100000;
+        const uint32 iterations = 20;
+
+        Vector<Matrix4> a, b, products(count);
+        Vector<Vector3> points(count);
+        Vector<AABBox3> boxes(count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            a.push_back(MakeTestMatrix(i % 100));
+            b.push_back(MakeTestMatrix(i % 37));
+            points[i] = Vector3(i * 0.5f, 1.0f - i, 0.01f * i);
+            boxes[i] = AABBox3(points[i], 1.0f);
+        }
+
+        int64 begin = SystemTimer::GetUs();
+        for (uint32 k = 0; k < iterations; ++k)
+            for (uint32 i = 0; i < count; ++i)
+                products[i] = ScalarMatrixMul(a[i], b[i]);
+        int64 scalarMul = SystemTimer::GetUs() - begin;
+
+        begin = SystemTimer::GetUs();
+        for (uint32 k = 0; k < iterations; ++k)
+            BatchMath::MultiplyMatrices(a.data(), b.data(), products.data(), count);
+        int64 simdMul = SystemTimer::GetUs() - begin;
+
+        Vector<Vector3> transformedPoints(count);
+        begin = SystemTimer::GetUs();
+        for (uint32 k = 0; k < iterations; ++k)
+            for (uint32 i = 0; i < count; ++i)
+                transformedPoints[i] = ScalarTransformPoint(points[i], a[k]);
+        int64 scalarPoints = SystemTimer::GetUs() - begin;
+
+        begin = SystemTimer::GetUs();
+        for (uint32 k = 0; k < iterations; ++k)
+            BatchMath::TransformPoints(a[k], points.data(), transformedPoints.data(), count);
+        int64 simdPoints = SystemTimer::GetUs() - begin;
+
+        Vector<AABBox3> transformedBoxes(count);
+        begin = SystemTimer::GetUs();
+        for (uint32 k = 0; k < iterations; ++k)
+            for (uint32 i = 0; i < count; ++i)
+                transformedBoxes[i] = ScalarTransformBox(boxes[i], a[k]);
+        int64 scalarBoxes = SystemTimer::GetUs() - begin;
+
+        begin = SystemTimer::GetUs();
+        for (uint32 k = 0; k < iterations; ++k)
+            BatchMath::TransformBoxes(a[k], boxes.data(), transformedBoxes.data(), count);
+        int64 simdBoxes = SystemTimer::GetUs() - begin;
+
+        Logger::Info("Matrix4 multiply x%u: scalar %lld us, simd %lld us", count * iterations, scalarMul, simdMul);
+        Logger::Info("Vector3 transform x%u: scalar %lld us, simd %lld us", count * iterations, scalarPoints, simdPoints);
+        Logger::Info("AABBox3 transform x%u: scalar %lld us, simd %lld us", count * iterations, scalarBoxes, simdBoxes);
+#endif
+    }
 }
 ;
@@ -0,0 +1,146 @@
+#include "UnitTests/UnitTests.h"
+
+#include "Concurrency/Thread.h"
+#include "Debug/ProfilerCPU.h"
+#include "Logger/Logger.h"
+#include "Time/SystemTimer.h"
+
+#include <sstream>
+
+using namespace DAVA;
+
+namespace ProfilerCPUTestDetails
+{
+const char* const ROOT_COUNTER = "Root";
+const char* const CHILD_COUNTER = "Child";
+const char* const WORKER_COUNTER = "Worker";
+const char* const WORKER_CHILD_COUNTER = "WorkerChild";
+
+void RunThreads(uint32 threadsCount, const Function<void(uint32)>& fn)
+{
+    Vector<Thread*> threads(threadsCount);
+    for (uint32 i = 0; i < threadsCount; ++i)
+    {
+        threads[i] = Thread::Create([i, &fn]() { fn(i); });
+        threads[i]->SetName(Format("ProfilerWorker%u", i));
+        threads[i]->Start();
+    }
+
+    for (Thread* t : threads)
+    {
+        t->Join();
+        SafeRelease(t);
+    }
+}
+
+size_t CountEvents(const Vector<TraceEvent>& trace, const char* name)
+{
+    FastName fastName(name);
+    return std::count_if(trace.begin(), trace.end(), [&fastName](const TraceEvent& e) { return e.name == fastName; });
+}
+}
+
+DAVA_TESTCLASS (ProfilerCPUTest)
+{
+    DAVA_TEST (ThreadCountersTest)
+    {
+        using namespace ProfilerCPUTestDetails;
+
+        const uint32 threadsCount = 4;
+        const uint32 countersCount = 10;
+
+        ProfilerCPU profiler(256);
+        profiler.Start();
+
+        {
+            ProfilerCPU::ScopedCounter root(ROOT_COUNTER, &profiler);
+            ProfilerCPU::ScopedCounter child(CHILD_COUNTER, &profiler);
+        }
+
+        RunThreads(threadsCount, [&profiler](uint32) {
+            for (uint32 i = 0; i < countersCount; ++i)
+            {
+                ProfilerCPU::ScopedCounter worker(WORKER_COUNTER, &profiler);
+                ProfilerCPU::ScopedCounter workerChild(WORKER_CHILD_COUNTER, &profiler);
+            }
+        });
+
+        // counter is found in its thread array while profiler is running
+        Vector<TraceEvent> rootTrace = profiler.GetTrace(ROOT_COUNTER);
+        TEST_VERIFY(CountEvents(rootTrace, ROOT_COUNTER) == 1);
+        TEST_VERIFY(CountEvents(rootTrace, CHILD_COUNTER) == 1);
+
+        Vector<TraceEvent> workerTrace = profiler.GetTrace(WORKER_COUNTER);
+        TEST_VERIFY(CountEvents(workerTrace, WORKER_COUNTER) == 1);
+        TEST_VERIFY(CountEvents(workerTrace, WORKER_CHILD_COUNTER) == 1);
+        TEST_VERIFY(CountEvents(workerTrace, ROOT_COUNTER) == 0);
+
+        profiler.Stop();
+
+        Vector<TraceEvent> trace = profiler.GetTrace();
+        TEST_VERIFY(CountEvents(trace, ROOT_COUNTER) == 1);
+        TEST_VERIFY(CountEvents(trace, WORKER_COUNTER) == threadsCount * countersCount);
+        TEST_VERIFY(CountEvents(trace, WORKER_CHILD_COUNTER) == threadsCount * countersCount);
+
+        // merged counters are ordered by start time
+        uint64 lastTimestamp = 0;
+        bool ordered = true;
+        for (const TraceEvent& e : trace)
+        {
+            if (e.phase == TraceEvent::PHASE_DURATION)
+            {
+                ordered &= (e.timestamp >= lastTimestamp);
+                lastTimestamp = e.timestamp;
+            }
+        }
+        TEST_VERIFY(ordered);
+
+        std::stringstream json;
+        TraceEvent::DumpJSON(trace, json);
+        for (uint32 i = 0; i < threadsCount; ++i)
+        {
+            TEST_VERIFY(json.str().find(Format("\"args\": { \"name\": \"ProfilerWorker%u\" }", i)) != String::npos);
+        }
+        TEST_VERIFY(json.str().find("\"ph\": \"M\", \"name\": \"thread_name\"") != String::npos);
+
+        std::stringstream dump;
+        int32 snapshot = profiler.MakeSnapshot();
+        profiler.DumpAverage(WORKER_COUNTER, countersCount, dump, snapshot);
+        TEST_VERIFY(dump.str().find(WORKER_CHILD_COUNTER) != String::npos);
+        profiler.DeleteSnapshot(snapshot);
+    }
+
+    DAVA_TEST (CounterOverheadTest)
+    {
+// used only for manual performance testing
+// change to `#if 1` to run this test
+#if 0
+        using namespace ProfilerCPUTestDetails;
+
+        const uint32 threadsCount = 8;
+        const uint32 countersCount = 1000000;
+
+        ProfilerCPU profiler;
+        auto measure = [&profiler]() {
+            int64 begin = SystemTimer::GetUs();
+            RunThreads(threadsCount, [&profiler](uint32) {
+                for (uint32 i = 0; i < countersCount; ++i)
+                {
+                    ProfilerCPU::ScopedCounter counter(WORKER_COUNTER, &profiler);
+                }
+            });
+            return SystemTimer::GetUs() - begin;
+        };
+
+        int64 stoppedTime = measure();
+
+        profiler.Start();
+        int64 startedTime = measure();
+        profiler.Stop();
+
+        Logger::Info("ProfilerCPU overhead: %u threads, %u counters per thread, stopped %lld us, started %lld us (%.1f ns per counter)",
+                     threadsCount, countersCount, stoppedTime, startedTime,
+                     (startedTime - stoppedTime) * 1000.0 / countersCount);
+#endif
+    }
+};
@@ -0,0 +1,253 @@
+#include "UnitTests/UnitTests.h"
+#include "Render/Highlevel/VisibilityQuadTree.h"
+#include "Render/Highlevel/RenderObject.h"
+#include "Render/Highlevel/Camera.h"
+
+#include <random>
+
+using namespace DAVA;
+
+DAVA_TESTCLASS (QuadTreeTest)
+{
+    DAVA_TEST (ClipMultipleMatchesClip)
+    {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float32> position(-500.0f, 500.0f);
+        std::uniform_real_distribution<float32> size(0.5f, 20.0f);
+
+        QuadTree* quadTree = new QuadTree(10);
+        Vector<RenderObject*> objects;
+        for (uint32 i = 0; i < 2000; ++i)
+        {
+            RenderObject* object = new RenderObject();
+            Vector3 min(position(rng), position(rng), position(rng) * 0.05f);
+            object->SetWorldAABBox(AABBox3(min, min + Vector3(size(rng), size(rng), size(rng))));
+            object->AddFlag(RenderObject::CLIPPING_VISIBILITY_CRITERIA);
+            if (i % 3 == 0)
+                object->AddFlag(RenderObject::VISIBLE_REFLECTION);
+
+            quadTree->AddRenderObject(object);
+            objects.push_back(object);
+        }
+        quadTree->Initialize();
+
+        Vector<Camera*> cameras;
+        for (uint32 i = 0; i < 4; ++i)
+        {
+            Camera* camera = new Camera();
+            camera->SetupPerspective(70.0f, 0.75f, 1.0f, 400.0f);
+            camera->SetPosition(Vector3(position(rng), position(rng), 50.0f));
+            camera->SetTarget(Vector3(position(rng), position(rng), 0.0f));
+            camera->SetUp(Vector3(0.0f, 0.0f, 1.0f));
+            camera->PrepareDynamicParameters(false);
+            cameras.push_back(camera);
+        }
+
+        SCOPE_EXIT
+        {
+            for (RenderObject* object : objects)
+            {
+                quadTree->RemoveRenderObject(object);
+                SafeRelease(object);
+            }
+            for (Camera* camera : cameras)
+            {
+                SafeRelease(camera);
+            }
+            SafeDelete(quadTree);
+        };
+
+        uint32 camerasCount = static_cast<uint32>(cameras.size());
+        Vector<Vector<RenderObject*>> expected(camerasCount);
+        Vector<Vector<RenderObject*>> actual(camerasCount);
+        Vector<RenderHierarchy::ClipRequest> requests(camerasCount);
+        for (uint32 i = 0; i < camerasCount; ++i)
+        {
+            uint32 criteria = RenderObject::CLIPPING_VISIBILITY_CRITERIA;
+            if (i % 2)
+                criteria |= RenderObject::VISIBLE_REFLECTION;
+
+            quadTree->Clip(cameras[i], expected[i], criteria);
+
+            requests[i].camera = cameras[i];
+            requests[i].visibilityCriteria = criteria;
+            requests[i].visibilityArray = &actual[i];
+        }
+
+        quadTree->ClipMultiple(requests);
+
+        for (uint32 i = 0; i < camerasCount; ++i)
+        {
+            TEST_VERIFY(!expected[i].empty());
+            TEST_VERIFY(expected[i] == actual[i]);
+
+            // every object passed visibility criteria and frustum test should be found exactly once
+            Frustum* frustum = cameras[i]->GetFrustum();
+            uint32 visibleCount = 0;
+            for (RenderObject* object : objects)
+            {
+                if ((object->GetFlags() & requests[i].visibilityCriteria) == requests[i].visibilityCriteria && frustum->IsInside(object->GetWorldBoundingBox()))
+                {
+                    ++visibleCount;
+                }
+            }
+            TEST_VERIFY(visibleCount == static_cast<uint32>(actual[i].size()));
+        }
+    }
+
+    DAVA_TEST (MoreThan65kNodes)
+    {
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float32> position(0.0f, 10000.0f);
+
+        QuadTree* quadTree = new QuadTree(12);
+        Vector<RenderObject*> objects;
+        for (uint32 i = 0; i < 80000; ++i)
+        {
+            RenderObject* object = new RenderObject();
+            Vector3 min(position(rng), position(rng), 0.0f);
+            object->SetWorldAABBox(AABBox3(min, min + Vector3(0.1f, 0.1f, 1.0f)));
+            object->AddFlag(RenderObject::CLIPPING_VISIBILITY_CRITERIA);
+
+            quadTree->AddRenderObject(object);
+            objects.push_back(object);
+        }
+        quadTree->Initialize();
+
+        SCOPE_EXIT
+        {
+            for (RenderObject* object : objects)
+            {
+                if (object->GetTreeNodeIndex() != QuadTree::INVALID_TREE_NODE_INDEX)
+                    quadTree->RemoveRenderObject(object);
+                SafeRelease(object);
+            }
+            SafeDelete(quadTree);
+        };
+
+        uint32 maxNodeIndex = 0;
+        for (RenderObject* object : objects)
+        {
+            maxNodeIndex = Max(maxNodeIndex, object->GetTreeNodeIndex());
+        }
+        TEST_VERIFY(maxNodeIndex > 0xFFFF);
+
+        // remove every third object and move every fifth one
+        uint32 expectedCount = 0;
+        for (uint32 i = 0; i < static_cast<uint32>(objects.size()); ++i)
+        {
+            RenderObject* object = objects[i];
+            if (i % 3 == 0)
+            {
+                quadTree->RemoveRenderObject(object);
+                continue;
+            }
+
+            if (i % 5 == 0)
+            {
+                Vector3 min(position(rng), position(rng), 0.0f);
+                object->SetWorldAABBox(AABBox3(min, min + Vector3(0.1f, 0.1f, 2.0f)));
+                quadTree->ObjectUpdated(object);
+            }
+            ++expectedCount;
+        }
+
+        quadTree->SetUpdateTimeBudget(std::numeric_limits<int64>::max());
+        quadTree->Update();
+
+        Vector<RenderObject*> found;
+        quadTree->GetAllObjectsInBBox(quadTree->GetWorldBoundingBox(), found);
+        TEST_VERIFY(found.size() == expectedCount);
+
+        for (RenderObject* object : found)
+        {
+            TEST_VERIFY((object->GetFlags() & RenderObject::TREE_NODE_NEED_UPDATE) == 0);
+        }
+    }
+
+    DAVA_TEST (RemoveDirtyObjects)
+    {
+        std::mt19937 rng(13);
+        std::uniform_real_distribution<float32> position(0.0f, 1000.0f);
+
+        QuadTree* quadTree = new QuadTree(8);
+        Vector<RenderObject*> objects;
+        for (uint32 i = 0; i < 100; ++i)
+        {
+            RenderObject* object = new RenderObject();
+            Vector3 min(position(rng), position(rng), 0.0f);
+            object->SetWorldAABBox(AABBox3(min, min + Vector3(1.0f, 1.0f, 1.0f)));
+            object->AddFlag(RenderObject::CLIPPING_VISIBILITY_CRITERIA);
+
+            quadTree->AddRenderObject(object);
+            objects.push_back(object);
+        }
+        quadTree->Initialize();
+
+        SCOPE_EXIT
+        {
+            for (RenderObject* object : objects)
+            {
+                if (object->GetTreeNodeIndex() != QuadTree::INVALID_TREE_NODE_INDEX)
+                    quadTree->RemoveRenderObject(object);
+                SafeRelease(object);
+            }
+            SafeDelete(quadTree);
+        };
+
+        auto countDirty = [&objects]() {
+            uint32 count = 0;
+            for (RenderObject* object : objects)
+            {
+                if (object->GetFlags() & RenderObject::TREE_NODE_NEED_UPDATE)
+                    ++count;
+            }
+            return count;
+        };
+
+        for (RenderObject* object : objects)
+        {
+            Vector3 min(position(rng), position(rng), 0.0f);
+            object->SetWorldAABBox(AABBox3(min, min + Vector3(1.0f, 1.0f, 1.0f)));
+            quadTree->ObjectUpdated(object);
+        }
+        TEST_VERIFY(countDirty() == 100);
+
+        // without time budget only the minimum number of objects is updated
+        quadTree->SetUpdateTimeBudget(0);
+        quadTree->Update();
+        TEST_VERIFY(countDirty() == 90);
+
+        // remove objects which are still dirty, the rest is updated on next frames
+        uint32 expectedCount = 0;
+        for (uint32 i = 0; i < static_cast<uint32>(objects.size()); ++i)
+        {
+            RenderObject* object = objects[i];
+            if (i % 4 == 0)
+            {
+                quadTree->RemoveRenderObject(object);
+                TEST_VERIFY((object->GetFlags() & RenderObject::TREE_NODE_NEED_UPDATE) == 0);
+                TEST_VERIFY(object->GetTreeDirtyIndex() == QuadTree::INVALID_TREE_DIRTY_INDEX);
+            }
+            else
+            {
+                ++expectedCount;
+            }
+        }
+
+        for (uint32 frame = 0; frame < 10 && countDirty() > 0; ++frame)
+        {
+            quadTree->Update();
+        }
+        TEST_VERIFY(countDirty() == 0);
+
+        Vector<RenderObject*> found;
+        quadTree->GetAllObjectsInBBox(quadTree->GetWorldBoundingBox(), found);
+        TEST_VERIFY(found.size() == expectedCount);
+
+        for (RenderObject* object : found)
+        {
+            TEST_VERIFY(object->GetTreeDirtyIndex() == QuadTree::INVALID_TREE_DIRTY_INDEX);
+        }
+    }
+};
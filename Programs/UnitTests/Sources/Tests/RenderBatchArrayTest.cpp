@@ -0,0 +1,259 @@
+#include "UnitTests/UnitTests.h"
+#include "Render/Highlevel/RenderBatchArray.h"
+#include "Render/Highlevel/RenderObject.h"
+#include "Render/Highlevel/Camera.h"
+#include "Render/Material/NMaterial.h"
+#include "Time/SystemTimer.h"
+#include "Logger/Logger.h"
+
+#include <random>
+
+using namespace DAVA;
+
+namespace RenderBatchArrayTestDetails
+{
+struct TestScene
+{
+    TestScene(uint32 objectsCount, uint32 materialsCount)
+        : transforms(objectsCount)
+    {
+        std::mt19937 rng(17);
+        std::uniform_real_distribution<float32> position(-1000.0f, 1000.0f);
+
+        for (uint32 i = 0; i < materialsCount; ++i)
+        {
+            ScopedPtr<NMaterial> parent(new NMaterial());
+            NMaterial* material = new NMaterial();
+            material->SetParent(parent);
+            materials.push_back(material);
+        }
+
+        for (uint32 i = 0; i < objectsCount; ++i)
+        {
+            Vector3 center(position(rng), position(rng), position(rng) * 0.1f);
+            transforms[i].BuildTranslation(center);
+
+            ScopedPtr<RenderBatch> batch(new RenderBatch());
+            batch->SetMaterial(materials[rng() % materialsCount]);
+            batch->SetSortingKey(rng() % 4);
+
+            RenderObject* object = new RenderObject();
+            object->SetWorldTransformPtr(&transforms[i]);
+            object->SetWorldAABBox(AABBox3(center, 1.0f));
+            object->AddRenderBatch(batch);
+            objects.push_back(object);
+        }
+    }
+
+    ~TestScene()
+    {
+        for (RenderObject* object : objects)
+        {
+            SafeRelease(object);
+        }
+        for (NMaterial* material : materials)
+        {
+            SafeRelease(material);
+        }
+    }
+
+    void Fill(RenderBatchArray& batchArray) const
+    {
+        batchArray.Clear();
+        for (RenderObject* object : objects)
+        {
+            batchArray.AddRenderBatch(object->GetRenderBatch(0));
+        }
+    }
+
+    Vector<Matrix4> transforms;
+    Vector<NMaterial*> materials;
+    Vector<RenderObject*> objects;
+};
+
+bool IsSorted(const RenderBatchArray& batchArray)
+{
+    for (uint32 i = 1; i < batchArray.GetRenderBatchCount(); ++i)
+    {
+        if (batchArray.Get(i - 1)->layerSortingKey < batchArray.Get(i)->layerSortingKey)
+            return false;
+    }
+    return true;
+}
+
+bool IsPermutation(const RenderBatchArray& batchArray, const TestScene& scene)
+{
+    Vector<RenderBatch*> expected;
+    for (RenderObject* object : scene.objects)
+    {
+        expected.push_back(object->GetRenderBatch(0));
+    }
+
+    Vector<RenderBatch*> actual;
+    for (uint32 i = 0; i < batchArray.GetRenderBatchCount(); ++i)
+    {
+        actual.push_back(batchArray.Get(i));
+    }
+
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+    return expected == actual;
+}
+}
+
+DAVA_TESTCLASS (RenderBatchArrayTest)
+{
+    DAVA_TEST (SortByMaterial)
+    {
+        using namespace RenderBatchArrayTestDetails;
+
+        TestScene scene(5000, 40);
+
+        Camera* camera = new Camera();
+        SCOPE_EXIT
+        {
+            SafeRelease(camera);
+        };
+        camera->SetPosition(Vector3(0.0f, 0.0f, 100.0f));
+
+        RenderBatchArray batchArray;
+        batchArray.SetSortingFlags(RenderBatchArray::SORT_ENABLED | RenderBatchArray::SORT_BY_MATERIAL);
+
+        // first sort uses radix sort, next ones start from the previous order
+        for (uint32 frame = 0; frame < 3; ++frame)
+        {
+            camera->SetPosition(Vector3(static_cast<float32>(frame) * 10.0f, 0.0f, 100.0f));
+
+            scene.Fill(batchArray);
+            batchArray.Sort(camera);
+
+            TEST_VERIFY(IsPermutation(batchArray, scene));
+            TEST_VERIFY(IsSorted(batchArray));
+        }
+
+        // order inside the same material: closer batches go first
+        for (uint32 i = 1; i < batchArray.GetRenderBatchCount(); ++i)
+        {
+            RenderBatch* a = batchArray.Get(i - 1);
+            RenderBatch* b = batchArray.Get(i);
+            if ((a->layerSortingKey >> 32) == (b->layerSortingKey >> 32))
+            {
+                float32 distanceA = (a->GetRenderObject()->GetWorldBoundingBox().GetCenter() - camera->GetPosition()).Length();
+                float32 distanceB = (b->GetRenderObject()->GetWorldBoundingBox().GetCenter() - camera->GetPosition()).Length();
+                TEST_VERIFY(static_cast<uint32>(distanceA) <= static_cast<uint32>(distanceB));
+            }
+        }
+    }
+
+    DAVA_TEST (SortByDistanceIsStable)
+    {
+        using namespace RenderBatchArrayTestDetails;
+
+        TestScene scene(3000, 8);
+
+        Camera* camera = new Camera();
+        SCOPE_EXIT
+        {
+            SafeRelease(camera);
+        };
+        camera->SetPosition(Vector3(0.0f, 0.0f, 100.0f));
+        camera->SetDirection(Vector3(0.0f, 1.0f, 0.0f));
+
+        RenderBatchArray batchArray;
+        batchArray.SetSortingFlags(RenderBatchArray::SORT_ENABLED | RenderBatchArray::SORT_BY_DISTANCE_BACK_TO_FRONT);
+
+        // first frame uses radix sort, small turns are sorted from previous order,
+        // the large one falls back to radix sort from previous order
+        const float32 angles[] = { 0.0f, 0.05f, 0.1f, PI, PI + 0.05f };
+        for (float32 angle : angles)
+        {
+            camera->SetDirection(Vector3(std::sin(angle), std::cos(angle), 0.0f));
+
+            scene.Fill(batchArray);
+            batchArray.Sort(camera);
+
+            // the same order as stable sort by key, objects behind camera have equal keys
+            Vector<RenderBatch*> expected;
+            for (RenderObject* object : scene.objects)
+            {
+                expected.push_back(object->GetRenderBatch(0));
+            }
+            std::stable_sort(expected.begin(), expected.end(), [](const RenderBatch* a, const RenderBatch* b) {
+                return a->layerSortingKey > b->layerSortingKey;
+            });
+
+            bool equal = (expected.size() == batchArray.GetRenderBatchCount());
+            for (uint32 i = 0; equal && i < batchArray.GetRenderBatchCount(); ++i)
+            {
+                equal = (expected[i] == batchArray.Get(i));
+            }
+            TEST_VERIFY(equal);
+        }
+    }
+
+    DAVA_TEST (SortPerformance)
+    {
+// used only for manual performance testing
+// change to `#if 1` to run this test
+#if 0
+        using namespace RenderBatchArrayTestDetails;
+
+        for (uint32 count : { 10000, 50000, 200000 })
+        {
+            const uint32 frames = 20;
+            TestScene scene(count, 200);
+
+            Camera* camera = new Camera();
+            SCOPE_EXIT
+            {
+                SafeRelease(camera);
+            };
+
+            RenderBatchArray batchArray;
+            batchArray.SetSortingFlags(RenderBatchArray::SORT_ENABLED | RenderBatchArray::SORT_BY_MATERIAL);
+
+            // previous implementation: std::sort with comparator reading keys through batch pointers
+            Vector<RenderBatch*> batches;
+            int64 stdSortTime = 0;
+            for (uint32 frame = 0; frame < frames; ++frame)
+            {
+                camera->SetPosition(Vector3(static_cast<float32>(frame), 0.0f, 100.0f));
+                batches.clear();
+                for (RenderObject* object : scene.objects)
+                {
+                    batches.push_back(object->GetRenderBatch(0));
+                }
+
+                int64 begin = SystemTimer::GetUs();
+                for (RenderBatch* batch : batches)
+                {
+                    batch->layerSortingKey = (batch->GetMaterial()->GetSortingKey() & 0x0FFFFFFF) | (batch->GetSortingKey() << 28);
+                }
+                std::sort(batches.begin(), batches.end(), [](const RenderBatch* a, const RenderBatch* b) {
+                    return a->layerSortingKey > b->layerSortingKey;
+                });
+                stdSortTime += SystemTimer::GetUs() - begin;
+            }
+
+            int64 firstSortTime = 0;
+            int64 coherentSortTime = 0;
+            for (uint32 frame = 0; frame < frames; ++frame)
+            {
+                camera->SetPosition(Vector3(static_cast<float32>(frame), 0.0f, 100.0f));
+                scene.Fill(batchArray);
+
+                int64 begin = SystemTimer::GetUs();
+                batchArray.Sort(camera);
+                int64 time = SystemTimer::GetUs() - begin;
+                if (frame == 0)
+                    firstSortTime = time;
+                else
+                    coherentSortTime += time;
+            }
+
+            Logger::Info("RenderBatchArray sort of %u batches: std::sort %lld us, radix %lld us, coherent %lld us",
+                         count, stdSortTime / frames, firstSortTime, coherentSortTime / (frames - 1));
+        }
+#endif
+    }
+};
@@ -2,6 +2,7 @@
 #include "UnitTests/UnitTests.h"
 
 #include "Concurrency/ThreadLocalPtr.h"
+#include "Concurrency/ThreadLocalSlots.h"
 
 using namespace DAVA;
 
@@ -34,6 +35,13 @@ ThreadLocalPtr<float> tlsFloat;
 ThreadLocalPtr<int64> tlsInt64;
 ThreadLocalPtr<TlsClass> tlsClass;
 
+struct TlsSlot
+{
+    int32 recycledCount = 0;
+};
+
+ThreadLocalSlots<TlsSlot> tlsSlots([](TlsSlot* slot) { slot->recycledCount += 1; });
+
 DAVA_TESTCLASS (ThreadLocalTest)
 {
     DAVA_TEST (ThreadLocalTestFunc)
@@ -65,6 +73,55 @@ DAVA_TESTCLASS (ThreadLocalTest)
         tlsClass.Reset();
     }
 
+    DAVA_TEST (ThreadLocalSlotsTestFunc)
+    {
+        TlsSlot* mainSlot = tlsSlots.Get();
+        TEST_VERIFY(mainSlot != nullptr);
+        TEST_VERIFY(tlsSlots.Get() == mainSlot);
+
+        // slot of exited thread is given to the next new thread
+        TlsSlot* firstSlot = nullptr;
+        RunThread([&firstSlot]() { firstSlot = tlsSlots.Get(); });
+        TEST_VERIFY(firstSlot != nullptr && firstSlot != mainSlot);
+        TEST_VERIFY(firstSlot->recycledCount == 0);
+
+        TlsSlot* secondSlot = nullptr;
+        RunThread([&secondSlot]() { secondSlot = tlsSlots.Get(); });
+        TEST_VERIFY(secondSlot == firstSlot);
+        TEST_VERIFY(secondSlot->recycledCount == 1);
+
+        // threads living at the same time get different slots
+        Semaphore started;
+        Semaphore finish;
+        TlsSlot* livingSlot = nullptr;
+        Thread* thread = Thread::Create([&]() {
+            livingSlot = tlsSlots.Get();
+            started.Post();
+            finish.Wait();
+        });
+        thread->Start();
+        started.Wait();
+
+        TlsSlot* otherSlot = nullptr;
+        RunThread([&otherSlot]() { otherSlot = tlsSlots.Get(); });
+        TEST_VERIFY(livingSlot == firstSlot);
+        TEST_VERIFY(otherSlot != livingSlot && otherSlot != mainSlot);
+
+        finish.Post();
+        thread->Join();
+        SafeRelease(thread);
+
+        TEST_VERIFY(tlsSlots.Get() == mainSlot);
+    }
+
+    void RunThread(const Thread::Procedure& proc)
+    {
+        Thread* thread = Thread::Create(proc);
+        thread->Start();
+        thread->Join();
+        SafeRelease(thread);
+    }
+
     void ThreadFunc()
     {
         // Set thread local variables in another thread
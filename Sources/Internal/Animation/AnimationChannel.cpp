@@ -1,12 +1,18 @@
 #include "AnimationChannel.h"
+#include "Animation/Private/AnimationChannelQuantization.h"
 #include "Base/BaseMath.h"
 #include "Debug/DVAssert.h"
 
+#include <algorithm>
+
 namespace DAVA
 {
 uint32 AnimationChannel::Bind(const uint8* _data)
 {
     keysData = nullptr;
+    keyTimes = nullptr;
+    keyTimesStorage.clear();
+    quantizationOffset = quantizationScale = nullptr;
     dimension = 0;
     keyStride = keysCount = 0;
 
@@ -27,65 +33,147 @@ uint32 AnimationChannel::Bind(const uint8* _data)
         keysCount = *reinterpret_cast<const uint32*>(dataptr);
         dataptr += 4;
 
-        keysData = dataptr;
+        if (compression == COMPRESSION_NONE)
+        {
+            keysData = dataptr;
+
+            keyStride = uint32(sizeof(float32)) * (dimension + 1);
+            if (interpolation == INTERPOLATION_BEZIER)
+                keyStride += uint32(sizeof(float32) * 4); //four float32 as tangents
 
-        keyStride = uint32(sizeof(float32)) * (dimension + 1);
-        if (interpolation == INTERPOLATION_BEZIER)
-            keyStride += uint32(sizeof(float32) * 4); //four float32 as tangents
+            keyTimesStorage.resize(keysCount);
+            for (uint32 k = 0; k < keysCount; ++k)
+                keyTimesStorage[k] = *reinterpret_cast<const float32*>(keysData + k * keyStride);
+            keyTimes = keyTimesStorage.data();
+
+            dataptr += keysCount * keyStride;
+        }
+        else if (compression == COMPRESSION_QUANTIZED)
+        {
+            DVASSERT(interpolation != INTERPOLATION_BEZIER && dimension <= MAX_QUANTIZED_DIMENSION);
+
+            keyTimes = reinterpret_cast<const float32*>(dataptr);
+            dataptr += keysCount * sizeof(float32);
+
+            if (interpolation == INTERPOLATION_SPHERICAL_LINEAR)
+            {
+                DVASSERT(dimension == 4); //should be quaternion
+                keyStride = uint32(sizeof(uint16)) * 3;
+            }
+            else
+            {
+                quantizationOffset = reinterpret_cast<const float32*>(dataptr);
+                dataptr += dimension * sizeof(float32);
+                quantizationScale = reinterpret_cast<const float32*>(dataptr);
+                dataptr += dimension * sizeof(float32);
+                keyStride = uint32(sizeof(uint16)) * dimension;
+            }
+
+            keysData = dataptr;
+            dataptr += (keysCount * keyStride + 3) & ~3u; //keep 4-bytes alignment of following data
+        }
+        else
+        {
+            DVASSERT(false, "Unknown animation channel compression");
+            keysCount = 0;
+            return 0;
+        }
     }
 
-    return uint32(keysData - _data) + keysCount * keyStride;
+    return uint32(dataptr - _data);
 }
 
 #define KEY_DATA_SIZE (dimension * sizeof(float32))
-#define KEY_TIME(keyIndex) (*reinterpret_cast<const float32*>(keysData + (keyIndex)*keyStride))
 #define KEY_DATA(keyIndex) (reinterpret_cast<const float32*>(keysData + (keyIndex)*keyStride + sizeof(float32)))
 #define KEY_META(keyIndex) (KEY_DATA(keyIndex) + KEY_DATA_SIZE) //tangents for bezier interpolation
 
-void AnimationChannel::Evaluate(float32 time, float32* outData, uint32 dataSize) const
+DAVA_FORCEINLINE const float32* AnimationChannel::GetKeyValue(uint32 k, float32* buffer) const
 {
-    DVASSERT(dataSize >= GetDimension());
-
-    uint32 k = startKey;
+    if (compression == COMPRESSION_NONE)
+        return KEY_DATA(k);
 
-    if (KEY_TIME(k) > time)
+    const uint16* encoded = reinterpret_cast<const uint16*>(keysData + k * keyStride);
+    if (interpolation == INTERPOLATION_SPHERICAL_LINEAR)
     {
-        k = 0;
+        AnimationChannelQuantization::DecodeSmallestThree(encoded, buffer);
     }
-
-    for (; k < keysCount; ++k)
+    else
     {
-        if (KEY_TIME(k) > time)
-            break;
+        for (uint32 d = 0; d < uint32(dimension); ++d)
+            buffer[d] = AnimationChannelQuantization::DequantizeValue(encoded[d], quantizationOffset[d], quantizationScale[d]);
+    }
+    return buffer;
+}
+
+uint32 AnimationChannel::FindKey(float32 time) const
+{
+    return uint32(std::upper_bound(keyTimes, keyTimes + keysCount, time) - keyTimes);
+}
 
-        startKey = k;
+uint32 AnimationChannel::FindKey(float32 time, uint32 cursor) const
+{
+    if (cursor > keysCount || (cursor > 0 && keyTimes[cursor - 1] > time))
+        return FindKey(time);
+
+    //time is not less than time of the key before cursor, so look forward a few keys first
+    for (uint32 i = 0; i < CURSOR_LINEAR_SEARCH_KEYS; ++i, ++cursor)
+    {
+        if (cursor == keysCount || keyTimes[cursor] > time)
+            return cursor;
     }
 
+    return uint32(std::upper_bound(keyTimes + cursor, keyTimes + keysCount, time) - keyTimes);
+}
+
+void AnimationChannel::Evaluate(float32 time, float32* outData, uint32 dataSize) const
+{
+    EvaluateKey(FindKey(time), time, outData, dataSize);
+}
+
+void AnimationChannel::Evaluate(float32 time, uint32* cursor, float32* outData, uint32 dataSize) const
+{
+    DVASSERT(cursor != nullptr);
+
+    *cursor = FindKey(time, *cursor);
+    EvaluateKey(*cursor, time, outData, dataSize);
+}
+
+void AnimationChannel::EvaluateKey(uint32 k, float32 time, float32* outData, uint32 dataSize) const
+{
+    DVASSERT(dataSize >= GetDimension());
+
+    float32 buffer0[MAX_QUANTIZED_DIMENSION];
+    float32 buffer1[MAX_QUANTIZED_DIMENSION];
+
     if (k == 0)
     {
-        Memcpy(outData, KEY_DATA(0), KEY_DATA_SIZE);
+        Memcpy(outData, GetKeyValue(0, buffer0), KEY_DATA_SIZE);
         return;
     }
 
     if (k == keysCount)
     {
-        Memcpy(outData, KEY_DATA(keysCount - 1), KEY_DATA_SIZE);
+        Memcpy(outData, GetKeyValue(keysCount - 1, buffer0), KEY_DATA_SIZE);
         return;
     }
 
     uint32 k0 = k - 1;
-    float32 time0 = KEY_TIME(k0);
-    float32 time1 = KEY_TIME(k);
+    float32 time0 = keyTimes[k0];
+    float32 time1 = keyTimes[k];
     float32 t = (time - time0) / (time1 - time0);
 
+    //quantized keys are decoded here, only two keys are needed for interpolation
+    const float32* value0 = (interpolation == INTERPOLATION_BEZIER) ? nullptr : GetKeyValue(k0, buffer0);
+    const float32* value1 = (interpolation == INTERPOLATION_BEZIER) ? nullptr : GetKeyValue(k, buffer1);
+
     switch (interpolation)
     {
     case INTERPOLATION_LINEAR:
     {
         for (uint32 d = 0; d < uint32(dimension); ++d)
         {
-            float32 v0 = *(KEY_DATA(k0) + d);
-            float32 v1 = *(KEY_DATA(k) + d);
+            float32 v0 = *(value0 + d);
+            float32 v1 = *(value1 + d);
             *(outData + d) = Lerp(v0, v1, t);
         }
     }
@@ -95,8 +183,8 @@ void AnimationChannel::Evaluate(float32 time, float32* outData, uint32 dataSize)
     {
         DVASSERT(dimension == 4); //should be quaternion
 
-        Quaternion q0(KEY_DATA(k0));
-        Quaternion q(KEY_DATA(k));
+        Quaternion q0(value0);
+        Quaternion q(value1);
         q.Slerp(q0, q, t);
         q.Normalize();
 
@@ -116,7 +204,6 @@ void AnimationChannel::Evaluate(float32 time, float32* outData, uint32 dataSize)
 }
 
 #undef KEY_DATA_SIZE
-#undef KEY_TIME
 #undef KEY_DATA
 #undef KEY_META
 }
@@ -18,16 +18,51 @@ public:
         INTERPOLATION_COUNT
     };
 
+    enum eCompression : uint16
+    {
+        COMPRESSION_NONE = 0,
+        COMPRESSION_QUANTIZED, //key times in separate array, 16-bit quantized values, smallest-three quaternions
+
+        COMPRESSION_COUNT
+    };
+
+    static const uint32 MAX_QUANTIZED_DIMENSION = 4;
+
     AnimationChannel() = default;
 
     uint32 Bind(const uint8* data);
+
+    /**
+        Evaluate channel value at `time`. Key is found with binary search over key times.
+        Channel is not modified, so it can be evaluated from several threads concurrently.
+    */
     void Evaluate(float32 time, float32* outData, uint32 dataSize) const;
 
+    /**
+        Evaluate channel value at `time` using external per-instance `cursor` as a hint.
+        Cursor should be initialized with zero, it is updated with the key found, so evaluation of monotonic
+        time sequence usually takes a few comparisons. On time jumps evaluation falls back to binary search.
+    */
+    void Evaluate(float32 time, uint32* cursor, float32* outData, uint32 dataSize) const;
+
     uint32 GetDimension() const;
 
 private:
+    // Return index of the first key with time greater than `time`, or `keysCount` if there is no such key
+    uint32 FindKey(float32 time) const;
+    uint32 FindKey(float32 time, uint32 cursor) const;
+    void EvaluateKey(uint32 key, float32 time, float32* outData, uint32 dataSize) const;
+
+    // Return pointer to value of key `k`. Quantized values are decoded to `buffer` of MAX_QUANTIZED_DIMENSION floats
+    const float32* GetKeyValue(uint32 k, float32* buffer) const;
+
+    static const uint32 CURSOR_LINEAR_SEARCH_KEYS = 4;
+
     const DAVA::uint8* keysData = nullptr;
-    mutable uint32 startKey = 0;
+    const float32* keyTimes = nullptr; // key times in contiguous array for fast search
+    Vector<float32> keyTimesStorage; // copy of key times for not compressed channels, which store times interleaved with values
+    const float32* quantizationOffset = nullptr; // value = offset + quantized * scale, for quantized linear channels
+    const float32* quantizationScale = nullptr;
     uint32 keysCount = 0;
     uint32 keyStride = 0;
     uint16 compression = 0;
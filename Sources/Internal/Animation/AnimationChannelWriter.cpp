@@ -0,0 +1,224 @@
+#include "Animation/AnimationChannelWriter.h"
+#include "Animation/Private/AnimationChannelQuantization.h"
+#include "Base/BaseMath.h"
+#include "Debug/DVAssert.h"
+
+namespace DAVA
+{
+namespace AnimationChannelWriterDetails
+{
+void Append(Vector<uint8>& buffer, const void* data, size_t size)
+{
+    const uint8* bytes = static_cast<const uint8*>(data);
+    buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+template <class T>
+void Append(Vector<uint8>& buffer, const T& value)
+{
+    Append(buffer, &value, sizeof(T));
+}
+
+// Check that every key in (first, last) is restored within tolerance by interpolation of `first` and `last` keys.
+// Error is measured against source values, interpolated keys are taken as restored by reader after quantization
+bool CanRemoveKeysBetween(uint32 first, uint32 last, uint32 dimension, AnimationChannel::eInterpolation interpolation,
+                          const Vector<float32>& times, const Vector<float32>& values, const Vector<float32>& restoredValues,
+                          const AnimationChannelWriter::Settings& settings)
+{
+    const float32* v0 = restoredValues.data() + first * dimension;
+    const float32* v1 = restoredValues.data() + last * dimension;
+    float32 duration = times[last] - times[first];
+
+    for (uint32 k = first + 1; k < last; ++k)
+    {
+        float32 t = (duration > 0.f) ? (times[k] - times[first]) / duration : 0.f;
+        const float32* v = values.data() + k * dimension;
+
+        if (interpolation == AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR)
+        {
+            Quaternion q(v1);
+            q.Slerp(Quaternion(v0), q, t);
+            q.Normalize();
+
+            float32 cosHalfAngle = Min(std::abs(q.DotProduct(Quaternion(v))), 1.f);
+            if (2.f * std::acos(cosHalfAngle) > settings.angleTolerance)
+                return false;
+        }
+        else
+        {
+            for (uint32 d = 0; d < dimension; ++d)
+            {
+                if (std::abs(Lerp(v0[d], v1[d], t) - v[d]) > settings.valueTolerance)
+                    return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// Keys reduction: every segment is extended as far as intermediate keys are restored within tolerance.
+// Segment end is found with exponential and then binary search, check of a segment is linear in its length,
+// so reduction takes O(n log n) instead of O(n^2) of extending segments key by key
+Vector<uint32> ReduceKeys(uint32 dimension, AnimationChannel::eInterpolation interpolation, const Vector<float32>& times,
+                          const Vector<float32>& values, const Vector<float32>& restoredValues, const AnimationChannelWriter::Settings& settings)
+{
+    uint32 keysCount = uint32(times.size());
+
+    Vector<uint32> keys;
+    if (keysCount == 0)
+        return keys;
+
+    auto canRemove = [&](uint32 first, uint32 last) {
+        return CanRemoveKeysBetween(first, last, dimension, interpolation, times, values, restoredValues, settings);
+    };
+
+    keys.push_back(0);
+    uint32 first = 0;
+    while (first + 1 < keysCount)
+    {
+        // `good` is a valid segment end, `bad` is not (or is out of keys)
+        uint32 good = first + 1;
+        uint32 bad = keysCount;
+        for (uint32 length = 2; first + length < keysCount; length *= 2)
+        {
+            if (!canRemove(first, first + length))
+            {
+                bad = first + length;
+                break;
+            }
+            good = first + length;
+        }
+
+        while (bad - good > 1)
+        {
+            uint32 middle = good + (bad - good) / 2;
+            if (canRemove(first, middle))
+                good = middle;
+            else
+                bad = middle;
+        }
+
+        keys.push_back(good);
+        first = good;
+    }
+
+    //constant channel: one key is enough
+    if (keys.size() == 2 && std::equal(restoredValues.begin(), restoredValues.begin() + dimension, restoredValues.begin() + keys[1] * dimension))
+    {
+        keys.pop_back();
+    }
+
+    return keys;
+}
+
+void AlignBuffer(Vector<uint8>& buffer, size_t blockStart)
+{
+    while ((buffer.size() - blockStart) & 3)
+        buffer.push_back(0);
+}
+}
+
+uint32 AnimationChannelWriter::Write(Vector<uint8>& buffer, uint8 dimension, AnimationChannel::eInterpolation interpolation,
+                                     const Vector<float32>& times, const Vector<float32>& values, const Settings& settings)
+{
+    using namespace AnimationChannelWriterDetails;
+
+    DVASSERT(interpolation == AnimationChannel::INTERPOLATION_LINEAR || interpolation == AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR);
+    DVASSERT(interpolation != AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR || dimension == 4);
+    DVASSERT(values.size() == times.size() * dimension);
+
+    uint16 compression = uint16(settings.compression);
+    if (dimension > AnimationChannel::MAX_QUANTIZED_DIMENSION)
+        compression = AnimationChannel::COMPRESSION_NONE;
+
+    //all keys are encoded before reduction, so error of reduced channel includes quantization error
+    uint32 sourceKeysCount = uint32(times.size());
+    Vector<uint16> encodedValues;
+    Vector<float32> restoredValues;
+    float32 offset[AnimationChannel::MAX_QUANTIZED_DIMENSION];
+    float32 scale[AnimationChannel::MAX_QUANTIZED_DIMENSION];
+    if (compression == AnimationChannel::COMPRESSION_NONE)
+    {
+        restoredValues = values;
+    }
+    else if (interpolation == AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR)
+    {
+        encodedValues.resize(sourceKeysCount * 3);
+        restoredValues.resize(values.size());
+        for (uint32 k = 0; k < sourceKeysCount; ++k)
+        {
+            AnimationChannelQuantization::EncodeSmallestThree(values.data() + k * 4, encodedValues.data() + k * 3);
+            AnimationChannelQuantization::DecodeSmallestThree(encodedValues.data() + k * 3, restoredValues.data() + k * 4);
+        }
+    }
+    else
+    {
+        for (uint32 d = 0; d < dimension; ++d)
+        {
+            float32 minValue = std::numeric_limits<float32>::max();
+            float32 maxValue = -std::numeric_limits<float32>::max();
+            for (uint32 k = 0; k < sourceKeysCount; ++k)
+            {
+                minValue = Min(minValue, values[k * dimension + d]);
+                maxValue = Max(maxValue, values[k * dimension + d]);
+            }
+            offset[d] = minValue;
+            scale[d] = (maxValue - minValue) / 65535.f;
+        }
+
+        encodedValues.resize(values.size());
+        restoredValues.resize(values.size());
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            uint32 d = uint32(i % dimension);
+            encodedValues[i] = AnimationChannelQuantization::QuantizeValue(values[i], offset[d], scale[d]);
+            restoredValues[i] = AnimationChannelQuantization::DequantizeValue(encodedValues[i], offset[d], scale[d]);
+        }
+    }
+
+    Vector<uint32> keys = ReduceKeys(dimension, interpolation, times, values, restoredValues, settings);
+    uint32 keysCount = uint32(keys.size());
+
+    uint32 signature = AnimationChannel::ANIMATION_CHANNEL_DATA_SIGNATURE;
+
+    size_t blockStart = buffer.size();
+    Append(buffer, signature);
+    Append(buffer, dimension);
+    Append(buffer, uint8(interpolation));
+    Append(buffer, compression);
+    Append(buffer, keysCount);
+
+    if (compression == AnimationChannel::COMPRESSION_NONE)
+    {
+        for (uint32 k : keys)
+        {
+            Append(buffer, times[k]);
+            Append(buffer, values.data() + k * dimension, dimension * sizeof(float32));
+        }
+    }
+    else
+    {
+        for (uint32 k : keys)
+            Append(buffer, times[k]);
+
+        if (interpolation == AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR)
+        {
+            for (uint32 k : keys)
+                Append(buffer, encodedValues.data() + k * 3, 3 * sizeof(uint16));
+        }
+        else
+        {
+            Append(buffer, offset, dimension * sizeof(float32));
+            Append(buffer, scale, dimension * sizeof(float32));
+
+            for (uint32 k : keys)
+                Append(buffer, encodedValues.data() + k * dimension, dimension * sizeof(uint16));
+        }
+
+        AlignBuffer(buffer, blockStart);
+    }
+
+    return keysCount;
+}
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Animation/AnimationChannel.h"
+
+namespace DAVA
+{
+/**
+    Serializes animation channel data in format readable by `AnimationChannel::Bind` (see 'AnimationBinaryFormat.md').
+    Used by importers to produce animation clips.
+*/
+class AnimationChannelWriter
+{
+public:
+    struct Settings
+    {
+        AnimationChannel::eCompression compression = AnimationChannel::COMPRESSION_QUANTIZED;
+        float32 valueTolerance = 0.0005f; // max absolute error of linear channel component introduced by keys reduction
+        float32 angleTolerance = 0.001f; // max angle (in radians) error of quaternion channel introduced by keys reduction
+    };
+
+    /**
+        Append channel block to `buffer`. `values` contains `dimension` floats per key, `times` should be sorted.
+        Keys which can be restored by interpolation of neighbours within tolerance are removed.
+        Only linear and spherical linear interpolations are supported.
+        Return number of written keys.
+    */
+    static uint32 Write(Vector<uint8>& buffer, uint8 dimension, AnimationChannel::eInterpolation interpolation,
+                        const Vector<float32>& times, const Vector<float32>& values, const Settings& settings);
+};
+}
@@ -47,6 +47,12 @@ void AnimationTrack::Evaluate(float32 time, uint32 channel, float32* outData, ui
     channels[channel].channel.Evaluate(time, outData, dataSize);
 }
 
+void AnimationTrack::Evaluate(float32 time, uint32 channel, uint32* cursor, float32* outData, uint32 dataSize) const
+{
+    DVASSERT(channel < GetChannelsCount());
+    channels[channel].channel.Evaluate(time, cursor, outData, dataSize);
+}
+
 uint32 AnimationTrack::GetChannelsCount() const
 {
     return uint32(channels.size());
@@ -19,7 +19,11 @@ public:
     };
 
     uint32 Bind(const uint8* data);
+
+    /** Evaluate value of `channel` at `time`, see `AnimationChannel::Evaluate`. Thread-safe. */
     void Evaluate(float32 time, uint32 channel, float32* outData, uint32 dataSize) const;
+    /** Evaluate value of `channel` at `time` using per-instance key cursor of this channel as a hint. */
+    void Evaluate(float32 time, uint32 channel, uint32* cursor, float32* outData, uint32 dataSize) const;
 
     uint32 GetChannelsCount() const;
     eChannelTarget GetChannelTarget(uint32 channel) const;
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Base/BaseMath.h"
+
+namespace DAVA
+{
+/**
+    Key values encoding of quantized animation channels (see 'AnimationBinaryFormat.md').
+    Shared by `AnimationChannel` and `AnimationChannelWriter`, so keys reduction measures error on exactly the values restored at runtime.
+*/
+namespace AnimationChannelQuantization
+{
+const float32 SMALLEST_THREE_RANGE = 0.70710678f; // components except largest one are in [-1/sqrt(2), 1/sqrt(2)]
+const float32 SMALLEST_THREE_SCALE = 2.f * SMALLEST_THREE_RANGE / 32767.f;
+
+// Components stored for every index of omitted one
+const uint8 SMALLEST_THREE_COMPONENTS[4][3] = { { 1, 2, 3 }, { 0, 2, 3 }, { 0, 1, 3 }, { 0, 1, 2 } };
+
+// Smallest-three quaternion: three 15-bit components, index of omitted (largest) component in high bits of first two
+inline void EncodeSmallestThree(const float32* quaternion, uint16* outEncoded)
+{
+    Quaternion q(quaternion);
+    q.Normalize();
+
+    uint32 largestIndex = 0;
+    for (uint32 c = 1; c < 4; ++c)
+    {
+        if (std::abs(q.data[c]) > std::abs(q.data[largestIndex]))
+            largestIndex = c;
+    }
+
+    //q and -q are the same rotation, make omitted component positive
+    float32 sign = (q.data[largestIndex] < 0.f) ? -1.f : 1.f;
+
+    const uint8* components = SMALLEST_THREE_COMPONENTS[largestIndex];
+    for (uint32 i = 0; i < 3; ++i)
+    {
+        float32 normalized = Clamp(sign * q.data[components[i]] / SMALLEST_THREE_RANGE, -1.f, 1.f);
+        outEncoded[i] = uint16(std::floor((normalized + 1.f) * 0.5f * 32767.f + 0.5f));
+    }
+
+    outEncoded[0] |= uint16((largestIndex >> 1) << 15);
+    outEncoded[1] |= uint16((largestIndex & 1) << 15);
+}
+
+// Decoded twice per channel evaluation, so it is branchless and multiplies instead of dividing
+DAVA_FORCEINLINE void DecodeSmallestThree(const uint16* encoded, float32* outQuaternion)
+{
+    uint32 largestIndex = ((encoded[0] >> 15) << 1) | (encoded[1] >> 15);
+    const uint8* components = SMALLEST_THREE_COMPONENTS[largestIndex];
+
+    float32 a = float32(encoded[0] & 0x7FFF) * SMALLEST_THREE_SCALE - SMALLEST_THREE_RANGE;
+    float32 b = float32(encoded[1] & 0x7FFF) * SMALLEST_THREE_SCALE - SMALLEST_THREE_RANGE;
+    float32 c = float32(encoded[2]) * SMALLEST_THREE_SCALE - SMALLEST_THREE_RANGE;
+
+    outQuaternion[components[0]] = a;
+    outQuaternion[components[1]] = b;
+    outQuaternion[components[2]] = c;
+    outQuaternion[largestIndex] = std::sqrt(Max(0.f, 1.f - (a * a + b * b + c * c)));
+}
+
+// Linear channel component: value = offset + quantized * scale
+inline uint16 QuantizeValue(float32 value, float32 offset, float32 scale)
+{
+    float32 normalized = (scale > 0.f) ? (value - offset) / scale : 0.f;
+    return uint16(Clamp(std::floor(normalized + 0.5f), 0.f, 65535.f));
+}
+
+DAVA_FORCEINLINE float32 DequantizeValue(uint16 quantized, float32 offset, float32 scale)
+{
+    return offset + float32(quantized) * scale;
+}
+} // namespace AnimationChannelQuantization
+} // namespace DAVA
@@ -2,9 +2,58 @@
 #include "Debug/DVAssert.h"
 
 #include "Concurrency/LockGuard.h"
+#include "Concurrency/ThreadLocalSlots.h"
 
 namespace DAVA
 {
+namespace FastNameDetails
+{
+/**
+    Per-thread direct-mapped cache of recently constructed names.
+    Hot names are resolved without touching any db shard.
+*/
+struct ThreadCache
+{
+    static const size_t SIZE = 256;
+
+    struct Entry
+    {
+        size_t hash = 0;
+        size_t length = 0;
+        const FastNameDB::CharT* str = nullptr;
+    };
+
+    const FastNameDB* db = nullptr;
+    Array<Entry, SIZE> entries;
+};
+
+// cache of exited thread is reused by a new one, its entries stay valid
+ThreadCache* GetThreadCache()
+{
+    static ThreadLocalSlots<ThreadCache> threadCaches;
+    return threadCaches.Get();
+}
+} // namespace FastNameDetails
+
+FastNameDB::FastNameDB()
+{
+    for (Shard& shard : shards)
+    {
+        shard.names.reserve(256);
+    }
+}
+
+FastNameDB::~FastNameDB()
+{
+    for (Shard& shard : shards)
+    {
+        for (CharT* block : shard.arenaBlocks)
+        {
+            SafeDeleteArray(block);
+        }
+    }
+}
+
 FastNameDB* FastNameDB::GetLocalDB()
 {
     return *GetLocalDBPtr();
@@ -29,37 +78,88 @@ void FastNameDB::SetMasterDB(FastNameDB* db)
     *localDBPtr = db;
 }
 
+size_t FastNameDB::HashName(const CharT* name, size_t& length)
+{
+    // FNV-1a
+    uint64 hash = 14695981039346656037ULL;
+    const CharT* s = name;
+    for (; *s; ++s)
+    {
+        hash = (hash ^ static_cast<uint8>(*s)) * 1099511628211ULL;
+    }
+    length = static_cast<size_t>(s - name);
+    return static_cast<size_t>(hash ^ (hash >> 32));
+}
+
+const FastNameDB::CharT* FastNameDB::Intern(const CharT* name, size_t length, size_t hash)
+{
+    // high bits select shard, low bits are left for hash table buckets
+    Shard& shard = shards[hash >> (sizeof(size_t) * 8 - SHARD_BITS)];
+    LockGuard<MutexT> guard(shard.mutex);
+
+    auto it = shard.names.find(NameKey{ name, length, hash });
+    if (it != shard.names.end())
+    {
+        return it->str;
+    }
+
+    CharT* nameCopy = AllocateName(shard, length + 1);
+    memcpy(nameCopy, name, (length + 1) * sizeof(CharT));
+    shard.names.insert(NameKey{ nameCopy, length, hash });
+    return nameCopy;
+}
+
+FastNameDB::CharT* FastNameDB::AllocateName(Shard& shard, size_t count)
+{
+    if (count > shard.arenaSpace)
+    {
+        // long names get their own block to keep free space of current one
+        if (count > ARENA_BLOCK_SIZE / 4)
+        {
+            CharT* block = new CharT[count];
+            shard.arenaBlocks.push_back(block);
+            return block;
+        }
+
+        shard.arenaCursor = new CharT[ARENA_BLOCK_SIZE];
+        shard.arenaSpace = ARENA_BLOCK_SIZE;
+        shard.arenaBlocks.push_back(shard.arenaCursor);
+    }
+
+    CharT* result = shard.arenaCursor;
+    shard.arenaCursor += count;
+    shard.arenaSpace -= count;
+    return result;
+}
+
 void FastName::Init(const char* name)
 {
     DVASSERT(nullptr != name);
 
+    size_t length = 0;
+    size_t hash = FastNameDB::HashName(name, length);
+
     FastNameDB* db = FastNameDB::GetLocalDB();
-    LockGuard<FastNameDB::MutexT> guard(db->mutex);
+    FastNameDetails::ThreadCache* cache = FastNameDetails::GetThreadCache();
+    if (cache->db != db)
+    {
+        // names cached before master db was set belong to another db
+        cache->entries.fill(FastNameDetails::ThreadCache::Entry());
+        cache->db = db;
+    }
 
-    // search if that name is already in hash
-    auto it = db->nameToIndexMap.find(name);
-    if (it != db->nameToIndexMap.end())
+    FastNameDetails::ThreadCache::Entry& entry = cache->entries[hash & (FastNameDetails::ThreadCache::SIZE - 1)];
+    if (entry.hash == hash && entry.length == length && nullptr != entry.str && (0 == memcmp(entry.str, name, length * sizeof(char))))
     {
-        // already exist, so we just need to set the same index to this object
-        str = db->namesTable[it->second];
+        str = entry.str;
     }
     else
     {
-        // string isn't in hash and it isn't in names table, so we need to copy it
-        // and find place for copied string in names table and set it
-        size_t nameLen = strlen(name);
-        FastNameDB::CharT* nameCopy = new FastNameDB::CharT[nameLen + 1];
-        memcpy(nameCopy, name, nameLen + 1);
-
-        db->sizeOfNames += (nameLen * sizeof(FastNameDB::CharT));
-
-        // index will be a new row in names table
-        size_t index = db->namesTable.size();
-
-        db->namesTable.push_back(nameCopy);
-        db->nameToIndexMap.emplace(nameCopy, index);
+        str = db->Intern(name, length, hash);
 
-        str = nameCopy;
+        entry.hash = hash;
+        entry.length = length;
+        entry.str = str;
     }
 }
 
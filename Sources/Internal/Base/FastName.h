@@ -19,44 +19,59 @@ public:
     void SetMasterDB(FastNameDB* masterDB);
 
 private:
-    FastNameDB()
-        : nameToIndexMap(8192 * 2)
+    /**
+        Names are spread by hash over independently locked shards, so threads interning
+        different names rarely meet on the same lock. Copies of names are placed into
+        per-shard arena blocks which are never moved or freed until db destruction.
+    */
+    static const size_t SHARD_BITS = 6;
+    static const size_t SHARDS_COUNT = size_t(1) << SHARD_BITS;
+    static const size_t ARENA_BLOCK_SIZE = 4096;
+
+    struct NameKey
     {
-        namesTable.reserve(512);
-    }
+        const CharT* str;
+        size_t length;
+        size_t hash;
+    };
 
-    ~FastNameDB()
+    struct NameKeyHash
     {
-        const size_t count = namesTable.size();
-        for (size_t i = 0; i < count; ++i)
+        size_t operator()(const NameKey& key) const
         {
-            SafeDeleteArray(namesTable[i]);
+            return key.hash;
         }
-    }
-
-    static FastNameDB** GetLocalDBPtr();
+    };
 
-    struct FastNameDBHash
+    struct NameKeyEqualTo
     {
-        size_t operator()(const char* str) const
+        bool operator()(const NameKey& left, const NameKey& right) const
         {
-            return DavaHashString(str);
+            return left.hash == right.hash && left.length == right.length && (0 == memcmp(left.str, right.str, left.length * sizeof(CharT)));
         }
     };
 
-    struct FastNameDBEqualTo
+    struct alignas(64) Shard
     {
-        bool operator()(const char* left, const char* right) const
-        {
-            return (0 == strcmp(left, right));
-        }
+        MutexT mutex;
+        UnorderedSet<NameKey, NameKeyHash, NameKeyEqualTo> names;
+        Vector<CharT*> arenaBlocks;
+        CharT* arenaCursor = nullptr;
+        size_t arenaSpace = 0;
     };
 
-    Vector<const CharT*> namesTable;
-    UnorderedMap<const CharT*, size_t, FastNameDBHash, FastNameDBEqualTo> nameToIndexMap;
+    FastNameDB();
+    ~FastNameDB();
+
+    static FastNameDB** GetLocalDBPtr();
+
+    /** Calculate hash of null-terminated `name` and its length in a single pass. */
+    static size_t HashName(const CharT* name, size_t& length);
+
+    const CharT* Intern(const CharT* name, size_t length, size_t hash);
+    CharT* AllocateName(Shard& shard, size_t count);
 
-    MutexT mutex;
-    size_t sizeOfNames = 0;
+    Array<Shard, SHARDS_COUNT> shards;
 };
 
 class FastName
@@ -102,4 +102,84 @@ void RadixSortImpl(intptr_t* array, int offset, int end, int shift)
         }
     }
 }
+
+void RadixSortEntries(RadixSortEntry* entries, RadixSortEntry* temp, uint32 count)
+{
+    const uint32 DIGITS_COUNT = sizeof(uint64);
+
+    uint32 histograms[DIGITS_COUNT][256] = {};
+    for (uint32 i = 0; i < count; ++i)
+    {
+        uint64 key = entries[i].key;
+        for (uint32 d = 0; d < DIGITS_COUNT; ++d)
+        {
+            ++histograms[d][(key >> (d * 8)) & 0xFF];
+        }
+    }
+
+    RadixSortEntry* src = entries;
+    RadixSortEntry* dst = temp;
+    for (uint32 d = 0; d < DIGITS_COUNT; ++d)
+    {
+        uint32* histogram = histograms[d];
+        uint32 shift = d * 8;
+
+        // all keys have the same digit, pass would not change the order
+        if (count == 0 || histogram[(src[0].key >> shift) & 0xFF] == count)
+            continue;
+
+        uint32 offset = 0;
+        for (uint32 x = 0; x < 256; ++x)
+        {
+            uint32 digitCount = histogram[x];
+            histogram[x] = offset;
+            offset += digitCount;
+        }
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+        }
+
+        std::swap(src, dst);
+    }
+
+    if (src != entries)
+    {
+        std::copy(src, src + count, entries);
+    }
+}
+
+namespace RadixDetails
+{
+inline bool IsEntryGreater(const RadixSortEntry& a, const RadixSortEntry& b)
+{
+    return (a.key > b.key) || (a.key == b.key && a.value > b.value);
+}
+}
+
+bool InsertionSortEntries(RadixSortEntry* entries, uint32 count, uint32 maxMoves)
+{
+    using namespace RadixDetails;
+
+    uint32 moves = 0;
+    for (uint32 x = 1; x < count; ++x)
+    {
+        if (!IsEntryGreater(entries[x - 1], entries[x]))
+            continue;
+
+        RadixSortEntry entry = entries[x];
+        uint32 y = x;
+        for (; y > 0 && IsEntryGreater(entries[y - 1], entry); --y)
+        {
+            entries[y] = entries[y - 1];
+        }
+        entries[y] = entry;
+
+        moves += x - y;
+        if (moves > maxMoves)
+            return false;
+    }
+    return true;
+}
 }
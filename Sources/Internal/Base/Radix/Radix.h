@@ -40,6 +40,31 @@ inline void RadixSort(void* array, int offset, int end, int shift)
 
     RadixSortImpl(static_cast<intptr_t*>(array), offset, end, shift);
 }
+
+/**
+    Pair of 64-bit sorting key and 32-bit payload (usually an index into the array being sorted).
+*/
+struct RadixSortEntry
+{
+    uint64 key;
+    uint32 value;
+};
+
+/**
+    Stable LSD radix sort of `count` entries by key in ascending order.
+    `temp` should point to a buffer of at least `count` entries, its content is undefined after the call.
+    Byte passes where all keys have the same digit are skipped, so keys with unused bits are sorted faster.
+*/
+void RadixSortEntries(RadixSortEntry* entries, RadixSortEntry* temp, uint32 count);
+
+/**
+    Insertion sort of `count` entries by key in ascending order, which gives up after `maxMoves` element moves.
+    Entries with equal keys are ordered by value, so result does not depend on initial order of entries and
+    matches `RadixSortEntries` of entries which are initially ordered by value.
+    Return true if entries are sorted. On failure entries are left in some permutation of the input.
+    Useful for nearly sorted input, e.g. when order of the previous frame is used as a starting point.
+*/
+bool InsertionSortEntries(RadixSortEntry* entries, uint32 count, uint32 maxMoves);
 };
 
 #endif // __DAVAENGINE_BASE_RADIX_RADIX__
\ No newline at end of file
@@ -40,6 +40,22 @@ bool LZ4Compressor::Decompress(const Vector<uint8>& in, Vector<uint8>& out) cons
     return true;
 }
 
+bool LZ4Compressor::Decompress(const uint8* in, uint32 inSize, uint8* out, uint32 outSize) const
+{
+    if (inSize > static_cast<uint32>(std::numeric_limits<int32>::max()) || outSize > static_cast<uint32>(std::numeric_limits<int32>::max()))
+    {
+        Logger::Error("LZ4 decompress failed too big buffer");
+        return false;
+    }
+    int32 decompressResult = LZ4_decompress_safe(reinterpret_cast<const char*>(in), reinterpret_cast<char*>(out), static_cast<int32>(inSize), static_cast<int32>(outSize));
+    if (decompressResult < 0 || static_cast<uint32>(decompressResult) != outSize)
+    {
+        Logger::Error("LZ4 decompress failed");
+        return false;
+    }
+    return true;
+}
+
 bool LZ4HCCompressor::Compress(const Vector<uint8>& in, Vector<uint8>& out) const
 {
     if (in.size() > LZ4_MAX_INPUT_SIZE)
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <cassert>
+#include <memory>
+
+#include "Base/BaseTypes.h"
+#include "Base/Platform.h"
+#include "Concurrency/LockGuard.h"
+#include "Concurrency/Mutex.h"
+
+namespace DAVA
+{
+/*
+    template class ThreadLocalSlots - per-thread objects of type T which are owned by ThreadLocalSlots instead of threads.
+
+    Object of current thread is default constructed on first Get() call. When thread exits its object is not destroyed
+    but returned to ThreadLocalSlots and handed as is to the next thread which calls Get() for the first time.
+    So count of objects is bounded by count of simultaneously living threads, and objects may safely be referenced
+    by other threads (e.g. consumers of per-thread buffers) until ThreadLocalSlots is destroyed.
+    Users which keep thread specific data in objects (thread id, thread name) can pass `recycler` function, it is called
+    on new thread before recycled object is returned from Get().
+
+    Thread exit is detected by pthread key destructor on POSIX platforms and by fiber local storage callback on Windows,
+    so it works for any thread, not only for DAVA::Thread.
+
+    Restrictions:
+        like ThreadLocalPtr, ThreadLocalSlots can have only static storage duration
+*/
+template <typename T>
+class ThreadLocalSlots final
+{
+public:
+    ThreadLocalSlots() DAVA_NOEXCEPT;
+    ThreadLocalSlots(void (*recycler_)(T*)) DAVA_NOEXCEPT;
+    ~ThreadLocalSlots() DAVA_NOEXCEPT;
+
+    /** Object of calling thread, never nullptr. */
+    T* Get();
+
+private:
+    ThreadLocalSlots(const ThreadLocalSlots&) = delete;
+    ThreadLocalSlots& operator=(const ThreadLocalSlots&) = delete;
+
+    struct Slot
+    {
+        T object;
+        ThreadLocalSlots* owner = nullptr;
+    };
+
+    T* AcquireSlot();
+    void RecycleSlot(Slot* slot) DAVA_NOEXCEPT;
+
+    // Platform specific methods
+    void CreateTlsKey() DAVA_NOEXCEPT;
+    void DeleteTlsKey() const DAVA_NOEXCEPT;
+    void SetTlsValue(void* rawValue) const DAVA_NOEXCEPT;
+    void* GetTlsValue() const DAVA_NOEXCEPT;
+
+#if defined(__DAVAENGINE_WINDOWS__)
+    static void WINAPI OnThreadExit(void* rawValue) DAVA_NOEXCEPT;
+    using KeyType = DWORD;
+#elif defined(__DAVAENGINE_POSIX__)
+    static void OnThreadExit(void* rawValue) DAVA_NOEXCEPT;
+    using KeyType = pthread_key_t;
+#else
+#error "ThreadLocalSlots: platform is unknown"
+#endif
+
+    KeyType key;
+    bool isCreated = false;
+    void (*recycler)(T*) = nullptr;
+    Mutex mutex;
+    Vector<std::unique_ptr<Slot>> slots;
+    Vector<Slot*> freeSlots;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+inline ThreadLocalSlots<T>::ThreadLocalSlots() DAVA_NOEXCEPT
+{
+    CreateTlsKey();
+}
+
+template <typename T>
+inline ThreadLocalSlots<T>::ThreadLocalSlots(void (*recycler_)(T*)) DAVA_NOEXCEPT
+    : recycler(recycler_)
+{
+    CreateTlsKey();
+}
+
+template <typename T>
+inline ThreadLocalSlots<T>::~ThreadLocalSlots() DAVA_NOEXCEPT
+{
+    // slots of threads which exit after this point are not recycled, all slots are released with members
+    DeleteTlsKey();
+}
+
+template <typename T>
+inline T* ThreadLocalSlots<T>::Get()
+{
+    Slot* slot = static_cast<Slot*>(GetTlsValue());
+    return (slot != nullptr) ? &slot->object : AcquireSlot();
+}
+
+template <typename T>
+T* ThreadLocalSlots<T>::AcquireSlot()
+{
+    Slot* slot = nullptr;
+    bool recycled = false;
+    {
+        LockGuard<Mutex> guard(mutex);
+        if (!freeSlots.empty())
+        {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+            recycled = true;
+        }
+        else
+        {
+            slot = new Slot();
+            slot->owner = this;
+            slots.emplace_back(slot);
+        }
+    }
+
+    if (recycled && recycler != nullptr)
+    {
+        recycler(&slot->object);
+    }
+
+    SetTlsValue(slot);
+    return &slot->object;
+}
+
+template <typename T>
+void ThreadLocalSlots<T>::RecycleSlot(Slot* slot) DAVA_NOEXCEPT
+{
+    LockGuard<Mutex> guard(mutex);
+    freeSlots.push_back(slot);
+}
+
+template <typename T>
+void ThreadLocalSlots<T>::OnThreadExit(void* rawValue) DAVA_NOEXCEPT
+{
+    if (rawValue != nullptr)
+    {
+        Slot* slot = static_cast<Slot*>(rawValue);
+        slot->owner->RecycleSlot(slot);
+    }
+}
+
+// Windows implementation
+#if defined(__DAVAENGINE_WINDOWS__)
+
+template <typename T>
+inline void ThreadLocalSlots<T>::CreateTlsKey() DAVA_NOEXCEPT
+{
+    key = FlsAlloc(&OnThreadExit);
+    isCreated = (key != FLS_OUT_OF_INDEXES);
+    assert(isCreated);
+}
+
+template <typename T>
+inline void ThreadLocalSlots<T>::DeleteTlsKey() const DAVA_NOEXCEPT
+{
+    FlsFree(key);
+}
+
+template <typename T>
+inline void ThreadLocalSlots<T>::SetTlsValue(void* rawValue) const DAVA_NOEXCEPT
+{
+    FlsSetValue(key, rawValue);
+}
+
+template <typename T>
+inline void* ThreadLocalSlots<T>::GetTlsValue() const DAVA_NOEXCEPT
+{
+    return FlsGetValue(key);
+}
+
+// POSIX implementation
+#elif defined(__DAVAENGINE_POSIX__)
+
+template <typename T>
+inline void ThreadLocalSlots<T>::CreateTlsKey() DAVA_NOEXCEPT
+{
+    isCreated = (0 == pthread_key_create(&key, &OnThreadExit));
+    assert(isCreated);
+}
+
+template <typename T>
+inline void ThreadLocalSlots<T>::DeleteTlsKey() const DAVA_NOEXCEPT
+{
+    pthread_key_delete(key);
+}
+
+template <typename T>
+inline void ThreadLocalSlots<T>::SetTlsValue(void* rawValue) const DAVA_NOEXCEPT
+{
+    pthread_setspecific(key, rawValue);
+}
+
+template <typename T>
+inline void* ThreadLocalSlots<T>::GetTlsValue() const DAVA_NOEXCEPT
+{
+    return pthread_getspecific(key);
+}
+
+#endif
+
+} // namespace DAVA
@@ -53,6 +53,12 @@ void DebugOverlayItemRenderStats::Draw()
             AddUIntStat("Packets", stats.packets2d);
         }
 
+        if (ImGui::CollapsingHeader("Skeletons"))
+        {
+            AddUIntStat("Updated Skeletons", stats.updatedSkeletons);
+            AddUIntStat("Updated Joints", stats.updatedJoints);
+        }
+
         if (ImGui::CollapsingHeader("Fragments Info"))
         {
             for (uint32 i = 0; i < uint32(VisibilityQueryResults::QUERY_INDEX_COUNT); ++i)
@@ -1,10 +1,13 @@
 #include "Debug/ProfilerCPU.h"
 #include "Time/SystemTimer.h"
 #include "Concurrency/Thread.h"
+#include "Concurrency/ThreadLocalSlots.h"
 #include "Concurrency/LockGuard.h"
 #include "Base/AllocatorFactory.h"
 #include "Debug/DVAssert.h"
 #include "ProfilerRingArray.h"
+#include <algorithm>
+#include <atomic>
 #include <ostream>
 
 //==============================================================================
@@ -31,6 +34,26 @@ struct ProfilerCPU::Counter
     uint32 frame = 0;
 };
 
+struct ProfilerCPU::ThreadCounters
+{
+    ThreadCounters(uint32 numCounters, uint64 threadID_, const String& threadName_)
+        : counters(numCounters)
+        , threadID(threadID_)
+        , threadName(threadName_)
+    {
+    }
+
+    CounterArray counters; // written only by owner thread
+    const uint64 threadID;
+    const String threadName;
+};
+
+struct ProfilerCPU::Snapshot
+{
+    std::unique_ptr<CounterArray> counters; // counters of all threads sorted by start time
+    Vector<std::pair<uint64, String>> threadNames;
+};
+
 namespace ProfilerCPUDetails
 {
 struct CounterTreeNode
@@ -68,6 +91,74 @@ bool NameEquals(const char* name1, const char* name2)
     return name1 == name2;
 #endif
 }
+
+// Counters arrays of current thread for every profiler used by this thread
+struct ThreadSlot
+{
+    uint64 lastProfilerID = 0;
+    void* lastCounters = nullptr;
+    Vector<std::pair<uint64, void*>> counters;
+};
+
+// arrays are bound to thread id and name, so slot of exited thread is reused without them
+void ResetThreadSlot(ThreadSlot* slot)
+{
+    slot->lastProfilerID = 0;
+    slot->lastCounters = nullptr;
+    slot->counters.clear();
+}
+
+ThreadSlot* GetThreadSlot()
+{
+    static ThreadLocalSlots<ThreadSlot> threadSlots(&ResetThreadSlot);
+    return threadSlots.Get();
+}
+
+// ids are never reused, so slot entries of destroyed profiler are never matched
+std::atomic<uint64> nextProfilerID{ 1 };
+
+bool FindLastCounter(const ProfilerCPU::CounterArray* array, const char* counterName, uint32 desiredFrameIndex, ProfilerCPU::CounterArray::const_reverse_iterator& result)
+{
+    ProfilerCPU::CounterArray::const_reverse_iterator rit = array->rbegin();
+    ProfilerCPU::CounterArray::const_reverse_iterator rend = array->rend();
+    for (; rit != rend; ++rit)
+    {
+        if (rit->endTime != 0 && (strcmp(counterName, rit->name) == 0))
+        {
+            if ((rit->frame <= desiredFrameIndex || rit->frame == 0 || desiredFrameIndex == 0))
+            {
+                result = rit;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void AppendCounterTrace(const ProfilerCPU::CounterArray* array, ProfilerCPU::CounterArray::const_iterator it, Vector<TraceEvent>& trace)
+{
+    ProfilerCPU::CounterArray::const_iterator end = array->end();
+
+    uint64 threadID = it->threadID;
+    uint64 counterEndTime = it->endTime;
+    for (; it != end; ++it)
+    {
+        if (it->threadID == threadID)
+        {
+            if (it->endTime == 0 || it->startTime > counterEndTime)
+            {
+                break;
+            }
+
+            trace.push_back({ FastName(it->name), it->startTime, it->endTime - it->startTime, it->threadID, 0, TraceEvent::PHASE_DURATION });
+
+            if (it->frame)
+            {
+                trace.back().args.push_back({ ProfilerCPU::TRACE_ARG_FRAME, it->frame });
+            }
+        }
+    }
+}
 }
 
 const FastName ProfilerCPU::TRACE_ARG_FRAME("Frame Number");
@@ -79,13 +170,14 @@ ProfilerCPU::ScopedCounter::ScopedCounter(const char* counterName, ProfilerCPU*
     profiler = _profiler;
     if (profiler->isStarted)
     {
-        Counter& c = profiler->counters->next();
+        ThreadCounters* threadCounters = profiler->GetThreadCounters();
+        Counter& c = threadCounters->counters.next_single_writer();
 
         endTime = &c.endTime;
         c.startTime = SystemTimer::GetUs();
         c.endTime = 0;
         c.name = counterName;
-        c.threadID = Thread::GetCurrentIdAsUInt64();
+        c.threadID = threadCounters->threadID;
         c.frame = frame;
     }
 }
@@ -104,14 +196,14 @@ ProfilerCPU::ScopedCounter::~ScopedCounter()
 }
 
 ProfilerCPU::ProfilerCPU(uint32 numCounters_)
-    : numCounters(numCounters_)
+    : profilerID(ProfilerCPUDetails::nextProfilerID++)
+    , numCounters(numCounters_)
 {
 }
 
 ProfilerCPU::~ProfilerCPU()
 {
     DeleteSnapshots();
-    SafeDelete(counters);
 }
 
 void ProfilerCPU::Start()
@@ -119,10 +211,7 @@ void ProfilerCPU::Start()
     LockGuard<Mutex> lock(mutex);
     if (isStarted == false)
     {
-        if (counters == nullptr)
-        {
-            counters = new CounterArray(numCounters);
-        }
+        mergedCounters.reset();
         isStarted = true;
     }
 }
@@ -138,6 +227,92 @@ bool ProfilerCPU::IsStarted() const
     return isStarted;
 }
 
+ProfilerCPU::ThreadCounters* ProfilerCPU::GetThreadCounters()
+{
+    ProfilerCPUDetails::ThreadSlot* slot = ProfilerCPUDetails::GetThreadSlot();
+    if (slot->lastProfilerID != profilerID)
+    {
+        uint64 id = profilerID;
+        auto found = std::find_if(slot->counters.begin(), slot->counters.end(), [id](const std::pair<uint64, void*>& p) {
+            return (p.first == id);
+        });
+
+        if (found != slot->counters.end())
+        {
+            slot->lastCounters = found->second;
+        }
+        else
+        {
+            slot->lastCounters = CreateThreadCounters();
+            slot->counters.emplace_back(profilerID, slot->lastCounters);
+        }
+        slot->lastProfilerID = profilerID;
+    }
+
+    return static_cast<ThreadCounters*>(slot->lastCounters);
+}
+
+ProfilerCPU::ThreadCounters* ProfilerCPU::CreateThreadCounters()
+{
+    String threadName;
+    if (Thread::IsMainThread())
+    {
+        threadName = Thread::davaMainThreadName;
+    }
+    else
+    {
+        Thread* thread = Thread::Current();
+        if (thread != nullptr)
+        {
+            threadName = thread->GetName();
+        }
+    }
+
+    ThreadCounters* counters = new ThreadCounters(numCounters, Thread::GetCurrentIdAsUInt64(), threadName);
+
+    LockGuard<Mutex> lock(mutex);
+    threadCounters.emplace_back(counters);
+    return counters;
+}
+
+ProfilerCPU::Snapshot* ProfilerCPU::MergeThreadCounters() const
+{
+    Snapshot* snapshot = new Snapshot();
+    Vector<const Counter*> merged;
+
+    {
+        LockGuard<Mutex> lock(mutex);
+        for (const std::unique_ptr<ThreadCounters>& t : threadCounters)
+        {
+            for (const Counter& c : t->counters)
+            {
+                if (c.name != nullptr && c.startTime != 0)
+                {
+                    merged.push_back(&c);
+                }
+            }
+
+            if (!t->threadName.empty())
+            {
+                snapshot->threadNames.emplace_back(t->threadID, t->threadName);
+            }
+        }
+    }
+
+    // counters of one thread are already ordered, stable sort keeps order of counters started in the same microsecond
+    std::stable_sort(merged.begin(), merged.end(), [](const Counter* l, const Counter* r) {
+        return l->startTime < r->startTime;
+    });
+
+    snapshot->counters.reset(new CounterArray(uint32(NextPowerOf2(Max(int32(merged.size()), 1)))));
+    for (const Counter* c : merged)
+    {
+        snapshot->counters->next() = *c;
+    }
+
+    return snapshot;
+}
+
 int32 ProfilerCPU::MakeSnapshot()
 {
     //CPU profiler use 'pseudo-thread-safe' ring array (see ProfilerRingArray.h)
@@ -145,7 +320,7 @@ int32 ProfilerCPU::MakeSnapshot()
     //For performance reasons we should stop profiler before dumping or snapshotting
     DVASSERT(!isStarted && "Stop profiler before make snapshot");
 
-    snapshots.push_back(new CounterArray(*counters));
+    snapshots.push_back(MergeThreadCounters());
     return int32(snapshots.size() - 1);
 }
 
@@ -161,24 +336,36 @@ void ProfilerCPU::DeleteSnapshot(int32 snapshot)
 
 void ProfilerCPU::DeleteSnapshots()
 {
-    for (CounterArray*& c : snapshots)
+    for (Snapshot*& s : snapshots)
     {
-        SafeDelete(c);
+        SafeDelete(s);
     }
     snapshots.clear();
 }
 
 uint64 ProfilerCPU::GetLastCounterTime(const char* counterName) const
 {
+    // can be called while profiler is running, so thread arrays are searched without merging
     uint64 timeDelta = 0;
-    CounterArray::reverse_iterator it = counters->rbegin(), itEnd = counters->rend();
-    for (; it != itEnd; ++it)
+    uint64 lastStartTime = 0;
+
+    LockGuard<Mutex> lock(mutex);
+    for (const std::unique_ptr<ThreadCounters>& t : threadCounters)
     {
-        const Counter& c = *it;
-        if (c.endTime != 0 && (strcmp(counterName, c.name) == 0))
+        const CounterArray& counters = t->counters;
+        CounterArray::const_reverse_iterator it = counters.rbegin(), itEnd = counters.rend();
+        for (; it != itEnd; ++it)
         {
-            timeDelta = c.endTime - c.startTime;
-            break;
+            const Counter& c = *it;
+            if (c.endTime != 0 && (strcmp(counterName, c.name) == 0))
+            {
+                if (c.startTime >= lastStartTime)
+                {
+                    lastStartTime = c.startTime;
+                    timeDelta = c.endTime - c.startTime;
+                }
+                break;
+            }
         }
     }
 
@@ -268,13 +455,13 @@ Vector<TraceEvent> ProfilerCPU::GetTrace(int32 snapshot) const
 {
     DVASSERT((snapshot != NO_SNAPSHOT_ID || !isStarted) && "Stop profiler before tracing");
 
-    const CounterArray* array = GetCounterArray(snapshot);
+    static const FastName threadNameEvent("thread_name");
+    static const FastName threadNameArg("name");
+
+    const Snapshot* counters = GetSnapshot(snapshot);
+    const CounterArray* array = counters->counters.get();
     Vector<TraceEvent> trace;
-    if (array == nullptr)
-    {
-        return trace;
-    }
-    trace.reserve(array->size());
+    trace.reserve(array->size() + counters->threadNames.size());
 
     for (const Counter& c : *array)
     {
@@ -291,63 +478,59 @@ Vector<TraceEvent> ProfilerCPU::GetTrace(int32 snapshot) const
         }
     }
 
+    for (const std::pair<uint64, String>& threadName : counters->threadNames)
+    {
+        trace.push_back({ threadNameEvent, 0, 0, threadName.first, 0, TraceEvent::PHASE_METADATA });
+        trace.back().stringArgs.push_back({ threadNameArg, threadName.second });
+    }
+
     return trace;
 }
 
 Vector<TraceEvent> ProfilerCPU::GetTrace(const char* counterName, uint32 desiredFrameIndex, int32 snapshot) const
 {
-    Vector<TraceEvent> trace;
+    using namespace ProfilerCPUDetails;
 
-    bool found = false;
-    std::size_t countersCount = 0;
-    const CounterArray* array = GetCounterArray(snapshot);
-    CounterArray::const_reverse_iterator rit = array->rbegin();
-    CounterArray::const_reverse_iterator rend = array->rend();
-    for (; rit != rend; ++rit)
+    Vector<TraceEvent> trace;
+    CounterArray::const_reverse_iterator found(nullptr, 0, 0);
+    if (snapshot != NO_SNAPSHOT_ID)
     {
-        ++countersCount;
-        if (rit->endTime != 0 && (strcmp(counterName, rit->name) == 0))
+        const CounterArray* array = GetCounterArray(snapshot);
+        if (FindLastCounter(array, counterName, desiredFrameIndex, found))
         {
-            if ((rit->frame <= desiredFrameIndex || rit->frame == 0 || desiredFrameIndex == 0))
-            {
-                found = true;
-                break;
-            }
+            AppendCounterTrace(array, CounterArray::const_iterator(found), trace);
         }
     }
-
-    if (found)
+    else
     {
-        CounterArray::const_iterator it(rit);
-        CounterArray::const_iterator end = array->end();
-
-        trace.reserve(countersCount);
+        // can be called while profiler is running, so thread arrays are searched without merging.
+        // Counter and its children are placed in the same thread array
+        LockGuard<Mutex> lock(mutex);
 
-        uint64 threadID = it->threadID;
-        uint64 counterEndTime = it->endTime;
-        for (; it != end; ++it)
+        const CounterArray* lastArray = nullptr;
+        CounterArray::const_reverse_iterator last(nullptr, 0, 0);
+        for (const std::unique_ptr<ThreadCounters>& t : threadCounters)
         {
-            if (it->threadID == threadID)
+            if (FindLastCounter(&t->counters, counterName, desiredFrameIndex, found))
             {
-                if (it->endTime == 0 || it->startTime > counterEndTime)
+                if (lastArray == nullptr || found->startTime > last->startTime)
                 {
-                    break;
-                }
-
-                trace.push_back({ FastName(it->name), it->startTime, it->endTime - it->startTime, it->threadID, 0, TraceEvent::PHASE_DURATION });
-
-                if (it->frame)
-                {
-                    trace.back().args.push_back({ TRACE_ARG_FRAME, it->frame });
+                    lastArray = &t->counters;
+                    last = found;
                 }
             }
         }
+
+        if (lastArray != nullptr)
+        {
+            AppendCounterTrace(lastArray, CounterArray::const_iterator(last), trace);
+        }
     }
 
     return trace;
 }
 
-const ProfilerCPU::CounterArray* ProfilerCPU::GetCounterArray(int32 snapshot) const
+const ProfilerCPU::Snapshot* ProfilerCPU::GetSnapshot(int32 snapshot) const
 {
     if (snapshot != NO_SNAPSHOT_ID)
     {
@@ -355,7 +538,17 @@ const ProfilerCPU::CounterArray* ProfilerCPU::GetCounterArray(int32 snapshot) co
         return snapshots[snapshot];
     }
 
-    return counters;
+    // counters don't change while profiler is stopped, so merged array is reused until next start
+    if (mergedCounters == nullptr)
+    {
+        mergedCounters.reset(MergeThreadCounters());
+    }
+    return mergedCounters.get();
+}
+
+const ProfilerCPU::CounterArray* ProfilerCPU::GetCounterArray(int32 snapshot) const
+{
+    return GetSnapshot(snapshot)->counters.get();
 }
 
 /////////////////////////////////////////////////////////////////////////////////
@@ -56,6 +56,13 @@ public:
     {
         return elements[head++ & mask];
     }
+    // Same as next() for array filled by one thread only. Doesn't need locked increment.
+    T& next_single_writer()
+    {
+        uint32 index = head.load(std::memory_order_relaxed);
+        head.store(index + 1, std::memory_order_relaxed);
+        return elements[index & mask];
+    }
     iterator begin()
     {
         return iterator(elements, (head & mask), mask);
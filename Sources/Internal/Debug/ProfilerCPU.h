@@ -4,6 +4,7 @@
 #include "Debug/TraceEvent.h"
 #include "Concurrency/Mutex.h"
 #include <iosfwd>
+#include <memory>
 
 #ifndef PROFILER_CPU_ENABLED
 #define PROFILER_CPU_ENABLED 1
@@ -22,8 +23,10 @@ class ProfilerRingArray;
 
              Any counter has string-name that must be passed to define and will be displayed in dump or trace. Time-measuring occurs in microseconds.
 
-             Profiler is using ring array for counters so you are limited by count passed to ctor. If it's necessary to store counters data for later usage you can use snapshots.
-             Snapshot - it just a copy of internal ring buffer. To make snapshot you have to stop profiler because it can be used by other thread.
+             Profiler is using ring array for counters so you are limited by count passed to ctor. Every thread writes counters into its own ring array of that size,
+             so counters from different threads don't contend. Arrays of all threads are merged by start time when profiler is dumped or snapshot is made.
+             If it's necessary to store counters data for later usage you can use snapshots.
+             Snapshot - it just a copy of merged ring buffers. To make snapshot you have to stop profiler because it can be used by other thread.
              After snapshot was made you can dump counted info or build JSON-trace from it. Remember, that dumping or building trace is more expensive in performance than making snapshot.
 
              Engine has own global profiler. You can access it through static field `ProfilerCPU::globalProfiler`.
@@ -143,6 +146,7 @@ public:
 
     /**
         Build and return trace of all available counters from snapshot with `snapshotID` or internal counters array.
+        Trace ends with `thread_name` metadata events for named threads.
         Trace can be dumped to JSON Chromium Trace Viewer format
     */
     Vector<TraceEvent> GetTrace(int32 snapshotID = NO_SNAPSHOT_ID) const;
@@ -157,11 +161,20 @@ public:
     Vector<TraceEvent> GetTrace(const char* counterName, uint32 desiredFrameIndex = 0, int32 snapshotID = NO_SNAPSHOT_ID) const;
 
 private:
+    struct ThreadCounters;
+    struct Snapshot;
+
+    ThreadCounters* GetThreadCounters();
+    ThreadCounters* CreateThreadCounters();
+    Snapshot* MergeThreadCounters() const;
+    const Snapshot* GetSnapshot(int32 snapshot) const;
     const CounterArray* GetCounterArray(int32 snapshot) const;
 
-    CounterArray* counters = nullptr;
-    Vector<CounterArray*> snapshots;
-    Mutex mutex;
+    const uint64 profilerID; // identifies counters of this profiler in thread local storage
+    Vector<std::unique_ptr<ThreadCounters>> threadCounters;
+    mutable std::unique_ptr<Snapshot> mergedCounters; // merged counters of all threads, valid until profiler is started again
+    Vector<Snapshot*> snapshots;
+    mutable Mutex mutex;
     uint32 numCounters = 2048;
     bool isStarted = false;
 
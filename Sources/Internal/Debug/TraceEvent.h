@@ -20,6 +20,7 @@ struct TraceEvent
         PHASE_END, ///< End of duration event. It does not use `duration` field
         PHASE_INSTANCE, ///< The instance event-type. Correspond to something that happens buy has no duration. It does not use `duration` field
         PHASE_DURATION, ///< Complete event. Logically combines a pair of `Begin` and `End` events. Preferably to use this event type instead Begin/End because it reduce the size of the trace.
+        PHASE_METADATA, ///< Metadata event, e.g. `thread_name` with string argument `name`. It does not use `timestamp` and `duration` fields
 
         PHASE_COUNT ///< Count of implemented event types.
     };
@@ -31,6 +32,7 @@ struct TraceEvent
     uint32 processID; ///< The process ID for the process that generate this event.
     EventPhase phase; ///< The event type. The valid values are listed in enum description.
     Vector<std::pair<FastName, uint32>> args; ///< Any arguments provided for the event. Used as `meta-info`. The arguments are displayed in Trace Viewer.
+    Vector<std::pair<FastName, String>> stringArgs; ///< String arguments provided for the event. Written to the same `args` object as numeric ones.
 
     /**
         Dump `trace` from any type container with value type `TraceEvent` to file with `filePath` in JSON-format
@@ -66,7 +68,7 @@ void TraceEvent::DumpJSON(const Container& trace, std::ostream& stream)
     static_assert(std::is_same<typename Container::value_type, TraceEvent>::value, "Container should contain TraceEvent class");
 
     static const char* const PHASE_STR[PHASE_COUNT] = {
-        "B", "E", "I", "X"
+        "B", "E", "I", "X", "M"
     };
 
     stream << "{ \"traceEvents\": [\n";
@@ -92,9 +94,30 @@ void TraceEvent::DumpJSON(const Container& trace, std::ostream& stream)
         stream << "\"ph\": \"" << PHASE_STR[event.phase] << "\", ";
         stream << "\"name\": \"" << event.name.c_str() << "\"";
 
-        for (const std::pair<FastName, uint32>& arg : event.args)
+        if (!event.args.empty() || !event.stringArgs.empty())
         {
-            stream << ", \"args\": { \"" << arg.first.c_str() << "\": " << arg.second << " }";
+            const char* separator = "";
+            stream << ", \"args\": { ";
+            for (const std::pair<FastName, uint32>& arg : event.args)
+            {
+                stream << separator << "\"" << arg.first.c_str() << "\": " << arg.second;
+                separator = ", ";
+            }
+            for (const std::pair<FastName, String>& arg : event.stringArgs)
+            {
+                stream << separator << "\"" << arg.first.c_str() << "\": \"";
+                for (char c : arg.second)
+                {
+                    if (c == '"' || c == '\\')
+                    {
+                        stream << '\\';
+                    }
+                    stream << c;
+                }
+                stream << "\"";
+                separator = ", ";
+            }
+            stream << " }";
         }
 
         stream << " }";
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Base/UnordererMap.h"
+#include "Debug/DVAssert.h"
+
+namespace DAVA
+{
+class Entity;
+class Component;
+
+/**
+    Chunk of entities with the same set of component types.
+
+    Chunk stores data in SoA layout: array of entities and one array of component pointers per component type (column).
+    Row `i` of every column belongs to the entity `GetEntities()[i]`.
+    For multi-components only the first component of each type is stored.
+*/
+class ArchetypeChunk final
+{
+public:
+    static const uint32 CAPACITY = 128;
+
+    ArchetypeChunk(uint32 columnsCount);
+    ~ArchetypeChunk();
+
+    uint32 GetCount() const;
+    Entity* const* GetEntities() const;
+    Component* const* GetColumn(uint32 column) const;
+
+private:
+    ArchetypeChunk(const ArchetypeChunk&) = delete;
+    ArchetypeChunk& operator=(const ArchetypeChunk&) = delete;
+
+    uint32 count = 0;
+    uint32 columnsCount = 0;
+    Entity** entities = nullptr;
+    Component** columns = nullptr;
+
+    friend class ArchetypeStorage;
+};
+
+/**
+    Group of entities with the same components mask, stored in a list of densely packed chunks.
+*/
+class Archetype final
+{
+public:
+    Archetype(const ComponentMask& mask);
+    ~Archetype();
+
+    const ComponentMask& GetComponentsMask() const;
+
+    /** Return index of column for component with specified runtime id or -1 if archetype has no such component. */
+    int32 GetColumnIndex(uint32 runtimeId) const;
+
+    uint32 GetChunksCount() const;
+    const ArchetypeChunk* GetChunk(uint32 index) const;
+
+private:
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+
+    ComponentMask mask;
+    Vector<uint32> runtimeIds; // runtime id of component for each column, sorted
+    Vector<ArchetypeChunk*> chunks;
+
+    friend class ArchetypeStorage;
+};
+
+/**
+    Optional scene storage which groups entities by components mask into archetypes.
+
+    Components themselves are still owned by entities, storage keeps packed arrays of component pointers
+    so that systems can iterate entities with required components without per-entity lookups (see `EntityQuery`).
+    Storage is updated by scene on entity/component registration. Entities whose components were changed
+    are re-inserted lazily in `Sync`, which is called before every query.
+    Storage should be modified on the main thread only. When it is synced, `Sync` and queries only read it,
+    so they can be run from several threads at once.
+*/
+class ArchetypeStorage final
+{
+public:
+    ArchetypeStorage() = default;
+    ~ArchetypeStorage();
+
+    void AddEntity(Entity* entity);
+    void RemoveEntity(Entity* entity);
+
+    /** Mark entity as changed, it will be moved to the archetype corresponding to its new components on next `Sync`. */
+    void InvalidateEntity(Entity* entity);
+
+    void Sync();
+
+    uint32 GetArchetypesCount() const;
+    const Archetype* GetArchetype(uint32 index) const;
+
+    uint32 GetEntitiesCount() const;
+
+private:
+    struct EntityLocation
+    {
+        Archetype* archetype = nullptr; // nullptr if entity is waiting for Sync
+        uint32 chunk = 0;
+        uint32 row = 0;
+    };
+
+    ArchetypeStorage(const ArchetypeStorage&) = delete;
+    ArchetypeStorage& operator=(const ArchetypeStorage&) = delete;
+
+    Archetype* GetOrCreateArchetype(const ComponentMask& mask);
+    void InsertEntity(Entity* entity, EntityLocation& location);
+    void EraseEntity(EntityLocation& location);
+
+    Vector<Archetype*> archetypes;
+    UnorderedMap<ComponentMask, Archetype*> archetypesMap;
+    UnorderedMap<Entity*, EntityLocation> locations;
+    Vector<Entity*> pendingEntities;
+};
+
+inline uint32 ArchetypeChunk::GetCount() const
+{
+    return count;
+}
+
+inline Entity* const* ArchetypeChunk::GetEntities() const
+{
+    return entities;
+}
+
+inline Component* const* ArchetypeChunk::GetColumn(uint32 column) const
+{
+    DVASSERT(column < columnsCount);
+    return columns + column * CAPACITY;
+}
+
+inline const ComponentMask& Archetype::GetComponentsMask() const
+{
+    return mask;
+}
+
+inline uint32 Archetype::GetChunksCount() const
+{
+    return static_cast<uint32>(chunks.size());
+}
+
+inline const ArchetypeChunk* Archetype::GetChunk(uint32 index) const
+{
+    return chunks[index];
+}
+
+inline uint32 ArchetypeStorage::GetArchetypesCount() const
+{
+    return static_cast<uint32>(archetypes.size());
+}
+
+inline const Archetype* ArchetypeStorage::GetArchetype(uint32 index) const
+{
+    return archetypes[index];
+}
+}
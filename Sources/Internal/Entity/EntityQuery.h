@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Entity/ArchetypeStorage.h"
+
+#include <utility>
+
+namespace DAVA
+{
+/**
+    View of one archetype chunk matched by `EntityQuery<T...>`.
+
+    Gives typed access to rows of the chunk: `GetEntity(i)` and `Get<C>(i)` for each queried component type `C`.
+*/
+template <typename... T>
+class EntityQueryChunk final
+{
+public:
+    uint32 GetCount() const;
+    Entity* GetEntity(uint32 row) const;
+
+    template <typename C>
+    C* Get(uint32 row) const;
+
+private:
+    const ArchetypeChunk* chunk = nullptr;
+    uint32 columns[sizeof...(T)];
+
+    template <typename... Args>
+    friend class EntityQuery;
+};
+
+/**
+    List of entities which have all components `T...`, built over scene `ArchetypeStorage`.
+
+    Query collects matching chunks on creation, so it should not be kept alive across changes of scene entities.
+    Usage:
+    \code
+    scene->Query<TransformComponent, RenderComponent>().ForEach([](Entity* e, TransformComponent* tc, RenderComponent* rc) {
+        ...
+    });
+    \endcode
+    Chunks are independent from each other, so they can be processed concurrently with `GetChunksCount`/`GetChunk` and `ParallelFor`.
+*/
+template <typename... T>
+class EntityQuery final
+{
+public:
+    EntityQuery(ArchetypeStorage* storage);
+
+    uint32 GetChunksCount() const;
+    const EntityQueryChunk<T...>& GetChunk(uint32 index) const;
+
+    uint32 GetEntitiesCount() const;
+
+    /** Call `fn(Entity*, T*...)` for each matched entity. */
+    template <typename Fn>
+    void ForEach(Fn&& fn) const;
+
+    /** Call `fn(const EntityQueryChunk<T...>&)` for each matched chunk. */
+    template <typename Fn>
+    void ForEachChunk(Fn&& fn) const;
+
+private:
+    template <typename Fn, size_t... I>
+    void ForEachInChunk(const EntityQueryChunk<T...>& chunk, Fn& fn, std::index_sequence<I...>) const;
+
+    Vector<EntityQueryChunk<T...>> chunks;
+};
+}
+
+#include "Entity/Private/EntityQuery_impl.h"
@@ -0,0 +1,214 @@
+#include "Entity/ArchetypeStorage.h"
+#include "Entity/Component.h"
+#include "Entity/ComponentUtils.h"
+#include "Concurrency/Thread.h"
+#include "Scene3D/Entity.h"
+
+namespace DAVA
+{
+//////////////////////////////////////////////////////////////////////////
+// ArchetypeChunk
+
+ArchetypeChunk::ArchetypeChunk(uint32 columnsCount_)
+    : columnsCount(columnsCount_)
+{
+    entities = new Entity*[CAPACITY];
+    columns = new Component*[columnsCount * CAPACITY];
+}
+
+ArchetypeChunk::~ArchetypeChunk()
+{
+    SafeDeleteArray(entities);
+    SafeDeleteArray(columns);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Archetype
+
+Archetype::Archetype(const ComponentMask& mask_)
+    : mask(mask_)
+{
+    for (uint32 runtimeId = 0; runtimeId < mask.size(); ++runtimeId)
+    {
+        if (mask.test(runtimeId))
+        {
+            runtimeIds.push_back(runtimeId);
+        }
+    }
+}
+
+Archetype::~Archetype()
+{
+    for (ArchetypeChunk* chunk : chunks)
+    {
+        delete chunk;
+    }
+    chunks.clear();
+}
+
+int32 Archetype::GetColumnIndex(uint32 runtimeId) const
+{
+    auto it = std::lower_bound(runtimeIds.begin(), runtimeIds.end(), runtimeId);
+    if (it != runtimeIds.end() && *it == runtimeId)
+    {
+        return static_cast<int32>(it - runtimeIds.begin());
+    }
+
+    return -1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// ArchetypeStorage
+
+ArchetypeStorage::~ArchetypeStorage()
+{
+    for (Archetype* archetype : archetypes)
+    {
+        delete archetype;
+    }
+    archetypes.clear();
+    archetypesMap.clear();
+    locations.clear();
+    pendingEntities.clear();
+}
+
+void ArchetypeStorage::AddEntity(Entity* entity)
+{
+    DVASSERT(entity != nullptr);
+
+    auto it = locations.find(entity);
+    if (it == locations.end())
+    {
+        InsertEntity(entity, locations[entity]);
+    }
+    else
+    {
+        InvalidateEntity(entity);
+    }
+}
+
+void ArchetypeStorage::RemoveEntity(Entity* entity)
+{
+    auto it = locations.find(entity);
+    if (it != locations.end())
+    {
+        if (it->second.archetype != nullptr)
+        {
+            EraseEntity(it->second);
+        }
+        locations.erase(it);
+    }
+}
+
+void ArchetypeStorage::InvalidateEntity(Entity* entity)
+{
+    auto it = locations.find(entity);
+    if (it != locations.end() && it->second.archetype != nullptr)
+    {
+        // Erase immediately: components of entity can be destroyed right after invalidation
+        EraseEntity(it->second);
+        pendingEntities.push_back(entity);
+    }
+}
+
+void ArchetypeStorage::Sync()
+{
+    // early exit keeps concurrent queries safe when there is nothing to sync
+    if (pendingEntities.empty())
+    {
+        return;
+    }
+
+    DVASSERT(Thread::IsMainThread(), "Entities were changed while archetype storage is queried concurrently");
+
+    for (Entity* entity : pendingEntities)
+    {
+        auto it = locations.find(entity);
+        if (it != locations.end() && it->second.archetype == nullptr)
+        {
+            InsertEntity(entity, it->second);
+        }
+    }
+    pendingEntities.clear();
+}
+
+uint32 ArchetypeStorage::GetEntitiesCount() const
+{
+    return static_cast<uint32>(locations.size());
+}
+
+Archetype* ArchetypeStorage::GetOrCreateArchetype(const ComponentMask& mask)
+{
+    auto it = archetypesMap.find(mask);
+    if (it != archetypesMap.end())
+    {
+        return it->second;
+    }
+
+    Archetype* archetype = new Archetype(mask);
+    archetypes.push_back(archetype);
+    archetypesMap[mask] = archetype;
+    return archetype;
+}
+
+void ArchetypeStorage::InsertEntity(Entity* entity, EntityLocation& location)
+{
+    Archetype* archetype = GetOrCreateArchetype(entity->GetAvailableComponentMask());
+
+    // all chunks except the last one are always full
+    if (archetype->chunks.empty() || archetype->chunks.back()->count == ArchetypeChunk::CAPACITY)
+    {
+        archetype->chunks.push_back(new ArchetypeChunk(static_cast<uint32>(archetype->runtimeIds.size())));
+    }
+
+    ArchetypeChunk* chunk = archetype->chunks.back();
+    uint32 row = chunk->count++;
+
+    chunk->entities[row] = entity;
+    for (uint32 c = 0; c < chunk->columnsCount; ++c)
+    {
+        const Type* type = ComponentUtils::GetType(archetype->runtimeIds[c]);
+        chunk->columns[c * ArchetypeChunk::CAPACITY + row] = entity->GetComponent(type);
+    }
+
+    location.archetype = archetype;
+    location.chunk = static_cast<uint32>(archetype->chunks.size() - 1);
+    location.row = row;
+}
+
+void ArchetypeStorage::EraseEntity(EntityLocation& location)
+{
+    Archetype* archetype = location.archetype;
+    DVASSERT(archetype != nullptr);
+
+    ArchetypeChunk* chunk = archetype->chunks[location.chunk];
+    ArchetypeChunk* lastChunk = archetype->chunks.back();
+    uint32 lastRow = lastChunk->count - 1;
+
+    if (chunk != lastChunk || location.row != lastRow)
+    {
+        // move the last entity of archetype into the hole to keep chunks dense
+        Entity* movedEntity = lastChunk->entities[lastRow];
+        chunk->entities[location.row] = movedEntity;
+        for (uint32 c = 0; c < chunk->columnsCount; ++c)
+        {
+            chunk->columns[c * ArchetypeChunk::CAPACITY + location.row] = lastChunk->columns[c * ArchetypeChunk::CAPACITY + lastRow];
+        }
+
+        EntityLocation& movedLocation = locations[movedEntity];
+        movedLocation.chunk = location.chunk;
+        movedLocation.row = location.row;
+    }
+
+    lastChunk->count--;
+    if (lastChunk->count == 0)
+    {
+        delete lastChunk;
+        archetype->chunks.pop_back();
+    }
+
+    location.archetype = nullptr;
+    location.chunk = 0;
+    location.row = 0;
+}
+}
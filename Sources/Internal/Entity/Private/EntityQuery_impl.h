@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Entity/ComponentUtils.h"
+
+namespace DAVA
+{
+namespace EntityQueryDetails
+{
+template <typename C, typename... T>
+struct IndexOf;
+
+template <typename C, typename... T>
+struct IndexOf<C, C, T...>
+{
+    static const uint32 value = 0;
+};
+
+template <typename C, typename U, typename... T>
+struct IndexOf<C, U, T...>
+{
+    static const uint32 value = 1 + IndexOf<C, T...>::value;
+};
+}
+
+template <typename... T>
+uint32 EntityQueryChunk<T...>::GetCount() const
+{
+    return chunk->GetCount();
+}
+
+template <typename... T>
+Entity* EntityQueryChunk<T...>::GetEntity(uint32 row) const
+{
+    DVASSERT(row < chunk->GetCount());
+    return chunk->GetEntities()[row];
+}
+
+template <typename... T>
+template <typename C>
+C* EntityQueryChunk<T...>::Get(uint32 row) const
+{
+    DVASSERT(row < chunk->GetCount());
+    const uint32 column = columns[EntityQueryDetails::IndexOf<C, T...>::value];
+    return static_cast<C*>(chunk->GetColumn(column)[row]);
+}
+
+template <typename... T>
+EntityQuery<T...>::EntityQuery(ArchetypeStorage* storage)
+{
+    static_assert(sizeof...(T) > 0, "Query should contain at least one component type");
+
+    storage->Sync();
+
+    const ComponentMask queryMask = ComponentUtils::MakeMask<T...>();
+    const uint32 runtimeIds[] = { ComponentUtils::GetRuntimeId<T>()... };
+
+    for (uint32 a = 0, archetypesCount = storage->GetArchetypesCount(); a < archetypesCount; ++a)
+    {
+        const Archetype* archetype = storage->GetArchetype(a);
+        if ((archetype->GetComponentsMask() & queryMask) != queryMask)
+        {
+            continue;
+        }
+
+        EntityQueryChunk<T...> queryChunk;
+        for (uint32 i = 0; i < sizeof...(T); ++i)
+        {
+            queryChunk.columns[i] = static_cast<uint32>(archetype->GetColumnIndex(runtimeIds[i]));
+        }
+
+        for (uint32 c = 0, chunksCount = archetype->GetChunksCount(); c < chunksCount; ++c)
+        {
+            queryChunk.chunk = archetype->GetChunk(c);
+            chunks.push_back(queryChunk);
+        }
+    }
+}
+
+template <typename... T>
+uint32 EntityQuery<T...>::GetChunksCount() const
+{
+    return static_cast<uint32>(chunks.size());
+}
+
+template <typename... T>
+const EntityQueryChunk<T...>& EntityQuery<T...>::GetChunk(uint32 index) const
+{
+    return chunks[index];
+}
+
+template <typename... T>
+uint32 EntityQuery<T...>::GetEntitiesCount() const
+{
+    uint32 count = 0;
+    for (const EntityQueryChunk<T...>& chunk : chunks)
+    {
+        count += chunk.GetCount();
+    }
+    return count;
+}
+
+template <typename... T>
+template <typename Fn>
+void EntityQuery<T...>::ForEach(Fn&& fn) const
+{
+    for (const EntityQueryChunk<T...>& chunk : chunks)
+    {
+        ForEachInChunk(chunk, fn, std::index_sequence_for<T...>());
+    }
+}
+
+template <typename... T>
+template <typename Fn>
+void EntityQuery<T...>::ForEachChunk(Fn&& fn) const
+{
+    for (const EntityQueryChunk<T...>& chunk : chunks)
+    {
+        fn(chunk);
+    }
+}
+
+template <typename... T>
+template <typename Fn, size_t... I>
+void EntityQuery<T...>::ForEachInChunk(const EntityQueryChunk<T...>& chunk, Fn& fn, std::index_sequence<I...>) const
+{
+    Entity* const* entities = chunk.chunk->GetEntities();
+    Component* const* columns[] = { chunk.chunk->GetColumn(chunk.columns[I])... };
+
+    for (uint32 row = 0, count = chunk.chunk->GetCount(); row < count; ++row)
+    {
+        fn(entities[row], static_cast<T*>(columns[I][row])...);
+    }
+}
+}
@@ -25,6 +25,19 @@ public:
     inline void SetRequiredComponents(const ComponentMask& requiredComponents);
     inline const ComponentMask& GetRequiredComponents() const;
 
+    /**
+        \brief Declare components read and written by `Process`.
+                Systems with declared access can be processed concurrently with each other
+                if scene parallel processing is enabled and their access does not conflict.
+                Declaring access means `Process` doesn't touch any other shared state.
+        \param[in] readComponents components `Process` reads.
+        \param[in] writeComponents components `Process` modifies.
+     */
+    inline void SetProcessComponentsAccess(const ComponentMask& readComponents, const ComponentMask& writeComponents);
+    inline bool IsProcessComponentsAccessDeclared() const;
+    inline const ComponentMask& GetProcessReadComponents() const;
+    inline const ComponentMask& GetProcessWriteComponents() const;
+
     /**
         \brief  This function is called when any entity registered to scene.
                 It sorts out is entity has all necessary components and we need to call AddEntity.
@@ -133,6 +146,9 @@ protected:
 
 private:
     ComponentMask requiredComponents;
+    ComponentMask processReadComponents;
+    ComponentMask processWriteComponents;
+    bool processComponentsAccessDeclared = false;
     Scene* scene = nullptr;
 
     bool locked = false;
@@ -153,4 +169,26 @@ inline const ComponentMask& SceneSystem::GetRequiredComponents() const
 {
     return requiredComponents;
 }
+
+inline void SceneSystem::SetProcessComponentsAccess(const ComponentMask& readComponents, const ComponentMask& writeComponents)
+{
+    processReadComponents = readComponents;
+    processWriteComponents = writeComponents;
+    processComponentsAccessDeclared = true;
+}
+
+inline bool SceneSystem::IsProcessComponentsAccessDeclared() const
+{
+    return processComponentsAccessDeclared;
+}
+
+inline const ComponentMask& SceneSystem::GetProcessReadComponents() const
+{
+    return processReadComponents;
+}
+
+inline const ComponentMask& SceneSystem::GetProcessWriteComponents() const
+{
+    return processWriteComponents;
+}
 }
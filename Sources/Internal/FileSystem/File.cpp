@@ -150,20 +150,27 @@ File* File::Create(const FilePath& filename, uint32 attributes)
 File* File::LoadFileFromMountedArchive(const String& packName, const String& relative)
 {
     FileSystem* fs = FileSystem::Instance();
+    std::shared_ptr<ResourceArchive> archive;
     {
         LockGuard<Mutex> lock(fs->accessArchiveMap);
 
         auto it = fs->resArchiveMap.find(packName);
         if (it != end(fs->resArchiveMap))
         {
-            Vector<uint8> fileContent;
-            if (it->second.archive->LoadFile(relative, fileContent))
-            {
-                return DynamicMemoryFile::Create(std::move(fileContent), READ, "~res:/" + relative);
-            }
+            archive = it->second.archive;
         }
-        return nullptr;
     }
+
+    // archive is safe to read concurrently, so lock is held only for lookup
+    if (archive)
+    {
+        Vector<uint8> fileContent;
+        if (archive->LoadFile(relative, fileContent))
+        {
+            return DynamicMemoryFile::Create(std::move(fileContent), READ, "~res:/" + relative);
+        }
+    }
+    return nullptr;
 }
 
 bool File::IsFileInMountedArchive(const String& packName, const String& relative)
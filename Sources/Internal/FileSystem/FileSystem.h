@@ -323,7 +323,8 @@ private:
         {
         }
 
-        std::unique_ptr<ResourceArchive> archive;
+        // shared to load files without holding accessArchiveMap
+        std::shared_ptr<ResourceArchive> archive;
         String attachPath;
         FilePath archiveFilePath;
     };
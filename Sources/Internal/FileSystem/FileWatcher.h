@@ -5,7 +5,7 @@
 #include "Functional/Signal.h"
 #include "Concurrency/Thread.h"
 
-#if defined(__DAVAENGINE_WIN32__) || defined(__DAVAENGINE_MACOS__)
+#if defined(__DAVAENGINE_WIN32__) || defined(__DAVAENGINE_MACOS__) || defined(__DAVAENGINE_LINUX__)
 
 namespace DAVA
 {
@@ -1,11 +1,13 @@
 #include "FileSystem/FileWatcher.h"
 
-#if defined(__DAVAENGINE_WIN32__) || defined(__DAVAENGINE_MACOS__)
+#if defined(__DAVAENGINE_WIN32__) || defined(__DAVAENGINE_MACOS__) || defined(__DAVAENGINE_LINUX__)
 
 #if defined(__DAVAENGINE_WIN32__)
 #include "FileSystem/Private/FileWatcherBackendWin32.h"
 #elif defined(__DAVAENGINE_MACOS__)
 #include "FileSystem/Private/FileWatcherBackendMac.h"
+#elif defined(__DAVAENGINE_LINUX__)
+#include "FileSystem/Private/FileWatcherBackendLinux.h"
 #else
 #error "FileWatcher is not implemented"
 #endif
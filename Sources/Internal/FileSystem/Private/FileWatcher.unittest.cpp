@@ -1,6 +1,6 @@
 #include "UnitTests/UnitTests.h"
 
-#if defined(__DAVAENGINE_WIN32__) || defined(__DAVAENGINE_MACOS__)
+#if defined(__DAVAENGINE_WIN32__) || defined(__DAVAENGINE_MACOS__) || defined(__DAVAENGINE_LINUX__)
 #include <Base/String.h>
 #include <Concurrency/Thread.h>
 #include <Engine/Engine.h>
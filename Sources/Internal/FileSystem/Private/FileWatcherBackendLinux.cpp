@@ -0,0 +1,494 @@
+#include "FileSystem/Private/FileWatcherBackendLinux.h"
+
+#if defined(__DAVAENGINE_LINUX__)
+#include "Base/Exception.h"
+#include "Concurrency/LockGuard.h"
+#include "Concurrency/Thread.h"
+#include "Logger/Logger.h"
+#include "Time/SystemTimer.h"
+#include "Utils/StringFormat.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace DAVA
+{
+namespace FileWatcherBackendDetails
+{
+const uint32 WATCH_MASK = IN_CREATE | IN_DELETE | IN_MODIFY | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_ONLYDIR;
+
+// events are emitted when tree is quiet for COALESCE_DELAY_MS, but not later than MAX_BATCH_DELAY_MS after first one
+const int64 COALESCE_DELAY_MS = 50;
+const int64 MAX_BATCH_DELAY_MS = 500;
+
+// directories listed between checks of inotify events while big tree is being scanned
+const uint32 SCANS_PER_ITERATION = 64;
+
+bool IsDirectory(const String& path, const dirent* entry)
+{
+    if (entry->d_type != DT_UNKNOWN)
+    {
+        return entry->d_type == DT_DIR;
+    }
+
+    struct stat entryStat;
+    return lstat(path.c_str(), &entryStat) == 0 && S_ISDIR(entryStat.st_mode);
+}
+} // namespace FileWatcherBackendDetails
+
+struct FileWatcherBackend::WatchNode
+{
+    String directory;
+    String path; // with trailing slash
+    bool isRecursive = false;
+    bool isRemoved = false;
+};
+
+FileWatcherBackend::FileWatcherBackend()
+{
+    inotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyDescriptor == -1)
+    {
+        DAVA_THROW(Exception, Format("inotify can't be initialized: %s", strerror(errno)));
+    }
+
+    if (pipe2(wakeupPipe, O_NONBLOCK | O_CLOEXEC) == -1)
+    {
+        close(inotifyDescriptor);
+        DAVA_THROW(Exception, Format("FileWatcher wakeup pipe can't be created: %s", strerror(errno)));
+    }
+}
+
+FileWatcherBackend::~FileWatcherBackend()
+{
+    DVASSERT(nodes.empty() == true);
+    close(wakeupPipe[0]);
+    close(wakeupPipe[1]);
+    close(inotifyDescriptor);
+}
+
+void FileWatcherBackend::Add(const String& directory, bool recursive)
+{
+    std::shared_ptr<WatchNode> node(new WatchNode());
+    node->directory = directory;
+    node->path = directory;
+    node->isRecursive = recursive;
+    if (node->path.empty() || node->path.back() != '/')
+    {
+        node->path += '/';
+    }
+
+    LockGuard<Mutex> lock(mutex);
+#if defined(__DAVAENGINE_DEBUG__)
+    for (const std::shared_ptr<WatchNode>& n : nodes)
+    {
+        DVASSERT(n->directory != directory);
+    }
+#endif
+
+    // root is watched right away to not miss changes made just after Add,
+    // subdirectories are scanned on watcher thread
+    if (AddWatch(node->path, node.get()) == false)
+    {
+        DAVA_THROW(Exception, Format("Directory %s can't be opened for watch: %s", directory.c_str(), strerror(errno)));
+    }
+
+    nodes.push_back(node);
+    if (recursive)
+    {
+        pendingScans.push_back(ScanRequest{ node->path, node, false });
+        Wakeup();
+    }
+}
+
+void FileWatcherBackend::Remove(const String& directory)
+{
+    LockGuard<Mutex> lock(mutex);
+    for (auto iter = nodes.begin(); iter != nodes.end(); ++iter)
+    {
+        if ((*iter)->directory == directory)
+        {
+            RemoveNode(*iter);
+            nodes.erase(iter);
+            break;
+        }
+    }
+}
+
+void FileWatcherBackend::RemoveAll()
+{
+    LockGuard<Mutex> lock(mutex);
+    for (const std::shared_ptr<WatchNode>& node : nodes)
+    {
+        RemoveNode(node);
+    }
+    nodes.clear();
+}
+
+void FileWatcherBackend::RemoveNode(const std::shared_ptr<WatchNode>& node)
+{
+    node->isRemoved = true;
+
+    auto iter = watchDirectories.begin();
+    while (iter != watchDirectories.end())
+    {
+        if (iter->second.node == node.get())
+        {
+            inotify_rm_watch(inotifyDescriptor, iter->first);
+            iter = watchDirectories.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+
+    pendingScans.erase(std::remove_if(pendingScans.begin(), pendingScans.end(), [&node](const ScanRequest& request) {
+                           return request.node == node;
+                       }),
+                       pendingScans.end());
+}
+
+bool FileWatcherBackend::AddWatch(const String& path, WatchNode* node)
+{
+    int watchDescriptor = inotify_add_watch(inotifyDescriptor, path.c_str(), FileWatcherBackendDetails::WATCH_MASK);
+    if (watchDescriptor == -1)
+    {
+        if (errno == ENOSPC)
+        {
+            Logger::Warning("FileWatcher: inotify watches limit is reached on %s, increase /proc/sys/fs/inotify/max_user_watches", path.c_str());
+        }
+        return false;
+    }
+
+    // same directory can be added again after rename, latest path is valid one
+    WatchDirectory& watchDirectory = watchDirectories[watchDescriptor];
+    watchDirectory.path = path;
+    watchDirectory.node = node;
+    return true;
+}
+
+void FileWatcherBackend::RemoveWatches(const String& pathPrefix)
+{
+    auto iter = watchDirectories.begin();
+    while (iter != watchDirectories.end())
+    {
+        if (iter->second.path.compare(0, pathPrefix.size(), pathPrefix) == 0)
+        {
+            inotify_rm_watch(inotifyDescriptor, iter->first);
+            iter = watchDirectories.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+}
+
+void FileWatcherBackend::Run()
+{
+    using namespace FileWatcherBackendDetails;
+
+    Thread* workThread = Thread::Current();
+    while (workThread->IsCancelling() == false)
+    {
+        bool hasScans = ProcessScans();
+
+        pollfd descriptors[2];
+        descriptors[0].fd = inotifyDescriptor;
+        descriptors[0].events = POLLIN;
+        descriptors[0].revents = 0;
+        descriptors[1].fd = wakeupPipe[0];
+        descriptors[1].events = POLLIN;
+        descriptors[1].revents = 0;
+
+        int result = poll(descriptors, 2, hasScans ? 0 : GetFlushTimeout());
+        if (result == -1 && errno != EINTR)
+        {
+            Logger::Error("FileWatcher: poll failed: %s", strerror(errno));
+            break;
+        }
+
+        if (descriptors[1].revents & POLLIN)
+        {
+            uint8 wakeupData[64];
+            while (read(wakeupPipe[0], wakeupData, sizeof(wakeupData)) > 0)
+            {
+            }
+
+            LockGuard<Mutex> lock(mutex);
+            if (stopRequested)
+            {
+                break;
+            }
+        }
+
+        if (descriptors[0].revents & POLLIN)
+        {
+            ReadEvents();
+        }
+
+        FlushEvents();
+    }
+}
+
+void FileWatcherBackend::Stop()
+{
+    LockGuard<Mutex> lock(mutex);
+    stopRequested = true;
+    Wakeup();
+}
+
+void FileWatcherBackend::Wakeup()
+{
+    uint8 wakeupData = 1;
+    ssize_t result = write(wakeupPipe[1], &wakeupData, 1);
+    // full pipe already wakes watcher thread up
+    DVASSERT(result == 1 || errno == EAGAIN);
+}
+
+bool FileWatcherBackend::ProcessScans()
+{
+    using namespace FileWatcherBackendDetails;
+
+    for (uint32 i = 0; i < SCANS_PER_ITERATION; ++i)
+    {
+        ScanRequest request;
+        {
+            LockGuard<Mutex> lock(mutex);
+            if (pendingScans.empty())
+            {
+                return false;
+            }
+
+            request = std::move(pendingScans.front());
+            pendingScans.pop_front();
+
+            // watch is added before listing, so entries created meanwhile are reported by inotify
+            if (AddWatch(request.path, request.node.get()) == false)
+            {
+                continue;
+            }
+        }
+
+        Vector<String> entries;
+        Vector<String> subdirectories;
+
+        DIR* dir = opendir(request.path.c_str());
+        if (dir == nullptr)
+        {
+            continue;
+        }
+
+        while (dirent* entry = readdir(dir))
+        {
+            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+            {
+                continue;
+            }
+
+            String entryPath = request.path + entry->d_name;
+            if (IsDirectory(entryPath, entry))
+            {
+                subdirectories.push_back(entryPath + '/');
+            }
+
+            if (request.reportCreated)
+            {
+                entries.push_back(std::move(entryPath));
+            }
+        }
+        closedir(dir);
+
+        LockGuard<Mutex> lock(mutex);
+        if (request.node->isRemoved)
+        {
+            continue;
+        }
+
+        for (const String& entry : entries)
+        {
+            PushEvent(entry, FileWatcher::FILE_CREATED);
+        }
+
+        for (String& subdirectory : subdirectories)
+        {
+            pendingScans.push_back(ScanRequest{ std::move(subdirectory), request.node, request.reportCreated });
+        }
+    }
+
+    LockGuard<Mutex> lock(mutex);
+    return pendingScans.empty() == false;
+}
+
+void FileWatcherBackend::ReadEvents()
+{
+    alignas(inotify_event) uint8 buffer[16 * 1024];
+
+    LockGuard<Mutex> lock(mutex);
+    while (true)
+    {
+        ssize_t length = read(inotifyDescriptor, buffer, sizeof(buffer));
+        if (length <= 0)
+        {
+            // EAGAIN: all events are read
+            break;
+        }
+
+        for (ssize_t offset = 0; offset < length;)
+        {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += sizeof(inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                Logger::Warning("FileWatcher: inotify queue overflow, some changes are lost");
+                continue;
+            }
+
+            auto iter = watchDirectories.find(event->wd);
+            if (iter == watchDirectories.end())
+            {
+                continue;
+            }
+
+            if (event->mask & IN_IGNORED)
+            {
+                // directory was removed or unmounted
+                watchDirectories.erase(iter);
+                continue;
+            }
+
+            if (event->len == 0)
+            {
+                // events about directory itself are reported by its parent
+                continue;
+            }
+
+            const WatchDirectory& watchDirectory = iter->second;
+            String path = watchDirectory.path + event->name;
+            bool isDirectory = (event->mask & IN_ISDIR) != 0;
+
+            if (event->mask & (IN_CREATE | IN_MOVED_TO))
+            {
+                PushEvent(path, FileWatcher::FILE_CREATED);
+                if (isDirectory && watchDirectory.node->isRecursive)
+                {
+                    auto nodeIter = std::find_if(nodes.begin(), nodes.end(), [&watchDirectory](const std::shared_ptr<WatchNode>& n) {
+                        return n.get() == watchDirectory.node;
+                    });
+                    DVASSERT(nodeIter != nodes.end());
+
+                    // content of directory moved into tree isn't new, created one could get files before it was watched
+                    bool reportCreated = (event->mask & IN_CREATE) != 0;
+                    pendingScans.push_back(ScanRequest{ path + '/', *nodeIter, reportCreated });
+                }
+            }
+
+            if ((event->mask & IN_MODIFY) && !isDirectory)
+            {
+                PushEvent(path, FileWatcher::FILE_MODIFIED);
+            }
+
+            if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+            {
+                PushEvent(path, FileWatcher::FILE_REMOVED);
+                if (isDirectory && (event->mask & IN_MOVED_FROM))
+                {
+                    // moved out subtree keeps watches with outdated paths, deleted one gets IN_IGNORED
+                    RemoveWatches(path + '/');
+                }
+            }
+        }
+    }
+}
+
+void FileWatcherBackend::PushEvent(const String& path, FileWatcher::eWatchEvent event)
+{
+    int64 currentMs = SystemTimer::GetMs();
+    if (pendingEvents.empty())
+    {
+        firstPendingEventMs = currentMs;
+    }
+    lastPendingEventMs = currentMs;
+
+    auto iter = pendingEventIndices.find(path);
+    if (iter == pendingEventIndices.end())
+    {
+        pendingEventIndices.emplace(path, pendingEvents.size());
+        pendingEvents.push_back(PendingEvent{ path, event, false });
+        return;
+    }
+
+    // merge with event already pending for same path
+    PendingEvent& pending = pendingEvents[iter->second];
+    if (pending.cancelled)
+    {
+        pending.event = event;
+        pending.cancelled = false;
+    }
+    else if (pending.event == FileWatcher::FILE_CREATED)
+    {
+        // file created and removed inside one batch is never reported
+        pending.cancelled = (event == FileWatcher::FILE_REMOVED);
+    }
+    else if (pending.event == FileWatcher::FILE_REMOVED)
+    {
+        // removed and created again, e.g. saved through temporary file
+        pending.event = (event == FileWatcher::FILE_REMOVED) ? FileWatcher::FILE_REMOVED : FileWatcher::FILE_MODIFIED;
+    }
+    else
+    {
+        pending.event = (event == FileWatcher::FILE_REMOVED) ? FileWatcher::FILE_REMOVED : FileWatcher::FILE_MODIFIED;
+    }
+}
+
+int32 FileWatcherBackend::GetFlushTimeout() const
+{
+    using namespace FileWatcherBackendDetails;
+
+    if (pendingEvents.empty())
+    {
+        return -1;
+    }
+
+    int64 currentMs = SystemTimer::GetMs();
+    int64 flushMs = std::min(lastPendingEventMs + COALESCE_DELAY_MS, firstPendingEventMs + MAX_BATCH_DELAY_MS);
+    return static_cast<int32>(std::max(flushMs - currentMs, int64(0)));
+}
+
+void FileWatcherBackend::FlushEvents()
+{
+    using namespace FileWatcherBackendDetails;
+
+    if (pendingEvents.empty())
+    {
+        return;
+    }
+
+    int64 currentMs = SystemTimer::GetMs();
+    if (currentMs - lastPendingEventMs < COALESCE_DELAY_MS && currentMs - firstPendingEventMs < MAX_BATCH_DELAY_MS)
+    {
+        return;
+    }
+
+    Vector<PendingEvent> events;
+    events.swap(pendingEvents);
+    pendingEventIndices.clear();
+
+    for (const PendingEvent& event : events)
+    {
+        if (event.cancelled == false)
+        {
+            onWatchersChanged.Emit(event.path, event.event);
+        }
+    }
+}
+
+} // namespace DAVA
+#endif // __DAVAENGINE_LINUX__
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "FileSystem/FileWatcher.h"
+
+#if defined(__DAVAENGINE_LINUX__)
+#include "Base/Deque.h"
+#include "Base/Vector.h"
+#include "Base/UnordererMap.h"
+#include "Concurrency/Mutex.h"
+#include "Functional/Signal.h"
+
+#include <memory>
+
+namespace DAVA
+{
+/**
+    inotify based backend. Every watched directory of recursive tree gets its own inotify watch,
+    subdirectories are scanned on watcher thread so Add doesn't block caller on big trees.
+    Events are coalesced per path and emitted in batches after short period without changes.
+*/
+class FileWatcherBackend final
+{
+public:
+    FileWatcherBackend();
+    ~FileWatcherBackend();
+
+    void Add(const String& directory, bool recursive);
+    void Remove(const String& directory);
+    void RemoveAll();
+
+    void Run();
+    void Stop();
+    Signal<const String&, FileWatcher::eWatchEvent> onWatchersChanged;
+
+private:
+    struct WatchNode;
+
+    struct WatchDirectory
+    {
+        String path; // with trailing slash
+        WatchNode* node = nullptr;
+    };
+
+    struct ScanRequest
+    {
+        String path;
+        std::shared_ptr<WatchNode> node;
+        bool reportCreated = false; // content of directory created after watch was added is reported as created
+    };
+
+    struct PendingEvent
+    {
+        String path;
+        FileWatcher::eWatchEvent event;
+        bool cancelled = false;
+    };
+
+    bool AddWatch(const String& path, WatchNode* node);
+    void RemoveWatches(const String& pathPrefix);
+    void RemoveNode(const std::shared_ptr<WatchNode>& node);
+
+    bool ProcessScans();
+    void ReadEvents();
+    void PushEvent(const String& path, FileWatcher::eWatchEvent event);
+    void FlushEvents();
+    int32 GetFlushTimeout() const;
+    void Wakeup();
+
+    int inotifyDescriptor = -1;
+    int wakeupPipe[2] = { -1, -1 };
+
+    Mutex mutex;
+    Vector<std::shared_ptr<WatchNode>> nodes;
+    UnorderedMap<int, WatchDirectory> watchDirectories;
+    Deque<ScanRequest> pendingScans;
+    bool stopRequested = false;
+
+    // used only on watcher thread
+    Vector<PendingEvent> pendingEvents;
+    UnorderedMap<String, size_t> pendingEventIndices;
+    int64 firstPendingEventMs = 0;
+    int64 lastPendingEventMs = 0;
+};
+} // namespace DAVA
+#endif // __DAVAENGINE_LINUX__
@@ -0,0 +1,113 @@
+#include "FileSystem/Private/MemoryMappedFile.h"
+#include "FileSystem/FilePath.h"
+#include "Logger/Logger.h"
+
+#if defined(__DAVAENGINE_WIN32__)
+#include "Utils/UTF8Utils.h"
+#elif defined(__DAVAENGINE_POSIX__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace DAVA
+{
+#if defined(__DAVAENGINE_WIN32__)
+
+std::unique_ptr<MemoryMappedFile> MemoryMappedFile::Open(const FilePath& filePath)
+{
+    WideString path = UTF8Utils::EncodeToWideString(filePath.GetAbsolutePathname());
+    HANDLE file = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return nullptr;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (::GetFileSizeEx(file, &fileSize) == FALSE || fileSize.QuadPart == 0 || static_cast<uint64>(fileSize.QuadPart) > std::numeric_limits<size_t>::max())
+    {
+        ::CloseHandle(file);
+        return nullptr;
+    }
+
+    // mapping keeps its own reference to file
+    HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    ::CloseHandle(file);
+    if (mapping == nullptr)
+    {
+        return nullptr;
+    }
+
+    void* view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr)
+    {
+        Logger::Warning("can't map file into memory: %s", filePath.GetAbsolutePathname().c_str());
+        ::CloseHandle(mapping);
+        return nullptr;
+    }
+
+    std::unique_ptr<MemoryMappedFile> result(new MemoryMappedFile());
+    result->data = static_cast<const uint8*>(view);
+    result->size = static_cast<uint64>(fileSize.QuadPart);
+    result->mappingHandle = mapping;
+    return result;
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    ::UnmapViewOfFile(data);
+    ::CloseHandle(mappingHandle);
+}
+
+#elif defined(__DAVAENGINE_POSIX__)
+
+std::unique_ptr<MemoryMappedFile> MemoryMappedFile::Open(const FilePath& filePath)
+{
+    const String& path = filePath.GetAbsolutePathname();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        return nullptr;
+    }
+
+    struct stat fileStat;
+    if (::fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0 || static_cast<uint64>(fileStat.st_size) > std::numeric_limits<size_t>::max())
+    {
+        ::close(fd);
+        return nullptr;
+    }
+
+    // mapping stays valid after descriptor is closed
+    size_t fileSize = static_cast<size_t>(fileStat.st_size);
+    void* view = ::mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED)
+    {
+        Logger::Warning("can't map file into memory: %s", path.c_str());
+        return nullptr;
+    }
+
+    std::unique_ptr<MemoryMappedFile> result(new MemoryMappedFile());
+    result->data = static_cast<const uint8*>(view);
+    result->size = static_cast<uint64>(fileSize);
+    return result;
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    ::munmap(const_cast<uint8*>(data), static_cast<size_t>(size));
+}
+
+#else
+
+std::unique_ptr<MemoryMappedFile> MemoryMappedFile::Open(const FilePath& filePath)
+{
+    return nullptr;
+}
+
+MemoryMappedFile::~MemoryMappedFile() = default;
+
+#endif
+
+} // end namespace DAVA
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+
+namespace DAVA
+{
+class FilePath;
+
+/**
+    Read-only memory mapping of a whole file on disk.
+    Mapped content can be read from any thread without synchronization.
+*/
+class MemoryMappedFile final
+{
+public:
+    /**
+        Map file with given path into memory.
+        Return nullptr if file can't be mapped (e.g. it is not on real file system,
+        is too large for address space or platform doesn't support mapping).
+    */
+    static std::unique_ptr<MemoryMappedFile> Open(const FilePath& filePath);
+
+    ~MemoryMappedFile();
+
+    const uint8* GetData() const;
+    uint64 GetSize() const;
+
+private:
+    MemoryMappedFile() = default;
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    const uint8* data = nullptr;
+    uint64 size = 0;
+#if defined(__DAVAENGINE_WIN32__)
+    void* mappingHandle = nullptr;
+#endif
+};
+
+inline const uint8* MemoryMappedFile::GetData() const
+{
+    return data;
+}
+
+inline uint64 MemoryMappedFile::GetSize() const
+{
+    return size;
+}
+
+} // end namespace DAVA
@@ -5,6 +5,7 @@
 #include "Utils/CRC32.h"
 #include "Logger/Logger.h"
 #include "Base/Exception.h"
+#include "Concurrency/LockGuard.h"
 
 #include <mutex>
 
@@ -174,6 +175,22 @@ PackArchive::PackArchive(RefPtr<File>& file_, const FilePath& archiveName_)
         }
         packMeta.reset(new PackMetaData(&metaBlock[0], metaBlock.size(), fileNames));
     }
+
+    // mapped pack is read by many threads at once without seeking shared file
+    mappedFile = MemoryMappedFile::Open(archiveName);
+    if (mappedFile && mappedFile->GetSize() != size)
+    {
+        mappedFile.reset();
+    }
+
+    if (mappedFile)
+    {
+        viewsCrc32Checked.reset(new std::atomic<bool>[footerBlock.info.numFiles]);
+        for (uint32 i = 0; i < footerBlock.info.numFiles; ++i)
+        {
+            viewsCrc32Checked[i] = false;
+        }
+    }
 }
 
 const Vector<ResourceArchive::FileInfo>& PackArchive::GetFilesInfo() const
@@ -206,51 +223,60 @@ bool PackArchive::LoadFile(const String& relativeFilePath, Vector<uint8>& output
 {
     using namespace PackFormat;
 
-    if (!HasFile(relativeFilePath))
+    auto it = mapFileData.find(relativeFilePath);
+    if (it == mapFileData.end())
     {
         return false;
     }
 
-    const FileTableEntry& fileEntry = *mapFileData.find(relativeFilePath)->second;
+    const FileTableEntry& fileEntry = *it->second;
     output.resize(fileEntry.originalSize);
 
-    if (!file)
-    {
-        DAVA_THROW(DAVA::Exception, "can't open: " + relativeFilePath + " from pack: " + archiveName.GetStringValue());
-    }
-
-    bool isOk = file->Seek(fileEntry.startPosition, File::SEEK_FROM_START);
-    if (!isOk)
-    {
-        Logger::Error("can't load file: %s course: can't find start file position in pack file", relativeFilePath.c_str());
-        return false;
-    }
+    bool isCompressed = fileEntry.type != Compressor::Type::None;
+    uint32 contentSize = isCompressed ? fileEntry.compressedSize : fileEntry.originalSize;
 
-    switch (fileEntry.type)
-    {
-    case Compressor::Type::None:
+    // compressed content is decompressed straight from mapping, uncompressed is copied once
+    const uint8* content = nullptr;
+    Vector<uint8> packedBuf;
+    if (mappedFile)
     {
-        uint32 readOk = file->Read(output.data(), fileEntry.originalSize);
-        if (readOk != fileEntry.originalSize)
+        content = GetMappedContent(fileEntry.startPosition, contentSize);
+        if (content == nullptr)
         {
-            Logger::Error("can't load file: %s course: can't read uncompressed content", relativeFilePath.c_str());
+            Logger::Error("can't load file: %s course: content is out of pack file bounds", relativeFilePath.c_str());
             return false;
         }
+
+        if (!isCompressed)
+        {
+            std::copy_n(content, contentSize, output.data());
+        }
     }
-    break;
-    case Compressor::Type::Lz4:
-    case Compressor::Type::Lz4HC:
+    else
     {
-        Vector<uint8> packedBuf(fileEntry.compressedSize);
+        uint8* readBuffer = output.data();
+        if (isCompressed)
+        {
+            packedBuf.resize(contentSize);
+            readBuffer = packedBuf.data();
+        }
 
-        uint32 readOk = file->Read(packedBuf.data(), fileEntry.compressedSize);
-        if (readOk != fileEntry.compressedSize)
+        if (!ReadContent(fileEntry.startPosition, readBuffer, contentSize))
         {
-            Logger::Error("can't load file: %s course: can't read compressed content", relativeFilePath.c_str());
+            Logger::Error("can't load file: %s course: can't read content", relativeFilePath.c_str());
             return false;
         }
+        content = readBuffer;
+    }
 
-        if (!LZ4Compressor().Decompress(packedBuf, output))
+    switch (fileEntry.type)
+    {
+    case Compressor::Type::None:
+        break;
+    case Compressor::Type::Lz4:
+    case Compressor::Type::Lz4HC:
+    {
+        if (!LZ4Compressor().Decompress(content, contentSize, output.data(), fileEntry.originalSize))
         {
             Logger::Error("can't load file: %s  course: decompress error", relativeFilePath.c_str());
             return false;
@@ -259,16 +285,7 @@ bool PackArchive::LoadFile(const String& relativeFilePath, Vector<uint8>& output
     break;
     case Compressor::Type::RFC1951:
     {
-        Vector<uint8> packedBuf(fileEntry.compressedSize);
-
-        uint32 readOk = file->Read(packedBuf.data(), fileEntry.compressedSize);
-        if (readOk != fileEntry.compressedSize)
-        {
-            Logger::Error("can't load file: %s course: can't read compressed content", relativeFilePath.c_str());
-            return false;
-        }
-
-        if (!ZipCompressor().Decompress(packedBuf, output))
+        if (!ZipCompressor().Decompress(content, contentSize, output.data(), fileEntry.originalSize))
         {
             Logger::Error("can't load file: %s  course: decompress error", relativeFilePath.c_str());
             return false;
@@ -277,14 +294,82 @@ bool PackArchive::LoadFile(const String& relativeFilePath, Vector<uint8>& output
     break;
     } // end switch
 
+    CheckCrc32(relativeFilePath, fileEntry, output.data());
+
+    return true;
+}
+
+bool PackArchive::GetFileView(const String& relativeFilePath, const uint8*& data, uint32& size) const
+{
+    using namespace PackFormat;
+
+    auto it = mapFileData.find(relativeFilePath);
+    if (it == mapFileData.end() || !mappedFile)
+    {
+        return false;
+    }
+
+    const FileTableEntry& fileEntry = *it->second;
+    if (fileEntry.type != Compressor::Type::None)
+    {
+        return false;
+    }
+
+    const uint8* content = GetMappedContent(fileEntry.startPosition, fileEntry.originalSize);
+    if (content == nullptr)
+    {
+        Logger::Error("can't map file: %s course: content is out of pack file bounds", relativeFilePath.c_str());
+        return false;
+    }
+
+    // mapped content doesn't change, so it is checked only when entry is viewed first time
+    std::atomic<bool>& crc32Checked = viewsCrc32Checked[std::distance(packFile.filesTable.data.files.data(), &fileEntry)];
+    if (!crc32Checked.load(std::memory_order_acquire))
+    {
+        CheckCrc32(relativeFilePath, fileEntry, content);
+        crc32Checked.store(true, std::memory_order_release);
+    }
+
+    data = content;
+    size = fileEntry.originalSize;
+    return true;
+}
+
+const uint8* PackArchive::GetMappedContent(uint64 position, uint32 size) const
+{
+    DVASSERT(mappedFile);
+
+    uint64 mappedSize = mappedFile->GetSize();
+    if (position > mappedSize || size > mappedSize - position)
+    {
+        return nullptr;
+    }
+    return mappedFile->GetData() + position;
+}
+
+bool PackArchive::ReadContent(uint64 position, uint8* output, uint32 size) const
+{
+    if (!file)
+    {
+        DAVA_THROW(DAVA::Exception, "can't read from pack: " + archiveName.GetStringValue());
+    }
+
+    LockGuard<Mutex> lock(fileMutex);
+    if (!file->Seek(position, File::SEEK_FROM_START))
+    {
+        return false;
+    }
+    return file->Read(output, size) == size;
+}
+
+void PackArchive::CheckCrc32(const String& relativeFilePath, const PackFormat::FileTableEntry& fileEntry, const uint8* content) const
+{
     // check crc32 for file content
-    if (fileEntry.originalCrc32 != 0 && fileEntry.originalCrc32 != CRC32::ForBuffer(output.data(), output.size()))
+    if (fileEntry.originalCrc32 != 0 && fileEntry.originalCrc32 != CRC32::ForBuffer(content, fileEntry.originalSize))
     {
         String msg = "original crc32 not match for: " + relativeFilePath + " during decompress from pack: " + archiveName.GetStringValue();
         throw FileCrc32FromPackNotMatch(msg, __FILE__, __LINE__);
     }
-
-    return true;
 }
 
 uint32 PackArchive::GetFileIndex(const String& releativeFilePath) const
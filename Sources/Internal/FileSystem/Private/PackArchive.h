@@ -3,7 +3,11 @@
 #include "FileSystem/Private/ResourceArchivePrivate.h"
 #include "FileSystem/Private/PackFormatSpec.h"
 #include "FileSystem/Private/PackMetaData.h"
+#include "FileSystem/Private/MemoryMappedFile.h"
 #include "FileSystem/File.h"
+#include "Concurrency/Mutex.h"
+
+#include <atomic>
 
 namespace DAVA
 {
@@ -16,6 +20,7 @@ public:
     const ResourceArchive::FileInfo* GetFileInfo(const String& relativeFilePath) const override;
     bool HasFile(const String& relativeFilePath) const override;
     bool LoadFile(const String& relativeFilePath, Vector<uint8>& output) const override;
+    bool GetFileView(const String& relativeFilePath, const uint8*& data, uint32& size) const override;
 
     /**
 		return index of struct with file info, usefull for meta data
@@ -43,8 +48,17 @@ public:
                               Vector<ResourceArchive::FileInfo>& filesInfo);
 
 private:
+    /** Return pointer to `size` bytes of mapped pack at `position` or nullptr if they are out of bounds. */
+    const uint8* GetMappedContent(uint64 position, uint32 size) const;
+    /** Read `size` bytes at `position` from pack file when it isn't mapped. */
+    bool ReadContent(uint64 position, uint8* output, uint32 size) const;
+    void CheckCrc32(const String& relativeFilePath, const PackFormat::FileTableEntry& fileEntry, const uint8* content) const;
+
     const FilePath archiveName;
     mutable RefPtr<File> file;
+    mutable Mutex fileMutex; // guards position of `file` when pack isn't mapped
+    std::unique_ptr<MemoryMappedFile> mappedFile;
+    std::unique_ptr<std::atomic<bool>[]> viewsCrc32Checked; // per file table entry, crc32 of mapped content is checked on first GetFileView
     PackFormat::PackFile packFile;
     std::unique_ptr<PackMetaData> packMeta;
     UnorderedMap<String, const PackFormat::FileTableEntry*> mapFileData;
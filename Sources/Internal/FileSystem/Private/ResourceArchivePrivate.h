@@ -13,6 +13,7 @@ public:
     virtual const ResourceArchive::FileInfo* GetFileInfo(const String& relativeFilePath) const = 0;
     virtual bool HasFile(const String& relativeFilePath) const = 0;
     virtual bool LoadFile(const String& relativeFilePath, Vector<uint8>& output) const = 0;
+    virtual bool GetFileView(const String& relativeFilePath, const uint8*& data, uint32& size) const = 0;
 };
 
 } // end namespace DAVA
@@ -97,6 +97,11 @@ bool ResourceArchive::LoadFile(const String& relativeFilePath,
     return impl->LoadFile(relativeFilePath, output);
 }
 
+bool ResourceArchive::GetFileView(const String& relativeFilePath, const uint8*& data, uint32& size) const
+{
+    return impl->GetFileView(relativeFilePath, data, size);
+}
+
 bool ResourceArchive::UnpackToFolder(const FilePath& dir) const
 {
     Vector<uint8> content;
@@ -43,6 +43,13 @@ public:
     const FileInfo* GetFileInfo(const String& relativeFilePath) const;
     bool HasFile(const String& relativeFilePath) const;
     bool LoadFile(const String& relativeFilePath, Vector<uint8>& outputFileContent) const;
+    /**
+        Get content of file stored uncompressed in memory mapped archive without copy.
+        Returned memory is valid while archive is alive. Return false if file is absent,
+        compressed or archive can't be mapped, use LoadFile in that case.
+        Both LoadFile and GetFileView can be called from several threads at once.
+    */
+    bool GetFileView(const String& relativeFilePath, const uint8*& data, uint32& size) const;
 
     bool UnpackToFolder(const FilePath& dir) const;
 
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Concurrency/Atomic.h"
+
+#include <memory>
+
+namespace DAVA
+{
+struct WorkerJob;
+
+/**
+    Handle to a worker job (or a group of worker jobs) created with `JobManager::CreateWorkerJob`.
+
+    Handle holds a shared counter of not yet finished jobs. Several jobs can be attached to the same
+    handle, in that case handle becomes done only when all of them are finished.
+    Default-constructed handle is invalid and is always treated as done.
+
+    Usage:
+    \code
+    JobHandle handle = jobManager->CreateWorkerJob(fn1);
+    jobManager->CreateWorkerJob(fn2, handle); // attach fn2 to the same handle
+    ...
+    jobManager->WaitWorkerJob(handle); // wait only for fn1 and fn2
+    \endcode
+*/
+class JobHandle final
+{
+public:
+    JobHandle() = default;
+
+    /** Return true if handle refers to some job(s). */
+    bool IsValid() const;
+
+    /** Return true if all jobs attached to handle are finished. Invalid handle is always done. */
+    bool IsDone() const;
+
+    /** Return number of attached jobs which are not finished yet. */
+    uint32 GetPendingCount() const;
+
+    /** Create valid handle without jobs. Jobs can be attached to it later with `JobManager::CreateWorkerJob`. */
+    static JobHandle Create();
+
+private:
+    struct Counter
+    {
+        Atomic<uint32> pending;
+    };
+
+    std::shared_ptr<Counter> counter;
+
+    friend class JobManager;
+    friend class JobQueueWorker;
+    friend struct WorkerJob;
+};
+
+inline bool JobHandle::IsValid() const
+{
+    return (counter != nullptr);
+}
+
+inline bool JobHandle::IsDone() const
+{
+    return (counter == nullptr || counter->pending.Get() == 0);
+}
+
+inline uint32 JobHandle::GetPendingCount() const
+{
+    return (counter != nullptr) ? counter->pending.Get() : 0;
+}
+
+inline JobHandle JobHandle::Create()
+{
+    JobHandle handle;
+    handle.counter = std::make_shared<Counter>();
+    return handle;
+}
+}
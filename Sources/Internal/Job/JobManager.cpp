@@ -16,13 +16,14 @@ JobManager::JobManager(Engine* e)
     , mainJobIDCounter(1)
     , mainJobLastExecutedID(0)
     , workerDoneSem(0)
+    , workerQueue(DeviceInfo::GetCpuCount(), &workerDoneSem)
 {
     uint32 cpuCoresCount = DeviceInfo::GetCpuCount();
     workerThreads.reserve(cpuCoresCount);
 
     for (uint32 i = 0; i < cpuCoresCount; ++i)
     {
-        JobThread* thread = new JobThread(&workerQueue, &workerDoneSem);
+        JobThread* thread = new JobThread(&workerQueue, i, &workerDoneSem);
         workerThreads.push_back(thread);
     }
 
@@ -235,10 +236,19 @@ bool JobManager::HasMainJobID(uint32 mainJobID)
     return (mainJobID > mainJobLastExecutedID);
 }
 
-void JobManager::CreateWorkerJob(const Function<void()>& fn)
+JobHandle JobManager::CreateWorkerJob(const Function<void()>& fn)
 {
-    workerQueue.Push(fn);
+    return CreateWorkerJob(fn, JobHandle());
+}
+
+JobHandle JobManager::CreateWorkerJob(const Function<void()>& fn, const JobHandle& handle)
+{
+    JobHandle ret = handle.IsValid() ? handle : JobHandle::Create();
+
+    workerQueue.Push(fn, ret);
     workerQueue.Signal();
+
+    return ret;
 }
 
 void JobManager::WaitWorkerJobs()
@@ -262,6 +272,48 @@ void JobManager::WaitWorkerJobs()
     }
 }
 
+void JobManager::WaitWorkerJob(const JobHandle& handle)
+{
+    if (handle.IsDone())
+    {
+        return;
+    }
+
+    bool isMainThread = Thread::IsMainThread();
+    if (isMainThread)
+    {
+        workerQueue.BeginWaitHandle();
+    }
+
+    while (!handle.IsDone())
+    {
+        if (isMainThread)
+        {
+            // allow worker jobs to execute main jobs, see WaitWorkerJobs
+            Update();
+        }
+
+        if (!workerQueue.PopAndExec() && !handle.IsDone())
+        {
+            if (isMainThread)
+            {
+                // workerDoneSem is posted when handle becomes done,
+                // when worker thread drains the queue or requests main job
+                workerDoneSem.Wait();
+            }
+            else
+            {
+                Thread::Yield();
+            }
+        }
+    }
+
+    if (isMainThread)
+    {
+        workerQueue.EndWaitHandle();
+    }
+}
+
 bool JobManager::HasWorkerJobs()
 {
     return !workerQueue.IsEmpty();
@@ -6,6 +6,7 @@
 #include "Concurrency/Semaphore.h"
 #include "Concurrency/Thread.h"
 #include "Functional/Function.h"
+#include "Job/JobHandle.h"
 #include "Job/JobQueue.h"
 
 namespace DAVA
@@ -59,12 +60,27 @@ public:
 
     /*! Add function to execute in the worker-thread.
 		\param [in] fn Function to execute.
+        \return Handle of created job. It can be used to wait until this job is finished.
 	*/
-    void CreateWorkerJob(const Function<void()>& fn);
+    JobHandle CreateWorkerJob(const Function<void()>& fn);
+
+    /*! Add function to execute in the worker-thread and attach it to the given handle.
+        Handle becomes done only when all attached jobs are finished.
+        \param [in] fn Function to execute.
+        \param [in] handle Handle to attach job to. If handle is invalid, new handle is created.
+        \return Handle the job was attached to.
+    */
+    JobHandle CreateWorkerJob(const Function<void()>& fn, const JobHandle& handle);
 
     /*! Wait until all worker-thread jobs are executed. */
     void WaitWorkerJobs();
 
+    /*! Wait until all jobs attached to the given handle are executed.
+        While waiting, calling thread executes pending worker jobs itself.
+        \param [in] handle Handle returned by CreateWorkerJob.
+    */
+    void WaitWorkerJob(const JobHandle& handle);
+
     /*!  Check in there are some not executed worker-thread jobs.
 		\return Return true if there are some jobs, otherwise false.
 	*/
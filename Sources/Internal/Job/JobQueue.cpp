@@ -1,80 +1,352 @@
 #include "Job/JobQueue.h"
 #include "Job/JobManager.h"
 #include "Concurrency/LockGuard.h"
+#include "Concurrency/Thread.h"
+#include "Math/MathHelpers.h"
 
 namespace DAVA
 {
-JobQueueWorker::JobQueueWorker(uint32 maxCount /* = 1024 */)
-    : jobsMaxCount(maxCount)
-    , nextPushIndex(0)
-    , nextPopIndex(0)
+// Slots are owned by JobQueueWorker, so ThreadLocalPtr::Release is used to unbind thread
+ThreadLocalPtr<JobQueueWorker::WorkerSlot> JobQueueWorker::currentWorkerSlot;
+
+//////////////////////////////////////////////////////////////////////////
+// JobDeque
+
+JobDeque::Buffer::Buffer(int64 capacity_)
+    : capacity(capacity_)
+    , mask(capacity_ - 1)
+{
+    items = new std::atomic<WorkerJob*>[static_cast<size_t>(capacity)];
+}
+
+JobDeque::Buffer::~Buffer()
+{
+    SafeDeleteArray(items);
+}
+
+WorkerJob* JobDeque::Buffer::Get(int64 index) const
+{
+    return items[index & mask].load(std::memory_order_relaxed);
+}
+
+void JobDeque::Buffer::Put(int64 index, WorkerJob* job)
+{
+    items[index & mask].store(job, std::memory_order_relaxed);
+}
+
+JobDeque::Buffer* JobDeque::Buffer::Grow(int64 bottom, int64 top) const
+{
+    Buffer* newBuffer = new Buffer(capacity * 2);
+    for (int64 i = top; i < bottom; ++i)
+    {
+        newBuffer->Put(i, Get(i));
+    }
+    return newBuffer;
+}
+
+JobDeque::JobDeque(uint32 initialCapacity)
+    : top(0)
+    , bottom(0)
+{
+    DVASSERT(IsPowerOf2(initialCapacity) && "Capacity of JobDeque should be pow of two");
+    buffer.store(new Buffer(initialCapacity), std::memory_order_relaxed);
+}
+
+JobDeque::~JobDeque()
+{
+    delete buffer.load(std::memory_order_relaxed);
+    for (Buffer* b : retiredBuffers)
+    {
+        delete b;
+    }
+}
+
+void JobDeque::Push(WorkerJob* job)
+{
+    int64 b = bottom.load(std::memory_order_relaxed);
+    int64 t = top.load(std::memory_order_acquire);
+    Buffer* buf = buffer.load(std::memory_order_relaxed);
+
+    if (b - t > buf->capacity - 1)
+    {
+        // thieves can still read from the old buffer, so it is released only in destructor
+        retiredBuffers.push_back(buf);
+        buf = buf->Grow(b, t);
+        buffer.store(buf, std::memory_order_release);
+    }
+
+    buf->Put(b, job);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+WorkerJob* JobDeque::Pop()
+{
+    int64 b = bottom.load(std::memory_order_relaxed) - 1;
+    Buffer* buf = buffer.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64 t = top.load(std::memory_order_relaxed);
+
+    WorkerJob* job = nullptr;
+    if (t <= b)
+    {
+        job = buf->Get(b);
+        if (t == b)
+        {
+            // the last item, race with thieves
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                job = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+    }
+    else
+    {
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    return job;
+}
+
+WorkerJob* JobDeque::Steal()
+{
+    int64 t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64 b = bottom.load(std::memory_order_acquire);
+
+    WorkerJob* job = nullptr;
+    if (t < b)
+    {
+        Buffer* buf = buffer.load(std::memory_order_acquire);
+        job = buf->Get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            // lost race with owner or another thief
+            job = nullptr;
+        }
+    }
+
+    return job;
+}
+
+bool JobDeque::IsEmpty() const
+{
+    int64 b = bottom.load(std::memory_order_relaxed);
+    int64 t = top.load(std::memory_order_relaxed);
+    return (b <= t);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// JobQueueWorker
+
+JobQueueWorker::JobQueueWorker(uint32 workersCount, Semaphore* jobDoneSem_)
+    : jobDoneSem(jobDoneSem_)
+    , injectedCount(0)
+    , handleWaitersCount(0)
+    , queuedCount(0)
     , processingCount(0)
+    , sleepingCount(0)
 {
-    jobs = new Function<void()>[jobsMaxCount];
+    workerDeques.reserve(workersCount);
+    workerSlots.reserve(workersCount);
+    for (uint32 i = 0; i < workersCount; ++i)
+    {
+        workerDeques.push_back(new JobDeque());
+        workerSlots.push_back({ this, i });
+    }
 }
 
 JobQueueWorker::~JobQueueWorker()
 {
-    SafeDeleteArray(jobs);
+    // release jobs that were never executed
+    for (JobDeque* deque : workerDeques)
+    {
+        while (WorkerJob* job = deque->Steal())
+        {
+            delete job;
+        }
+        SafeDelete(deque);
+    }
+
+    while (WorkerJob* job = mainDeque.Steal())
+    {
+        delete job;
+    }
+
+    for (WorkerJob* job : injectedJobs)
+    {
+        delete job;
+    }
+    injectedJobs.clear();
 }
 
-void JobQueueWorker::Push(const Function<void()>& fn)
+void JobQueueWorker::Push(const Function<void()>& fn, const JobHandle& handle)
 {
     if (fn != nullptr)
     {
-        LockGuard<Spinlock> guard(lock);
-        if (nextPushIndex == nextPopIndex && 0 == processingCount)
+        WorkerJob* job = new WorkerJob();
+        job->fn = fn;
+        job->counter = handle.counter;
+
+        if (job->counter != nullptr)
         {
-            nextPushIndex = 0;
-            nextPopIndex = 0;
+            job->counter->pending++;
         }
 
-        DVASSERT(nextPushIndex < jobsMaxCount);
-
-        jobs[nextPushIndex++] = fn;
         processingCount++;
+
+        WorkerSlot* slot = currentWorkerSlot.Get();
+        if (slot != nullptr && slot->owner == this)
+        {
+            workerDeques[slot->index]->Push(job);
+        }
+        else if (Thread::IsMainThread())
+        {
+            mainDeque.Push(job);
+        }
+        else
+        {
+            LockGuard<Spinlock> guard(injectedLock);
+            injectedJobs.push_back(job);
+            injectedCount++;
+        }
+
+        queuedCount++;
     }
 }
 
-bool JobQueueWorker::PopAndExec()
+WorkerJob* JobQueueWorker::PopJob()
 {
-    bool ret = false;
-    Function<void()> fn;
+    WorkerJob* job = nullptr;
+    uint32 stealStartIndex = 0;
 
+    WorkerSlot* slot = currentWorkerSlot.Get();
+    if (slot != nullptr && slot->owner == this)
+    {
+        job = workerDeques[slot->index]->Pop();
+        stealStartIndex = slot->index + 1;
+    }
+    else if (Thread::IsMainThread())
     {
-        LockGuard<Spinlock> guard(lock);
-        if (nextPopIndex < nextPushIndex)
+        job = mainDeque.Pop();
+    }
+
+    if (job == nullptr && !mainDeque.IsEmpty())
+    {
+        job = mainDeque.Steal();
+    }
+
+    if (job == nullptr && injectedCount > 0)
+    {
+        LockGuard<Spinlock> guard(injectedLock);
+        if (!injectedJobs.empty())
         {
-            fn = std::move(jobs[nextPopIndex++]);
+            job = injectedJobs.front();
+            injectedJobs.pop_front();
+            injectedCount--;
         }
     }
 
-    if (fn != nullptr)
+    if (job == nullptr)
+    {
+        job = StealJob(stealStartIndex);
+    }
+
+    if (job != nullptr)
     {
-        fn();
+        queuedCount--;
+    }
+
+    return job;
+}
 
+WorkerJob* JobQueueWorker::StealJob(uint32 startIndex)
+{
+    uint32 count = static_cast<uint32>(workerDeques.size());
+    for (uint32 i = 0; i < count; ++i)
+    {
+        JobDeque* victim = workerDeques[(startIndex + i) % count];
+        if (!victim->IsEmpty())
         {
-            LockGuard<Spinlock> guard(lock);
-            DVASSERT(processingCount > 0);
-            processingCount--;
+            WorkerJob* job = victim->Steal();
+            if (job != nullptr)
+            {
+                return job;
+            }
         }
+    }
 
-        ret = true;
+    return nullptr;
+}
+
+void JobQueueWorker::ExecJob(WorkerJob* job)
+{
+    job->fn();
+
+    if (job->counter != nullptr)
+    {
+        uint32 pending = --job->counter->pending;
+        if (0 == pending && handleWaitersCount > 0 && jobDoneSem != nullptr)
+        {
+            jobDoneSem->Post();
+        }
+    }
+
+    delete job;
+
+    DVASSERT(processingCount > 0);
+    processingCount--;
+}
+
+bool JobQueueWorker::PopAndExec()
+{
+    WorkerJob* job = PopJob();
+    if (job != nullptr)
+    {
+        ExecJob(job);
+        return true;
     }
 
-    return ret;
+    return false;
 }
 
 bool JobQueueWorker::IsEmpty()
 {
-    LockGuard<Spinlock> guard(lock);
-    return (nextPopIndex == nextPushIndex && 0 == processingCount);
+    return (0 == processingCount);
+}
+
+void JobQueueWorker::AttachWorkerThread(uint32 workerIndex)
+{
+    DVASSERT(workerIndex < workerSlots.size());
+    currentWorkerSlot.Reset(&workerSlots[workerIndex]);
+}
+
+void JobQueueWorker::DetachWorkerThread()
+{
+    currentWorkerSlot.Release();
+}
+
+void JobQueueWorker::BeginWaitHandle()
+{
+    handleWaitersCount++;
+}
+
+void JobQueueWorker::EndWaitHandle()
+{
+    handleWaitersCount--;
 }
 
 void JobQueueWorker::Signal()
 {
-    LockGuard<Mutex> guard(jobsInQueueMutex);
-    jobsInQueueCV.NotifyOne();
+    // sleepingCount is incremented under jobsInQueueMutex before checking queuedCount,
+    // so if we see no sleeping workers here, they will see pushed job before going to sleep
+    if (sleepingCount > 0)
+    {
+        LockGuard<Mutex> guard(jobsInQueueMutex);
+        jobsInQueueCV.NotifyOne();
+    }
 }
 
 void JobQueueWorker::Broadcast()
@@ -86,6 +358,11 @@ void JobQueueWorker::Broadcast()
 void JobQueueWorker::Wait()
 {
     UniqueLock<Mutex> lock(jobsInQueueMutex);
-    jobsInQueueCV.Wait(lock);
+    sleepingCount++;
+    if (0 == queuedCount)
+    {
+        jobsInQueueCV.Wait(lock);
+    }
+    sleepingCount--;
 }
 }
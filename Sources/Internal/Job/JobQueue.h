@@ -2,36 +2,127 @@
 
 #include "Base/BaseTypes.h"
 #include "Functional/Function.h"
+#include "Concurrency/Atomic.h"
 #include "Concurrency/ConditionVariable.h"
 #include "Concurrency/Mutex.h"
+#include "Concurrency/Semaphore.h"
 #include "Concurrency/Spinlock.h"
+#include "Concurrency/ThreadLocalPtr.h"
+#include "Job/JobHandle.h"
+
+#include <atomic>
 
 namespace DAVA
 {
+struct WorkerJob
+{
+    Function<void()> fn;
+    std::shared_ptr<JobHandle::Counter> counter;
+};
+
+/**
+    Lock-free work-stealing deque (Chase-Lev) with unbounded capacity.
+
+    Only the owner thread is allowed to call `Push` and `Pop`, they work with the bottom of the deque in LIFO order.
+    Any other thread can call `Steal`, which takes jobs from the top of the deque in FIFO order.
+    When deque is full its storage is grown by the owner, old storage is kept alive until deque destruction,
+    because thieves may still read from it.
+*/
+class JobDeque
+{
+public:
+    JobDeque(uint32 initialCapacity = 256);
+    ~JobDeque();
+
+    void Push(WorkerJob* job);
+    WorkerJob* Pop();
+    WorkerJob* Steal();
+
+    bool IsEmpty() const;
+
+private:
+    struct Buffer
+    {
+        Buffer(int64 capacity);
+        ~Buffer();
+
+        WorkerJob* Get(int64 index) const;
+        void Put(int64 index, WorkerJob* job);
+        Buffer* Grow(int64 bottom, int64 top) const;
+
+        int64 capacity;
+        int64 mask;
+        std::atomic<WorkerJob*>* items;
+    };
+
+    JobDeque(const JobDeque&) = delete;
+    JobDeque& operator=(const JobDeque&) = delete;
+
+    std::atomic<int64> top;
+    std::atomic<int64> bottom;
+    std::atomic<Buffer*> buffer;
+    Vector<Buffer*> retiredBuffers;
+};
+
+/**
+    Queue of worker jobs shared by all JobThread's.
+
+    Every worker thread owns its own `JobDeque`, jobs created from worker thread are pushed into it.
+    Main thread owns a separate deque as well. Jobs created from other threads go into the shared injection queue.
+    Idle thread first takes jobs from own deque and, if it is empty, steals jobs from the deques of other threads.
+*/
 class JobQueueWorker
 {
 public:
-    JobQueueWorker(uint32 maxCount = 1024);
+    JobQueueWorker(uint32 workersCount, Semaphore* jobDoneSem = nullptr);
     virtual ~JobQueueWorker();
 
-    void Push(const Function<void()>& fn);
+    void Push(const Function<void()>& fn, const JobHandle& handle = JobHandle());
     bool PopAndExec();
 
     bool IsEmpty();
 
+    /** Bind calling thread to the deque with specified index. Should be called by worker thread before processing jobs. */
+    void AttachWorkerThread(uint32 workerIndex);
+    void DetachWorkerThread();
+
+    /** Request posting `jobDoneSem` every time some job handle becomes done. Used while waiting for handle. */
+    void BeginWaitHandle();
+    void EndWaitHandle();
+
     void Signal();
     void Broadcast();
     void Wait();
 
 protected:
-    uint32 jobsMaxCount;
-    Function<void()>* jobs;
+    struct WorkerSlot
+    {
+        JobQueueWorker* owner;
+        uint32 index;
+    };
+
+    // Slot of the worker thread bound to current thread, nullptr for non-worker threads
+    static ThreadLocalPtr<WorkerSlot> currentWorkerSlot;
+
+    WorkerJob* PopJob();
+    WorkerJob* StealJob(uint32 startIndex);
+    void ExecJob(WorkerJob* job);
+
+    Vector<JobDeque*> workerDeques;
+    Vector<WorkerSlot> workerSlots;
+    JobDeque mainDeque;
+
+    Spinlock injectedLock;
+    Deque<WorkerJob*> injectedJobs;
+    Atomic<int32> injectedCount;
+
+    Semaphore* jobDoneSem;
+    Atomic<int32> handleWaitersCount;
 
-    uint32 nextPushIndex;
-    uint32 nextPopIndex;
-    int32 processingCount;
+    Atomic<int32> queuedCount;
+    Atomic<int32> processingCount;
+    Atomic<int32> sleepingCount;
 
-    Spinlock lock;
     ConditionVariable jobsInQueueCV;
     Mutex jobsInQueueMutex;
 };
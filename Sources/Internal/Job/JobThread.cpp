@@ -2,8 +2,9 @@
 
 namespace DAVA
 {
-JobThread::JobThread(JobQueueWorker* _workerQueue, Semaphore* _workerDoneSem)
+JobThread::JobThread(JobQueueWorker* _workerQueue, uint32 _workerIndex, Semaphore* _workerDoneSem)
     : workerQueue(_workerQueue)
+    , workerIndex(_workerIndex)
     , workerDoneSem(_workerDoneSem)
     , threadCancel(false)
     , threadFinished(false)
@@ -30,6 +31,8 @@ JobThread::~JobThread()
 
 void JobThread::ThreadFunc()
 {
+    workerQueue->AttachWorkerThread(workerIndex);
+
     while (!threadCancel)
     {
         workerQueue->Wait();
@@ -41,6 +44,7 @@ void JobThread::ThreadFunc()
         workerDoneSem->Post();
     }
 
+    workerQueue->DetachWorkerThread();
     threadFinished = true;
 }
 
@@ -9,7 +9,7 @@ namespace DAVA
 class JobThread
 {
 public:
-    JobThread(JobQueueWorker* workerQueue, Semaphore* workerDoneSem);
+    JobThread(JobQueueWorker* workerQueue, uint32 workerIndex, Semaphore* workerDoneSem);
     ~JobThread();
 
     void Cancel();
@@ -17,6 +17,7 @@ public:
 protected:
     Thread* thread;
     JobQueueWorker* workerQueue;
+    uint32 workerIndex;
     Semaphore* workerDoneSem;
     volatile bool threadCancel;
     volatile bool threadFinished;
@@ -0,0 +1,58 @@
+#include "Job/ParallelFor.h"
+#include "Job/JobManager.h"
+#include "Concurrency/Atomic.h"
+#include "Engine/Engine.h"
+
+namespace DAVA
+{
+void ParallelFor(JobManager* jobManager, uint32 begin, uint32 end, uint32 grainSize, const Function<void(uint32, uint32)>& fn)
+{
+    if (begin >= end)
+    {
+        return;
+    }
+
+    grainSize = Max(grainSize, 1u);
+    uint32 chunksCount = (end - begin + grainSize - 1) / grainSize;
+    uint32 workersCount = (jobManager != nullptr) ? jobManager->GetWorkersCount() : 0;
+
+    if (chunksCount <= 1 || workersCount == 0)
+    {
+        fn(begin, end);
+        return;
+    }
+
+    // every job takes chunks one by one until range is exhausted,
+    // so that chunks of different cost are balanced between threads
+    Atomic<uint32> nextChunk(0);
+    auto processChunks = [&]()
+    {
+        uint32 chunk = nextChunk++;
+        while (chunk < chunksCount)
+        {
+            uint32 chunkBegin = begin + chunk * grainSize;
+            uint32 chunkEnd = Min(chunkBegin + grainSize, end);
+            fn(chunkBegin, chunkEnd);
+
+            chunk = nextChunk++;
+        }
+    };
+
+    // calling thread processes chunks too
+    uint32 jobsCount = Min(chunksCount - 1, workersCount);
+
+    JobHandle handle;
+    for (uint32 i = 0; i < jobsCount; ++i)
+    {
+        handle = jobManager->CreateWorkerJob(processChunks, handle);
+    }
+
+    processChunks();
+    jobManager->WaitWorkerJob(handle);
+}
+
+void ParallelFor(uint32 begin, uint32 end, uint32 grainSize, const Function<void(uint32, uint32)>& fn)
+{
+    ParallelFor(GetEngineContext()->jobManager, begin, end, grainSize, fn);
+}
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Functional/Function.h"
+
+namespace DAVA
+{
+class JobManager;
+
+/**
+    Process range [begin, end) in parallel on worker threads.
+
+    Range is split into chunks of `grainSize` elements, `fn(chunkBegin, chunkEnd)` is called once for every chunk.
+    Chunks are distributed dynamically between worker threads and the calling thread, so `fn` should be safe
+    to call concurrently for non-overlapping ranges. Function returns only when the whole range is processed.
+
+    If `jobManager` is nullptr, there are no worker threads or the range fits into single chunk,
+    `fn` is called for the whole range on the calling thread.
+
+    Usage:
+    \code
+    ParallelFor(jobManager, 0, count, 256, [&](uint32 begin, uint32 end) {
+        for (uint32 i = begin; i < end; ++i)
+            output[i] = input[i] * matrix;
+    });
+    \endcode
+*/
+void ParallelFor(JobManager* jobManager, uint32 begin, uint32 end, uint32 grainSize, const Function<void(uint32, uint32)>& fn);
+
+/** Same as above, uses job manager from engine context. */
+void ParallelFor(uint32 begin, uint32 end, uint32 grainSize, const Function<void(uint32, uint32)>& fn);
+}
@@ -0,0 +1,101 @@
+#include "Job/TaskGraph.h"
+#include "Job/JobManager.h"
+#include "Debug/DVAssert.h"
+
+namespace DAVA
+{
+TaskGraph::TaskId TaskGraph::AddTask(const Function<void()>& fn, const ComponentMask& readComponents, const ComponentMask& writeComponents)
+{
+    TaskId id = static_cast<TaskId>(tasks.size());
+
+    tasks.emplace_back();
+    Task& task = tasks.back();
+    task.fn = fn;
+    task.readComponents = readComponents;
+    task.writeComponents = writeComponents;
+
+    ComponentMask accessComponents = readComponents | writeComponents;
+    for (TaskId i = 0; i < id; ++i)
+    {
+        const Task& prev = tasks[i];
+        bool writeConflict = (prev.writeComponents & accessComponents).any();
+        bool readConflict = (prev.readComponents & writeComponents).any();
+        if (writeConflict || readConflict)
+        {
+            AddDependency(id, i);
+        }
+    }
+
+    return id;
+}
+
+void TaskGraph::AddDependency(TaskId task, TaskId dependency)
+{
+    DVASSERT(task < tasks.size());
+    DVASSERT(dependency < task, "Dependency should be added before task");
+
+    Vector<TaskId>& successors = tasks[dependency].successors;
+    if (std::find(successors.begin(), successors.end(), task) == successors.end())
+    {
+        successors.push_back(task);
+        tasks[task].dependenciesCount++;
+    }
+}
+
+void TaskGraph::Execute(JobManager* jobManager)
+{
+    if (jobManager == nullptr || jobManager->GetWorkersCount() == 0 || tasks.size() == 1)
+    {
+        // dependencies always point to previously added tasks,
+        // so order of addition is valid order of execution
+        for (Task& task : tasks)
+        {
+            task.fn();
+        }
+        return;
+    }
+
+    Vector<Atomic<uint32>> pendingDependencies(tasks.size());
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        pendingDependencies[i] = tasks[i].dependenciesCount;
+    }
+
+    // tasks spawned by finished tasks are attached to the same handle before
+    // finished task is released, so handle can't become done prematurely
+    JobHandle handle = JobHandle::Create();
+    for (TaskId id = 0; id < static_cast<TaskId>(tasks.size()); ++id)
+    {
+        if (tasks[id].dependenciesCount == 0)
+        {
+            jobManager->CreateWorkerJob([this, id, jobManager, handle, &pendingDependencies]() {
+                RunTask(id, jobManager, handle, pendingDependencies.data());
+            },
+                                        handle);
+        }
+    }
+
+    jobManager->WaitWorkerJob(handle);
+}
+
+void TaskGraph::RunTask(TaskId id, JobManager* jobManager, const JobHandle& handle, Atomic<uint32>* pendingDependencies)
+{
+    tasks[id].fn();
+
+    for (TaskId successor : tasks[id].successors)
+    {
+        if (--pendingDependencies[successor] == 0)
+        {
+            jobManager->CreateWorkerJob([this, successor, jobManager, handle, pendingDependencies]() {
+                RunTask(successor, jobManager, handle, pendingDependencies);
+            },
+                                        handle);
+        }
+    }
+}
+
+void TaskGraph::Clear()
+{
+    tasks.clear();
+}
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Functional/Function.h"
+#include "Job/JobHandle.h"
+
+namespace DAVA
+{
+class JobManager;
+
+/**
+    Set of tasks with dependencies executed on worker threads.
+
+    Every task declares components it reads and writes. Dependencies between tasks are deduced from
+    this declaration in order of addition: task depends on every previously added task that
+    - writes components this task reads or writes,
+    - reads components this task writes.
+    Tasks without conflicts run concurrently. Additional dependencies can be set explicitly with `AddDependency`.
+
+    Usage:
+    \code
+    TaskGraph graph;
+    graph.AddTask(updateSkeletons, ComponentUtils::MakeMask<TransformComponent>(), ComponentUtils::MakeMask<SkeletonComponent>());
+    graph.AddTask(updateWaves, ComponentMask(), ComponentUtils::MakeMask<WaveComponent>());
+    graph.Execute(jobManager); // both tasks run in parallel
+    \endcode
+*/
+class TaskGraph final
+{
+public:
+    using TaskId = uint32;
+
+    /** Add task and deduce its dependencies on previously added tasks. Return id of added task. */
+    TaskId AddTask(const Function<void()>& fn, const ComponentMask& readComponents, const ComponentMask& writeComponents);
+
+    /** Make `task` start only after `dependency` is finished. `dependency` should be added before `task`. */
+    void AddDependency(TaskId task, TaskId dependency);
+
+    /**
+        Run all tasks and wait until they are finished. Calling thread takes part in execution.
+        If `jobManager` is nullptr tasks are executed on calling thread in order of addition.
+    */
+    void Execute(JobManager* jobManager);
+
+    /** Remove all tasks. */
+    void Clear();
+
+    uint32 GetTasksCount() const;
+    bool IsEmpty() const;
+
+private:
+    struct Task
+    {
+        Function<void()> fn;
+        ComponentMask readComponents;
+        ComponentMask writeComponents;
+        Vector<TaskId> successors;
+        uint32 dependenciesCount = 0;
+    };
+
+    void RunTask(TaskId id, JobManager* jobManager, const JobHandle& handle, Atomic<uint32>* pendingDependencies);
+
+    Vector<Task> tasks;
+};
+
+inline uint32 TaskGraph::GetTasksCount() const
+{
+    return static_cast<uint32>(tasks.size());
+}
+
+inline bool TaskGraph::IsEmpty() const
+{
+    return tasks.empty();
+}
+}
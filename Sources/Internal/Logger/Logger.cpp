@@ -1,4 +1,5 @@
 #include "Logger/Logger.h"
+#include "Logger/Private/LoggerAsyncWriter.h"
 #include "Engine/Engine.h"
 #include "FileSystem/FileSystem.h"
 #include "Debug/DVAssert.h"
@@ -49,10 +50,15 @@ String ConvertCFormatListToString(const char8* format, va_list pargs)
 
 void Logger::Logv(eLogLevel ll, const char8* text, va_list li) const
 {
-    Logv(logFilename, ll, text, li);
+    FormatAndPost(nullptr, ll, text, li);
 }
 
 void Logger::Logv(const FilePath& customLogFilename, eLogLevel ll, const char8* text, va_list li) const
+{
+    FormatAndPost(&customLogFilename, ll, text, li);
+}
+
+void Logger::FormatAndPost(const FilePath* customLogFilename, eLogLevel ll, const char8* text, va_list li) const
 {
     if (!text || text[0] == '\0')
         return;
@@ -70,14 +76,22 @@ void Logger::Logv(const FilePath& customLogFilename, eLogLevel ll, const char8*
         String formatedMessage = ConvertCFormatListToString(text, li);
         formatedMessage += '\n';
 
-        Output(customLogFilename, ll, formatedMessage.c_str());
+        Post(customLogFilename, ll, formatedMessage.c_str(), formatedMessage.size());
     }
     else
     {
         stackbuf[charactersWritten] = '\n';
         stackbuf[charactersWritten + 1] = '\0';
 
-        Output(customLogFilename, ll, &stackbuf[0]);
+        Post(customLogFilename, ll, &stackbuf[0], charactersWritten + 1);
+    }
+}
+
+void Logger::Post(const FilePath* customLogFilename, eLogLevel ll, const char8* formatedMsg, size_t length) const
+{
+    if (asyncWriter == nullptr || !asyncWriter->Post(customLogFilename, ll, formatedMsg, length))
+    {
+        Output((customLogFilename != nullptr) ? *customLogFilename : logFilename, ll, formatedMsg);
     }
 }
 
@@ -101,6 +115,9 @@ Logger::Logger()
 
 Logger::~Logger()
 {
+    // writer uses outputs, so it is stopped first
+    asyncWriter.reset();
+
     for (auto logOutput : customOutputs)
     {
         delete logOutput;
@@ -138,6 +155,35 @@ void Logger::SetLogLevel(eLogLevel ll)
     logLevel = ll;
 }
 
+void Logger::EnableAsyncMode(uint32 threadBufferSize, eOverflowPolicy policy)
+{
+    // previous writer writes its messages before new one is started
+    asyncWriter.reset();
+
+    auto output = [this](const FilePath* customLogFilename, eLogLevel ll, const char8* text) {
+        Output((customLogFilename != nullptr) ? *customLogFilename : logFilename, ll, text);
+    };
+    asyncWriter.reset(new LoggerDetails::AsyncWriter(threadBufferSize, policy, output));
+}
+
+void Logger::DisableAsyncMode()
+{
+    asyncWriter.reset();
+}
+
+bool Logger::IsAsyncModeEnabled() const
+{
+    return asyncWriter != nullptr;
+}
+
+void Logger::Flush()
+{
+    if (asyncWriter != nullptr)
+    {
+        asyncWriter->Flush();
+    }
+}
+
 void Logger::Log(eLogLevel ll, const char8* text, ...) const
 {
     if (ll < logLevel)
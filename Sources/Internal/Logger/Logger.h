@@ -14,11 +14,17 @@
 #include "FileSystem/FilePath.h"
 
 #include <cstdarg>
+#include <memory>
 
 namespace DAVA
 {
 class LoggerOutput;
 
+namespace LoggerDetails
+{
+class AsyncWriter;
+}
+
 class Logger
 {
 public:
@@ -33,6 +39,12 @@ public:
         LEVEL__DISABLE //<! Disable logs.
     };
 
+    enum eOverflowPolicy
+    {
+        OVERFLOW_DROP = 0, //<! Message is dropped if buffer of logging thread is full. Count of dropped messages is logged later.
+        OVERFLOW_BLOCK //<! Logging thread waits until writer thread frees space in its buffer.
+    };
+
     Logger();
     virtual ~Logger();
 
@@ -58,6 +70,24 @@ public:
     //! \param ll - new log level filter value.
     virtual void SetLogLevel(eLogLevel ll);
 
+    /**
+        Enables asynchronous logging. Messages are formatted on calling thread and put into its ring buffer
+        of `threadBufferSize` bytes, outputs (platform log, files and custom outputs) are called on background writer thread.
+        Messages of one thread keep their order. Messages which don't fit into half of buffer are written synchronously.
+        Pending messages are written by Flush, DisableAsyncMode, Logger destruction and on crash (best effort).
+
+        Enabling and disabling should not race with logging from other threads.
+    */
+    void EnableAsyncMode(uint32 threadBufferSize = 64 * 1024, eOverflowPolicy policy = OVERFLOW_BLOCK);
+
+    //! Writes pending messages and returns to synchronous logging.
+    void DisableAsyncMode();
+
+    bool IsAsyncModeEnabled() const;
+
+    //! Waits until all messages logged before the call are written. Does nothing in synchronous mode.
+    void Flush();
+
     //! Prints out a text into the log
     //! \param text - Text to print out.
     //! \param ll - Log level of the text. If the text is an error, set
@@ -119,6 +149,10 @@ private:
     static Logger* GetLoggerInstance();
     bool CutOldLogFileIfExist(const FilePath& logFile) const;
 
+    // customLogFilename is nullptr for messages to default log file
+    void FormatAndPost(const FilePath* customLogFilename, eLogLevel ll, const char8* text, va_list li) const;
+    void Post(const FilePath* customLogFilename, eLogLevel ll, const char8* formatedMsg, size_t length) const;
+
     void FileLog(const FilePath& filepath, eLogLevel ll, const char8* text) const;
     void CustomLog(eLogLevel ll, const char8* text) const;
     void ConsoleLog(eLogLevel ll, const char8* text) const;
@@ -130,6 +164,7 @@ private:
     Vector<LoggerOutput*> customOutputs;
     bool consoleModeEnabled;
     uint32 cutLogSize = 512 * 1024; //0.5 MB;
+    std::unique_ptr<LoggerDetails::AsyncWriter> asyncWriter;
 };
 
 class LoggerOutput
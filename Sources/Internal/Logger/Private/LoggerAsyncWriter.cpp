@@ -0,0 +1,559 @@
+#include "Logger/Private/LoggerAsyncWriter.h"
+
+#include "Base/Platform.h"
+#include "Concurrency/LockGuard.h"
+#include "Concurrency/Thread.h"
+#include "Concurrency/ThreadLocalSlots.h"
+#include "Concurrency/UniqueLock.h"
+#include "Utils/StringFormat.h"
+
+#include <cerrno>
+#include <csignal>
+#include <exception>
+#include <limits>
+
+#if defined(__DAVAENGINE_WINDOWS__)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace DAVA
+{
+namespace LoggerDetails
+{
+namespace
+{
+const uint32 RECORD_ALIGNMENT = 16;
+const uint8 SKIP_RECORD = 0xff; // fills the end of buffer when record doesn't fit before wrap
+
+struct RecordHeader
+{
+    uint32 size; // whole record size including header and alignment
+    uint32 textLength;
+    uint16 pathLength;
+    uint8 level;
+    uint8 reserved[5];
+};
+static_assert(sizeof(RecordHeader) == RECORD_ALIGNMENT, "record header should keep records aligned");
+
+uint32 AlignRecordSize(size_t size)
+{
+    return static_cast<uint32>((size + RECORD_ALIGNMENT - 1) & ~static_cast<size_t>(RECORD_ALIGNMENT - 1));
+}
+
+uint32 RoundUpToPowerOfTwo(uint32 value)
+{
+    uint32 result = RECORD_ALIGNMENT * 16;
+    while (result < value)
+    {
+        result <<= 1;
+    }
+    return result;
+}
+
+// Buffer of current thread for writer with given generation
+struct ThreadSlot
+{
+    uint64 generation = 0;
+    void* buffer = nullptr;
+};
+
+ThreadSlot* GetThreadSlot()
+{
+    static ThreadLocalSlots<ThreadSlot> threadSlots;
+    return threadSlots.Get();
+}
+
+std::atomic<uint64> nextWriterGeneration{ 1 };
+
+// Raw write to stderr which may be called from signal handlers
+void WriteToStdErr(const char8* text, size_t length)
+{
+    while (length > 0)
+    {
+#if defined(__DAVAENGINE_WINDOWS__)
+        int written = _write(2, text, static_cast<unsigned int>(length));
+#else
+        ssize_t written = write(STDERR_FILENO, text, length);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+#endif
+        if (written <= 0)
+        {
+            break;
+        }
+        text += written;
+        length -= static_cast<size_t>(written);
+    }
+}
+
+// Crash handlers write pending messages of the writer which is active now.
+// Handlers are installed once and do nothing when async mode is disabled.
+std::atomic<AsyncWriter*> crashFlushWriter{ nullptr };
+std::terminate_handler previousTerminateHandler = nullptr;
+
+void FlushOnCrash()
+{
+    AsyncWriter* writer = crashFlushWriter.exchange(nullptr);
+    if (writer != nullptr)
+    {
+        writer->FlushOnCrash();
+    }
+}
+
+void OnTerminate()
+{
+    FlushOnCrash();
+    if (previousTerminateHandler != nullptr)
+    {
+        previousTerminateHandler();
+    }
+    std::abort();
+}
+
+#if defined(__DAVAENGINE_WINDOWS__)
+void (*previousAbortHandler)(int) = SIG_DFL;
+
+void OnAbortSignal(int sig)
+{
+    FlushOnCrash();
+    std::signal(sig, previousAbortHandler);
+    std::raise(sig);
+}
+
+#if defined(__DAVAENGINE_WIN32__)
+LPTOP_LEVEL_EXCEPTION_FILTER previousExceptionFilter = nullptr;
+
+LONG WINAPI OnUnhandledException(EXCEPTION_POINTERS* exceptionInfo)
+{
+    FlushOnCrash();
+    return (previousExceptionFilter != nullptr) ? previousExceptionFilter(exceptionInfo) : EXCEPTION_CONTINUE_SEARCH;
+}
+#endif
+
+void InstallCrashHandlers()
+{
+    previousTerminateHandler = std::set_terminate(&OnTerminate);
+    previousAbortHandler = std::signal(SIGABRT, &OnAbortSignal);
+#if defined(__DAVAENGINE_WIN32__)
+    previousExceptionFilter = ::SetUnhandledExceptionFilter(&OnUnhandledException);
+#endif
+}
+#else
+const int crashSignals[] = { SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT };
+struct sigaction previousSignalActions[sizeof(crashSignals) / sizeof(crashSignals[0])];
+
+// handler may run after stack overflow, so it uses alternate stack when thread has one
+const size_t CRASH_SIGNAL_STACK_SIZE = 64 * 1024;
+uint8 crashSignalStack[CRASH_SIGNAL_STACK_SIZE];
+
+void OnCrashSignal(int sig)
+{
+    FlushOnCrash();
+
+    // restore previous handler (crash reporter or default) and let it process the signal
+    for (size_t i = 0; i < sizeof(crashSignals) / sizeof(crashSignals[0]); ++i)
+    {
+        if (crashSignals[i] == sig)
+        {
+            sigaction(sig, &previousSignalActions[i], nullptr);
+        }
+    }
+    raise(sig);
+}
+
+void InstallCrashHandlers()
+{
+    previousTerminateHandler = std::set_terminate(&OnTerminate);
+
+    // alternate stack is per thread, it is set for installing thread if crash reporter didn't set one
+    stack_t currentStack = {};
+    if (sigaltstack(nullptr, &currentStack) == 0 && (currentStack.ss_flags & SS_DISABLE) != 0)
+    {
+        stack_t signalStack = {};
+        signalStack.ss_sp = crashSignalStack;
+        signalStack.ss_size = CRASH_SIGNAL_STACK_SIZE;
+        sigaltstack(&signalStack, nullptr);
+    }
+
+    struct sigaction action = {};
+    action.sa_handler = &OnCrashSignal;
+    action.sa_flags = SA_ONSTACK;
+    sigemptyset(&action.sa_mask);
+    for (size_t i = 0; i < sizeof(crashSignals) / sizeof(crashSignals[0]); ++i)
+    {
+        sigaction(crashSignals[i], &action, &previousSignalActions[i]);
+    }
+}
+#endif
+} // unnamed namespace
+
+struct AsyncWriter::ThreadBuffer
+{
+    explicit ThreadBuffer(uint32 size)
+        : data(size)
+        , mask(size - 1)
+    {
+    }
+
+    Vector<uint8> data;
+    const uint32 mask;
+
+    // positions grow monotonically, separate cache lines keep producer and consumer from false sharing
+    uint8 padding0[64];
+    std::atomic<uint64> writePos{ 0 };
+    uint8 padding1[64];
+    std::atomic<uint64> readPos{ 0 };
+    uint8 padding2[64];
+};
+
+AsyncWriter::AsyncWriter(uint32 threadBufferSize, Logger::eOverflowPolicy policy_, const OutputFn& output_)
+    : bufferSize(RoundUpToPowerOfTwo(threadBufferSize))
+    , policy(policy_)
+    , generation(nextWriterGeneration++)
+    , output(output_)
+{
+    static bool crashHandlersInstalled = false;
+    if (!crashHandlersInstalled)
+    {
+        InstallCrashHandlers();
+        crashHandlersInstalled = true;
+    }
+
+    thread = Thread::Create([this]() { WriterThread(); });
+    thread->SetName("LoggerWriter");
+    thread->Start();
+
+    crashFlushWriter = this;
+}
+
+AsyncWriter::~AsyncWriter()
+{
+    AsyncWriter* self = this;
+    crashFlushWriter.compare_exchange_strong(self, nullptr);
+
+    stopRequested = true;
+    wakeup.Post();
+    thread->Join();
+    SafeRelease(thread);
+
+    // messages posted while writer was stopping
+    Drain();
+}
+
+AsyncWriter::ThreadBuffer* AsyncWriter::GetThreadBuffer()
+{
+    ThreadSlot* slot = GetThreadSlot();
+    if (slot->generation != generation)
+    {
+        ThreadBuffer* buffer = new ThreadBuffer(bufferSize);
+        {
+            LockGuard<Mutex> lock(buffersMutex);
+            buffers.emplace_back(buffer);
+        }
+
+        slot->generation = generation;
+        slot->buffer = buffer;
+    }
+    return static_cast<ThreadBuffer*>(slot->buffer);
+}
+
+bool AsyncWriter::Post(const FilePath* customLogFilename, Logger::eLogLevel ll, const char8* text, size_t length)
+{
+    if (stopRequested.load(std::memory_order_relaxed))
+    {
+        WaitThreadBufferWritten();
+        return false;
+    }
+
+    String path;
+    if (customLogFilename != nullptr)
+    {
+        path = customLogFilename->GetStringValue();
+    }
+
+    uint32 recordSize = AlignRecordSize(sizeof(RecordHeader) + path.size() + length + 1);
+    if (recordSize > bufferSize / 2 || path.size() > std::numeric_limits<uint16>::max())
+    {
+        WaitThreadBufferWritten();
+        return false;
+    }
+
+    ThreadBuffer* buffer = GetThreadBuffer();
+    uint64 writePos = buffer->writePos.load(std::memory_order_relaxed);
+    uint32 offset = static_cast<uint32>(writePos) & buffer->mask;
+    uint32 spaceToEnd = bufferSize - offset;
+    uint32 requiredSize = (recordSize > spaceToEnd) ? spaceToEnd + recordSize : recordSize;
+
+    if (!WaitForSpace(buffer, writePos, requiredSize))
+    {
+        droppedMessages.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    if (recordSize > spaceToEnd)
+    {
+        RecordHeader* skip = reinterpret_cast<RecordHeader*>(&buffer->data[offset]);
+        skip->size = spaceToEnd;
+        skip->level = SKIP_RECORD;
+        writePos += spaceToEnd;
+        offset = 0;
+    }
+
+    RecordHeader* header = reinterpret_cast<RecordHeader*>(&buffer->data[offset]);
+    header->size = recordSize;
+    header->textLength = static_cast<uint32>(length);
+    header->pathLength = static_cast<uint16>(path.size());
+    header->level = static_cast<uint8>(ll);
+
+    char8* payload = reinterpret_cast<char8*>(header + 1);
+    memcpy(payload, path.data(), path.size());
+    memcpy(payload + path.size(), text, length);
+    payload[path.size() + length] = '\0';
+
+    // seq_cst store pairs with writerSleeping check below, so sleeping writer can't miss the record
+    buffer->writePos.store(writePos + recordSize);
+    if (writerSleeping.load() && writerSleeping.exchange(false))
+    {
+        wakeup.Post();
+    }
+    return true;
+}
+
+void AsyncWriter::WaitThreadBufferWritten()
+{
+    ThreadSlot* slot = GetThreadSlot();
+    if (slot->generation != generation)
+    {
+        return; // nothing was posted by calling thread
+    }
+
+    // thread which writes messages can't wait for itself, its own messages are written after current output
+    if (drainingThreadId.load() == Thread::GetCurrentIdAsUInt64())
+    {
+        return;
+    }
+
+    // stopped writer doesn't drain anymore, so buffer is drained here if writer is not busy with it
+    ThreadBuffer* buffer = static_cast<ThreadBuffer*>(slot->buffer);
+    while (buffer->readPos.load(std::memory_order_acquire) != buffer->writePos.load(std::memory_order_relaxed))
+    {
+        if (!Drain())
+        {
+            WakeWriter();
+            Thread::Yield();
+        }
+    }
+}
+
+bool AsyncWriter::WaitForSpace(ThreadBuffer* buffer, uint64 writePos, uint32 requiredSize)
+{
+    if (writePos - buffer->readPos.load(std::memory_order_acquire) + requiredSize <= bufferSize)
+    {
+        return true;
+    }
+
+    // writer thread can't wait for itself
+    if (policy == Logger::OVERFLOW_DROP || writerThreadId.load() == Thread::GetCurrentIdAsUInt64())
+    {
+        return false;
+    }
+
+    do
+    {
+        WakeWriter();
+        Thread::Yield();
+        if (stopRequested.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+    } while (writePos - buffer->readPos.load(std::memory_order_acquire) + requiredSize > bufferSize);
+
+    return true;
+}
+
+void AsyncWriter::WakeWriter()
+{
+    if (writerSleeping.exchange(false))
+    {
+        wakeup.Post();
+    }
+}
+
+void AsyncWriter::Flush()
+{
+    if (writerThreadId.load() == Thread::GetCurrentIdAsUInt64())
+    {
+        return; // messages of writer thread are written after current output
+    }
+
+    uint64 request = 0;
+    {
+        LockGuard<Mutex> lock(flushMutex);
+        request = ++flushRequested;
+    }
+
+    writerSleeping = false;
+    wakeup.Post();
+
+    UniqueLock<Mutex> lock(flushMutex);
+    flushCondition.Wait(lock, [this, request]() { return flushCompleted >= request; });
+}
+
+void AsyncWriter::FlushOnCrash()
+{
+    // may be called from signal handler: crashed thread may hold any lock or be in the middle of allocation,
+    // so records are written to stderr as is and nothing is written if buffers are in use
+    if (draining.exchange(true, std::memory_order_acquire))
+    {
+        return;
+    }
+
+    if (buffersMutex.TryLock())
+    {
+        for (const std::unique_ptr<ThreadBuffer>& buffer : buffers)
+        {
+            uint64 readPos = buffer->readPos.load(std::memory_order_relaxed);
+            uint64 writePos = buffer->writePos.load(std::memory_order_acquire);
+            while (readPos != writePos)
+            {
+                const RecordHeader* header = reinterpret_cast<const RecordHeader*>(&buffer->data[static_cast<uint32>(readPos) & buffer->mask]);
+                if (header->level != SKIP_RECORD)
+                {
+                    const char8* payload = reinterpret_cast<const char8*>(header + 1);
+                    WriteToStdErr(payload + header->pathLength, header->textLength);
+                }
+
+                readPos += header->size;
+                buffer->readPos.store(readPos, std::memory_order_release);
+            }
+        }
+        buffersMutex.Unlock();
+    }
+
+    draining.store(false, std::memory_order_release);
+}
+
+void AsyncWriter::WriterThread()
+{
+    writerThreadId = Thread::GetCurrentIdAsUInt64();
+
+    while (true)
+    {
+        uint64 flushRequest = 0;
+        {
+            LockGuard<Mutex> lock(flushMutex);
+            flushRequest = flushRequested;
+        }
+
+        bool stopping = stopRequested.load();
+        bool processed = Drain();
+
+        if (flushRequest > flushCompleted)
+        {
+            LockGuard<Mutex> lock(flushMutex);
+            flushCompleted = flushRequest;
+            flushCondition.NotifyAll();
+        }
+
+        if (stopping)
+        {
+            break;
+        }
+
+        if (!processed)
+        {
+            writerSleeping = true;
+            if (HasPendingRecords())
+            {
+                writerSleeping = false;
+            }
+            else
+            {
+                wakeup.Wait();
+            }
+        }
+    }
+}
+
+bool AsyncWriter::HasPendingRecords()
+{
+    LockGuard<Mutex> lock(buffersMutex);
+    for (const std::unique_ptr<ThreadBuffer>& buffer : buffers)
+    {
+        if (buffer->writePos.load() != buffer->readPos.load(std::memory_order_relaxed))
+        {
+            return true;
+        }
+    }
+
+    if (stopRequested.load())
+    {
+        return true;
+    }
+
+    LockGuard<Mutex> flushLock(flushMutex);
+    return flushRequested > flushCompleted;
+}
+
+bool AsyncWriter::Drain()
+{
+    // only one thread may consume records
+    if (draining.exchange(true, std::memory_order_acquire))
+    {
+        return false;
+    }
+    drainingThreadId = Thread::GetCurrentIdAsUInt64();
+
+    {
+        LockGuard<Mutex> lock(buffersMutex);
+        drainingBuffers.clear();
+        for (const std::unique_ptr<ThreadBuffer>& buffer : buffers)
+        {
+            drainingBuffers.push_back(buffer.get());
+        }
+    }
+
+    bool processed = false;
+    for (ThreadBuffer* buffer : drainingBuffers)
+    {
+        uint64 readPos = buffer->readPos.load(std::memory_order_relaxed);
+        uint64 writePos = buffer->writePos.load(std::memory_order_acquire);
+        while (readPos != writePos)
+        {
+            const RecordHeader* header = reinterpret_cast<const RecordHeader*>(&buffer->data[static_cast<uint32>(readPos) & buffer->mask]);
+            if (header->level != SKIP_RECORD)
+            {
+                const char8* payload = reinterpret_cast<const char8*>(header + 1);
+                if (header->pathLength > 0)
+                {
+                    FilePath path(String(payload, header->pathLength));
+                    output(&path, static_cast<Logger::eLogLevel>(header->level), payload + header->pathLength);
+                }
+                else
+                {
+                    output(nullptr, static_cast<Logger::eLogLevel>(header->level), payload);
+                }
+                processed = true;
+            }
+
+            readPos += header->size;
+            buffer->readPos.store(readPos, std::memory_order_release);
+        }
+    }
+
+    uint32 dropped = droppedMessages.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0)
+    {
+        output(nullptr, Logger::LEVEL_WARNING, Format("%u log messages were dropped because logging thread buffer was full\n", dropped).c_str());
+    }
+
+    drainingThreadId = 0;
+    draining.store(false, std::memory_order_release);
+    return processed;
+}
+} // namespace LoggerDetails
+} // namespace DAVA
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Logger/Logger.h"
+
+#include "Base/BaseTypes.h"
+#include "Concurrency/ConditionVariable.h"
+#include "Concurrency/Mutex.h"
+#include "Concurrency/Semaphore.h"
+#include "Functional/Function.h"
+
+#include <atomic>
+#include <memory>
+
+namespace DAVA
+{
+class Thread;
+
+namespace LoggerDetails
+{
+/**
+    Background writer of Logger async mode.
+
+    Every logging thread gets its own single-producer single-consumer ring buffer, so posting
+    a message is a copy into the buffer and a couple of atomic operations without any locks.
+    Writer thread drains all buffers and passes messages to output function.
+    Messages of one thread keep their order, messages of different threads may be reordered.
+*/
+class AsyncWriter final
+{
+public:
+    // customLogFilename is nullptr for messages to default log file
+    using OutputFn = Function<void(const FilePath* customLogFilename, Logger::eLogLevel ll, const char8* text)>;
+
+    AsyncWriter(uint32 threadBufferSize, Logger::eOverflowPolicy policy, const OutputFn& output);
+    ~AsyncWriter();
+
+    /**
+        Copies message into ring buffer of calling thread.
+        Returns false if message can't be posted (it is too big or writer is stopped) and should be written synchronously.
+        In this case messages posted by calling thread before are written before return, so order of its messages is kept.
+    */
+    bool Post(const FilePath* customLogFilename, Logger::eLogLevel ll, const char8* text, size_t length);
+
+    /** Waits until all messages posted before the call are written. */
+    void Flush();
+
+    /**
+        Writes pending messages to stderr on calling thread without waiting for writer thread. Used by crash handlers,
+        so it doesn't lock, allocate or call outputs, and writes nothing if buffers are being drained or registered.
+    */
+    void FlushOnCrash();
+
+private:
+    struct ThreadBuffer;
+
+    ThreadBuffer* GetThreadBuffer();
+    void WaitThreadBufferWritten();
+    bool WaitForSpace(ThreadBuffer* buffer, uint64 writePos, uint32 requiredSize);
+    void WakeWriter();
+
+    void WriterThread();
+    bool Drain();
+    bool HasPendingRecords();
+
+    const uint32 bufferSize;
+    const Logger::eOverflowPolicy policy;
+    const uint64 generation; // distinguishes buffers of this writer from buffers of previous ones in thread local slot
+    OutputFn output;
+
+    Mutex buffersMutex;
+    Vector<std::unique_ptr<ThreadBuffer>> buffers; // buffer of exited thread is reused with its thread slot by a new thread
+    Vector<ThreadBuffer*> drainingBuffers; // used only by thread which drains buffers
+
+    Thread* thread = nullptr;
+    std::atomic<uint64> writerThreadId{ 0 };
+    std::atomic<bool> stopRequested{ false };
+    std::atomic<bool> writerSleeping{ false };
+    std::atomic<bool> draining{ false };
+    std::atomic<uint64> drainingThreadId{ 0 };
+    std::atomic<uint32> droppedMessages{ 0 };
+    Semaphore wakeup;
+
+    Mutex flushMutex;
+    ConditionVariable flushCondition;
+    uint64 flushRequested = 0;
+    uint64 flushCompleted = 0;
+};
+} // namespace LoggerDetails
+} // namespace DAVA
@@ -10,6 +10,12 @@ void AABBox3::GetTransformedBox(const Matrix4& transform, AABBox3& result) const
         return;
     }
 
+#if defined(__DAVAENGINE_SSE2__)
+    __m128 rmin, rmax;
+    SSE_TransformBox(min.data, max.data, transform.data, rmin, rmax);
+    SSE_StoreVector3(rmin, result.min.data);
+    SSE_StoreVector3(rmax, result.max.data);
+#else
     result.min.x = transform.data[12];
     result.min.y = transform.data[13];
     result.min.z = transform.data[14];
@@ -37,6 +43,7 @@ void AABBox3::GetTransformedBox(const Matrix4& transform, AABBox3& result) const
             }
         };
     }
+#endif
 }
 
 void AABBox3::GetCorners(Vector3* cornersArray) const
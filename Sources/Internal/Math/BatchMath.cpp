@@ -0,0 +1,136 @@
+#include "Math/BatchMath.h"
+#include "Math/AABBox3.h"
+#include "Math/Matrix4.h"
+#include "Math/Vector.h"
+
+namespace DAVA
+{
+namespace BatchMath
+{
+void TransformPoints(const Matrix4& m, const Vector3* src, Vector3* dst, uint32 count)
+{
+    uint32 i = 0;
+
+#if defined(__DAVAENGINE_AVX__)
+    // two points per iteration: lower lane for src[i], upper lane for src[i + 1]
+    __m256 row0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m.data));
+    __m256 row1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m.data + 4));
+    __m256 row2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m.data + 8));
+    __m256 row3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m.data + 12));
+
+    for (; i + 1 < count; i += 2)
+    {
+        const Vector3& v0 = src[i];
+        const Vector3& v1 = src[i + 1];
+
+        __m256 r = _mm256_mul_ps(_mm256_setr_m128(_mm_set1_ps(v0.x), _mm_set1_ps(v1.x)), row0);
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_setr_m128(_mm_set1_ps(v0.y), _mm_set1_ps(v1.y)), row1));
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_setr_m128(_mm_set1_ps(v0.z), _mm_set1_ps(v1.z)), row2));
+        r = _mm256_add_ps(r, row3);
+
+        SSE_StoreVector3(_mm256_castps256_ps128(r), dst[i].data);
+        SSE_StoreVector3(_mm256_extractf128_ps(r, 1), dst[i + 1].data);
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        dst[i] = src[i] * m;
+    }
+}
+
+void TransformBoxes(const Matrix4& m, const AABBox3* src, AABBox3* dst, uint32 count)
+{
+#if defined(__DAVAENGINE_SSE2__)
+    __m128 t = _mm_loadu_ps(m.data + 12);
+    __m128 row[3] = { _mm_loadu_ps(m.data), _mm_loadu_ps(m.data + 4), _mm_loadu_ps(m.data + 8) };
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        const AABBox3& box = src[i];
+        if (box.IsEmpty())
+        {
+            dst[i].Empty();
+            continue;
+        }
+
+        __m128 rmin = t;
+        __m128 rmax = t;
+        for (int32 j = 0; j < 3; ++j)
+        {
+            __m128 a = _mm_mul_ps(row[j], _mm_set1_ps(box.min.data[j]));
+            __m128 b = _mm_mul_ps(row[j], _mm_set1_ps(box.max.data[j]));
+            rmin = _mm_add_ps(rmin, _mm_min_ps(a, b));
+            rmax = _mm_add_ps(rmax, _mm_max_ps(b, a));
+        }
+
+        SSE_StoreVector3(rmin, dst[i].min.data);
+        SSE_StoreVector3(rmax, dst[i].max.data);
+    }
+#else
+    for (uint32 i = 0; i < count; ++i)
+    {
+        src[i].GetTransformedBox(m, dst[i]);
+    }
+#endif
+}
+
+void TransformBoxes(const Matrix4* const* matrices, const AABBox3* src, AABBox3* dst, uint32 count)
+{
+    for (uint32 i = 0; i < count; ++i)
+    {
+        src[i].GetTransformedBox(*matrices[i], dst[i]);
+    }
+}
+
+void MultiplyMatrices(const Matrix4* a, const Matrix4* b, Matrix4* dst, uint32 count)
+{
+    for (uint32 i = 0; i < count; ++i)
+    {
+#if defined(__DAVAENGINE_AVX__)
+        AVX_Matrix4Mul(a[i].data, b[i].data, dst[i].data);
+#elif defined(__DAVAENGINE_SSE2__)
+        SSE_Matrix4Mul(a[i].data, b[i].data, dst[i].data);
+#else
+        dst[i] = a[i] * b[i];
+#endif
+    }
+}
+
+void MultiplyMatrices(const Matrix4* a, const Matrix4& b, Matrix4* dst, uint32 count)
+{
+#if defined(__DAVAENGINE_SSE2__)
+    // rows of b are loaded once for all matrices
+    __m128 b0 = _mm_loadu_ps(b.data);
+    __m128 b1 = _mm_loadu_ps(b.data + 4);
+    __m128 b2 = _mm_loadu_ps(b.data + 8);
+    __m128 b3 = _mm_loadu_ps(b.data + 12);
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        const float32* m = a[i].data;
+        __m128 r[4];
+        for (int32 k = 0; k < 4; ++k)
+        {
+            const float32* row = m + 4 * k;
+            r[k] = _mm_mul_ps(_mm_set1_ps(row[0]), b0);
+            r[k] = _mm_add_ps(r[k], _mm_mul_ps(_mm_set1_ps(row[1]), b1));
+            r[k] = _mm_add_ps(r[k], _mm_mul_ps(_mm_set1_ps(row[2]), b2));
+            r[k] = _mm_add_ps(r[k], _mm_mul_ps(_mm_set1_ps(row[3]), b3));
+        }
+
+        float32* out = dst[i].data;
+        _mm_storeu_ps(out, r[0]);
+        _mm_storeu_ps(out + 4, r[1]);
+        _mm_storeu_ps(out + 8, r[2]);
+        _mm_storeu_ps(out + 12, r[3]);
+    }
+#else
+    for (uint32 i = 0; i < count; ++i)
+    {
+        dst[i] = a[i] * b;
+    }
+#endif
+}
+}
+}
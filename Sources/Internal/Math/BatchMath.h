@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+
+namespace DAVA
+{
+class Vector3;
+class AABBox3;
+struct Matrix4;
+
+/**
+    \ingroup math
+    Batch versions of frequently used transformations.
+    They use SSE/AVX when available (see Math/SSE/SSEMath.h) and produce the same results as per-element operators.
+    Source and destination arrays can be the same, but should not partially overlap.
+*/
+namespace BatchMath
+{
+/** Calculate `dst[i] = src[i] * m` for `count` points. */
+void TransformPoints(const Matrix4& m, const Vector3* src, Vector3* dst, uint32 count);
+
+/** Calculate `src[i].GetTransformedBox(m, dst[i])` for `count` boxes. */
+void TransformBoxes(const Matrix4& m, const AABBox3* src, AABBox3* dst, uint32 count);
+
+/** Calculate `src[i].GetTransformedBox(*matrices[i], dst[i])` for `count` boxes. */
+void TransformBoxes(const Matrix4* const* matrices, const AABBox3* src, AABBox3* dst, uint32 count);
+
+/** Calculate `dst[i] = a[i] * b[i]` for `count` matrices. */
+void MultiplyMatrices(const Matrix4* a, const Matrix4* b, Matrix4* dst, uint32 count);
+
+/** Calculate `dst[i] = a[i] * b` for `count` matrices. */
+void MultiplyMatrices(const Matrix4* a, const Matrix4& b, Matrix4* dst, uint32 count);
+}
+}
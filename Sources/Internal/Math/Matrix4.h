@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Neon/NeonMath.h"
+#include "SSE/SSEMath.h"
 #include "Base/Any.h"
 #include "Math/Matrix3.h"
 #include "Debug/DVAssert.h"
@@ -321,9 +322,13 @@ inline Vector3 operator*(const Vector3& _v, const Matrix4& _m)
 {
     Vector3 res;
 
+#if defined(__DAVAENGINE_SSE2__)
+    SSE_StoreVector3(SSE_Vector3Matrix4Mul(_v.data, _m.data), res.data);
+#else
     res.x = _v.x * _m._00 + _v.y * _m._10 + _v.z * _m._20 + _m._30;
     res.y = _v.x * _m._01 + _v.y * _m._11 + _v.z * _m._21 + _m._31;
     res.z = _v.x * _m._02 + _v.y * _m._12 + _v.z * _m._22 + _m._32;
+#endif
 
     return res;
 }
@@ -332,10 +337,14 @@ inline Vector4 operator*(const Vector4& _v, const Matrix4& _m)
 {
     Vector4 res;
 
+#if defined(__DAVAENGINE_SSE2__)
+    SSE_Vector4Matrix4Mul(_v.data, _m.data, res.data);
+#else
     res.x = _v.x * _m._00 + _v.y * _m._10 + _v.z * _m._20 + _v.w * _m._30;
     res.y = _v.x * _m._01 + _v.y * _m._11 + _v.z * _m._21 + _v.w * _m._31;
     res.z = _v.x * _m._02 + _v.y * _m._12 + _v.z * _m._22 + _v.w * _m._32;
     res.w = _v.x * _m._03 + _v.y * _m._13 + _v.z * _m._23 + _v.w * _m._33;
+#endif
 
     return res;
 }
@@ -456,6 +465,14 @@ inline Matrix4 Matrix4::operator*(const Matrix4& m) const
     Matrix4 res;
     NEON_Matrix4Mul(this->data, m.data, res.data);
     return res;
+#elif defined(__DAVAENGINE_AVX__)
+    Matrix4 res;
+    AVX_Matrix4Mul(this->data, m.data, res.data);
+    return res;
+#elif defined(__DAVAENGINE_SSE2__)
+    Matrix4 res;
+    SSE_Matrix4Mul(this->data, m.data, res.data);
+    return res;
 #else
     return Matrix4(_00 * m._00 + _01 * m._10 + _02 * m._20 + _03 * m._30,
                    _00 * m._01 + _01 * m._11 + _02 * m._21 + _03 * m._31,
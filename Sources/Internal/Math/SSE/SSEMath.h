@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Math/Neon/NeonMath.h"
+
+// SSE2 path is enabled on every x86 target which guarantees SSE2 (x86-64 or /arch:SSE2),
+// AVX path is enabled additionally when compiler is allowed to emit AVX instructions (-mavx or /arch:AVX).
+// Define __DAVAENGINE_NO_SIMD__ to force scalar math.
+#if !defined(__DAVAENGINE_NO_SIMD__) && !defined(__DAVAENGINE_ARM_7__)
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define __DAVAENGINE_SSE2__
+    #endif
+    #if defined(__DAVAENGINE_SSE2__) && defined(__AVX__)
+        #define __DAVAENGINE_AVX__
+    #endif
+#endif
+
+#if defined(__DAVAENGINE_SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__DAVAENGINE_AVX__)
+#include <immintrin.h>
+#endif
+
+// Matrices are row-major, vectors are rows (see Matrix4.h).
+// Every function performs multiplications and additions in the same order as scalar code,
+// so results are bitwise identical to scalar implementation.
+
+#if defined(__DAVAENGINE_SSE2__)
+namespace DAVA
+{
+// Multiplies two 4x4 matrices (a, b) outputting a 4x4 matrix (output = a * b), output can alias a or b
+inline void SSE_Matrix4Mul(const float32* a, const float32* b, float32* output)
+{
+    __m128 b0 = _mm_loadu_ps(b);
+    __m128 b1 = _mm_loadu_ps(b + 4);
+    __m128 b2 = _mm_loadu_ps(b + 8);
+    __m128 b3 = _mm_loadu_ps(b + 12);
+
+    for (int32 i = 0; i < 16; i += 4)
+    {
+        __m128 r = _mm_mul_ps(_mm_set1_ps(a[i + 0]), b0);
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a[i + 1]), b1));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a[i + 2]), b2));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a[i + 3]), b3));
+        _mm_storeu_ps(output + i, r);
+    }
+}
+
+// Multiplies a vector 4 (v) with 4x4 matrix (m), outputting a vector 4
+inline void SSE_Vector4Matrix4Mul(const float32* v, const float32* m, float32* output)
+{
+    __m128 r = _mm_mul_ps(_mm_set1_ps(v[0]), _mm_loadu_ps(m));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v[1]), _mm_loadu_ps(m + 4)));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v[2]), _mm_loadu_ps(m + 8)));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v[3]), _mm_loadu_ps(m + 12)));
+    _mm_storeu_ps(output, r);
+}
+
+// Transforms a point (v) with 4x4 matrix (m), outputting a vector 4 with undefined w
+inline __m128 SSE_Vector3Matrix4Mul(const float32* v, const float32* m)
+{
+    __m128 r = _mm_mul_ps(_mm_set1_ps(v[0]), _mm_loadu_ps(m));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v[1]), _mm_loadu_ps(m + 4)));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v[2]), _mm_loadu_ps(m + 8)));
+    r = _mm_add_ps(r, _mm_loadu_ps(m + 12));
+    return r;
+}
+
+// Transforms axis aligned box (bmin, bmax) with 4x4 matrix (m), outputting box in (outMin, outMax) with undefined w
+inline void SSE_TransformBox(const float32* bmin, const float32* bmax, const float32* m, __m128& outMin, __m128& outMax)
+{
+    __m128 t = _mm_loadu_ps(m + 12);
+    __m128 rmin = t;
+    __m128 rmax = t;
+
+    for (int32 j = 0; j < 3; ++j)
+    {
+        __m128 row = _mm_loadu_ps(m + 4 * j);
+        __m128 a = _mm_mul_ps(row, _mm_set1_ps(bmin[j]));
+        __m128 b = _mm_mul_ps(row, _mm_set1_ps(bmax[j]));
+        rmin = _mm_add_ps(rmin, _mm_min_ps(a, b));
+        rmax = _mm_add_ps(rmax, _mm_max_ps(b, a));
+    }
+
+    outMin = rmin;
+    outMax = rmax;
+}
+
+// Stores xyz components of (v) to (output)
+inline void SSE_StoreVector3(__m128 v, float32* output)
+{
+    alignas(16) float32 tmp[4];
+    _mm_store_ps(tmp, v);
+    output[0] = tmp[0];
+    output[1] = tmp[1];
+    output[2] = tmp[2];
+}
+
+// Outputs s0 * a + s1 * b for 4-component vectors
+inline void SSE_Vector4Blend(const float32* a, float32 s0, const float32* b, float32 s1, float32* output)
+{
+    __m128 r = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(s0), _mm_loadu_ps(a)), _mm_mul_ps(_mm_set1_ps(s1), _mm_loadu_ps(b)));
+    _mm_storeu_ps(output, r);
+}
+}
+#endif //#if defined(__DAVAENGINE_SSE2__)
+
+#if defined(__DAVAENGINE_AVX__)
+namespace DAVA
+{
+// Multiplies two 4x4 matrices (a, b) outputting a 4x4 matrix (output = a * b), two rows per iteration
+inline void AVX_Matrix4Mul(const float32* a, const float32* b, float32* output)
+{
+    __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b));
+    __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 4));
+    __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 8));
+    __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 12));
+
+    for (int32 i = 0; i < 16; i += 8)
+    {
+        __m256 r = _mm256_mul_ps(_mm256_setr_m128(_mm_set1_ps(a[i + 0]), _mm_set1_ps(a[i + 4])), b0);
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_setr_m128(_mm_set1_ps(a[i + 1]), _mm_set1_ps(a[i + 5])), b1));
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_setr_m128(_mm_set1_ps(a[i + 2]), _mm_set1_ps(a[i + 6])), b2));
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_setr_m128(_mm_set1_ps(a[i + 3]), _mm_set1_ps(a[i + 7])), b3));
+        _mm256_storeu_ps(output + i, r);
+    }
+}
+}
+#endif //#if defined(__DAVAENGINE_AVX__)
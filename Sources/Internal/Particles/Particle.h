@@ -2,16 +2,15 @@
 
 #include "Base/BaseTypes.h"
 #include "Base/BaseMath.h"
-#include "Base/AllocatorFactory.h"
 
 namespace DAVA
 {
+/**
+    State of a single particle.
+    Used to initialize new particles, simulated particles are stored in `ParticleStorage`.
+*/
 struct Particle
 {
-    IMPLEMENT_POOL_ALLOCATOR(Particle, 1000);
-
-    Particle* next = nullptr;
-
     float32 life = 0.0f;
     float32 lifeTime = 0.0f;
 
@@ -43,5 +42,6 @@ struct Particle
     Color color = {};
 
     int32 positionTarget = 0; //superemitter particles only
+    uint32 randomIndex = 0; //stable per-particle index for pseudo-random forces behaviour
 };
 }
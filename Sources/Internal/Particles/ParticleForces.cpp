@@ -1,10 +1,10 @@
 #include "Particles/ParticleForces.h"
 
 #include <random>
-#include <chrono>
 
-#include "Particles/Particle.h"
+#include "Particles/ParticleStorage.h"
 #include "Particles/ParticleForce.h"
+#include "Particles/ParticlesRandom.h"
 #include "Math/MathHelpers.h"
 #include "Math/Noise.h"
 #include "Scene3D/Entity.h"
@@ -30,11 +30,11 @@ T GetValue(const ParticleForce* force, float32 particleOverLife, float32 layerOv
     case ParticleForce::eTimingType::CONSTANT:
         return value;
     case ParticleForce::eTimingType::OVER_PARTICLE_LIFE:
-        return line->GetValue(particleOverLife);
+        return line->Sample(particleOverLife);
     case ParticleForce::eTimingType::OVER_LAYER_LIFE:
-        return line->GetValue(layerOverLife);
+        return line->Sample(layerOverLife);
     case ParticleForce::eTimingType::SECONDS_PARTICLE_LIFE:
-        return line->GetValue(particleLife);
+        return line->Sample(particleLife);
     default:
         return value;
     }
@@ -56,15 +56,15 @@ Vector3 GetNoiseValue(float32 particleOverLife, float32 frequency, uint32 clampe
     return Lerp(t1, t2, fractPart);
 }
 
-inline void KillParticle(Particle* particle)
+inline void KillParticle(ParticleStorage& particles, uint32 index)
 {
-    particle->life = particle->lifeTime + 0.1f;
+    particles.life[index] = particles.lifeTime[index] + 0.1f;
 }
 
-inline void KillParticlePlaneCollision(const ParticleForce* force, Particle* particle, Vector3& effectSpaceVelocity)
+inline void KillParticlePlaneCollision(const ParticleForce* force, ParticleStorage& particles, uint32 index, Vector3& effectSpaceVelocity)
 {
     if (force->killParticles)
-        KillParticle(particle);
+        KillParticle(particles, index);
     else
         effectSpaceVelocity = Vector3::Zero;
 }
@@ -88,14 +88,14 @@ inline bool IsPositionInForceShape(const ParticleForce* force, const Vector3& pa
     return false;
 }
 
-void ApplyDragForce(const ParticleForce* force, Vector3& velocity, const Vector3& position, float32 dt, float32 particleOverLife, float32 layerOverLife, const Particle* particle, const Vector3& forcePosition)
+void ApplyDragForce(const ParticleForce* force, Vector3& velocity, const Vector3& position, float32 dt, float32 particleOverLife, float32 layerOverLife, float32 particleLife, const Vector3& forcePosition)
 {
-    Vector3 forceStrength = GetValue(force, particleOverLife, layerOverLife, particle->life, force->forcePowerLine.Get(), force->forcePower) * dt;
+    Vector3 forceStrength = GetValue(force, particleOverLife, layerOverLife, particleLife, force->forcePowerLine.Get(), force->forcePower) * dt;
     Vector3 v(Max(Vector3::Zero, 1.0f - forceStrength));
     velocity *= v;
 }
 
-void ApplyVortex(const ParticleForce* force, Vector3& velocity, const Vector3& position, float32 dt, float32 particleOverLife, float32 layerOverLife, const Particle* particle, const Vector3& forcePosition)
+void ApplyVortex(const ParticleForce* force, Vector3& velocity, const Vector3& position, float32 dt, float32 particleOverLife, float32 layerOverLife, float32 particleLife, const Vector3& forcePosition)
 {
     Vector3 forceDir = (position - forcePosition).CrossProduct(force->direction);
     float32 len = forceDir.SquareLength();
@@ -104,26 +104,24 @@ void ApplyVortex(const ParticleForce* force, Vector3& velocity, const Vector3& p
         float32 d = 1.0f / std::sqrt(len);
         forceDir *= d;
     }
-    Vector3 forceStrength = GetValue(force, particleOverLife, layerOverLife, particle->life, force->forcePowerLine.Get(), force->forcePower) * dt;
+    Vector3 forceStrength = GetValue(force, particleOverLife, layerOverLife, particleLife, force->forcePowerLine.Get(), force->forcePower) * dt;
     velocity += forceStrength * forceDir;
 }
 
-void ApplyGravity(const ParticleForce* force, Vector3& velocity, const Vector3& down, float32 dt, float32 particleOverLife, float32 layerOverLife, const Particle* particle)
+void ApplyGravity(const ParticleForce* force, Vector3& velocity, const Vector3& down, float32 dt, float32 particleOverLife, float32 layerOverLife, float32 particleLife)
 {
-    velocity += down * GetValue(force, particleOverLife, layerOverLife, particle->life, force->forcePowerLine.Get(), force->forcePower).x * dt;
+    velocity += down * GetValue(force, particleOverLife, layerOverLife, particleLife, force->forcePowerLine.Get(), force->forcePower).x * dt;
 }
 
-void ApplyWind(const ParticleForce* force, Vector3& velocity, Vector3& position, float32 dt, float32 particleOverLife, float32 layerOverLife, const Particle* particle, const Vector3& forcePosition)
+void ApplyWind(const ParticleForce* force, Vector3& velocity, Vector3& position, float32 dt, float32 particleOverLife, float32 layerOverLife, float32 particleLife, uint32 randomIndex, const Vector3& forcePosition)
 {
     static const float32 windScale = 100.0f; // Artiom request.
 
-    uintptr_t partInd = reinterpret_cast<uintptr_t>(particle);
-    uint64 particleIndex = static_cast<uint64>(partInd);
     Vector3 turbulence;
 
-    uint32 clampedIndex = particleIndex % noiseWidth;
+    uint32 clampedIndex = randomIndex % noiseWidth;
     float32 windMultiplier = 1.0f;
-    float32 tubulencePower = GetValue(force, particleOverLife, layerOverLife, particle->life, force->turbulenceLine.Get(), force->windTurbulence);
+    float32 tubulencePower = GetValue(force, particleOverLife, layerOverLife, particleLife, force->turbulenceLine.Get(), force->windTurbulence);
     if (Abs(tubulencePower) > EPSILON)
     {
         turbulence = GetNoiseValue(particleOverLife, force->windTurbulenceFrequency, clampedIndex);
@@ -141,11 +139,11 @@ void ApplyWind(const ParticleForce* force, Vector3& velocity, Vector3& position,
         float32 noiseVal = GetNoiseValue(particleOverLife, force->windFrequency, clampedIndex).x;
         windMultiplier = noiseVal + force->windBias;
     }
-    Vector3 forceStrength = GetValue(force, particleOverLife, layerOverLife, particle->life, force->forcePowerLine.Get(), force->forcePower) * dt;
+    Vector3 forceStrength = GetValue(force, particleOverLife, layerOverLife, particleLife, force->forcePowerLine.Get(), force->forcePower) * dt;
     velocity += force->direction * dt * windMultiplier * forceStrength.x * windScale;
 }
 
-void ApplyPointGravity(const ParticleForce* force, Vector3& velocity, Vector3& position, float32 dt, float32 particleOverLife, float32 layerOverLife, Particle* particle, const Vector3& forcePosition)
+void ApplyPointGravity(const ParticleForce* force, Vector3& velocity, Vector3& position, float32 dt, float32 particleOverLife, float32 layerOverLife, ParticleStorage& particles, uint32 index, const Vector3& forcePosition)
 {
     Vector3 toCenter = forcePosition - position;
     float32 sqrToCenterDist = toCenter.SquareLength();
@@ -155,9 +153,7 @@ void ApplyPointGravity(const ParticleForce* force, Vector3& velocity, Vector3& p
     Vector3 forceDirection = toCenter;
     if (force->pointGravityUseRandomPointsOnSphere)
     {
-        uintptr_t partInd = reinterpret_cast<uintptr_t>(particle);
-        size_t particleIndex = static_cast<size_t>(partInd);
-        particleIndex %= sphereRandomVectorsSize;
+        uint32 particleIndex = particles.randomIndex[index] % sphereRandomVectorsSize;
         Vector3 forcePositionModified = forcePosition + sphereRandomVectors[particleIndex] * force->pointGravityRadius;
         forceDirection = forcePositionModified - position;
         float32 sqrDistToTarget = forceDirection.SquareLength();
@@ -165,19 +161,19 @@ void ApplyPointGravity(const ParticleForce* force, Vector3& velocity, Vector3& p
             forceDirection /= sqrt(sqrDistToTarget);
     }
 
-    Vector3 forceStrength = GetValue(force, particleOverLife, layerOverLife, particle->life, force->forcePowerLine.Get(), force->forcePower) * dt;
+    Vector3 forceStrength = GetValue(force, particleOverLife, layerOverLife, particles.life[index], force->forcePowerLine.Get(), force->forcePower) * dt;
     if (sqrToCenterDist > force->pointGravityRadius * force->pointGravityRadius)
         velocity += forceDirection * forceStrength;
     else
     {
         if (force->killParticles)
-            KillParticle(particle);
+            KillParticle(particles, index);
         else
             position = forcePosition - force->pointGravityRadius * toCenter;
     }
 }
 
-void ApplyPlaneCollision(const ParticleForce* force, Vector3& velocity, Vector3& position, Particle* particle, const Vector3& prevPosition, const Vector3& forcePosition)
+void ApplyPlaneCollision(const ParticleForce* force, Vector3& velocity, Vector3& position, ParticleStorage& particles, uint32 index, const Vector3& prevPosition, const Vector3& forcePosition, ParticlesRandom::Generator& random)
 {
     Vector3 normal = Normalize(force->direction);
     Vector3 a = prevPosition - forcePosition;
@@ -188,7 +184,7 @@ void ApplyPlaneCollision(const ParticleForce* force, Vector3& velocity, Vector3&
     {
         if (velocity.SquareLength() < force->velocityThreshold * force->velocityThreshold)
         {
-            KillParticlePlaneCollision(force, particle, velocity);
+            KillParticlePlaneCollision(force, particles, index, velocity);
             return;
         }
 
@@ -198,9 +194,7 @@ void ApplyPlaneCollision(const ParticleForce* force, Vector3& velocity, Vector3&
             return;
         position = position + dir * (-bProj) / abProj;
 
-        std::mt19937 rng(std::random_device{}());
-        std::uniform_int_distribution<int32> uniInt(0, 99);
-        bool reflectParticle = static_cast<uint32>(uniInt(rng)) < force->reflectionPercent;
+        bool reflectParticle = (random.Rand() % 100) < force->reflectionPercent;
         if (reflectParticle)
         {
             Vector3 newVel;
@@ -211,25 +205,28 @@ void ApplyPlaneCollision(const ParticleForce* force, Vector3& velocity, Vector3&
 
             if (Abs(force->reflectionChaos) > EPSILON)
             {
-                std::uniform_real_distribution<float32> uni(-DegToRad(force->reflectionChaos), DegToRad(force->reflectionChaos));
-                Quaternion q = Quaternion::MakeRotationFastX(uni(rng)) * Quaternion::MakeRotationFastY(uni(rng)) * Quaternion::MakeRotationFastZ(uni(rng));
+                float32 chaos = DegToRad(force->reflectionChaos);
+                float32 angleX = (random.RandFloat() * 2.0f - 1.0f) * chaos;
+                float32 angleY = (random.RandFloat() * 2.0f - 1.0f) * chaos;
+                float32 angleZ = (random.RandFloat() * 2.0f - 1.0f) * chaos;
+                Quaternion q = Quaternion::MakeRotationFastX(angleX) * Quaternion::MakeRotationFastY(angleY) * Quaternion::MakeRotationFastZ(angleZ);
                 newVel = q.ApplyToVectorFast(newVel);
                 if (newVel.DotProduct(normal) < 0)
                     newVel = -newVel;
             }
             velocity = newVel * force->forcePower;
             if (force->randomizeReflectionForce)
-                velocity *= std::uniform_real_distribution<float32>(force->rndReflectionForceMin, force->rndReflectionForceMax)(rng);
+                velocity *= force->rndReflectionForceMin + (force->rndReflectionForceMax - force->rndReflectionForceMin) * random.RandFloat();
         }
         else
-            KillParticlePlaneCollision(force, particle, velocity);
+            KillParticlePlaneCollision(force, particles, index, velocity);
     }
     else if (bProj < 0.0f && aProj < 0.0f)
-        KillParticlePlaneCollision(force, particle, velocity);
+        KillParticlePlaneCollision(force, particles, index, velocity);
 }
 }
 
-void ParticleForces::ApplyForce(const ParticleForce* force, Vector3& velocity, Vector3& position, float32 dt, float32 particleOverLife, float32 layerOverLife, const Vector3& down, Particle* particle, const Vector3& prevPosition, const Vector3& forcePosition)
+void ParticleForces::ApplyForce(const ParticleForce* force, Vector3& velocity, Vector3& position, float32 dt, float32 particleOverLife, float32 layerOverLife, const Vector3& down, ParticleStorage& particles, uint32 index, const Vector3& prevPosition, const Vector3& forcePosition, ParticlesRandom::Generator& random)
 {
     using ForceType = ParticleForce::eType;
 
@@ -238,22 +235,22 @@ void ParticleForces::ApplyForce(const ParticleForce* force, Vector3& velocity, V
     switch (force->type)
     {
     case ForceType::DRAG_FORCE:
-        ParticleForcesDetails::ApplyDragForce(force, velocity, position, dt, particleOverLife, layerOverLife, particle, forcePosition);
+        ParticleForcesDetails::ApplyDragForce(force, velocity, position, dt, particleOverLife, layerOverLife, particles.life[index], forcePosition);
         break;
     case ForceType::VORTEX:
-        ParticleForcesDetails::ApplyVortex(force, velocity, position, dt, particleOverLife, layerOverLife, particle, forcePosition);
+        ParticleForcesDetails::ApplyVortex(force, velocity, position, dt, particleOverLife, layerOverLife, particles.life[index], forcePosition);
         break;
     case ForceType::GRAVITY:
-        ParticleForcesDetails::ApplyGravity(force, velocity, down, dt, particleOverLife, layerOverLife, particle);
+        ParticleForcesDetails::ApplyGravity(force, velocity, down, dt, particleOverLife, layerOverLife, particles.life[index]);
         break;
     case ForceType::WIND:
-        ParticleForcesDetails::ApplyWind(force, velocity, position, dt, particleOverLife, layerOverLife, particle, forcePosition);
+        ParticleForcesDetails::ApplyWind(force, velocity, position, dt, particleOverLife, layerOverLife, particles.life[index], particles.randomIndex[index], forcePosition);
         break;
     case ForceType::POINT_GRAVITY:
-        ParticleForcesDetails::ApplyPointGravity(force, velocity, position, dt, particleOverLife, layerOverLife, particle, forcePosition);
+        ParticleForcesDetails::ApplyPointGravity(force, velocity, position, dt, particleOverLife, layerOverLife, particles, index, forcePosition);
         break;
     case ForceType::PLANE_COLLISION:
-        ParticleForcesDetails::ApplyPlaneCollision(force, velocity, position, particle, prevPosition, forcePosition);
+        ParticleForcesDetails::ApplyPlaneCollision(force, velocity, position, particles, index, prevPosition, forcePosition, random);
         break;
     default:
         DVASSERT(false, "Unsupported force.");
@@ -263,8 +260,8 @@ void ParticleForces::ApplyForce(const ParticleForce* force, Vector3& velocity, V
 
 void ParticleForcesUtils::GenerateSphereRandomVectors()
 {
-    uint32 seed = static_cast<uint32>(std::chrono::system_clock::now().time_since_epoch().count());
-    std::mt19937 generator(seed);
+    // fixed seed keeps point gravity deterministic between runs
+    std::mt19937 generator(0);
 
     std::uniform_real_distribution<float32> uinform01(0.0f, 1.0f);
     for (uint32 i = 0; i < ParticleForcesDetails::sphereRandomVectorsSize; ++i)
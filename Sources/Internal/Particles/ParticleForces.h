@@ -7,12 +7,16 @@ namespace DAVA
 class ParticleForce;
 class Vector3;
 class Entity;
-struct Particle;
+class ParticleStorage;
+namespace ParticlesRandom
+{
+class Generator;
+}
 
 class ParticleForces
 {
 public:
-    static void ApplyForce(const ParticleForce* force, Vector3& velocity, Vector3& position, float32 dt, float32 particleOverLife, float32 layerOverLife, const Vector3& down, Particle* particle, const Vector3& prevPosition, const Vector3& forcePosition);
+    static void ApplyForce(const ParticleForce* force, Vector3& velocity, Vector3& position, float32 dt, float32 particleOverLife, float32 layerOverLife, const Vector3& down, ParticleStorage& particles, uint32 index, const Vector3& prevPosition, const Vector3& forcePosition, ParticlesRandom::Generator& random);
 };
 
 class ParticleForcesUtils
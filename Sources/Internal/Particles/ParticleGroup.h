@@ -3,6 +3,8 @@
 #include "ParticleEmitter.h"
 #include "ParticleLayer.h"
 #include "Particle.h"
+#include "ParticleStorage.h"
+#include "ParticlesRandom.h"
 #include "Render/Material/NMaterial.h"
 
 namespace DAVA
@@ -42,7 +44,7 @@ struct ParticleGroup
     ParticleEmitter* emitter = nullptr;
     ParticleLayer* layer = nullptr;
     NMaterial* material = nullptr;
-    Particle* head = nullptr;
+    ParticleStorage particles;
 
     Vector3 spawnPosition;
 
@@ -56,6 +58,7 @@ struct ParticleGroup
     float32 particlesToGenerate = 0.0f;
 
     uint16 particlesGenerated = 0;
+    uint32 randomIndexOffset = 0; // distinguishes low-discrepancy sequences of groups, taken from effect random generator
 
     bool finishingGroup = false;
     bool visibleLod = true;
@@ -73,5 +76,7 @@ struct ParticleEffectData
 {
     Vector<ParentInfo> infoSources;
     List<ParticleGroup> groups;
+    ParticlesRandom::Generator random; // seeded when effect is started, see ParticlesRandom::MakeEffectSeed
+    bool hasPendingMaterials = false; // some groups were started during concurrent update with material not created yet
 };
 }
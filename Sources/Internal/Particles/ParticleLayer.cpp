@@ -482,6 +482,41 @@ void ParticleLayer::UpdateLayerTime(float32 startTime, float32 endTime)
     UpdatePropertyLineKeys(PropertyLineHelper::GetValueLine(noiseVScrollSpeedVariation).Get(), startTime, translateTime, endTime);
 }
 
+template <class T>
+void BakePropertyLine(PropertyLine<T>* line, uint32 resolution)
+{
+    if (line != nullptr && (line->GetBakedResolution() != resolution || line->IsBakeOutdated()))
+        line->Bake(resolution);
+}
+
+void ParticleLayer::BakePropertyLines(uint32 resolution)
+{
+    /*only lines sampled per particle are baked*/
+    BakePropertyLine(sizeOverLifeXY.Get(), resolution);
+    BakePropertyLine(velocityOverLife.Get(), resolution);
+    BakePropertyLine(spinOverLife.Get(), resolution);
+    BakePropertyLine(colorOverLife.Get(), resolution);
+    BakePropertyLine(alphaOverLife.Get(), resolution);
+    BakePropertyLine(animSpeedOverLife.Get(), resolution);
+    BakePropertyLine(noiseScaleOverLife.Get(), resolution);
+    BakePropertyLine(noiseUScrollSpeedOverLife.Get(), resolution);
+    BakePropertyLine(noiseVScrollSpeedOverLife.Get(), resolution);
+    BakePropertyLine(alphaRemapOverLife.Get(), resolution);
+
+    BakePropertyLine(stripeSizeOverLife.Get(), resolution);
+    BakePropertyLine(stripeTextureTileOverLife.Get(), resolution);
+    BakePropertyLine(stripeColorOverLife.Get(), resolution);
+
+    for (ParticleForceSimplified* force : forcesSimplified)
+        BakePropertyLine(force->forceOverLife.Get(), resolution);
+
+    for (ParticleForce* force : particleForces)
+    {
+        BakePropertyLine(force->forcePowerLine.Get(), resolution);
+        BakePropertyLine(force->turbulenceLine.Get(), resolution);
+    }
+}
+
 void ParticleLayer::SetSprite(const FilePath& path)
 {
     spritePath = path;
@@ -97,6 +97,9 @@ struct ParticleLayer : public BaseObject
 
     void UpdateLayerTime(float32 startTime, float32 endTime);
 
+    /** Bake property lines sampled per particle with `resolution`, lines already baked with it are skipped. See `PropertyLine::Bake`. */
+    void BakePropertyLines(uint32 resolution);
+
     bool IsLodActive(int32 lod);
     void SetLodActive(int32 lod, bool active);
 
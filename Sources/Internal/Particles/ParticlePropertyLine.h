@@ -5,6 +5,7 @@
 #include "FileSystem/YamlNode.h"
 #include "Base/RefPtr.h"
 #include <limits>
+#include <algorithm>
 
 namespace DAVA
 {
@@ -35,8 +36,170 @@ public:
     {
         return 0;
     }
+
+    /**
+        Bake line into table which is sampled by `GetBakedValue` without virtual calls and shared mutable state.
+        With zero `resolution` table contains line keys and is interpolated the same way as `GetValue` does,
+        otherwise it contains `resolution` values evenly spaced between first and last keys.
+        Keys added with `AddValue` rebake the line, keys changed in place make baked table outdated until next `Bake`.
+    */
+    void Bake(uint32 resolution);
+    bool IsBaked() const;
+    /** Return true if line is not baked or its keys are changed since it was baked. */
+    bool IsBakeOutdated();
+    uint32 GetBakedResolution() const;
+    /** Sample baked table, line should be baked. */
+    T GetBakedValue(float32 t) const;
+    /** Interpolate line keys without shared mutable state, slower than `GetBakedValue`. */
+    virtual T Evaluate(float32 t) const;
+    /** Sample baked table if line is baked, call `Evaluate` otherwise. Safe to call from several threads at once. */
+    T Sample(float32 t) const;
+
+protected:
+    /** Fill `result` with keys line is baked from. */
+    virtual void GetBakeKeys(Vector<PropertyKey>& result)
+    {
+        result = keys;
+    }
+
+private:
+    Vector<PropertyKey> bakedKeys; // keys table is baked from, compared with current keys to find in place edits
+    Vector<float32> bakedTimes; // empty for fixed resolution table
+    Vector<T> bakedValues;
+    float32 bakedStart = 0.0f;
+    float32 bakedScale = 0.0f;
+    uint32 bakedResolution = 0;
 };
 
+namespace PropertyLineDetails
+{
+template <class T>
+T InterpolateKeys(const Vector<float32>& times, const Vector<T>& values, float32 t)
+{
+    if (t <= times.front())
+        return values.front();
+    if (t >= times.back())
+        return values.back();
+
+    size_t r = std::lower_bound(times.begin() + 1, times.end(), t) - times.begin();
+    size_t l = r - 1;
+    float32 ti = (t - times[l]) / (times[r] - times[l]);
+    return values[l] + (values[r] - values[l]) * ti;
+}
+}
+
+template <class T>
+void PropertyLine<T>::Bake(uint32 resolution)
+{
+    GetBakeKeys(bakedKeys);
+
+    bakedTimes.clear();
+    bakedValues.clear();
+    bakedStart = 0.0f;
+    bakedScale = 0.0f;
+    bakedResolution = resolution;
+    if (bakedKeys.empty())
+        return;
+
+    bakedTimes.reserve(bakedKeys.size());
+    bakedValues.reserve(bakedKeys.size());
+    for (const PropertyKey& key : bakedKeys)
+    {
+        bakedTimes.push_back(key.t);
+        bakedValues.push_back(key.value);
+    }
+
+    if (resolution == 0)
+        return;
+
+    Vector<T> table;
+    float32 start = bakedTimes.front();
+    float32 end = bakedTimes.back();
+    if (resolution > 1 && end > start)
+    {
+        table.resize(resolution);
+        for (uint32 i = 0; i < resolution; ++i)
+        {
+            float32 t = start + (end - start) * (static_cast<float32>(i) / static_cast<float32>(resolution - 1));
+            table[i] = PropertyLineDetails::InterpolateKeys(bakedTimes, bakedValues, t);
+        }
+        bakedStart = start;
+        bakedScale = static_cast<float32>(resolution - 1) / (end - start);
+    }
+    else
+    {
+        table.push_back(bakedValues.front());
+    }
+
+    bakedTimes.clear();
+    bakedValues.swap(table);
+}
+
+template <class T>
+bool PropertyLine<T>::IsBaked() const
+{
+    return !bakedValues.empty();
+}
+
+template <class T>
+bool PropertyLine<T>::IsBakeOutdated()
+{
+    if (!IsBaked())
+        return true;
+
+    Vector<PropertyKey> currentKeys;
+    GetBakeKeys(currentKeys);
+    return !std::equal(currentKeys.begin(), currentKeys.end(), bakedKeys.begin(), bakedKeys.end(), [](const PropertyKey& k0, const PropertyKey& k1) {
+        return k0.t == k1.t && k0.value == k1.value;
+    });
+}
+
+template <class T>
+uint32 PropertyLine<T>::GetBakedResolution() const
+{
+    return bakedResolution;
+}
+
+template <class T>
+T PropertyLine<T>::GetBakedValue(float32 t) const
+{
+    DVASSERT(IsBaked());
+    if (!bakedTimes.empty())
+        return PropertyLineDetails::InterpolateKeys(bakedTimes, bakedValues, t);
+
+    float32 x = (t - bakedStart) * bakedScale;
+    uint32 last = static_cast<uint32>(bakedValues.size()) - 1;
+    if (x <= 0.0f)
+        return bakedValues.front();
+    if (x >= static_cast<float32>(last))
+        return bakedValues.back();
+
+    uint32 i = static_cast<uint32>(x);
+    float32 ti = x - static_cast<float32>(i);
+    return bakedValues[i] + (bakedValues[i + 1] - bakedValues[i]) * ti;
+}
+
+template <class T>
+T PropertyLine<T>::Evaluate(float32 t) const
+{
+    DVASSERT(!keys.empty());
+    if (t <= keys.front().t)
+        return keys.front().value;
+    if (t >= keys.back().t)
+        return keys.back().value;
+
+    auto r = std::lower_bound(keys.begin() + 1, keys.end(), t, [](const PropertyKey& key, float32 t) { return key.t < t; });
+    auto l = r - 1;
+    float32 ti = (t - l->t) / (r->t - l->t);
+    return l->value + (r->value - l->value) * ti;
+}
+
+template <class T>
+T PropertyLine<T>::Sample(float32 t) const
+{
+    return IsBaked() ? GetBakedValue(t) : Evaluate(t);
+}
+
 class PropertyValueHelper
 {
 public:
@@ -140,6 +303,9 @@ public:
         key.t = t;
         key.value = value;
         PropertyLine<T>::keys.push_back(key);
+
+        if (PropertyLine<T>::IsBaked())
+            PropertyLine<T>::Bake(PropertyLine<T>::GetBakedResolution());
     }
 
     PropertyLine<T>* Clone()
@@ -188,6 +354,8 @@ public:
     void SetValueLine(RefPtr<PropertyLine<T>> line)
     {
         this->valueLine = line;
+        if (PropertyLine<T>::IsBaked())
+            PropertyLine<T>::Bake(PropertyLine<T>::GetBakedResolution());
     }
 
     RefPtr<PropertyLine<T>> GetModificationLine()
@@ -199,9 +367,12 @@ public:
         return valueLine;
     }
     const T& GetValue(float32 t);
+    T Evaluate(float32 t) const override;
     virtual PropertyLine<T>* Clone();
 
 protected:
+    void GetBakeKeys(Vector<typename PropertyLine<T>::PropertyKey>& result) override;
+
     T resultValue; //well - this how ProertyLine itself work - err
     T modifier;
     RefPtr<PropertyLine<T>> modificationLine;
@@ -215,6 +386,31 @@ void ModifiablePropertyLine<T>::SetModifier(float32 v)
         modifier = modificationLine->GetValue(v);
     else
         modifier = PropertyValueHelper::MakeUnityValue<T>();
+
+    if (PropertyLine<T>::IsBaked())
+        PropertyLine<T>::Bake(PropertyLine<T>::GetBakedResolution());
+}
+
+template <class T>
+void ModifiablePropertyLine<T>::GetBakeKeys(Vector<typename PropertyLine<T>::PropertyKey>& result)
+{
+    result.clear();
+    if (!valueLine)
+    {
+        typename PropertyLine<T>::PropertyKey key;
+        key.t = 0.0f;
+        key.value = T();
+        result.push_back(key);
+        return;
+    }
+
+    for (const typename PropertyLine<T>::PropertyKey& valueKey : valueLine->keys)
+    {
+        typename PropertyLine<T>::PropertyKey key;
+        key.t = valueKey.t;
+        key.value = modifier * valueKey.value;
+        result.push_back(key);
+    }
 }
 
 template <class T>
@@ -231,6 +427,12 @@ const T& ModifiablePropertyLine<T>::GetValue(float32 t)
     return resultValue;
 }
 
+template <class T>
+T ModifiablePropertyLine<T>::Evaluate(float32 t) const
+{
+    return valueLine ? modifier * valueLine->Evaluate(t) : T();
+}
+
 template <class T>
 PropertyLine<T>* ModifiablePropertyLine<T>::Clone()
 {
@@ -1,12 +1,19 @@
 #include "ParticleRenderObject.h"
 
 #include "Math/MathConstants.h"
+#include "Job/ParallelFor.h"
 #include "Render/DynamicBufferAllocator.h"
 #include "Render/Renderer.h"
 #include "Time/SystemTimer.h"
 
 namespace DAVA
 {
+namespace ParticleRenderObjectDetails
+{
+// Max number of quads filled by single job
+const uint32 QUADS_GRAIN_SIZE = 256;
+}
+
 ParticleRenderObject::ParticleRenderObject(ParticleEffectData* effect)
     : effectData(effect)
     , sortingOffset(15)
@@ -191,7 +198,7 @@ uint32 ParticleRenderObject::SelectLayout(const ParticleLayer& layer)
     return layoutMap[key];
 }
 
-void ParticleRenderObject::UpdateStripeVertex(float32*& dataPtr, Vector3& position, Vector3& uv, float32* color, ParticleLayer* layer, Particle* particle, float32 fresToAlpha)
+void ParticleRenderObject::UpdateStripeVertex(float32*& dataPtr, Vector3& position, Vector3& uv, float32* color, ParticleLayer* layer, const ParticleStorage& particles, uint32 index, float32 fresToAlpha)
 {
     *dataPtr++ = position.x;
     *dataPtr++ = position.y;
@@ -206,28 +213,28 @@ void ParticleRenderObject::UpdateStripeVertex(float32*& dataPtr, Vector3& positi
     {
         *dataPtr++ = uv.x;
         *dataPtr++ = uv.y;
-        *dataPtr++ = particle->currFlowSpeed;
-        *dataPtr++ = particle->currFlowOffset;
+        *dataPtr++ = particles.currFlowSpeed[index];
+        *dataPtr++ = particles.currFlowOffset[index];
     }
     if (layer->enableNoise && layer->noise.get() != nullptr)
     {
         float32 offsetU = uv.x;
         if (layer->enableNoiseScroll)
-            offsetU += layer->usePerspectiveMapping ? particle->currNoiseUOffset * uv.z : particle->currNoiseUOffset;
+            offsetU += layer->usePerspectiveMapping ? particles.currNoiseUOffset[index] * uv.z : particles.currNoiseUOffset[index];
 
         *dataPtr++ = offsetU;
 
         float32 offsetV = uv.y;
         if (layer->enableNoiseScroll)
-            offsetV += layer->usePerspectiveMapping ? particle->currNoiseVOffset * uv.z : particle->currNoiseVOffset;
+            offsetV += layer->usePerspectiveMapping ? particles.currNoiseVOffset[index] * uv.z : particles.currNoiseVOffset[index];
         *dataPtr++ = offsetV;
 
-        *dataPtr++ = particle->currNoiseScale;
+        *dataPtr++ = particles.currNoiseScale[index];
     }
     if (layer->enableAlphaRemap || layer->usePerspectiveMapping || layer->useFresnelToAlpha)
     {
         *dataPtr++ = fresToAlpha;
-        *dataPtr++ = particle->alphaRemap;
+        *dataPtr++ = particles.alphaRemap[index];
         *dataPtr++ = uv.z;
     }
 }
@@ -290,181 +297,217 @@ void ParticleRenderObject::AppendParticleGroup(List<ParticleGroup>::iterator beg
 
     uint32 verteciesToAllocate = particlesCount * 4;
     DynamicBufferAllocator::AllocResultVB target = DynamicBufferAllocator::AllocateVertexBuffer(vertexStride, verteciesToAllocate);
-    uint8* currpos = target.data;
 
     uint32 verteciesAppended = 0;
-    uint32 particleStride = vertexStride * 4;
 
     if (begin->material && begin->layer->useThreePointGradient)
         SetupThreePontGradient(*begin, begin->material);
 
+    // Distribute quads between allocated vertex buffers first, then fill the reserved ranges concurrently.
+    quadsRanges.clear();
     for (auto it = begin; it != end; ++it)
     {
         const ParticleGroup& group = *it;
         if (!CheckGroup(group))
             continue; //if no material was set up, or empty group, or layer rendering is disabled or sprite is removed - don't draw anyway
 
-        //prepare basis indexes
-        int32 basisCount = 0;
-        int32 basises[4]; //4 basises max per particle
-        basisCount = PrepareBasisIndexes(group, basises);
+        int32 basises[4];
+        uint32 groupQuadsCount = group.particles.GetCount() * static_cast<uint32>(PrepareBasisIndexes(group, basises));
+        uint32 quad = 0;
+        while (quad < groupQuadsCount)
+        {
+            if (verteciesAppended + 4 > target.allocatedVertices)
+            {
+                uint32 vLayout = SelectLayout(*group.layer);
+                AppendRenderBatch(group.material, verteciesAppended / 4 * 6, vLayout, target);
+                verteciesToAllocate -= verteciesAppended;
+                verteciesAppended = 0;
+
+                target = DynamicBufferAllocator::AllocateVertexBuffer(vertexStride, verteciesToAllocate);
+            }
+
+            uint32 freeQuadsCount = (target.allocatedVertices - verteciesAppended) / 4;
+            uint32 rangeQuadsCount = Min(Min(groupQuadsCount - quad, freeQuadsCount), ParticleRenderObjectDetails::QUADS_GRAIN_SIZE);
+
+            QuadsRange range;
+            range.group = &group;
+            range.firstQuad = quad;
+            range.quadsCount = rangeQuadsCount;
+            range.data = target.data + verteciesAppended * vertexStride;
+            quadsRanges.push_back(range);
+
+            quad += rangeQuadsCount;
+            verteciesAppended += rangeQuadsCount * 4;
+        }
+    }
+
+    ParticleLayer* layoutLayer = begin->layer;
+    ParallelFor(0, static_cast<uint32>(quadsRanges.size()), 1, [&](uint32 rangeBegin, uint32 rangeEnd) {
+        for (uint32 r = rangeBegin; r < rangeEnd; ++r)
+            FillParticleQuads(quadsRanges[r], layoutLayer, vertexStride, cameraDirection, basisVectors);
+    });
+
+    if (verteciesAppended)
+    {
+        AppendRenderBatch(begin->material, verteciesAppended / 4 * 6, SelectLayout(*begin->layer), target);
+    }
+}
+
+void ParticleRenderObject::FillParticleQuads(const QuadsRange& range, const ParticleLayer* layoutLayer, uint32 vertexStride, const Vector3& cameraDirection, const Vector3* basisVectors) const
+{
+    const ParticleGroup& group = *range.group;
+    const ParticleStorage& particles = group.particles;
 
-        Particle* current = group.head;
-        while (current)
+    int32 basises[4]; //4 basises max per particle
+    uint32 basisCount = static_cast<uint32>(PrepareBasisIndexes(group, basises));
+    uint32 particleStride = vertexStride * 4;
+    uint8* dst = range.data;
+
+    // quads are ordered by particles, newest particles first
+    uint32 particlesCount = particles.GetCount();
+    uint32 prevIndex = particlesCount;
+    float32* pT = nullptr;
+    uint32 color = 0;
+    float32 sin_angle = 0.0f;
+    float32 cos_angle = 0.0f;
+    for (uint32 quad = range.firstQuad, quadsEnd = range.firstQuad + range.quadsCount; quad < quadsEnd; ++quad)
+    {
+        uint32 index = particlesCount - 1 - quad / basisCount;
+        uint32 basis = quad % basisCount;
+        if (index != prevIndex)
         {
-            float32* pT = group.layer->sprite->GetTextureVerts(current->frame);
-            Color currColor = current->color;
+            prevIndex = index;
+            pT = group.layer->sprite->GetTextureVerts(particles.frame[index]);
+            Color currColor = particles.color[index];
             if (group.layer->colorOverLife)
-                currColor = group.layer->colorOverLife->GetValue(current->life / current->lifeTime);
+                currColor = group.layer->colorOverLife->Sample(particles.life[index] / particles.lifeTime[index]);
             if (group.layer->alphaOverLife)
-                currColor.a = group.layer->alphaOverLife->GetValue(current->life / current->lifeTime);
-            uint32 color = rhi::NativeColorRGBA(currColor.r, currColor.g, currColor.b, Min(currColor.a, 1.0f));
-            float32 sin_angle;
-            float32 cos_angle;
-            SinCosFast(-current->angle, sin_angle, cos_angle); //- is because artists consider positive rotation to be clockwise
-
-            for (int32 i = 0; i < basisCount; i++)
-            {
-                if (verteciesAppended + 4 > target.allocatedVertices)
-                {
-                    uint32 vLayout = SelectLayout(*group.layer);
-                    AppendRenderBatch(group.material, verteciesAppended / 4 * 6, vLayout, target);
-                    verteciesToAllocate -= verteciesAppended;
-                    verteciesAppended = 0;
-
-                    target = DynamicBufferAllocator::AllocateVertexBuffer(vertexStride, verteciesToAllocate);
-                    currpos = target.data;
-                }
+                currColor.a = group.layer->alphaOverLife->Sample(particles.life[index] / particles.lifeTime[index]);
+            color = rhi::NativeColorRGBA(currColor.r, currColor.g, currColor.b, Min(currColor.a, 1.0f));
+            SinCosFast(-particles.angle[index], sin_angle, cos_angle); //- is because artists consider positive rotation to be clockwise
+        }
 
-                float32* verts[4];
-                verts[0] = reinterpret_cast<float32*>(currpos);
-                verts[1] = reinterpret_cast<float32*>(currpos + vertexStride);
-                verts[2] = reinterpret_cast<float32*>(currpos + 2 * vertexStride);
-                verts[3] = reinterpret_cast<float32*>(currpos + 3 * vertexStride);
+        float32* verts[4];
+        verts[0] = reinterpret_cast<float32*>(dst);
+        verts[1] = reinterpret_cast<float32*>(dst + vertexStride);
+        verts[2] = reinterpret_cast<float32*>(dst + 2 * vertexStride);
+        verts[3] = reinterpret_cast<float32*>(dst + 3 * vertexStride);
 
-                Vector3 ex = basisVectors[basises[i] * 2];
-                Vector3 ey = basisVectors[basises[i] * 2 + 1];
-                //TODO: rethink this code - it should be easier
-                if (group.layer->isLong) //note that for now it's just a copy of long implementatio - later rethink it;
-                {
-                    ey = current->speed;
-                    float32 vel = ey.Length();
-                    float32 base = 0.0f;
-                    if (vel < EPSILON)
-                        ey = Vector3(0.0f, 0.0f, 1.0f);
-                    else
-                        base = group.layer->scaleVelocityBase / vel;
-                    ex = ey.CrossProduct(cameraDirection);
-                    ex.Normalize();
-                    ey *= (base + group.layer->scaleVelocityFactor); //optimized ex=(svBase+svFactor*vel)/vel
-                }
+        Vector3 ex = basisVectors[basises[basis] * 2];
+        Vector3 ey = basisVectors[basises[basis] * 2 + 1];
+        //TODO: rethink this code - it should be easier
+        if (group.layer->isLong) //note that for now it's just a copy of long implementatio - later rethink it;
+        {
+            ey = particles.GetSpeed(index);
+            float32 vel = ey.Length();
+            float32 base = 0.0f;
+            if (vel < EPSILON)
+                ey = Vector3(0.0f, 0.0f, 1.0f);
+            else
+                base = group.layer->scaleVelocityBase / vel;
+            ex = ey.CrossProduct(cameraDirection);
+            ex.Normalize();
+            ey *= (base + group.layer->scaleVelocityFactor); //optimized ex=(svBase+svFactor*vel)/vel
+        }
 
-                Vector3 left = ex * cos_angle + ey * sin_angle;
-                Vector3 right = -left;
-                Vector3 top = ey * (-cos_angle) + ex * sin_angle;
-                Vector3 bot = -top;
+        Vector3 left = ex * cos_angle + ey * sin_angle;
+        Vector3 right = -left;
+        Vector3 top = ey * (-cos_angle) + ex * sin_angle;
+        Vector3 bot = -top;
 
-                float32 fresnelToAlpha = 0.0f;
-                if (begin->layer->useFresnelToAlpha)
-                {
-                    Vector3 viewNormal = left.CrossProduct(top);
-                    float32 dot = cameraDirection.DotProduct(viewNormal);
-                    dot = 1.0f - Abs(dot);
-                    fresnelToAlpha = FresnelShlick(dot, group.layer->fresnelToAlphaBias, group.layer->fresnelToAlphaPower);
-                }
+        float32 fresnelToAlpha = 0.0f;
+        if (layoutLayer->useFresnelToAlpha)
+        {
+            Vector3 viewNormal = left.CrossProduct(top);
+            float32 dot = cameraDirection.DotProduct(viewNormal);
+            dot = 1.0f - Abs(dot);
+            fresnelToAlpha = FresnelShlick(dot, group.layer->fresnelToAlphaBias, group.layer->fresnelToAlphaPower);
+        }
 
-                left *= 0.5f * current->currSize.x * (1 + group.layer->layerPivotPoint.x);
-                right *= 0.5f * current->currSize.x * (1 - group.layer->layerPivotPoint.x);
-                top *= 0.5f * current->currSize.y * (1 + group.layer->layerPivotPoint.y);
-                bot *= 0.5f * current->currSize.y * (1 - group.layer->layerPivotPoint.y);
+        left *= 0.5f * particles.currSize[index].x * (1 + group.layer->layerPivotPoint.x);
+        right *= 0.5f * particles.currSize[index].x * (1 - group.layer->layerPivotPoint.x);
+        top *= 0.5f * particles.currSize[index].y * (1 + group.layer->layerPivotPoint.y);
+        bot *= 0.5f * particles.currSize[index].y * (1 - group.layer->layerPivotPoint.y);
 
-                Vector3 particlePosition = current->position;
-                if (group.layer->GetInheritPosition())
-                    particlePosition += effectData->infoSources[group.positionSource].position;
-                Array<Vector3, 4> quadPos = { particlePosition + left + bot, particlePosition + right + bot, particlePosition + left + top, particlePosition + right + top };
-                uint32 ptrOffset = 0;
+        Vector3 particlePosition = particles.GetPosition(index);
+        if (group.layer->GetInheritPosition())
+            particlePosition += effectData->infoSources[group.positionSource].position;
+        Array<Vector3, 4> quadPos = { particlePosition + left + bot, particlePosition + right + bot, particlePosition + left + top, particlePosition + right + top };
+        uint32 ptrOffset = 0;
 
-                for (int32 i = 0; i < 4; i++)
-                {
-                    verts[i][ptrOffset + 0] = quadPos[i].x; // Position xyz.
-                    verts[i][ptrOffset + 1] = quadPos[i].y;
-                    verts[i][ptrOffset + 2] = quadPos[i].z;
-
-                    verts[i][ptrOffset + 3] = pT[i * 2]; // VS_TEXCOORD0 xy + color.
-                    verts[i][ptrOffset + 4] = pT[i * 2 + 1];
-                    uint32* cp = reinterpret_cast<uint32*>(verts[i]) + (ptrOffset + 5);
-                    *cp = color;
-                }
-                ptrOffset += 6;
+        for (int32 i = 0; i < 4; i++)
+        {
+            verts[i][ptrOffset + 0] = quadPos[i].x; // Position xyz.
+            verts[i][ptrOffset + 1] = quadPos[i].y;
+            verts[i][ptrOffset + 2] = quadPos[i].z;
+
+            verts[i][ptrOffset + 3] = pT[i * 2]; // VS_TEXCOORD0 xy + color.
+            verts[i][ptrOffset + 4] = pT[i * 2 + 1];
+            uint32* cp = reinterpret_cast<uint32*>(verts[i]) + (ptrOffset + 5);
+            *cp = color;
+        }
+        ptrOffset += 6;
 
-                if (begin->layer->enableFrameBlend)
-                {
-                    int32 nextFrame = current->frame + 1;
-                    if (nextFrame >= group.layer->sprite->GetFrameCount())
-                    {
-                        if (group.layer->loopSpriteAnimation)
-                            nextFrame = 0;
-                        else
-                            nextFrame = group.layer->sprite->GetFrameCount() - 1;
-                    }
-                    float32* pT = group.layer->sprite->GetTextureVerts(nextFrame);
+        if (layoutLayer->enableFrameBlend)
+        {
+            int32 nextFrame = particles.frame[index] + 1;
+            if (nextFrame >= group.layer->sprite->GetFrameCount())
+            {
+                if (group.layer->loopSpriteAnimation)
+                    nextFrame = 0;
+                else
+                    nextFrame = group.layer->sprite->GetFrameCount() - 1;
+            }
+            float32* pT = group.layer->sprite->GetTextureVerts(nextFrame);
 
-                    for (int32 i = 0; i < 4; i++) // VS_TEXCOORD1 xy + time.
-                    {
-                        verts[i][ptrOffset] = *(pT++);
-                        verts[i][ptrOffset + 1] = *(pT++);
-                        verts[i][ptrOffset + 2] = current->animTime;
-                    }
-                    ptrOffset += 3;
-                }
-                if (begin->layer->enableFlow && begin->layer->flowmap.get() != nullptr)
-                {
-                    float32* flowUV = group.layer->flowmap->GetTextureVerts(current->frame);
-                    for (int32 i = 0; i < 4; i++) // VS_TEXCOORD2.xy, z - speed, w - offset.
-                    {
-                        verts[i][ptrOffset + 0] = flowUV[i * 2];
-                        verts[i][ptrOffset + 1] = flowUV[i * 2 + 1];
-                        verts[i][ptrOffset + 2] = current->currFlowSpeed;
-                        verts[i][ptrOffset + 3] = current->currFlowOffset;
-                    }
-                    ptrOffset += 4;
-                }
-                if (begin->layer->enableNoise && begin->layer->noise.get() != nullptr)
-                {
-                    float32* noiseUV = group.layer->noise->GetTextureVerts(current->frame);
-                    for (int32 i = 0; i < 4; ++i)
-                    {
-                        verts[i][ptrOffset + 0] = noiseUV[i * 2]; // VS_TEXCOORD0 xy + color.
-                        verts[i][ptrOffset + 1] = noiseUV[i * 2 + 1];
-                        verts[i][ptrOffset + 2] = current->currNoiseScale;
-                        if (begin->layer->enableNoiseScroll)
-                        {
-                            verts[i][ptrOffset + 0] += current->currNoiseUOffset;
-                            verts[i][ptrOffset + 1] += current->currNoiseVOffset;
-                        }
-                    }
-                    ptrOffset += 3;
-                }
-                if (begin->layer->enableAlphaRemap || begin->layer->useFresnelToAlpha)
+            for (int32 i = 0; i < 4; i++) // VS_TEXCOORD1 xy + time.
+            {
+                verts[i][ptrOffset] = *(pT++);
+                verts[i][ptrOffset + 1] = *(pT++);
+                verts[i][ptrOffset + 2] = particles.animTime[index];
+            }
+            ptrOffset += 3;
+        }
+        if (layoutLayer->enableFlow && layoutLayer->flowmap.get() != nullptr)
+        {
+            float32* flowUV = group.layer->flowmap->GetTextureVerts(particles.frame[index]);
+            for (int32 i = 0; i < 4; i++) // VS_TEXCOORD2.xy, z - speed, w - offset.
+            {
+                verts[i][ptrOffset + 0] = flowUV[i * 2];
+                verts[i][ptrOffset + 1] = flowUV[i * 2 + 1];
+                verts[i][ptrOffset + 2] = particles.currFlowSpeed[index];
+                verts[i][ptrOffset + 3] = particles.currFlowOffset[index];
+            }
+            ptrOffset += 4;
+        }
+        if (layoutLayer->enableNoise && layoutLayer->noise.get() != nullptr)
+        {
+            float32* noiseUV = group.layer->noise->GetTextureVerts(particles.frame[index]);
+            for (int32 i = 0; i < 4; ++i)
+            {
+                verts[i][ptrOffset + 0] = noiseUV[i * 2]; // VS_TEXCOORD0 xy + color.
+                verts[i][ptrOffset + 1] = noiseUV[i * 2 + 1];
+                verts[i][ptrOffset + 2] = particles.currNoiseScale[index];
+                if (layoutLayer->enableNoiseScroll)
                 {
-                    for (int32 i = 0; i < 4; ++i)
-                    {
-                        verts[i][ptrOffset + 0] = fresnelToAlpha;
-                        verts[i][ptrOffset + 1] = current->alphaRemap;
-                        verts[i][ptrOffset + 2] = 0.0f;
-                    }
-                    ptrOffset += 3;
+                    verts[i][ptrOffset + 0] += particles.currNoiseUOffset[index];
+                    verts[i][ptrOffset + 1] += particles.currNoiseVOffset[index];
                 }
-                currpos += particleStride;
-                verteciesAppended += 4;
             }
-            current = current->next;
+            ptrOffset += 3;
+        }
+        if (layoutLayer->enableAlphaRemap || layoutLayer->useFresnelToAlpha)
+        {
+            for (int32 i = 0; i < 4; ++i)
+            {
+                verts[i][ptrOffset + 0] = fresnelToAlpha;
+                verts[i][ptrOffset + 1] = particles.alphaRemap[index];
+                verts[i][ptrOffset + 2] = 0.0f;
+            }
+            ptrOffset += 3;
         }
-    }
 
-    if (verteciesAppended)
-    {
-        AppendRenderBatch(begin->material, verteciesAppended / 4 * 6, SelectLayout(*begin->layer), target);
+        dst += particleStride;
     }
 }
 
@@ -489,22 +532,19 @@ void ParticleRenderObject::AppendStripeParticle(List<ParticleGroup>::iterator be
         if (basisCount == 0)
             continue;
 
-        Particle* currentParticle = group.head;
-        while (currentParticle)
+        const ParticleStorage& particles = group.particles;
+        for (uint32 index = particles.GetCount(); index-- > 0;)
         {
             StripeData& data = group.stripe;
             if (!data.isActive)
-            {
-                currentParticle = currentParticle->next;
                 continue;
-            }
 
-            float32* pT = group.layer->sprite->GetTextureVerts(currentParticle->frame);
-            Color currColor = currentParticle->color;
+            float32* pT = group.layer->sprite->GetTextureVerts(particles.frame[index]);
+            Color currColor = particles.color[index];
             if (group.layer->colorOverLife)
-                currColor = group.layer->colorOverLife->GetValue(currentParticle->life / currentParticle->lifeTime);
+                currColor = group.layer->colorOverLife->Sample(particles.life[index] / particles.lifeTime[index]);
             if (group.layer->alphaOverLife)
-                currColor.a = group.layer->alphaOverLife->GetValue(currentParticle->life / currentParticle->lifeTime);
+                currColor.a = group.layer->alphaOverLife->Sample(particles.life[index] / particles.lifeTime[index]);
 
             StripeNode& base = data.baseNode;
             List<StripeNode>& nodes = data.stripeNodes;
@@ -558,7 +598,7 @@ void ParticleRenderObject::AppendStripeParticle(List<ParticleGroup>::iterator be
 
                 float32 size = group.layer->stripeStartSize * 0.5f;
                 if (group.layer->stripeSizeOverLife)
-                    size *= group.layer->stripeSizeOverLife->GetValue(0.0f);
+                    size *= group.layer->stripeSizeOverLife->Sample(0.0f);
                 Vector3 scaledBasis = basisVector * size;
                 float32 fullEdgeSize = size + size;
                 Vector3 left = base.position + data.inheritPositionOffset + scaledBasis;
@@ -566,11 +606,11 @@ void ParticleRenderObject::AppendStripeParticle(List<ParticleGroup>::iterator be
 
                 float32 tile = 1.0f;
                 if (group.layer->stripeTextureTileOverLife)
-                    tile = group.layer->stripeTextureTileOverLife->GetValue(0.0f);
-                float32 startU = currentParticle->life * group.layer->stripeUScrollSpeed;
-                float32 startV = currentParticle->life * group.layer->stripeVScrollSpeed;
+                    tile = group.layer->stripeTextureTileOverLife->Sample(0.0f);
+                float32 startU = particles.life[index] * group.layer->stripeUScrollSpeed;
+                float32 startV = particles.life[index] * group.layer->stripeVScrollSpeed;
                 if (Abs(data.uvOffset) > EPSILON)
-                    startV += data.uvOffset * tile + currentParticle->life * group.layer->stripeVScrollSpeed;
+                    startV += data.uvOffset * tile + particles.life[index] * group.layer->stripeVScrollSpeed;
 
                 Vector3 uv1 = Vector3(startU, startV, 0.0f);
                 Vector3 uv2 = Vector3(startU + 1.0f, startV, 0.0f);
@@ -587,7 +627,7 @@ void ParticleRenderObject::AppendStripeParticle(List<ParticleGroup>::iterator be
 
                 Color colOverLife = Color::White;
                 if (group.layer->stripeColorOverLife)
-                    colOverLife = group.layer->stripeColorOverLife->GetValue(0.0f);
+                    colOverLife = group.layer->stripeColorOverLife->Sample(0.0f);
 
                 float32 fadeFromTop = 1.0f;
                 float32 distToUp = 0.0f;
@@ -601,8 +641,8 @@ void ParticleRenderObject::AppendStripeParticle(List<ParticleGroup>::iterator be
 
                 uint32 col = rhi::NativeColorRGBA(Saturate(currColor.r * colOverLife.r), Saturate(currColor.g * colOverLife.g), Saturate(currColor.b * colOverLife.b), Saturate(currColor.a * colOverLife.a * fadeFromTop));
                 float32* color = reinterpret_cast<float32*>(&col);
-                UpdateStripeVertex(vertexBufferData, left, uv1, color, group.layer, currentParticle, fresnelToAlpha);
-                UpdateStripeVertex(vertexBufferData, right, uv2, color, group.layer, currentParticle, fresnelToAlpha);
+                UpdateStripeVertex(vertexBufferData, left, uv1, color, group.layer, particles, index, fresnelToAlpha);
+                UpdateStripeVertex(vertexBufferData, right, uv2, color, group.layer, particles, index, fresnelToAlpha);
 
                 float32 distance = 0.0f;
 
@@ -625,7 +665,7 @@ void ParticleRenderObject::AppendStripeParticle(List<ParticleGroup>::iterator be
                     float32 overLifeTime = node.lifeime / group.layer->stripeLifetime;
                     size = group.layer->stripeStartSize * 0.5f;
                     if (group.layer->stripeSizeOverLife)
-                        size *= group.layer->stripeSizeOverLife->GetValue(overLifeTime);
+                        size *= group.layer->stripeSizeOverLife->Sample(overLifeTime);
                     fullEdgeSize = size + size;
                     scaledBasis = basisVector * size;
                     left = node.position + data.inheritPositionOffset + scaledBasis;
@@ -633,7 +673,7 @@ void ParticleRenderObject::AppendStripeParticle(List<ParticleGroup>::iterator be
 
                     colOverLife = Color::White;
                     if (group.layer->stripeColorOverLife)
-                        colOverLife = group.layer->stripeColorOverLife->GetValue(overLifeTime);
+                        colOverLife = group.layer->stripeColorOverLife->Sample(overLifeTime);
 
                     col = rhi::NativeColorRGBA(Saturate(currColor.r * colOverLife.r), Saturate(currColor.g * colOverLife.g), Saturate(currColor.b * colOverLife.b), Saturate(currColor.a * colOverLife.a * fadeFromTop));
 
@@ -641,10 +681,10 @@ void ParticleRenderObject::AppendStripeParticle(List<ParticleGroup>::iterator be
 
                     tile = 1.0f;
                     if (group.layer->stripeTextureTileOverLife)
-                        tile = group.layer->stripeTextureTileOverLife->GetValue(overLifeTime);
-                    float32 v = distance * tile + currentParticle->life * group.layer->stripeVScrollSpeed;
+                        tile = group.layer->stripeTextureTileOverLife->Sample(overLifeTime);
+                    float32 v = distance * tile + particles.life[index] * group.layer->stripeVScrollSpeed;
                     if (Abs(data.uvOffset) > EPSILON)
-                        v += data.uvOffset * tile + currentParticle->life * group.layer->stripeVScrollSpeed;
+                        v += data.uvOffset * tile + particles.life[index] * group.layer->stripeVScrollSpeed;
 
                     if (group.layer->usePerspectiveMapping)
                     {
@@ -657,8 +697,8 @@ void ParticleRenderObject::AppendStripeParticle(List<ParticleGroup>::iterator be
                     uv1.y = v;
                     uv2.y = v;
 
-                    UpdateStripeVertex(vertexBufferData, left, uv1, color, group.layer, currentParticle, fresnelToAlpha);
-                    UpdateStripeVertex(vertexBufferData, right, uv2, color, group.layer, currentParticle, fresnelToAlpha);
+                    UpdateStripeVertex(vertexBufferData, left, uv1, color, group.layer, particles, index, fresnelToAlpha);
+                    UpdateStripeVertex(vertexBufferData, right, uv2, color, group.layer, particles, index, fresnelToAlpha);
                 }
                 for (uint32 i = 0; i < static_cast<uint32>(nodes.size()); ++i)
                 {
@@ -674,7 +714,6 @@ void ParticleRenderObject::AppendStripeParticle(List<ParticleGroup>::iterator be
                 baseVertex += vCountInBasis;
             }
             AppendRenderBatch(begin->material, iCount, SelectLayout(*begin->layer), vb, ib.buffer, ib.baseIndex);
-            currentParticle = currentParticle->next;
         }
     }
 }
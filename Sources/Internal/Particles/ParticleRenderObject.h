@@ -76,9 +76,21 @@ private:
     uint32 GetVertexStride(ParticleLayer* layer);
     int32 CalculateParticleCount(const ParticleGroup& group);
     uint32 SelectLayout(const ParticleLayer& layer);
-    void UpdateStripeVertex(float32*& dataPtr, Vector3& position, Vector3& uv, float32* color, ParticleLayer* layer, Particle* particle, float32 fresToAlpha);
+    void UpdateStripeVertex(float32*& dataPtr, Vector3& position, Vector3& uv, float32* color, ParticleLayer* layer, const ParticleStorage& particles, uint32 index, float32 fresToAlpha);
     Vector3 GetStripeNormalizedSpeed(const StripeData& data);
 
+    /** Part of group quads written to reserved vertex buffer range. Quad `q` is basis `q % basisCount` of particle `count - 1 - q / basisCount`. */
+    struct QuadsRange
+    {
+        const ParticleGroup* group = nullptr;
+        uint32 firstQuad = 0;
+        uint32 quadsCount = 0;
+        uint8* data = nullptr;
+    };
+    Vector<QuadsRange> quadsRanges;
+
+    void FillParticleQuads(const QuadsRange& range, const ParticleLayer* layoutLayer, uint32 vertexStride, const Vector3& cameraDirection, const Vector3* basisVectors) const;
+
     Map<uint32, uint32> layoutMap;
 
     float FresnelShlick(float32 nDotVInv, float32 bias, float32 power) const;
@@ -107,6 +119,6 @@ inline bool ParticleRenderObject::CheckIfSimpleParticle(ParticleLayer* layer) co
 
 inline bool ParticleRenderObject::CheckGroup(const ParticleGroup& group) const
 {
-    return group.material && group.head && !group.layer->isDisabled && group.layer->sprite;
+    return group.material && !group.particles.IsEmpty() && !group.layer->isDisabled && group.layer->sprite;
 }
 }
@@ -0,0 +1,285 @@
+#include "Particles/ParticleSimulation.h"
+#include "Particles/ParticleStorage.h"
+#include "Math/AABBox3.h"
+#include "Math/SSE/SSEMath.h"
+
+namespace DAVA
+{
+namespace ParticleSimulation
+{
+void AdvanceLife(ParticleStorage& particles, float32 dt)
+{
+    uint32 count = particles.GetCount();
+    float32* life = particles.life.data();
+    uint32 i = 0;
+
+#if defined(__DAVAENGINE_SSE2__)
+    __m128 dt4 = _mm_set1_ps(dt);
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(life + i, _mm_add_ps(_mm_loadu_ps(life + i), dt4));
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        life[i] += dt;
+    }
+}
+
+void RemoveDeadParticles(ParticleStorage& particles)
+{
+    // backward order: particle moved in place of removed one is already checked
+    for (uint32 i = particles.GetCount(); i-- > 0;)
+    {
+        if (particles.life[i] >= particles.lifeTime[i])
+            particles.Remove(i);
+    }
+}
+
+void CalculateOverLife(const ParticleStorage& particles, float32* overLife)
+{
+    uint32 count = particles.GetCount();
+    const float32* life = particles.life.data();
+    const float32* lifeTime = particles.lifeTime.data();
+    uint32 i = 0;
+
+#if defined(__DAVAENGINE_SSE2__)
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(overLife + i, _mm_div_ps(_mm_loadu_ps(life + i), _mm_loadu_ps(lifeTime + i)));
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        overLife[i] = life[i] / lifeTime[i];
+    }
+}
+
+void IntegratePositions(ParticleStorage& particles, float32 dt)
+{
+    uint32 count = particles.GetCount();
+    float32* position[3] = { particles.positionX.data(), particles.positionY.data(), particles.positionZ.data() };
+    const float32* speed[3] = { particles.speedX.data(), particles.speedY.data(), particles.speedZ.data() };
+
+    for (uint32 c = 0; c < 3; ++c)
+    {
+        float32* p = position[c];
+        const float32* s = speed[c];
+        uint32 i = 0;
+
+#if defined(__DAVAENGINE_SSE2__)
+        __m128 dt4 = _mm_set1_ps(dt);
+        for (; i + 4 <= count; i += 4)
+        {
+            _mm_storeu_ps(p + i, _mm_add_ps(_mm_loadu_ps(p + i), _mm_mul_ps(_mm_loadu_ps(s + i), dt4)));
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            p[i] += s[i] * dt;
+        }
+    }
+}
+
+void IntegratePositions(ParticleStorage& particles, const float32* timeScale)
+{
+    uint32 count = particles.GetCount();
+    float32* position[3] = { particles.positionX.data(), particles.positionY.data(), particles.positionZ.data() };
+    const float32* speed[3] = { particles.speedX.data(), particles.speedY.data(), particles.speedZ.data() };
+
+    for (uint32 c = 0; c < 3; ++c)
+    {
+        float32* p = position[c];
+        const float32* s = speed[c];
+        uint32 i = 0;
+
+#if defined(__DAVAENGINE_SSE2__)
+        for (; i + 4 <= count; i += 4)
+        {
+            _mm_storeu_ps(p + i, _mm_add_ps(_mm_loadu_ps(p + i), _mm_mul_ps(_mm_loadu_ps(s + i), _mm_loadu_ps(timeScale + i))));
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            p[i] += s[i] * timeScale[i];
+        }
+    }
+}
+
+void IntegrateAngles(ParticleStorage& particles, float32 dt)
+{
+    uint32 count = particles.GetCount();
+    float32* angle = particles.angle.data();
+    const float32* spin = particles.spin.data();
+    uint32 i = 0;
+
+#if defined(__DAVAENGINE_SSE2__)
+    __m128 dt4 = _mm_set1_ps(dt);
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(angle + i, _mm_add_ps(_mm_loadu_ps(angle + i), _mm_mul_ps(_mm_loadu_ps(spin + i), dt4)));
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        angle[i] += spin[i] * dt;
+    }
+}
+
+void IntegrateAngles(ParticleStorage& particles, const float32* spinScale, float32 dt)
+{
+    uint32 count = particles.GetCount();
+    float32* angle = particles.angle.data();
+    const float32* spin = particles.spin.data();
+    uint32 i = 0;
+
+#if defined(__DAVAENGINE_SSE2__)
+    __m128 dt4 = _mm_set1_ps(dt);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 delta = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(spin + i), _mm_loadu_ps(spinScale + i)), dt4);
+        _mm_storeu_ps(angle + i, _mm_add_ps(_mm_loadu_ps(angle + i), delta));
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        angle[i] += spin[i] * spinScale[i] * dt;
+    }
+}
+
+void AccumulateForce(float32* accelerationX, float32* accelerationY, float32* accelerationZ, uint32 count, const Vector3& force)
+{
+    float32* acceleration[3] = { accelerationX, accelerationY, accelerationZ };
+
+    for (uint32 c = 0; c < 3; ++c)
+    {
+        float32* a = acceleration[c];
+        float32 f = force.data[c];
+        uint32 i = 0;
+
+#if defined(__DAVAENGINE_SSE2__)
+        __m128 f4 = _mm_set1_ps(f);
+        for (; i + 4 <= count; i += 4)
+        {
+            _mm_storeu_ps(a + i, _mm_add_ps(_mm_loadu_ps(a + i), f4));
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            a[i] += f;
+        }
+    }
+}
+
+void AccumulateForce(float32* accelerationX, float32* accelerationY, float32* accelerationZ, uint32 count, const Vector3& force, const float32* forceScale)
+{
+    float32* acceleration[3] = { accelerationX, accelerationY, accelerationZ };
+
+    for (uint32 c = 0; c < 3; ++c)
+    {
+        float32* a = acceleration[c];
+        float32 f = force.data[c];
+        uint32 i = 0;
+
+#if defined(__DAVAENGINE_SSE2__)
+        __m128 f4 = _mm_set1_ps(f);
+        for (; i + 4 <= count; i += 4)
+        {
+            _mm_storeu_ps(a + i, _mm_add_ps(_mm_loadu_ps(a + i), _mm_mul_ps(f4, _mm_loadu_ps(forceScale + i))));
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            a[i] += f * forceScale[i];
+        }
+    }
+}
+
+void ApplyAcceleration(ParticleStorage& particles, const float32* accelerationX, const float32* accelerationY, const float32* accelerationZ, float32 dt)
+{
+    uint32 count = particles.GetCount();
+    float32* speed[3] = { particles.speedX.data(), particles.speedY.data(), particles.speedZ.data() };
+    const float32* acceleration[3] = { accelerationX, accelerationY, accelerationZ };
+
+    for (uint32 c = 0; c < 3; ++c)
+    {
+        float32* s = speed[c];
+        const float32* a = acceleration[c];
+        uint32 i = 0;
+
+#if defined(__DAVAENGINE_SSE2__)
+        __m128 dt4 = _mm_set1_ps(dt);
+        for (; i + 4 <= count; i += 4)
+        {
+            _mm_storeu_ps(s + i, _mm_add_ps(_mm_loadu_ps(s + i), _mm_mul_ps(_mm_loadu_ps(a + i), dt4)));
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            s[i] += a[i] * dt;
+        }
+    }
+}
+
+void AddParticlesToBBox(const ParticleStorage& particles, const Vector3& offset, AABBox3& bbox)
+{
+    uint32 count = particles.GetCount();
+    if (count == 0)
+        return;
+
+    const float32* position[3] = { particles.positionX.data(), particles.positionY.data(), particles.positionZ.data() };
+    const float32* radius = particles.currRadius.data();
+
+    Vector3 bmin = bbox.min;
+    Vector3 bmax = bbox.max;
+    for (uint32 c = 0; c < 3; ++c)
+    {
+        const float32* p = position[c];
+        float32 o = offset.data[c];
+        uint32 i = 0;
+
+#if defined(__DAVAENGINE_SSE2__)
+        if (count >= 4)
+        {
+            __m128 o4 = _mm_set1_ps(o);
+            __m128 min4 = _mm_set1_ps(bmin.data[c]);
+            __m128 max4 = _mm_set1_ps(bmax.data[c]);
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 center = _mm_add_ps(_mm_loadu_ps(p + i), o4);
+                __m128 r = _mm_loadu_ps(radius + i);
+                min4 = _mm_min_ps(min4, _mm_sub_ps(center, r));
+                max4 = _mm_max_ps(max4, _mm_add_ps(center, r));
+            }
+
+            float32 mins[4];
+            float32 maxs[4];
+            _mm_storeu_ps(mins, min4);
+            _mm_storeu_ps(maxs, max4);
+            bmin.data[c] = Min(Min(mins[0], mins[1]), Min(mins[2], mins[3]));
+            bmax.data[c] = Max(Max(maxs[0], maxs[1]), Max(maxs[2], maxs[3]));
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            float32 center = p[i] + o;
+            bmin.data[c] = Min(bmin.data[c], center - radius[i]);
+            bmax.data[c] = Max(bmax.data[c], center + radius[i]);
+        }
+    }
+
+    bbox.min = bmin;
+    bbox.max = bmax;
+}
+}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+
+namespace DAVA
+{
+class Vector3;
+class AABBox3;
+class ParticleStorage;
+
+/**
+    Kernels advancing all particles of `ParticleStorage` at once.
+    They use SSE when available (see Math/SSE/SSEMath.h) and produce the same results as per-particle scalar code.
+    Per-particle arrays passed to kernels should contain at least `particles.GetCount()` values.
+*/
+namespace ParticleSimulation
+{
+/** Calculate `life[i] += dt`. */
+void AdvanceLife(ParticleStorage& particles, float32 dt);
+
+/** Remove particles with `life[i] >= lifeTime[i]`. */
+void RemoveDeadParticles(ParticleStorage& particles);
+
+/** Calculate `overLife[i] = life[i] / lifeTime[i]`. */
+void CalculateOverLife(const ParticleStorage& particles, float32* overLife);
+
+/** Calculate `position[i] += speed[i] * dt`. */
+void IntegratePositions(ParticleStorage& particles, float32 dt);
+
+/** Calculate `position[i] += speed[i] * timeScale[i]`. */
+void IntegratePositions(ParticleStorage& particles, const float32* timeScale);
+
+/** Calculate `angle[i] += spin[i] * dt`. */
+void IntegrateAngles(ParticleStorage& particles, float32 dt);
+
+/** Calculate `angle[i] += spin[i] * spinScale[i] * dt`. */
+void IntegrateAngles(ParticleStorage& particles, const float32* spinScale, float32 dt);
+
+/** Calculate `acceleration[i] += force` for `count` particles, acceleration is split by components. */
+void AccumulateForce(float32* accelerationX, float32* accelerationY, float32* accelerationZ, uint32 count, const Vector3& force);
+
+/** Calculate `acceleration[i] += force * forceScale[i]` for `count` particles, acceleration is split by components. */
+void AccumulateForce(float32* accelerationX, float32* accelerationY, float32* accelerationZ, uint32 count, const Vector3& force, const float32* forceScale);
+
+/** Calculate `speed[i] += acceleration[i] * dt`. */
+void ApplyAcceleration(ParticleStorage& particles, const float32* accelerationX, const float32* accelerationY, const float32* accelerationZ, float32 dt);
+
+/** Add boxes with centers `position[i] + offset` and half sizes `currRadius[i]` to `bbox`. */
+void AddParticlesToBBox(const ParticleStorage& particles, const Vector3& offset, AABBox3& bbox);
+}
+}
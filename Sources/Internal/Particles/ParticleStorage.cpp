@@ -0,0 +1,138 @@
+#include "Particles/ParticleStorage.h"
+#include "Particles/Particle.h"
+#include "Debug/DVAssert.h"
+
+namespace DAVA
+{
+namespace ParticleStorageDetails
+{
+template <typename T>
+inline void RemoveSwap(Vector<T>& values, uint32 index)
+{
+    values[index] = values.back();
+    values.pop_back();
+}
+}
+
+uint32 ParticleStorage::Add(const Particle& particle)
+{
+    uint32 index = GetCount();
+
+    life.push_back(particle.life);
+    lifeTime.push_back(particle.lifeTime);
+
+    positionX.push_back(particle.position.x);
+    positionY.push_back(particle.position.y);
+    positionZ.push_back(particle.position.z);
+    speedX.push_back(particle.speed.x);
+    speedY.push_back(particle.speed.y);
+    speedZ.push_back(particle.speed.z);
+
+    angle.push_back(particle.angle);
+    spin.push_back(particle.spin);
+    currRadius.push_back(particle.currRadius);
+
+    baseSize.push_back(particle.baseSize);
+    currSize.push_back(particle.currSize);
+    color.push_back(particle.color);
+
+    frame.push_back(particle.frame);
+    animTime.push_back(particle.animTime);
+
+    currFlowSpeed.push_back(particle.currFlowSpeed);
+    currFlowOffset.push_back(particle.currFlowOffset);
+
+    baseNoiseScale.push_back(particle.baseNoiseScale);
+    currNoiseScale.push_back(particle.currNoiseScale);
+    baseNoiseUScrollSpeed.push_back(particle.baseNoiseUScrollSpeed);
+    currNoiseUOffset.push_back(particle.currNoiseUOffset);
+    baseNoiseVScrollSpeed.push_back(particle.baseNoiseVScrollSpeed);
+    currNoiseVOffset.push_back(particle.currNoiseVOffset);
+
+    alphaRemap.push_back(particle.alphaRemap);
+    positionTarget.push_back(particle.positionTarget);
+    randomIndex.push_back(particle.randomIndex);
+
+    return index;
+}
+
+void ParticleStorage::Remove(uint32 index)
+{
+    using ParticleStorageDetails::RemoveSwap;
+
+    DVASSERT(index < GetCount());
+
+    RemoveSwap(life, index);
+    RemoveSwap(lifeTime, index);
+
+    RemoveSwap(positionX, index);
+    RemoveSwap(positionY, index);
+    RemoveSwap(positionZ, index);
+    RemoveSwap(speedX, index);
+    RemoveSwap(speedY, index);
+    RemoveSwap(speedZ, index);
+
+    RemoveSwap(angle, index);
+    RemoveSwap(spin, index);
+    RemoveSwap(currRadius, index);
+
+    RemoveSwap(baseSize, index);
+    RemoveSwap(currSize, index);
+    RemoveSwap(color, index);
+
+    RemoveSwap(frame, index);
+    RemoveSwap(animTime, index);
+
+    RemoveSwap(currFlowSpeed, index);
+    RemoveSwap(currFlowOffset, index);
+
+    RemoveSwap(baseNoiseScale, index);
+    RemoveSwap(currNoiseScale, index);
+    RemoveSwap(baseNoiseUScrollSpeed, index);
+    RemoveSwap(currNoiseUOffset, index);
+    RemoveSwap(baseNoiseVScrollSpeed, index);
+    RemoveSwap(currNoiseVOffset, index);
+
+    RemoveSwap(alphaRemap, index);
+    RemoveSwap(positionTarget, index);
+    RemoveSwap(randomIndex, index);
+}
+
+void ParticleStorage::Clear()
+{
+    life.clear();
+    lifeTime.clear();
+
+    positionX.clear();
+    positionY.clear();
+    positionZ.clear();
+    speedX.clear();
+    speedY.clear();
+    speedZ.clear();
+
+    angle.clear();
+    spin.clear();
+    currRadius.clear();
+
+    baseSize.clear();
+    currSize.clear();
+    color.clear();
+
+    frame.clear();
+    animTime.clear();
+
+    currFlowSpeed.clear();
+    currFlowOffset.clear();
+
+    baseNoiseScale.clear();
+    currNoiseScale.clear();
+    baseNoiseUScrollSpeed.clear();
+    currNoiseUOffset.clear();
+    baseNoiseVScrollSpeed.clear();
+    currNoiseVOffset.clear();
+
+    alphaRemap.clear();
+    positionTarget.clear();
+    randomIndex.clear();
+}
+}
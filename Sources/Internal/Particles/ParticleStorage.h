@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Base/BaseMath.h"
+
+namespace DAVA
+{
+struct Particle;
+
+/**
+    Particles of a single `ParticleGroup` stored as structure of arrays.
+    Every per-particle value is kept in its own array (positions and speeds are split by components),
+    so simulation kernels (see `ParticleSimulation`) process several particles at once with SIMD.
+    Particles are unordered: removed particle is replaced by the last one.
+*/
+class ParticleStorage
+{
+public:
+    uint32 GetCount() const;
+    bool IsEmpty() const;
+
+    /** Append `particle` and return its index. */
+    uint32 Add(const Particle& particle);
+    /** Remove particle at `index` moving the last particle in its place. */
+    void Remove(uint32 index);
+    void Clear();
+
+    Vector3 GetPosition(uint32 index) const;
+    void SetPosition(uint32 index, const Vector3& position);
+    Vector3 GetSpeed(uint32 index) const;
+    void SetSpeed(uint32 index, const Vector3& speed);
+
+    Vector<float32> life;
+    Vector<float32> lifeTime;
+
+    Vector<float32> positionX;
+    Vector<float32> positionY;
+    Vector<float32> positionZ;
+    Vector<float32> speedX;
+    Vector<float32> speedY;
+    Vector<float32> speedZ;
+
+    Vector<float32> angle;
+    Vector<float32> spin;
+    Vector<float32> currRadius;
+
+    Vector<Vector2> baseSize;
+    Vector<Vector2> currSize;
+    Vector<Color> color;
+
+    Vector<int32> frame;
+    Vector<float32> animTime;
+
+    Vector<float32> currFlowSpeed;
+    Vector<float32> currFlowOffset;
+
+    Vector<float32> baseNoiseScale;
+    Vector<float32> currNoiseScale;
+    Vector<float32> baseNoiseUScrollSpeed;
+    Vector<float32> currNoiseUOffset;
+    Vector<float32> baseNoiseVScrollSpeed;
+    Vector<float32> currNoiseVOffset;
+
+    Vector<float32> alphaRemap;
+    Vector<int32> positionTarget;
+    Vector<uint32> randomIndex;
+};
+
+inline uint32 ParticleStorage::GetCount() const
+{
+    return static_cast<uint32>(life.size());
+}
+
+inline bool ParticleStorage::IsEmpty() const
+{
+    return life.empty();
+}
+
+inline Vector3 ParticleStorage::GetPosition(uint32 index) const
+{
+    return Vector3(positionX[index], positionY[index], positionZ[index]);
+}
+
+inline void ParticleStorage::SetPosition(uint32 index, const Vector3& position)
+{
+    positionX[index] = position.x;
+    positionY[index] = position.y;
+    positionZ[index] = position.z;
+}
+
+inline Vector3 ParticleStorage::GetSpeed(uint32 index) const
+{
+    return Vector3(speedX[index], speedY[index], speedZ[index]);
+}
+
+inline void ParticleStorage::SetSpeed(uint32 index, const Vector3& speed)
+{
+    speedX[index] = speed.x;
+    speedY[index] = speed.y;
+    speedZ[index] = speed.z;
+}
+}
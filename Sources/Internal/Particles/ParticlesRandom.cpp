@@ -1,4 +1,6 @@
 #include "Particles/ParticlesRandom.h"
+#include "Concurrency/Thread.h"
+#include "Debug/DVAssert.h"
 
 // https://blog.demofox.org/2017/05/29/when-random-numbers-are-too-random-low-discrepancy-sequences/
 
@@ -43,5 +45,24 @@ float32 VanDerCorputRnd(float32 min, float32 max, uint32 n, uint32 base)
 {
     return (max - min) * VanDerCorputRnd(n, base) + min;
 }
+
+namespace ParticlesRandomDetails
+{
+Generator seedGenerator;
+}
+
+void SetSeed(uint64 seed)
+{
+    DVASSERT(Thread::IsMainThread());
+    ParticlesRandomDetails::seedGenerator.Seed(seed);
+}
+
+uint64 MakeEffectSeed()
+{
+    DVASSERT(Thread::IsMainThread());
+    uint64 high = ParticlesRandomDetails::seedGenerator.Rand();
+    uint64 low = ParticlesRandomDetails::seedGenerator.Rand();
+    return (high << 32) | low;
+}
 }
 }
\ No newline at end of file
@@ -10,5 +10,51 @@ float32 HammersleyRnd(uint32 n);
 float32 HammersleyRnd(float32 min, float32 max, uint32 n);
 float32 VanDerCorputRnd(uint32 n, uint32 base);
 float32 VanDerCorputRnd(float32 min, float32 max, uint32 n, uint32 base);
+
+/**
+    Small and fast pseudo-random generator (splitmix64).
+    Every particle effect owns one, so effects are simulated independently of each other and of update order.
+*/
+class Generator
+{
+public:
+    explicit Generator(uint64 seed = 0);
+    void Seed(uint64 seed);
+
+    uint32 Rand();
+    /** Return value in [0, 1). */
+    float32 RandFloat();
+
+private:
+    uint64 state = 0;
+};
+
+/** Set seed effect generators are seeded from, particles simulation is deterministic for the same seed. */
+void SetSeed(uint64 seed);
+/** Return seed for generator of just started effect. Should be called from the main thread only. */
+uint64 MakeEffectSeed();
+
+inline Generator::Generator(uint64 seed)
+    : state(seed)
+{
+}
+
+inline void Generator::Seed(uint64 seed)
+{
+    state = seed;
+}
+
+inline uint32 Generator::Rand()
+{
+    uint64 z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return static_cast<uint32>((z ^ (z >> 31)) >> 32);
+}
+
+inline float32 Generator::RandFloat()
+{
+    return static_cast<float32>(Rand() >> 8) * (1.0f / 16777216.0f);
+}
 }
 }
@@ -0,0 +1,117 @@
+#include "UnitTests/UnitTests.h"
+
+#include "Particles/ParticlePropertyLine.h"
+
+DAVA_TESTCLASS (ParticlePropertyLineTest)
+{
+    DAVA::RefPtr<DAVA::PropertyLineKeyframes<DAVA::float32>> MakeKeyframes()
+    {
+        using namespace DAVA;
+
+        RefPtr<PropertyLineKeyframes<float32>> line(new PropertyLineKeyframes<float32>());
+        line->AddValue(0.1f, 1.f);
+        line->AddValue(0.3f, 4.f);
+        line->AddValue(0.35f, -2.f);
+        line->AddValue(0.9f, 0.5f);
+        return line;
+    }
+
+    DAVA_TEST (BakedKeysMatchGetValue)
+    {
+        using namespace DAVA;
+
+        RefPtr<PropertyLineKeyframes<float32>> line = MakeKeyframes();
+        TEST_VERIFY(!line->IsBaked());
+        TEST_VERIFY(line->Sample(0.2f) == line->GetValue(0.2f));
+
+        line->Bake(0);
+        TEST_VERIFY(line->IsBaked());
+        TEST_VERIFY(line->GetBakedResolution() == 0);
+
+        bool allEqual = true;
+        for (float32 t = -0.5f; t < 1.5f; t += 0.0137f)
+        {
+            allEqual &= (line->GetBakedValue(t) == line->GetValue(t));
+        }
+        TEST_VERIFY(allEqual);
+    }
+
+    DAVA_TEST (LookupTableApproximatesLine)
+    {
+        using namespace DAVA;
+
+        RefPtr<PropertyLineKeyframes<float32>> line = MakeKeyframes();
+        line->Bake(256);
+        TEST_VERIFY(line->GetBakedResolution() == 256);
+
+        // table step is (0.9 - 0.1) / 255, the steepest segment changes by 120 per unit
+        const float32 epsilon = 120.f * 0.8f / 255.f;
+        bool allClose = true;
+        for (float32 t = -0.5f; t < 1.5f; t += 0.0137f)
+        {
+            allClose &= (std::abs(line->GetBakedValue(t) - line->GetValue(t)) <= epsilon);
+        }
+        TEST_VERIFY(allClose);
+        TEST_VERIFY(line->GetBakedValue(0.f) == 1.f);
+        TEST_VERIFY(line->GetBakedValue(1.f) == 0.5f);
+
+        RefPtr<PropertyLine<float32>> value(new PropertyLineValue<float32>(3.f));
+        value->Bake(256);
+        TEST_VERIFY(value->GetBakedValue(0.f) == 3.f);
+        TEST_VERIFY(value->GetBakedValue(10.f) == 3.f);
+    }
+
+    DAVA_TEST (ModifiableLineIsRebakedWithModifier)
+    {
+        using namespace DAVA;
+
+        RefPtr<PropertyLineKeyframes<float32>> modification(new PropertyLineKeyframes<float32>());
+        modification->AddValue(0.f, 1.f);
+        modification->AddValue(1.f, 3.f);
+
+        RefPtr<ModifiablePropertyLine<float32>> line(new ModifiablePropertyLine<float32>("variable"));
+        line->SetValueLine(RefPtr<PropertyLine<float32>>(MakeKeyframes()));
+        line->SetModificationLine(modification);
+        line->SetModifier(0.f);
+        line->Bake(0);
+        TEST_VERIFY(FLOAT_EQUAL(line->GetBakedValue(0.2f), line->GetValue(0.2f)));
+
+        line->SetModifier(0.5f);
+        TEST_VERIFY(line->GetBakedResolution() == 0);
+        TEST_VERIFY(FLOAT_EQUAL(line->GetBakedValue(0.2f), line->GetValue(0.2f)));
+        TEST_VERIFY(FLOAT_EQUAL(line->GetBakedValue(0.2f), 2.f * 2.5f));
+    }
+
+    DAVA_TEST (EditedKeysOutdateBakedTable)
+    {
+        using namespace DAVA;
+
+        RefPtr<PropertyLineKeyframes<float32>> line = MakeKeyframes();
+        TEST_VERIFY(line->IsBakeOutdated());
+        line->Bake(0);
+        TEST_VERIFY(!line->IsBakeOutdated());
+
+        // keys changed in place are found by comparison with keys table is baked from
+        line->GetValues()[1].value = 8.f;
+        TEST_VERIFY(line->IsBakeOutdated());
+        line->Bake(0);
+        TEST_VERIFY(!line->IsBakeOutdated());
+        TEST_VERIFY(line->GetBakedValue(0.3f) == 8.f);
+
+        // added key rebakes line right away
+        line->AddValue(1.f, 5.f);
+        TEST_VERIFY(!line->IsBakeOutdated());
+        TEST_VERIFY(line->GetBakedResolution() == 0);
+        TEST_VERIFY(line->GetBakedValue(1.f) == 5.f);
+
+        // keys of value line of modifiable line
+        RefPtr<PropertyLineKeyframes<float32>> valueLine = MakeKeyframes();
+        RefPtr<ModifiablePropertyLine<float32>> modifiable(new ModifiablePropertyLine<float32>("variable"));
+        modifiable->SetValueLine(RefPtr<PropertyLine<float32>>(valueLine));
+        modifiable->SetModifier(0.f);
+        modifiable->Bake(0);
+        TEST_VERIFY(!modifiable->IsBakeOutdated());
+        valueLine->GetValues()[0].t = 0.05f;
+        TEST_VERIFY(modifiable->IsBakeOutdated());
+    }
+};
@@ -0,0 +1,147 @@
+#include "UnitTests/UnitTests.h"
+
+#include "Engine/Engine.h"
+#include "Math/AABBox3.h"
+#include "Particles/Particle.h"
+#include "Particles/ParticleSimulation.h"
+#include "Particles/ParticleStorage.h"
+#include "Utils/Random.h"
+
+DAVA_TESTCLASS (ParticleSimulationTest)
+{
+    DAVA::Vector<DAVA::Particle> MakeRandomParticles(DAVA::uint32 count)
+    {
+        using namespace DAVA;
+
+        Random* random = GetEngineContext()->random;
+
+        Vector<Particle> result(count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            Particle& p = result[i];
+            p.lifeTime = random->RandFloat32InBounds(0.5f, 2.f);
+            p.life = random->RandFloat32InBounds(0.f, p.lifeTime);
+            p.position = Vector3(random->RandFloat32InBounds(-10.f, 10.f), random->RandFloat32InBounds(-10.f, 10.f), random->RandFloat32InBounds(-10.f, 10.f));
+            p.speed = Vector3(random->RandFloat32InBounds(-1.f, 1.f), random->RandFloat32InBounds(-1.f, 1.f), random->RandFloat32InBounds(-1.f, 1.f));
+            p.angle = random->RandFloat32InBounds(0.f, PI_2);
+            p.spin = random->RandFloat32InBounds(-1.f, 1.f);
+            p.currRadius = random->RandFloat32InBounds(0.f, 0.5f);
+            p.randomIndex = i;
+        }
+        return result;
+    }
+
+    DAVA_TEST (KernelsMatchScalarCode)
+    {
+        using namespace DAVA;
+
+        const float32 dt = 0.016f;
+
+        // counts not multiple of SIMD width check tail handling
+        for (uint32 count : { 0, 1, 3, 4, 7, 33 })
+        {
+            Vector<Particle> expected = MakeRandomParticles(count);
+
+            ParticleStorage particles;
+            for (const Particle& p : expected)
+            {
+                particles.Add(p);
+            }
+
+            Vector<float32> timeScale(count);
+            Vector<float32> spinScale(count);
+            Vector<float32> forceScale(count);
+            for (uint32 i = 0; i < count; ++i)
+            {
+                timeScale[i] = (0.5f + i * 0.1f) * dt;
+                spinScale[i] = 1.f - i * 0.01f;
+                forceScale[i] = i * 0.2f;
+            }
+
+            Vector3 force0(0.f, 0.f, -9.8f);
+            Vector3 force1(1.f, 0.5f, 0.f);
+            Vector<float32> accelerationX(count, 0.f), accelerationY(count, 0.f), accelerationZ(count, 0.f);
+
+            ParticleSimulation::AdvanceLife(particles, dt);
+            ParticleSimulation::IntegratePositions(particles, timeScale.data());
+            ParticleSimulation::IntegrateAngles(particles, spinScale.data(), dt);
+            ParticleSimulation::AccumulateForce(accelerationX.data(), accelerationY.data(), accelerationZ.data(), count, force0);
+            ParticleSimulation::AccumulateForce(accelerationX.data(), accelerationY.data(), accelerationZ.data(), count, force1, forceScale.data());
+            ParticleSimulation::ApplyAcceleration(particles, accelerationX.data(), accelerationY.data(), accelerationZ.data(), dt);
+
+            Vector<float32> overLife(count);
+            ParticleSimulation::CalculateOverLife(particles, overLife.data());
+
+            AABBox3 bbox;
+            AABBox3 expectedBBox;
+            Vector3 offset(1.f, 2.f, 3.f);
+            ParticleSimulation::AddParticlesToBBox(particles, offset, bbox);
+
+            bool allEqual = true;
+            for (uint32 i = 0; i < count; ++i)
+            {
+                Particle& p = expected[i];
+                p.life += dt;
+                p.position += p.speed * timeScale[i];
+                p.angle += p.spin * spinScale[i] * dt;
+
+                Vector3 acceleration(0.f, 0.f, 0.f);
+                acceleration += force0;
+                acceleration += force1 * forceScale[i];
+                p.speed += acceleration * dt;
+
+                Vector3 radius(p.currRadius, p.currRadius, p.currRadius);
+                expectedBBox.AddPoint(p.position + offset - radius);
+                expectedBBox.AddPoint(p.position + offset + radius);
+
+                allEqual &= (particles.life[i] == p.life);
+                allEqual &= (overLife[i] == p.life / p.lifeTime);
+                allEqual &= (particles.GetPosition(i) == p.position);
+                allEqual &= (particles.GetSpeed(i) == p.speed);
+                allEqual &= (particles.angle[i] == p.angle);
+            }
+            TEST_VERIFY(allEqual);
+            TEST_VERIFY(bbox.min == expectedBBox.min);
+            TEST_VERIFY(bbox.max == expectedBBox.max);
+        }
+    }
+
+    DAVA_TEST (RemoveDeadParticles)
+    {
+        using namespace DAVA;
+
+        Vector<Particle> source = MakeRandomParticles(50);
+        ParticleStorage particles;
+        uint32 aliveCount = 0;
+        for (uint32 i = 0; i < 50; ++i)
+        {
+            if (i % 3 == 0)
+                source[i].life = source[i].lifeTime;
+            else
+                ++aliveCount;
+            particles.Add(source[i]);
+        }
+
+        ParticleSimulation::RemoveDeadParticles(particles);
+        TEST_VERIFY(particles.GetCount() == aliveCount);
+
+        // every remaining particle keeps all its values after being moved
+        bool allAlive = true;
+        bool allConsistent = true;
+        for (uint32 i = 0; i < particles.GetCount(); ++i)
+        {
+            const Particle& p = source[particles.randomIndex[i]];
+            allAlive &= (particles.randomIndex[i] % 3 != 0);
+            allConsistent &= (particles.life[i] == p.life);
+            allConsistent &= (particles.lifeTime[i] == p.lifeTime);
+            allConsistent &= (particles.GetPosition(i) == p.position);
+            allConsistent &= (particles.GetSpeed(i) == p.speed);
+            allConsistent &= (particles.currRadius[i] == p.currRadius);
+        }
+        TEST_VERIFY(allAlive);
+        TEST_VERIFY(allConsistent);
+
+        particles.Clear();
+        TEST_VERIFY(particles.IsEmpty());
+    }
+};
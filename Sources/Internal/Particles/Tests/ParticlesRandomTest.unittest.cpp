@@ -0,0 +1,50 @@
+#include "UnitTests/UnitTests.h"
+
+#include "Particles/ParticlesRandom.h"
+
+DAVA_TESTCLASS (ParticlesRandomTest)
+{
+    DAVA_TEST (GeneratorIsDeterministic)
+    {
+        using namespace DAVA;
+
+        ParticlesRandom::Generator first(42);
+        ParticlesRandom::Generator second(42);
+        ParticlesRandom::Generator other(43);
+
+        bool allEqual = true;
+        bool anyDifferent = false;
+        bool allInRange = true;
+        for (uint32 i = 0; i < 1000; ++i)
+        {
+            uint32 value = first.Rand();
+            allEqual &= (value == second.Rand());
+            anyDifferent |= (value != other.Rand());
+
+            float32 f = first.RandFloat();
+            second.RandFloat();
+            allInRange &= (f >= 0.f && f < 1.f);
+        }
+        TEST_VERIFY(allEqual);
+        TEST_VERIFY(anyDifferent);
+        TEST_VERIFY(allInRange);
+
+        first.Seed(7);
+        second.Seed(7);
+        TEST_VERIFY(first.Rand() == second.Rand());
+    }
+
+    DAVA_TEST (EffectSeedsRepeatAfterSetSeed)
+    {
+        using namespace DAVA;
+
+        ParticlesRandom::SetSeed(123);
+        uint64 seed0 = ParticlesRandom::MakeEffectSeed();
+        uint64 seed1 = ParticlesRandom::MakeEffectSeed();
+        TEST_VERIFY(seed0 != seed1);
+
+        ParticlesRandom::SetSeed(123);
+        TEST_VERIFY(ParticlesRandom::MakeEffectSeed() == seed0);
+        TEST_VERIFY(ParticlesRandom::MakeEffectSeed() == seed1);
+    }
+};
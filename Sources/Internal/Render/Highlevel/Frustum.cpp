@@ -1,6 +1,7 @@
 #include "Render/RenderHelper.h"
 #include "Render/Highlevel/Frustum.h"
 #include <Render/2D/Systems/RenderSystem2D.h>
+#include "Math/SSE/SSEMath.h"
 
 namespace DAVA
 {
@@ -332,6 +333,95 @@ bool Frustum::IsInside(const AABBox3& box, uint8 planeMask, uint8& startClipping
     return true;
 }
 
+uint32 Frustum::GetOutsidePlanes(const AABBox3Block& block, uint8 planeMask, uint8* outsidePlanes) const
+{
+    const float32* verts[2][3] = { { block.minX, block.minY, block.minZ }, { block.maxX, block.maxY, block.maxZ } };
+    uint32 anyOutside = 0;
+
+    for (uint32 i = 0; i < AABBox3Block::SIZE; ++i)
+    {
+        outsidePlanes[i] = 0;
+    }
+
+    uint8 k;
+    const Plane* plane;
+    uint32 currPlaneAccess;
+    for (plane = planeArray, k = 1, currPlaneAccess = planeAccesBits; k <= planeMask; ++plane, k += k, currPlaneAccess >>= 3)
+    {
+        if ((k & planeMask) == 0)
+            continue;
+
+        // the same vertex selection and the same order of operations as in Plane::DistanceToPoint
+        const float32* px = verts[currPlaneAccess & 1][0];
+        const float32* py = verts[(currPlaneAccess >> 1) & 1][1];
+        const float32* pz = verts[(currPlaneAccess >> 2) & 1][2];
+
+        uint32 outside = 0;
+#if defined(__DAVAENGINE_AVX__)
+        __m256 dist = _mm256_mul_ps(_mm256_set1_ps(plane->n.x), _mm256_loadu_ps(px));
+        dist = _mm256_add_ps(dist, _mm256_mul_ps(_mm256_set1_ps(plane->n.y), _mm256_loadu_ps(py)));
+        dist = _mm256_add_ps(dist, _mm256_mul_ps(_mm256_set1_ps(plane->n.z), _mm256_loadu_ps(pz)));
+        dist = _mm256_add_ps(dist, _mm256_set1_ps(plane->d));
+        outside = static_cast<uint32>(_mm256_movemask_ps(_mm256_cmp_ps(dist, _mm256_setzero_ps(), _CMP_GT_OQ)));
+#elif defined(__DAVAENGINE_SSE2__)
+        __m128 nx = _mm_set1_ps(plane->n.x);
+        __m128 ny = _mm_set1_ps(plane->n.y);
+        __m128 nz = _mm_set1_ps(plane->n.z);
+        __m128 d = _mm_set1_ps(plane->d);
+        for (uint32 half = 0; half < AABBox3Block::SIZE; half += 4)
+        {
+            __m128 dist = _mm_mul_ps(nx, _mm_loadu_ps(px + half));
+            dist = _mm_add_ps(dist, _mm_mul_ps(ny, _mm_loadu_ps(py + half)));
+            dist = _mm_add_ps(dist, _mm_mul_ps(nz, _mm_loadu_ps(pz + half)));
+            dist = _mm_add_ps(dist, d);
+            outside |= static_cast<uint32>(_mm_movemask_ps(_mm_cmpgt_ps(dist, _mm_setzero_ps()))) << half;
+        }
+#else
+        for (uint32 i = 0; i < AABBox3Block::SIZE; ++i)
+        {
+            if (plane->DistanceToPoint(px[i], py[i], pz[i]) > 0.0f)
+                outside |= 1u << i;
+        }
+#endif
+
+        anyOutside |= outside;
+        for (uint32 i = 0; outside != 0; ++i, outside >>= 1)
+        {
+            if (outside & 1)
+                outsidePlanes[i] |= k;
+        }
+    }
+
+    return anyOutside;
+}
+
+uint32 Frustum::IsInside(const AABBox3Block& block, uint32 count, uint8 planeMask, uint8* startClippingPlanes) const
+{
+    DVASSERT(count <= AABBox3Block::SIZE);
+
+    uint8 outsidePlanes[AABBox3Block::SIZE];
+    uint32 countMask = (1u << count) - 1;
+    uint32 insideMask = ~GetOutsidePlanes(block, planeMask, outsidePlanes) & countMask;
+
+    if (insideMask != countMask)
+    {
+        for (uint32 i = 0; i < count; ++i)
+        {
+            uint8 outside = outsidePlanes[i];
+            if (outside != 0 && (outside & (1 << startClippingPlanes[i])) == 0)
+            {
+                // box is not rejected by preffered plane - lowest rejecting plane becomes preffered, as in scalar version
+                uint8 plane = 0;
+                while ((outside & (1 << plane)) == 0)
+                    ++plane;
+                startClippingPlanes[i] = plane;
+            }
+        }
+    }
+
+    return insideMask;
+}
+
 //! \brief check bounding sphere visibility against frustum
 //! \param point sphere center point
 //! \param radius sphere radius
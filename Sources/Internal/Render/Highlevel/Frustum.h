@@ -18,6 +18,25 @@ namespace DAVA
     The answer is simple: I assume that culling code can differ for OGL, DX matrices. Let's see when we'll add DirectX am I right.  
 */
 class RenderHelper;
+
+/**
+    \brief Block of bounding boxes stored in SoA layout, used for batched frustum tests.
+ */
+struct AABBox3Block
+{
+    static const uint32 SIZE = 8;
+
+    float32 minX[SIZE];
+    float32 minY[SIZE];
+    float32 minZ[SIZE];
+    float32 maxX[SIZE];
+    float32 maxY[SIZE];
+    float32 maxZ[SIZE];
+
+    inline void Set(uint32 index, const AABBox3& box);
+    inline void Copy(uint32 index, const AABBox3Block& src, uint32 srcIndex);
+};
+
 class Frustum : public BaseObject
 {
 public:
@@ -62,6 +81,11 @@ public:
     // unlike Classify this function do not modify plane masking as, though still modify startClippingPlane
     bool IsInside(const AABBox3& box, uint8 planeMask, uint8& startClippingPlane) const;
 
+    //! \brief Check visibility of first `count` boxes from block with plane mask and preffered planes
+    //! \param startClippingPlanes array of `count` preffered planes, modified for each box in the same way as in IsInside above
+    //! \return bit mask of boxes which are inside
+    uint32 IsInside(const AABBox3Block& block, uint32 count, uint8 planeMask, uint8* startClippingPlanes) const;
+
     //! \brief Check axial aligned bounding box visibility
     //! \param box bounding box
     bool IsFullyInside(const AABBox3& box) const;
@@ -109,10 +133,34 @@ public:
     void DebugDraw(RenderHelper* drawer);
 
 private:
+    uint32 GetOutsidePlanes(const AABBox3Block& block, uint8 planeMask, uint8* outsidePlanes) const;
+
     int32 planeCount = 0;
     uint32 planeAccesBits = 0;
     Plane planeArray[6];
 };
+
+inline void AABBox3Block::Set(uint32 index, const AABBox3& box)
+{
+    DVASSERT(index < SIZE);
+    minX[index] = box.min.x;
+    minY[index] = box.min.y;
+    minZ[index] = box.min.z;
+    maxX[index] = box.max.x;
+    maxY[index] = box.max.y;
+    maxZ[index] = box.max.z;
+}
+
+inline void AABBox3Block::Copy(uint32 index, const AABBox3Block& src, uint32 srcIndex)
+{
+    DVASSERT(index < SIZE && srcIndex < SIZE);
+    minX[index] = src.minX[srcIndex];
+    minY[index] = src.minY[srcIndex];
+    minZ[index] = src.minZ[srcIndex];
+    maxX[index] = src.maxX[srcIndex];
+    maxY[index] = src.maxY[srcIndex];
+    maxZ[index] = src.maxZ[srcIndex];
+}
 };
 
 #endif // __DAVAENGINE_FRUSTUM_H__
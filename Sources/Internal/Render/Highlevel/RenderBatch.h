@@ -61,7 +61,7 @@ public:
 
     void UpdateAABBoxFromSource();
 
-    pointer_size layerSortingKey;
+    uint64 layerSortingKey = 0;
 
     rhi::HVertexBuffer vertexBuffer;
     rhi::HVertexBuffer instanceBuffer;
@@ -4,6 +4,27 @@
 
 namespace DAVA
 {
+namespace RenderBatchArrayDetails
+{
+// arrays smaller than this are sorted with insertion sort only
+const uint32 MIN_RADIX_SORT_SIZE = 64;
+// insertion sort on previous order gives up after (count * MAX_COHERENT_MOVES_FACTOR) moves
+const uint32 MAX_COHERENT_MOVES_FACTOR = 4;
+
+// keys are sorted in ascending order, batches with larger 'natural' key should be drawn first
+inline uint64 MakeSortKey(uint64 key)
+{
+    return ~key;
+}
+
+inline uint32 GetGeometryKey(RenderBatch* batch)
+{
+    PolygonGroup* polygonGroup = batch->GetPolygonGroup();
+    rhi::Handle vertexBuffer = (polygonGroup != nullptr) ? polygonGroup->vertexBuffer : batch->vertexBuffer;
+    return static_cast<uint32>(vertexBuffer) & 0xFFFF;
+}
+}
+
 RenderBatchArray::RenderBatchArray()
     : sortFlags(0)
 {
@@ -11,37 +32,39 @@ RenderBatchArray::RenderBatchArray()
     //renderBatchArray.reserve(4096);
 }
 
-bool RenderBatchArray::MaterialCompareFunction(const RenderBatch* a, const RenderBatch* b)
-{
-    return a->layerSortingKey > b->layerSortingKey;
-}
-
 void RenderBatchArray::Sort(Camera* camera)
 {
+    using namespace RenderBatchArrayDetails;
+
     // Need sort
     sortFlags |= SORT_REQUIRED;
 
     if ((sortFlags & SORT_THIS_FRAME) == SORT_THIS_FRAME)
     {
+        uint32 count = GetRenderBatchCount();
+        sortEntries.resize(count);
+
         if (sortFlags & SORT_BY_MATERIAL)
         {
-            //Vector3 cameraPosition = camera->GetPosition();
+            Vector3 cameraPosition = camera->GetPosition();
 
-            for (RenderBatch* batch : renderBatchArray)
+            for (uint32 i = 0; i < count; ++i)
             {
-                //pointer_size renderObjectId = (pointer_size)batch->GetRenderObject();
-                //RenderObject * renderObject = batch->GetRenderObject();
-                //Vector3 position = renderObject->GetWorldBoundingBox().GetCenter();
-                //float32 distance = (position - cameraPosition).Length();
-                //uint32 distanceBits = (0xFFFF - ((uint32)distance) & 0xFFFF);
+                RenderBatch* batch = renderBatchArray[i];
                 uint32 materialIndex = batch->GetMaterial()->GetSortingKey();
-                //VI: sorting key has the following layout: (m:8)(s:4)(d:20)
-                //batch->layerSortingKey = (pointer_size)((materialIndex << 20) | (batch->GetSortingKey() << 28) | (distanceBits));
-                batch->layerSortingKey = static_cast<pointer_size>((materialIndex & 0x0FFFFFFF) | (batch->GetSortingKey() << 28));
-                //batch->layerSortingKey = (pointer_size)((batch->GetMaterial()->GetSortingKey() << 20) | (batch->GetSortingKey() << 28) | (renderObjectId & 0x000FFFFF));
+                Vector3 position = batch->GetRenderObject()->GetWorldBoundingBox().GetCenter();
+                uint32 distance = Min(static_cast<uint32>((position - cameraPosition).Length()), 0xFFFFu);
+
+                //sorting key has the following layout: (s:4)(m:28)(d:16)(g:16), closer batches first inside material
+                uint64 key = (static_cast<uint64>((materialIndex & 0x0FFFFFFF) | (batch->GetSortingKey() << 28)) << 32);
+                key |= static_cast<uint64>(0xFFFF - distance) << 16;
+                key |= GetGeometryKey(batch);
+
+                batch->layerSortingKey = key;
+                sortEntries[i] = { MakeSortKey(key), i };
             }
 
-            std::sort(renderBatchArray.begin(), renderBatchArray.end(), MaterialCompareFunction);
+            SortEntries();
 
             sortFlags &= ~SORT_REQUIRED;
         }
@@ -50,15 +73,19 @@ void RenderBatchArray::Sort(Camera* camera)
             Vector3 cameraPosition = camera->GetPosition();
             Vector3 cameraDirection = camera->GetDirection();
 
-            for (RenderBatch* batch : renderBatchArray)
+            for (uint32 i = 0; i < count; ++i)
             {
+                RenderBatch* batch = renderBatchArray[i];
                 Vector3 delta = batch->GetRenderObject()->GetWorldTransformPtr()->GetTranslationVector() - cameraPosition;
                 uint32 distance = delta.DotProduct(cameraDirection) < 0 ? 0 : (static_cast<uint32>(delta.Length() * 1000.0f)); //x1000.0f is to prevent resorting of nearby objects (still 26 km range)
                 distance = distance + 31 - batch->GetSortingOffset();
-                batch->layerSortingKey = (distance & 0x0fffffff) | (batch->GetSortingKey() << 28);
+
+                uint64 key = static_cast<uint64>((distance & 0x0fffffff) | (batch->GetSortingKey() << 28)) << 32;
+                batch->layerSortingKey = key;
+                sortEntries[i] = { MakeSortKey(key), i };
             }
 
-            std::stable_sort(renderBatchArray.begin(), renderBatchArray.end(), MaterialCompareFunction);
+            SortEntries();
 
             sortFlags |= SORT_REQUIRED;
         }
@@ -66,20 +93,71 @@ void RenderBatchArray::Sort(Camera* camera)
         {
             Vector3 cameraPosition = camera->GetPosition();
 
-            for (RenderBatch* batch : renderBatchArray)
+            for (uint32 i = 0; i < count; ++i)
             {
+                RenderBatch* batch = renderBatchArray[i];
                 RenderObject* renderObject = batch->GetRenderObject();
                 Vector3 position = renderObject->GetWorldBoundingBox().GetCenter();
                 uint32 distance = static_cast<uint32>((position - cameraPosition).Length() * 100.0f) + 31 - batch->GetSortingOffset();
                 uint32 distanceBits = 0x0fffffff - distance & 0x0fffffff;
 
-                batch->layerSortingKey = distanceBits | (batch->GetSortingKey() << 28);
+                uint64 key = static_cast<uint64>(distanceBits | (batch->GetSortingKey() << 28)) << 32;
+                batch->layerSortingKey = key;
+                sortEntries[i] = { MakeSortKey(key), i };
             }
 
-            std::sort(renderBatchArray.begin(), renderBatchArray.end(), MaterialCompareFunction);
+            SortEntries();
 
             sortFlags |= SORT_REQUIRED;
         }
     }
 }
+
+void RenderBatchArray::SortEntries()
+{
+    using namespace RenderBatchArrayDetails;
+
+    uint32 count = static_cast<uint32>(sortEntries.size());
+    sortTemp.resize(count);
+
+    bool sorted = false;
+    if (count < MIN_RADIX_SORT_SIZE)
+    {
+        sorted = InsertionSortEntries(sortEntries.data(), count, std::numeric_limits<uint32>::max());
+    }
+    else if (prevBatches == renderBatchArray)
+    {
+        // the same batches as on previous sort: start from previous order, keys are probably changed a little
+        for (uint32 i = 0; i < count; ++i)
+        {
+            sortTemp[i] = sortEntries[prevOrder[i]];
+        }
+        sortEntries.swap(sortTemp);
+        sorted = InsertionSortEntries(sortEntries.data(), count, count * MAX_COHERENT_MOVES_FACTOR);
+        if (!sorted)
+        {
+            // radix sort keeps order of equal keys, restore index order for it to match other paths
+            for (const RadixSortEntry& entry : sortEntries)
+            {
+                sortTemp[entry.value] = entry;
+            }
+            sortEntries.swap(sortTemp);
+        }
+    }
+
+    if (!sorted)
+    {
+        RadixSortEntries(sortEntries.data(), sortTemp.data(), count);
+    }
+
+    prevBatches.swap(renderBatchArray);
+    prevOrder.resize(count);
+    renderBatchArray.resize(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        uint32 index = sortEntries[i].value;
+        prevOrder[i] = index;
+        renderBatchArray[i] = prevBatches[index];
+    }
+}
 };
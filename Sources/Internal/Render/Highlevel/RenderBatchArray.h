@@ -2,6 +2,7 @@
 
 #include "Base/BaseTypes.h"
 #include "Base/FastName.h"
+#include "Base/Radix/Radix.h"
 #include "Reflection/Reflection.h"
 #include "Render/Highlevel/RenderBatch.h"
 
@@ -26,16 +27,31 @@ public:
 
     inline void Clear();
     inline void AddRenderBatch(RenderBatch* batch);
+    inline void AddRenderBatches(const Vector<RenderBatch*>& batches);
     inline uint32 GetRenderBatchCount() const;
     inline RenderBatch* Get(uint32 index) const;
 
+    /**
+        Sort batches according to sorting flags.
+
+        Every batch gets 64-bit key (sorting key | material | depth | geometry for material sorting,
+        sorting key | distance for distance sorting), then (key, index) pairs are sorted with radix sort.
+        If array contains the same batches in the same order as on previous sort, previous order is used
+        as a starting point and insertion sort is tried first, as keys usually change a little between frames.
+    */
     void Sort(Camera* camera);
     inline void SetSortingFlags(uint32 flags);
 
 private:
+    void SortEntries();
+
     Vector<RenderBatch*> renderBatchArray;
     uint32 sortFlags;
-    static bool MaterialCompareFunction(const RenderBatch* a, const RenderBatch* b);
+
+    Vector<RadixSortEntry> sortEntries;
+    Vector<RadixSortEntry> sortTemp;
+    Vector<RenderBatch*> prevBatches; // batches in the order they were added before previous sort
+    Vector<uint32> prevOrder; // sorted order of `prevBatches`
 };
 
 inline void RenderBatchArray::Clear()
@@ -48,6 +64,11 @@ inline void RenderBatchArray::AddRenderBatch(RenderBatch* batch)
     renderBatchArray.push_back(batch);
 }
 
+inline void RenderBatchArray::AddRenderBatches(const Vector<RenderBatch*>& batches)
+{
+    renderBatchArray.insert(renderBatchArray.end(), batches.begin(), batches.end());
+}
+
 inline void RenderBatchArray::SetSortingFlags(uint32 _flags)
 {
     sortFlags = _flags;
@@ -7,6 +7,14 @@
 
 namespace DAVA
 {
+void RenderHierarchy::ClipMultiple(const Vector<ClipRequest>& requests)
+{
+    for (const ClipRequest& request : requests)
+    {
+        Clip(request.camera, *request.visibilityArray, request.visibilityCriteria);
+    }
+}
+
 void LinearRenderHierarchy::AddRenderObject(RenderObject* object)
 {
     renderObjectArray.push_back(object);
@@ -25,6 +25,13 @@ public:
 class RenderHierarchy
 {
 public:
+    struct ClipRequest
+    {
+        Camera* camera = nullptr;
+        uint32 visibilityCriteria = 0;
+        Vector<RenderObject*>* visibilityArray = nullptr;
+    };
+
     virtual ~RenderHierarchy()
     {
     }
@@ -34,6 +41,13 @@ public:
     virtual void ObjectUpdated(RenderObject* renderObject) = 0;
     virtual void Clip(Camera* camera, Vector<RenderObject*>& visibilityArray, uint32 visibilityCriteria) = 0;
 
+    /**
+        Clip objects for several cameras at once, visible objects are appended to `visibilityArray` of each request.
+        Result for every request is the same as for separate `Clip` call, regardless of how requests are processed.
+        Default implementation processes requests one by one, hierarchies may process them concurrently.
+    */
+    virtual void ClipMultiple(const Vector<ClipRequest>& requests);
+
     virtual void GetAllObjectsInBBox(const AABBox3& bbox, Vector<RenderObject*>& visibilityArray) = 0;
     virtual bool RayTrace(const Ray3& ray, RayTraceCollision& collision,
                           const Vector<RenderObject*>& ignoreObjects) = 0;
@@ -5,6 +5,7 @@
 #include "Render/Highlevel/RenderPassNames.h"
 #include "Render/Highlevel/ShadowVolumeRenderLayer.h"
 #include "Render/ShaderCache.h"
+#include "Job/ParallelFor.h"
 
 #include "Debug/ProfilerCPU.h"
 #include "Debug/ProfilerMarkerNames.h"
@@ -20,6 +21,8 @@
 #include "Debug/ProfilerGPU.h"
 #include "Debug/ProfilerMarkerNames.h"
 
+#include <atomic>
+
 namespace DAVA
 {
 RenderPass::RenderPass(const FastName& _name)
@@ -127,30 +130,136 @@ void RenderPass::PrepareVisibilityArrays(Camera* camera, RenderSystem* renderSys
     PrepareLayersArrays(visibilityArray, camera);
 }
 
-void RenderPass::PrepareLayersArrays(const Vector<RenderObject*> objectsArray, Camera* camera)
+void RenderPass::PrepareLayersArrays(const Vector<RenderObject*>& objectsArray, Camera* camera)
 {
-    size_t size = objectsArray.size();
-    for (size_t ro = 0; ro < size; ++ro)
+    // custom preparation can change render batches of object, so it is done on the calling thread before collection
+    for (RenderObject* renderObject : objectsArray)
     {
-        RenderObject* renderObject = objectsArray[ro];
         if (renderObject->GetFlags() & RenderObject::CUSTOM_PREPARE_TO_RENDER)
         {
             renderObject->PrepareToRender(camera);
         }
+    }
 
-        uint32 batchCount = renderObject->GetActiveRenderBatchCount();
-        for (uint32 batchIndex = 0; batchIndex < batchCount; ++batchIndex)
+    uint32 objectsCount = static_cast<uint32>(objectsArray.size());
+    uint32 chunksCount = (objectsCount + LAYERS_CHUNK_SIZE - 1) / LAYERS_CHUNK_SIZE;
+    if (layersChunks.size() < chunksCount)
+    {
+        layersChunks.resize(chunksCount);
+    }
+
+    // materials are shared between objects, so materials which require rebuild for this pass
+    // are found concurrently, but rebuilt on the calling thread. After that they are only read.
+    ParallelFor(0, objectsCount, LAYERS_CHUNK_SIZE, [&](uint32 begin, uint32 end) {
+        LayersChunk& chunk = layersChunks[begin / LAYERS_CHUNK_SIZE];
+        chunk.materialsToPreBuild.clear();
+        for (uint32 ro = begin; ro < end; ++ro)
         {
-            RenderBatch* batch = renderObject->GetActiveRenderBatch(batchIndex);
+            RenderObject* renderObject = objectsArray[ro];
+            uint32 batchCount = renderObject->GetActiveRenderBatchCount();
+            for (uint32 batchIndex = 0; batchIndex < batchCount; ++batchIndex)
+            {
+                NMaterial* material = renderObject->GetActiveRenderBatch(batchIndex)->GetMaterial();
+                DVASSERT(material);
+
+                bool preBuildResult = false;
+                if (!material->IsPreBuilt(passName, preBuildResult))
+                {
+                    chunk.materialsToPreBuild.push_back(material);
+                }
+            }
+        }
+    });
 
-            NMaterial* material = batch->GetMaterial();
-            DVASSERT(material);
-            if (material->PreBuildMaterial(passName))
+    preBuildResults.clear();
+    for (uint32 c = 0; c < chunksCount; ++c)
+    {
+        for (NMaterial* material : layersChunks[c].materialsToPreBuild)
+        {
+            if (preBuildResults.count(material) == 0)
             {
-                layersBatchArrays[material->GetRenderLayerID()].AddRenderBatch(batch);
+                preBuildResults[material] = material->PreBuildMaterial(passName);
             }
         }
     }
+
+    // returns false if chunk contains material which was not prebuilt above; it can happen when
+    // prebuild of a parent material invalidates a child which was already checked
+    auto collectChunk = [&](uint32 begin, uint32 end, bool allowPreBuild) {
+        LayersChunk& chunk = layersChunks[begin / LAYERS_CHUNK_SIZE];
+        for (Vector<RenderBatch*>& batches : chunk.batches)
+        {
+            batches.clear();
+        }
+
+        for (uint32 ro = begin; ro < end; ++ro)
+        {
+            RenderObject* renderObject = objectsArray[ro];
+            uint32 batchCount = renderObject->GetActiveRenderBatchCount();
+            for (uint32 batchIndex = 0; batchIndex < batchCount; ++batchIndex)
+            {
+                RenderBatch* batch = renderObject->GetActiveRenderBatch(batchIndex);
+                NMaterial* material = batch->GetMaterial();
+
+                bool preBuildResult = false;
+                if (!material->IsPreBuilt(passName, preBuildResult))
+                {
+                    if (allowPreBuild)
+                    {
+                        preBuildResult = material->PreBuildMaterial(passName);
+                    }
+                    else
+                    {
+                        // material failed to switch to this pass or to finish rebuild
+                        auto found = preBuildResults.find(material);
+                        if (found == preBuildResults.end())
+                        {
+                            return false;
+                        }
+                        preBuildResult = found->second;
+                    }
+                }
+
+                if (preBuildResult)
+                {
+                    chunk.batches[material->GetRenderLayerID()].push_back(batch);
+                }
+            }
+        }
+        return true;
+    };
+
+    std::atomic<bool> hasIncompleteChunks(false);
+    ParallelFor(0, objectsCount, LAYERS_CHUNK_SIZE, [&](uint32 begin, uint32 end) {
+        LayersChunk& chunk = layersChunks[begin / LAYERS_CHUNK_SIZE];
+        chunk.isComplete = collectChunk(begin, end, false);
+        if (!chunk.isComplete)
+        {
+            hasIncompleteChunks = true;
+        }
+    });
+
+    if (hasIncompleteChunks)
+    {
+        // rare case: chunks with invalidated materials are collected again on the calling thread,
+        // like it was done before parallel collection
+        for (uint32 c = 0; c < chunksCount; ++c)
+        {
+            if (!layersChunks[c].isComplete)
+            {
+                uint32 begin = c * LAYERS_CHUNK_SIZE;
+                collectChunk(begin, Min(begin + LAYERS_CHUNK_SIZE, objectsCount), true);
+            }
+        }
+    }
+
+    for (uint32 c = 0; c < chunksCount; ++c)
+    {
+        for (uint32 id = 0; id < static_cast<uint32>(RenderLayer::RENDER_LAYER_ID_COUNT); ++id)
+        {
+            layersBatchArrays[id].AddRenderBatches(layersChunks[c].batches[id]);
+        }
+    }
 }
 
 void RenderPass::DrawLayers(Camera* camera)
@@ -337,11 +446,18 @@ void MainForwardRenderPass::PrepareReflectionRefractionTextures(RenderSystem* re
 
     reflectionPass->SetWaterLevel(waterBox.max.z);
     reflectionPass->GetPassConfig().priority = passConfig.priority + PRIORITY_SERVICE_3D;
-    reflectionPass->Draw(renderSystem);
 
     refractionPass->SetWaterLevel(waterBox.min.z);
     refractionPass->GetPassConfig().priority = passConfig.priority + PRIORITY_SERVICE_3D;
-    refractionPass->Draw(renderSystem);
+
+    // both passes are clipped concurrently, then drawn in the same order as before
+    waterClipRequests.clear();
+    waterClipRequests.push_back(reflectionPass->PrepareClipRequest(renderSystem));
+    waterClipRequests.push_back(refractionPass->PrepareClipRequest(renderSystem));
+    renderSystem->GetRenderHierarchy()->ClipMultiple(waterClipRequests);
+
+    reflectionPass->DrawVisibleObjects();
+    refractionPass->DrawVisibleObjects();
 }
 
 void MainForwardRenderPass::Draw(RenderSystem* renderSystem)
@@ -376,10 +492,12 @@ MainForwardRenderPass::~MainForwardRenderPass()
     SafeDelete(refractionPass);
 }
 
-WaterPrePass::WaterPrePass(const FastName& name)
+WaterPrePass::WaterPrePass(const FastName& name, uint32 visibilityCriteria_, const char* gpuMarkerName_)
     : RenderPass(name)
     , passMainCamera(NULL)
     , passDrawCamera(NULL)
+    , visibilityCriteria(visibilityCriteria_)
+    , gpuMarkerName(gpuMarkerName_)
 {
     AddRenderLayer(new RenderLayer(RenderLayer::RENDER_LAYER_OPAQUE_ID, RenderLayer::LAYER_SORTING_FLAGS_OPAQUE));
     AddRenderLayer(new RenderLayer(RenderLayer::RENDER_LAYER_AFTER_OPAQUE_ID, RenderLayer::LAYER_SORTING_FLAGS_AFTER_OPAQUE));
@@ -395,23 +513,14 @@ WaterPrePass::~WaterPrePass()
     SafeRelease(passDrawCamera);
 }
 
-WaterReflectionRenderPass::WaterReflectionRenderPass(const FastName& name)
-    : WaterPrePass(name)
+void WaterPrePass::Draw(RenderSystem* renderSystem)
 {
+    RenderHierarchy::ClipRequest request = PrepareClipRequest(renderSystem);
+    renderSystem->GetRenderHierarchy()->Clip(request.camera, *request.visibilityArray, request.visibilityCriteria);
+    DrawVisibleObjects();
 }
 
-void WaterReflectionRenderPass::UpdateCamera(Camera* camera)
-{
-    Vector3 v;
-    v = camera->GetPosition();
-    v.z = waterLevel - (v.z - waterLevel);
-    camera->SetPosition(v);
-    v = camera->GetTarget();
-    v.z = waterLevel - (v.z - waterLevel);
-    camera->SetTarget(v);
-}
-
-void WaterReflectionRenderPass::Draw(RenderSystem* renderSystem)
+RenderHierarchy::ClipRequest WaterPrePass::PrepareClipRequest(RenderSystem* renderSystem)
 {
     Camera* mainCamera = renderSystem->GetMainCamera();
     Camera* drawCamera = renderSystem->GetDrawCamera();
@@ -425,13 +534,11 @@ void WaterReflectionRenderPass::Draw(RenderSystem* renderSystem)
     passMainCamera->CopyMathOnly(*mainCamera);
     UpdateCamera(passMainCamera);
 
-    Vector4 clipPlane(0, 0, 1, -(waterLevel - 0.1f));
-    Camera* currMainCamera = passMainCamera;
-    Camera* currDrawCamera;
+    clipPlane = GetClipPlane();
 
     if (drawCamera == mainCamera)
     {
-        currDrawCamera = currMainCamera;
+        currDrawCamera = passMainCamera;
     }
     else
     {
@@ -440,70 +547,69 @@ void WaterReflectionRenderPass::Draw(RenderSystem* renderSystem)
         currDrawCamera = passDrawCamera;
     }
 
-    SetupCameraParams(currMainCamera, currDrawCamera, &clipPlane);
+    // frustum is built with the clip plane, it should be ready before clipping
+    passMainCamera->PrepareDynamicParameters(rhi::NeedInvertProjection(passConfig), &clipPlane);
 
     visibilityArray.clear();
-    renderSystem->GetRenderHierarchy()->Clip(currMainCamera, visibilityArray, RenderObject::CLIPPING_VISIBILITY_CRITERIA | RenderObject::VISIBLE_REFLECTION);
+
+    RenderHierarchy::ClipRequest request;
+    request.camera = passMainCamera;
+    request.visibilityCriteria = visibilityCriteria;
+    request.visibilityArray = &visibilityArray;
+    return request;
+}
+
+void WaterPrePass::DrawVisibleObjects()
+{
+    SetupCameraParams(passMainCamera, currDrawCamera, &clipPlane);
+
     ClearLayersArrays();
-    PrepareLayersArrays(visibilityArray, currMainCamera);
+    PrepareLayersArrays(visibilityArray, passMainCamera);
 
-    DAVA_PROFILER_GPU_RENDER_PASS(passConfig, ProfilerGPUMarkerName::RENDER_PASS_WATER_REFLECTION);
+    DAVA_PROFILER_GPU_RENDER_PASS(passConfig, gpuMarkerName);
     if (BeginRenderPass())
     {
-        DrawLayers(currMainCamera);
+        DrawLayers(passMainCamera);
         EndRenderPass();
     }
 }
 
-WaterRefractionRenderPass::WaterRefractionRenderPass(const FastName& name)
-    : WaterPrePass(name)
+void WaterPrePass::UpdateCamera(Camera* camera)
 {
-    /*const RenderLayerManager * renderLayerManager = RenderLayerManager::Instance();
-    AddRenderLayer(renderLayerManager->GetRenderLayer(LAYER_SHADOW_VOLUME), LAST_LAYER);*/
 }
 
-void WaterRefractionRenderPass::Draw(RenderSystem* renderSystem)
+WaterReflectionRenderPass::WaterReflectionRenderPass(const FastName& name)
+    : WaterPrePass(name, RenderObject::CLIPPING_VISIBILITY_CRITERIA | RenderObject::VISIBLE_REFLECTION, ProfilerGPUMarkerName::RENDER_PASS_WATER_REFLECTION)
 {
-    Camera* mainCamera = renderSystem->GetMainCamera();
-    Camera* drawCamera = renderSystem->GetDrawCamera();
+}
 
-    if (!passDrawCamera)
-    {
-        passMainCamera = new Camera();
-        passDrawCamera = new Camera();
-    }
+void WaterReflectionRenderPass::UpdateCamera(Camera* camera)
+{
+    Vector3 v;
+    v = camera->GetPosition();
+    v.z = waterLevel - (v.z - waterLevel);
+    camera->SetPosition(v);
+    v = camera->GetTarget();
+    v.z = waterLevel - (v.z - waterLevel);
+    camera->SetTarget(v);
+}
 
-    passMainCamera->CopyMathOnly(*mainCamera);
+Vector4 WaterReflectionRenderPass::GetClipPlane() const
+{
+    return Vector4(0, 0, 1, -(waterLevel - 0.1f));
+}
 
+WaterRefractionRenderPass::WaterRefractionRenderPass(const FastName& name)
+    : WaterPrePass(name, RenderObject::CLIPPING_VISIBILITY_CRITERIA | RenderObject::VISIBLE_REFRACTION, ProfilerGPUMarkerName::RENDER_PASS_WATER_REFRACTION)
+{
+    /*const RenderLayerManager * renderLayerManager = RenderLayerManager::Instance();
+    AddRenderLayer(renderLayerManager->GetRenderLayer(LAYER_SHADOW_VOLUME), LAST_LAYER);*/
+}
+
+Vector4 WaterRefractionRenderPass::GetClipPlane() const
+{
     //-0.1f ?
     //Vector4 clipPlane(0,0, -1, waterLevel*3);
-    Vector4 clipPlane(0, 0, -1, waterLevel + 0.1f);
-
-    Camera* currMainCamera = passMainCamera;
-    Camera* currDrawCamera;
-
-    if (drawCamera == mainCamera)
-    {
-        currDrawCamera = currMainCamera;
-    }
-    else
-    {
-        passDrawCamera->CopyMathOnly(*drawCamera);
-        currDrawCamera = passDrawCamera;
-    }
-
-    SetupCameraParams(currMainCamera, currDrawCamera, &clipPlane);
-
-    visibilityArray.clear();
-    renderSystem->GetRenderHierarchy()->Clip(currMainCamera, visibilityArray, RenderObject::CLIPPING_VISIBILITY_CRITERIA | RenderObject::VISIBLE_REFRACTION);
-    ClearLayersArrays();
-    PrepareLayersArrays(visibilityArray, currMainCamera);
-
-    DAVA_PROFILER_GPU_RENDER_PASS(passConfig, ProfilerGPUMarkerName::RENDER_PASS_WATER_REFRACTION);
-    if (BeginRenderPass())
-    {
-        DrawLayers(currMainCamera);
-        EndRenderPass();
-    }
+    return Vector4(0, 0, -1, waterLevel + 0.1f);
 }
 };
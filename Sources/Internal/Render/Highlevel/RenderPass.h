@@ -3,6 +3,7 @@
 #include "Base/BaseTypes.h"
 #include "Base/FastName.h"
 #include "Render/Highlevel/RenderLayer.h"
+#include "Render/Highlevel/RenderHierarchy.h"
 #include "Render/Highlevel/RenderPassNames.h"
 
 namespace DAVA
@@ -38,7 +39,7 @@ protected:
 
     /*convinience*/
     void PrepareVisibilityArrays(Camera* camera, RenderSystem* renderSystem);
-    void PrepareLayersArrays(const Vector<RenderObject*> objectsArray, Camera* camera);
+    void PrepareLayersArrays(const Vector<RenderObject*>& objectsArray, Camera* camera);
     void ClearLayersArrays();
 
     void SetupCameraParams(Camera* mainCamera, Camera* drawCamera, Vector4* externalClipPlane = NULL);
@@ -54,6 +55,18 @@ protected:
     std::array<RenderBatchArray, RenderLayer::RENDER_LAYER_ID_COUNT> layersBatchArrays;
     Vector<RenderObject*> visibilityArray;
 
+    // batches of objects are collected into layers by chunks on worker threads,
+    // chunks are merged in order, so layers content is the same as for sequential collection
+    static const uint32 LAYERS_CHUNK_SIZE = 256;
+    struct LayersChunk
+    {
+        std::array<Vector<RenderBatch*>, RenderLayer::RENDER_LAYER_ID_COUNT> batches;
+        Vector<NMaterial*> materialsToPreBuild;
+        bool isComplete = true;
+    };
+    Vector<LayersChunk> layersChunks;
+    UnorderedMap<NMaterial*, bool> preBuildResults;
+
     rhi::HPacketList packetList;
     rhi::HRenderPass renderPass;
 
@@ -106,29 +119,47 @@ public:
     {
         waterLevel = level;
     }
-    WaterPrePass(const FastName& name);
+    WaterPrePass(const FastName& name, uint32 visibilityCriteria, const char* gpuMarkerName);
     ~WaterPrePass();
 
+    void Draw(RenderSystem* renderSystem) override;
+
+    /**
+        Setup pass cameras for current scene cameras and water level and clear visibility array.
+        Returned request should be clipped (possibly together with other requests) before `DrawVisibleObjects` call.
+    */
+    RenderHierarchy::ClipRequest PrepareClipRequest(RenderSystem* renderSystem);
+    void DrawVisibleObjects();
+
 protected:
+    virtual void UpdateCamera(Camera* camera);
+    virtual Vector4 GetClipPlane() const = 0;
+
     Camera *passMainCamera, *passDrawCamera;
+    Camera* currDrawCamera = nullptr;
+    Vector4 clipPlane;
     float32 waterLevel = 0;
+    uint32 visibilityCriteria = 0;
+    const char* gpuMarkerName = nullptr;
 };
 
 class WaterReflectionRenderPass : public WaterPrePass
 {
 public:
     WaterReflectionRenderPass(const FastName& name);
-    virtual void Draw(RenderSystem* renderSystem);
 
 private:
-    void UpdateCamera(Camera* camera);
+    void UpdateCamera(Camera* camera) override;
+    Vector4 GetClipPlane() const override;
 };
 
 class WaterRefractionRenderPass : public WaterPrePass
 {
 public:
     WaterRefractionRenderPass(const FastName& name);
-    virtual void Draw(RenderSystem* renderSystem);
+
+private:
+    Vector4 GetClipPlane() const override;
 };
 
 class MainForwardRenderPass : public RenderPass
@@ -143,6 +174,7 @@ private:
     WaterRefractionRenderPass* refractionPass;
 
     AABBox3 waterBox;
+    Vector<RenderHierarchy::ClipRequest> waterClipRequests;
 
     void InitReflectionRefraction();
     void PrepareReflectionRefractionTextures(RenderSystem* renderSystem);
@@ -93,7 +93,13 @@ void SkinnedMesh::BindDynamicParameters(Camera* camera, RenderBatch* batch)
     RenderObject::BindDynamicParameters(camera, batch);
 }
 
-void SkinnedMesh::UpdateJointTransforms(const Vector<JointTransform>& finalTransforms)
+void SkinnedMesh::PrepareToRender(Camera* camera)
+{
+    RenderObject::PrepareToRender(camera);
+    visibleSinceUpdate = true;
+}
+
+void SkinnedMesh::UpdateJointTransforms(const Vector<Vector4>& finalPositionsScales, const Vector<Vector4>& finalOrientations)
 {
     for (auto& jointsData : jointTargetsData)
     {
@@ -103,11 +109,10 @@ void SkinnedMesh::UpdateJointTransforms(const Vector<JointTransform>& finalTrans
         for (uint32 j = 0; j < data.jointsDataCount; ++j)
         {
             uint32 transformIndex = targets[j];
-            DVASSERT(transformIndex < uint32(finalTransforms.size()));
+            DVASSERT(transformIndex < uint32(finalPositionsScales.size()));
 
-            const JointTransform& finalTransform = finalTransforms[transformIndex];
-            data.positions[j] = Vector4(Vector3(finalTransform.GetPosition().data), finalTransform.GetScale());
-            data.quaternions[j] = Vector4(finalTransform.GetOrientation().data);
+            data.positions[j] = finalPositionsScales[transformIndex];
+            data.quaternions[j] = finalOrientations[transformIndex];
         }
     }
 }
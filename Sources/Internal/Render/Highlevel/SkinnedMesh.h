@@ -39,18 +39,28 @@ public:
     void Load(KeyedArchive* archive, SerializationContext* serializationContext) override;
 
     void BindDynamicParameters(Camera* camera, RenderBatch* batch) override;
+    void PrepareToRender(Camera* camera) override;
 
     void SetBoundingBox(const AABBox3& box);
-    void UpdateJointTransforms(const Vector<JointTransform>& finalTransforms);
+    void UpdateJointTransforms(const Vector<Vector4>& finalPositionsScales, const Vector<Vector4>& finalOrientations);
 
     void SetJointTargets(RenderBatch* batch, const JointTargets& jointTargets);
 
     const JointTargets& GetJointTargets(RenderBatch* batch);
     const JointTargetsData& GetJointTargetsData(RenderBatch* batch);
 
+    /**
+        Return whether mesh passed visibility tests of any render pass since last `ResetVisibleSinceUpdate` call.
+        Used by animation systems to skip invisible skeletons.
+    */
+    bool IsVisibleSinceUpdate() const;
+    void ResetVisibleSinceUpdate();
+
 protected:
     UnorderedMap<RenderBatch*, uint32> jointTargetsDataMap; //RenderBatch -> targets-data index
     Vector<std::pair<JointTargets, JointTargetsData>> jointTargetsData;
+
+    bool visibleSinceUpdate = true;
 };
 
 inline void SkinnedMesh::SetBoundingBox(const AABBox3& box)
@@ -58,4 +68,14 @@ inline void SkinnedMesh::SetBoundingBox(const AABBox3& box)
     bbox = box;
 }
 
+inline bool SkinnedMesh::IsVisibleSinceUpdate() const
+{
+    return visibleSinceUpdate;
+}
+
+inline void SkinnedMesh::ResetVisibleSinceUpdate()
+{
+    visibleSinceUpdate = false;
+}
+
 } //ns
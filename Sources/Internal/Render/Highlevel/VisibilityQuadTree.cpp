@@ -4,9 +4,25 @@
 #include "Render/Highlevel/GeometryOctTree.h"
 #include "Render/Highlevel/Landscape.h"
 #include "Render/RenderHelper.h"
+#include "Job/ParallelFor.h"
+#include "Time/SystemTimer.h"
 
 namespace DAVA
 {
+namespace QuadTreeDetails
+{
+// index of free list for objects range of specified capacity
+uint32 GetCapacityClass(uint32 capacity)
+{
+    uint32 capacityClass = 0;
+    while ((AABBox3Block::SIZE << capacityClass) < capacity)
+    {
+        ++capacityClass;
+    }
+    return capacityClass;
+}
+}
+
 QuadTree::QuadTreeNode::QuadTreeNode()
 {
     Reset();
@@ -18,6 +34,8 @@ void QuadTree::QuadTreeNode::Reset()
     for (int32 i = 0; i < 4; i++)
         children[i] = INVALID_TREE_NODE_INDEX;
     nodeInfo = 0;
+    startClipPlane = 0;
+    objectsCount = 0;
 }
 
 QuadTree::QuadTree(int32 _maxTreeDepth)
@@ -106,9 +124,9 @@ void QuadTree::UpdateParentBox(AABBox3& childtBox, QuadTreeNode::eNodeType child
     }
 }
 
-uint16 QuadTree::FindObjectAddNode(uint16 startNodeId, const AABBox3& objBox)
+uint32 QuadTree::FindObjectAddNode(uint32 startNodeId, const AABBox3& objBox)
 {
-    uint16 currIndex = startNodeId;
+    uint32 currIndex = startNodeId;
 
     bool placeHere = false;
 
@@ -154,16 +172,16 @@ uint16 QuadTree::FindObjectAddNode(uint16 startNodeId, const AABBox3& objBox)
             if (currNode.children[fitNode] == INVALID_TREE_NODE_INDEX) //set child node if not exist
             {
                 DVASSERT((nodes[currIndex].nodeInfo & QuadTreeNode::NUM_CHILD_NODES_MASK) != 4);
-                uint16 newNodeIndex;
+                uint32 newNodeIndex;
                 if (emptyNodes.size()) //take from empty
                 {
-                    newNodeIndex = static_cast<uint16>(emptyNodes.back());
+                    newNodeIndex = emptyNodes.back();
                     emptyNodes.pop_back();
                     nodes[newNodeIndex].Reset();
                 }
                 else //or create new node
                 {
-                    newNodeIndex = uint16(nodes.size());
+                    newNodeIndex = static_cast<uint32>(nodes.size());
                     nodes.resize(newNodeIndex + 1); //starting from here currNode may be invalid
                 }
                 nodes[newNodeIndex].nodeInfo = (nodes[currIndex].nodeInfo & QuadTreeNode::NODE_DEPTH_MASK) + (1 << QuadTreeNode::NODE_DEPTH_OFFSET); //depth
@@ -183,7 +201,126 @@ uint16 QuadTree::FindObjectAddNode(uint16 startNodeId, const AABBox3& objBox)
     return currIndex;
 }
 
-void QuadTree::MarkNodeDirty(uint16 nodeId)
+RenderObject* const* QuadTree::GetNodeObjects(const QuadTreeNode& node) const
+{
+    return objectsPool.data() + node.objectsOffset;
+}
+
+const AABBox3Block* QuadTree::GetNodeObjectsBounds(const QuadTreeNode& node) const
+{
+    return objectsBoundsPool.data() + node.objectsOffset / AABBox3Block::SIZE;
+}
+
+int32 QuadTree::FindNodeObject(uint32 nodeId, RenderObject* object) const
+{
+    const QuadTreeNode& node = nodes[nodeId];
+    RenderObject* const* objects = GetNodeObjects(node);
+    for (uint32 i = 0; i < node.objectsCount; ++i)
+    {
+        if (objects[i] == object)
+            return static_cast<int32>(i);
+    }
+    return -1;
+}
+
+uint32 QuadTree::AllocateObjectsRange(uint32 capacity)
+{
+    uint32 capacityClass = QuadTreeDetails::GetCapacityClass(capacity);
+    if (capacityClass < freeObjectsRanges.size() && !freeObjectsRanges[capacityClass].empty())
+    {
+        uint32 offset = freeObjectsRanges[capacityClass].back();
+        freeObjectsRanges[capacityClass].pop_back();
+        return offset;
+    }
+
+    uint32 offset = static_cast<uint32>(objectsPool.size());
+    objectsPool.resize(offset + capacity, nullptr);
+    objectsBoundsPool.resize((offset + capacity) / AABBox3Block::SIZE);
+    return offset;
+}
+
+void QuadTree::ReserveNodeObjects(uint32 nodeId, uint32 count)
+{
+    if (count <= nodes[nodeId].objectsCapacity)
+        return;
+
+    uint32 capacity = AABBox3Block::SIZE;
+    while (capacity < count)
+    {
+        capacity *= 2;
+    }
+    uint32 offset = AllocateObjectsRange(capacity);
+
+    QuadTreeNode& node = nodes[nodeId];
+    std::copy(objectsPool.begin() + node.objectsOffset, objectsPool.begin() + node.objectsOffset + node.objectsCount, objectsPool.begin() + offset);
+
+    uint32 blocksCount = (node.objectsCount + AABBox3Block::SIZE - 1) / AABBox3Block::SIZE;
+    uint32 oldBlock = node.objectsOffset / AABBox3Block::SIZE;
+    std::copy(objectsBoundsPool.begin() + oldBlock, objectsBoundsPool.begin() + oldBlock + blocksCount, objectsBoundsPool.begin() + offset / AABBox3Block::SIZE);
+
+    if (node.objectsCapacity > 0)
+    {
+        uint32 capacityClass = QuadTreeDetails::GetCapacityClass(node.objectsCapacity);
+        if (capacityClass >= freeObjectsRanges.size())
+        {
+            freeObjectsRanges.resize(capacityClass + 1);
+        }
+        freeObjectsRanges[capacityClass].push_back(node.objectsOffset);
+    }
+
+    node.objectsOffset = offset;
+    node.objectsCapacity = capacity;
+}
+
+void QuadTree::AddNodeObject(uint32 nodeId, RenderObject* object)
+{
+    ReserveNodeObjects(nodeId, nodes[nodeId].objectsCount + 1);
+
+    QuadTreeNode& node = nodes[nodeId];
+    uint32 position = node.objectsOffset + node.objectsCount;
+    objectsPool[position] = object;
+    objectsBoundsPool[position / AABBox3Block::SIZE].Set(position % AABBox3Block::SIZE, object->GetWorldBoundingBox());
+    ++node.objectsCount;
+}
+
+void QuadTree::EraseNodeObject(uint32 nodeId, uint32 index)
+{
+    QuadTreeNode& node = nodes[nodeId];
+    DVASSERT(index < node.objectsCount);
+
+    for (uint32 p = node.objectsOffset + index + 1, end = node.objectsOffset + node.objectsCount; p < end; ++p)
+    {
+        objectsPool[p - 1] = objectsPool[p];
+        objectsBoundsPool[(p - 1) / AABBox3Block::SIZE].Copy((p - 1) % AABBox3Block::SIZE, objectsBoundsPool[p / AABBox3Block::SIZE], p % AABBox3Block::SIZE);
+    }
+    --node.objectsCount;
+}
+
+void QuadTree::SwapRemoveNodeObject(uint32 nodeId, uint32 index)
+{
+    QuadTreeNode& node = nodes[nodeId];
+    DVASSERT(index < node.objectsCount);
+
+    uint32 position = node.objectsOffset + index;
+    uint32 last = node.objectsOffset + node.objectsCount - 1;
+    if (position != last)
+    {
+        objectsPool[position] = objectsPool[last];
+        objectsBoundsPool[position / AABBox3Block::SIZE].Copy(position % AABBox3Block::SIZE, objectsBoundsPool[last / AABBox3Block::SIZE], last % AABBox3Block::SIZE);
+    }
+    --node.objectsCount;
+}
+
+void QuadTree::UpdateNodeObjectBounds(uint32 nodeId, RenderObject* object)
+{
+    int32 index = FindNodeObject(nodeId, object);
+    DVASSERT(index != -1);
+
+    uint32 position = nodes[nodeId].objectsOffset + static_cast<uint32>(index);
+    objectsBoundsPool[position / AABBox3Block::SIZE].Set(position % AABBox3Block::SIZE, object->GetWorldBoundingBox());
+}
+
+void QuadTree::MarkNodeDirty(uint32 nodeId)
 {
     if ((nodes[nodeId].nodeInfo & QuadTreeNode::DIRTY_Z_MASK) != QuadTreeNode::DIRTY_Z_MASK)
     {
@@ -197,27 +334,29 @@ void QuadTree::MarkObjectDirty(RenderObject* object)
     if (!(object->GetFlags() & RenderObject::TREE_NODE_NEED_UPDATE))
     {
         object->AddFlag(RenderObject::TREE_NODE_NEED_UPDATE);
+        object->SetTreeDirtyIndex(static_cast<uint32>(dirtyObjects.size()));
         dirtyObjects.push_back(object);
     }
 }
 
-void QuadTree::RecalculateNodeZLimits(uint16 nodeId)
+void QuadTree::RecalculateNodeZLimits(uint32 nodeId)
 {
     QuadTreeNode& currNode = nodes[nodeId];
     currNode.bbox.min.z = AABBOX_INFINITY;
     currNode.bbox.max.z = -AABBOX_INFINITY;
     for (int32 i = 0; i < QuadTreeNode::NODE_NONE; i++)
     {
-        uint16 childId = currNode.children[i];
+        uint32 childId = currNode.children[i];
         if (childId != INVALID_TREE_NODE_INDEX)
         {
             currNode.bbox.min.z = Min(currNode.bbox.min.z, nodes[childId].bbox.min.z);
             currNode.bbox.max.z = Max(currNode.bbox.max.z, nodes[childId].bbox.max.z);
         }
     }
-    for (size_t i = 0, size = currNode.objects.size(); i < size; i++)
+    RenderObject* const* objects = GetNodeObjects(currNode);
+    for (uint32 i = 0; i < currNode.objectsCount; i++)
     {
-        const AABBox3& objBox = currNode.objects[i]->GetWorldBoundingBox();
+        const AABBox3& objBox = objects[i]->GetWorldBoundingBox();
         currNode.bbox.min.z = Min(currNode.bbox.min.z, objBox.min.z);
         currNode.bbox.max.z = Max(currNode.bbox.max.z, objBox.max.z);
     }
@@ -245,13 +384,13 @@ void QuadTree::AddRenderObject(RenderObject* renderObject)
     if ((renderObject->GetFlags() & RenderObject::ALWAYS_CLIPPING_VISIBLE) || (!worldBox.IsInside(objBox)))
     {
         //object is somehow outside the world - just add to root
-        nodes[0].objects.push_back(renderObject);
+        AddNodeObject(0, renderObject);
         renderObject->SetTreeNodeIndex(0);
         renderObject->RemoveFlag(RenderObject::TREE_NODE_NEED_UPDATE);
         return;
     }
-    uint16 nodeToAdd = FindObjectAddNode(0, renderObject->GetWorldBoundingBox());
-    nodes[nodeToAdd].objects.push_back(renderObject);
+    uint32 nodeToAdd = FindObjectAddNode(0, renderObject->GetWorldBoundingBox());
+    AddNodeObject(nodeToAdd, renderObject);
     renderObject->SetTreeNodeIndex(nodeToAdd);
     renderObject->RemoveFlag(RenderObject::TREE_NODE_NEED_UPDATE);
 }
@@ -271,18 +410,19 @@ void QuadTree::RemoveRenderObject(RenderObject* renderObject)
         worldInitObjects.erase(it);
         return;
     }
-    uint16 currIndex = renderObject->GetTreeNodeIndex();
+    uint32 currIndex = renderObject->GetTreeNodeIndex();
     DVASSERT(currIndex != INVALID_TREE_NODE_INDEX);
     renderObject->SetTreeNodeIndex(INVALID_TREE_NODE_INDEX);
-    Vector<RenderObject*>::iterator it = std::find(nodes[currIndex].objects.begin(), nodes[currIndex].objects.end(), renderObject);
-    DVASSERT(it != nodes[currIndex].objects.end());
-    nodes[currIndex].objects.erase(it);
+    int32 objIndex = FindNodeObject(currIndex, renderObject);
+    DVASSERT(objIndex != -1);
+    EraseNodeObject(currIndex, static_cast<uint32>(objIndex));
 
-    if (renderObject->GetFlags() & RenderObject::TREE_NODE_NEED_UPDATE)
+    uint32 dirtyIndex = renderObject->GetTreeDirtyIndex();
+    if (dirtyIndex != INVALID_TREE_DIRTY_INDEX)
     {
-        List<RenderObject*>::iterator it = std::find(dirtyObjects.begin(), dirtyObjects.end(), renderObject);
-        DVASSERT(it != dirtyObjects.end());
-        dirtyObjects.erase(it);
+        DVASSERT(dirtyIndex < dirtyObjects.size() && dirtyObjects[dirtyIndex] == renderObject);
+        dirtyObjects[dirtyIndex] = nullptr; // keep order of dirty objects, removed entries are skipped in Update
+        renderObject->SetTreeDirtyIndex(INVALID_TREE_DIRTY_INDEX);
         renderObject->RemoveFlag(RenderObject::TREE_NODE_NEED_UPDATE);
     }
 
@@ -292,7 +432,7 @@ void QuadTree::RemoveRenderObject(RenderObject* renderObject)
         QuadTreeNode& currNode = nodes[currIndex];
 
         if ((currIndex != 0) && //do not remove root node anyway
-            currNode.objects.empty() &&
+            (currNode.objectsCount == 0) &&
             (!(currNode.nodeInfo & QuadTreeNode::NUM_CHILD_NODES_MASK)))
         { //empty node - just remove it from tree
             emptyNodes.push_back(currIndex);
@@ -344,6 +484,9 @@ void QuadTree::PrepareForShutdown()
     dirtyZNodes.clear();
     dirtyObjects.clear();
     worldInitObjects.clear();
+    objectsPool.clear();
+    objectsBoundsPool.clear();
+    freeObjectsRanges.clear();
     preparedForShutdown = true;
 }
 
@@ -359,12 +502,12 @@ void QuadTree::ObjectUpdated(RenderObject* renderObject)
 
     DVASSERT(worldInitialized);
     //remove object from its current tree node
-    uint16 baseIndex = renderObject->GetTreeNodeIndex();
+    uint32 baseIndex = renderObject->GetTreeNodeIndex();
     DVASSERT(baseIndex != INVALID_TREE_NODE_INDEX);
 
     //climb up
     const AABBox3& objBox = renderObject->GetWorldBoundingBox();
-    uint16 reverseIndex = baseIndex;
+    uint32 reverseIndex = baseIndex;
     while (reverseIndex && (!CheckObjectFitNode(objBox, nodes[reverseIndex].bbox)))
     {
         reverseIndex = nodes[reverseIndex].parent;
@@ -375,29 +518,21 @@ void QuadTree::ObjectUpdated(RenderObject* renderObject)
     if (reverseIndex != baseIndex)
     {
         //remove from base
-        int32 objectsSize = static_cast<int32>(nodes[baseIndex].objects.size());
-        int32 objIndex = 0;
-        for (; objIndex < objectsSize; ++objIndex)
-        {
-            if (nodes[baseIndex].objects[objIndex] == renderObject)
-                break;
-        }
-        DVASSERT(objIndex < objectsSize);
-        if (objectsSize > 1)
-            nodes[baseIndex].objects[objIndex] = nodes[baseIndex].objects[objectsSize - 1];
-        nodes[baseIndex].objects.resize(objectsSize - 1);
+        int32 objIndex = FindNodeObject(baseIndex, renderObject);
+        DVASSERT(objIndex != -1);
+        SwapRemoveNodeObject(baseIndex, static_cast<uint32>(objIndex));
         //and add to target
-        nodes[reverseIndex].objects.push_back(renderObject);
+        AddNodeObject(reverseIndex, renderObject);
         renderObject->SetTreeNodeIndex(reverseIndex);
 
         /*only now we can climb back and remove/mark nodes*/
-        uint16 currIndex = baseIndex;
+        uint32 currIndex = baseIndex;
         while (currIndex != reverseIndex)
         {
             QuadTreeNode& currNode = nodes[currIndex];
 
             if ((currIndex != 0) && //do not remove root node anyway
-                currNode.objects.empty() &&
+                (currNode.objectsCount == 0) &&
                 (!(currNode.nodeInfo & QuadTreeNode::NUM_CHILD_NODES_MASK)))
             { //empty node - just remove it from tree
                 emptyNodes.push_back(currIndex);
@@ -417,10 +552,11 @@ void QuadTree::ObjectUpdated(RenderObject* renderObject)
     }
     else
     {
+        UpdateNodeObjectBounds(baseIndex, renderObject);
         MarkNodeDirty(baseIndex);
     }
     //as object change can wrap any of parent boxes
-    uint16 currIndex = reverseIndex;
+    uint32 currIndex = reverseIndex;
     bool sizeUpdeted;
     do
     {
@@ -439,51 +575,69 @@ void QuadTree::ObjectUpdated(RenderObject* renderObject)
     } while (sizeUpdeted && (currIndex != INVALID_TREE_NODE_INDEX));
 }
 
-void QuadTree::ProcessNodeClipping(uint16 nodeId, uint8 clippingFlags, Vector<RenderObject*>& visibilityArray)
+void QuadTree::ProcessNodeClipping(const ClipContext& context, uint32 nodeId, uint8 clippingFlags, Vector<RenderObject*>& visibilityArray)
 {
     QuadTreeNode& currNode = nodes[nodeId];
-    int32 objectsSize = static_cast<int32>(currNode.objects.size());
+    RenderObject* const* objects = GetNodeObjects(currNode);
+    int32 objectsSize = static_cast<int32>(currNode.objectsCount);
     int32 clipBoxCount = (currNode.nodeInfo & QuadTreeNode::NUM_CHILD_NODES_MASK) + objectsSize; //still can sometime try to clip node with only invisible objects
 
     if (clippingFlags && (clipBoxCount > 1) && nodeId) //root node is considered as always pass  - as objects out of worldBox are added here
     {
-        uint8 startClipPlane = (currNode.nodeInfo & QuadTreeNode::START_CLIP_PLANE_MASK) >> QuadTreeNode::START_CLIP_PLANE_OFFSET;
-        if (currFrustum->Classify(currNode.bbox, clippingFlags, startClipPlane) == Frustum::EFR_OUTSIDE)
+        uint8 startClipPlane = context.updateStartClipPlanes ? currNode.startClipPlane : 0;
+        if (context.frustum->Classify(currNode.bbox, clippingFlags, startClipPlane) == Frustum::EFR_OUTSIDE)
             return; //node box is outside - return
-        currNode.nodeInfo &= ~QuadTreeNode::START_CLIP_PLANE_MASK;
-        currNode.nodeInfo |= (uint16(startClipPlane)) << QuadTreeNode::START_CLIP_PLANE_OFFSET;
+        if (context.updateStartClipPlanes)
+            currNode.startClipPlane = startClipPlane;
     }
     //process objects in current node
     if (!clippingFlags) //node is fully inside frustum - no need to clip anymore
     {
         for (int32 i = 0; i < objectsSize; ++i)
         {
-            RenderObject* obj = currNode.objects[i];
+            RenderObject* obj = objects[i];
             uint32 flags = obj->GetFlags();
-            if ((flags & currVisibilityCriteria) == currVisibilityCriteria)
+            if ((flags & context.visibilityCriteria) == context.visibilityCriteria)
             {
                 visibilityArray.push_back(obj);
-#if defined(__DAVAENGINE_RENDERSTATS__)
-                ++Renderer::GetRenderStats().visibleRenderObjects;
-#endif
             }
         }
     }
     else
     {
-        for (int32 i = 0; i < objectsSize; ++i)
+        // objects are tested against frustum by blocks, results are the same as for per-object Frustum::IsInside
+        uint8 startClippingPlanes[AABBox3Block::SIZE];
+        for (int32 blockStart = 0; blockStart < objectsSize; blockStart += AABBox3Block::SIZE)
         {
-            RenderObject* obj = currNode.objects[i];
-            uint32 flags = obj->GetFlags();
-            if ((flags & currVisibilityCriteria) == currVisibilityCriteria)
+            uint32 count = static_cast<uint32>(Min(objectsSize - blockStart, static_cast<int32>(AABBox3Block::SIZE)));
+            RenderObject* const* blockObjects = objects + blockStart;
+
+            for (uint32 i = 0; i < count; ++i)
+            {
+                startClippingPlanes[i] = context.updateStartClipPlanes ? blockObjects[i]->startClippingPlane : 0;
+            }
+
+            const AABBox3Block& block = GetNodeObjectsBounds(currNode)[blockStart / AABBox3Block::SIZE];
+            uint32 insideMask = context.frustum->IsInside(block, count, clippingFlags, startClippingPlanes);
+
+            for (uint32 i = 0; i < count; ++i)
             {
-                if ((flags & RenderObject::ALWAYS_CLIPPING_VISIBLE)
-                    || currFrustum->IsInside(obj->GetWorldBoundingBox(), clippingFlags, obj->startClippingPlane))
+                RenderObject* obj = blockObjects[i];
+                uint32 flags = obj->GetFlags();
+                if ((flags & context.visibilityCriteria) == context.visibilityCriteria)
                 {
-                    visibilityArray.push_back(obj);
-#if defined(__DAVAENGINE_RENDERSTATS__)
-                    ++Renderer::GetRenderStats().visibleRenderObjects;
-#endif
+                    bool visible = true;
+                    if ((flags & RenderObject::ALWAYS_CLIPPING_VISIBLE) == 0)
+                    {
+                        if (context.updateStartClipPlanes)
+                            obj->startClippingPlane = startClippingPlanes[i];
+                        visible = (insideMask & (1u << i)) != 0;
+                    }
+
+                    if (visible)
+                    {
+                        visibilityArray.push_back(obj);
+                    }
                 }
             }
         }
@@ -492,10 +646,10 @@ void QuadTree::ProcessNodeClipping(uint16 nodeId, uint8 clippingFlags, Vector<Re
     //process children
     for (int32 i = 0; i < QuadTreeNode::NODE_NONE; ++i)
     {
-        uint16 childNodeId = currNode.children[i];
+        uint32 childNodeId = currNode.children[i];
         if (childNodeId != INVALID_TREE_NODE_INDEX)
         {
-            ProcessNodeClipping(childNodeId, clippingFlags, visibilityArray);
+            ProcessNodeClipping(context, childNodeId, clippingFlags, visibilityArray);
         }
     }
 }
@@ -503,22 +657,72 @@ void QuadTree::ProcessNodeClipping(uint16 nodeId, uint8 clippingFlags, Vector<Re
 void QuadTree::Clip(Camera* camera, Vector<RenderObject*>& visibilityArray, uint32 visibilityCriteria)
 {
     DVASSERT(worldInitialized);
-    currCamera = camera;
-    currVisibilityCriteria = visibilityCriteria;
-    currFrustum = camera->GetFrustum();
-    ProcessNodeClipping(0, 0x3f, visibilityArray);
+
+    ClipContext context;
+    context.frustum = camera->GetFrustum();
+    context.visibilityCriteria = visibilityCriteria;
+    context.updateStartClipPlanes = true;
+
+#if defined(__DAVAENGINE_RENDERSTATS__)
+    size_t visibleBefore = visibilityArray.size();
+#endif
+
+    ProcessNodeClipping(context, 0, 0x3f, visibilityArray);
+
+#if defined(__DAVAENGINE_RENDERSTATS__)
+    Renderer::GetRenderStats().visibleRenderObjects += static_cast<uint32>(visibilityArray.size() - visibleBefore);
+#endif
+}
+
+void QuadTree::ClipMultiple(const Vector<ClipRequest>& requests)
+{
+    DVASSERT(worldInitialized);
+
+    uint32 requestsCount = static_cast<uint32>(requests.size());
+
+#if defined(__DAVAENGINE_RENDERSTATS__)
+    Vector<size_t> visibleBefore(requestsCount);
+    for (uint32 i = 0; i < requestsCount; ++i)
+    {
+        visibleBefore[i] = requests[i].visibilityArray->size();
+    }
+#endif
+
+    // every request writes only to own visibility array, so results do not depend on scheduling.
+    // The first request keeps start clipping planes coherent, as it would do in a separate `Clip` call
+    ParallelFor(0, requestsCount, 1, [&](uint32 begin, uint32 end) {
+        for (uint32 i = begin; i < end; ++i)
+        {
+            const ClipRequest& request = requests[i];
+
+            ClipContext context;
+            context.frustum = request.camera->GetFrustum();
+            context.visibilityCriteria = request.visibilityCriteria;
+            context.updateStartClipPlanes = (i == 0);
+
+            ProcessNodeClipping(context, 0, 0x3f, *request.visibilityArray);
+        }
+    });
+
+#if defined(__DAVAENGINE_RENDERSTATS__)
+    for (uint32 i = 0; i < requestsCount; ++i)
+    {
+        Renderer::GetRenderStats().visibleRenderObjects += static_cast<uint32>(requests[i].visibilityArray->size() - visibleBefore[i]);
+    }
+#endif
 }
 
-void QuadTree::GetObjects(uint16 nodeId, const AABBox3& bbox, Vector<RenderObject*>& visibilityArray)
+void QuadTree::GetObjects(uint32 nodeId, const AABBox3& bbox, Vector<RenderObject*>& visibilityArray)
 {
     QuadTreeNode& currNode = nodes[nodeId];
-    int32 objectsSize = static_cast<int32>(currNode.objects.size());
+    RenderObject* const* objects = GetNodeObjects(currNode);
+    int32 objectsSize = static_cast<int32>(currNode.objectsCount);
 
     if (bbox.IntersectsWithBox(currNode.bbox))
     {
         for (int32 i = 0; i < objectsSize; ++i)
         {
-            RenderObject* renderObject = currNode.objects[i];
+            RenderObject* renderObject = objects[i];
             if (bbox.IntersectsWithBox(renderObject->GetWorldBoundingBox()))
             {
                 visibilityArray.push_back(renderObject);
@@ -528,7 +732,7 @@ void QuadTree::GetObjects(uint16 nodeId, const AABBox3& bbox, Vector<RenderObjec
         //process children
         for (int32 i = 0; i < QuadTreeNode::NODE_NONE; ++i)
         {
-            uint16 childNodeId = currNode.children[i];
+            uint32 childNodeId = currNode.children[i];
             if (childNodeId != INVALID_TREE_NODE_INDEX)
             {
                 GetObjects(childNodeId, bbox, visibilityArray);
@@ -548,11 +752,12 @@ void QuadTree::BroadPhaseCollisions(const Ray3& rayInWorldSpace, Vector<BroadPha
 
     while (broadPhaseQueue.size() > 0)
     {
-        uint16 nodeId = broadPhaseQueue.front();
+        uint32 nodeId = broadPhaseQueue.front();
         broadPhaseQueue.pop();
 
         QuadTreeNode& currNode = nodes[nodeId];
-        int32 objectsSize = static_cast<int32>(currNode.objects.size());
+        RenderObject* const* objects = GetNodeObjects(currNode);
+        int32 objectsSize = static_cast<int32>(currNode.objectsCount);
         //    int32 clipBoxCount = (currNode.nodeInfo & QuadTreeNode::NUM_CHILD_NODES_MASK) + objectsSize; //still can sometime try to clip node with only invisible objects
 
         float32 tMin, tMax;
@@ -562,7 +767,7 @@ void QuadTree::BroadPhaseCollisions(const Ray3& rayInWorldSpace, Vector<BroadPha
             localRayBoxTraceCount += objectsSize;
             for (int32 i = 0; i < objectsSize; ++i)
             {
-                RenderObject* renderObject = currNode.objects[i];
+                RenderObject* renderObject = objects[i];
                 float32 objTMin, objTMax;
                 if (Intersection::RayBox(rayInWorldSpace, renderObject->GetWorldBoundingBox(), objTMin, objTMax))
                 {
@@ -575,7 +780,7 @@ void QuadTree::BroadPhaseCollisions(const Ray3& rayInWorldSpace, Vector<BroadPha
             //process children
             for (int32 i = 0; i < QuadTreeNode::NODE_NONE; ++i)
             {
-                uint16 childNodeId = currNode.children[i];
+                uint32 childNodeId = currNode.children[i];
                 if (childNodeId != INVALID_TREE_NODE_INDEX)
                 {
                     broadPhaseQueue.push(childNodeId);
@@ -672,48 +877,74 @@ bool QuadTree::RayTrace(const Ray3& ray, RayTraceCollision& collision, const Vec
 void QuadTree::Update()
 {
     DVASSERT(worldInitialized);
-    int32 count = 0;
-    for (List<int32>::iterator it = dirtyZNodes.begin(), e = dirtyZNodes.end(); (it != e) && (count < RECALCULATE_Z_PER_FRAME); ++count)
+
+    int64 startTime = SystemTimer::GetUs();
+    auto timeIsOver = [this, startTime](uint32 processed, uint32 minCount) {
+        return (processed >= minCount) && ((processed - minCount) % UPDATE_TIME_CHECK_PERIOD == 0) && (SystemTimer::GetUs() - startTime >= updateTimeBudgetUs);
+    };
+
+    // recalculation can mark parent nodes dirty, they are appended to the end and may be processed in the same frame
+    uint32 processed = 0;
+    for (; processed < dirtyZNodes.size() && !timeIsOver(processed, MIN_RECALCULATE_Z_PER_FRAME); ++processed)
     {
-        RecalculateNodeZLimits(*it);
-        it = dirtyZNodes.erase(it);
+        RecalculateNodeZLimits(dirtyZNodes[processed]);
     }
-    count = 0;
-    for (List<RenderObject *>::iterator it = dirtyObjects.begin(), e = dirtyObjects.end(); (it != e) && (count < RECALCULATE_OBJECTS_PER_FRAME); ++count)
+    dirtyZNodes.erase(dirtyZNodes.begin(), dirtyZNodes.begin() + processed);
+
+    processed = 0;
+    for (; processed < dirtyObjects.size() && !timeIsOver(processed, MIN_RECALCULATE_OBJECTS_PER_FRAME); ++processed)
     {
-        RenderObject* object = *it;
-        it = dirtyObjects.erase(it);
-        //as now invisible render objects are updeted after becoming visible no no need to store them in this list for all that time
-        object->RemoveFlag(RenderObject::TREE_NODE_NEED_UPDATE);
-        if ((object->GetFlags() & RenderObject::CLIPPING_VISIBILITY_CRITERIA) == RenderObject::CLIPPING_VISIBILITY_CRITERIA)
+        RenderObject* object = dirtyObjects[processed];
+        if (object != nullptr)
         {
-            uint16 startNode = object->GetTreeNodeIndex();
-            if ((!startNode) && (!worldBox.IsInside(object->GetWorldBoundingBox())))
-                continue; //object is out of world - leave it in root node
+            UpdateDirtyObject(object);
+        }
+    }
 
-            uint16 targetNode = FindObjectAddNode(startNode, object->GetWorldBoundingBox());
-            if (startNode != targetNode)
-            {
-                //remove from base
-                int32 objectsSize = static_cast<int32>(nodes[startNode].objects.size());
-                int32 objIndex = 0;
-                for (; objIndex < objectsSize; ++objIndex)
-                {
-                    if (nodes[startNode].objects[objIndex] == object)
-                        break;
-                }
-                DVASSERT(objIndex < objectsSize);
-                if (objectsSize > 1)
-                    nodes[startNode].objects[objIndex] = nodes[startNode].objects[objectsSize - 1];
-                nodes[startNode].objects.resize(objectsSize - 1);
-                //and add to target
-                nodes[targetNode].objects.push_back(object);
-                object->SetTreeNodeIndex(targetNode);
-            }
+    // move objects left for next frames to the beginning, dropping removed ones
+    uint32 remaining = 0;
+    for (; processed < dirtyObjects.size(); ++processed)
+    {
+        RenderObject* object = dirtyObjects[processed];
+        if (object != nullptr)
+        {
+            object->SetTreeDirtyIndex(remaining);
+            dirtyObjects[remaining++] = object;
+        }
+    }
+    dirtyObjects.resize(remaining);
+}
+
+void QuadTree::UpdateDirtyObject(RenderObject* object)
+{
+    //as now invisible render objects are updeted after becoming visible no no need to store them in this list for all that time
+    object->RemoveFlag(RenderObject::TREE_NODE_NEED_UPDATE);
+    object->SetTreeDirtyIndex(INVALID_TREE_DIRTY_INDEX);
+    if ((object->GetFlags() & RenderObject::CLIPPING_VISIBILITY_CRITERIA) == RenderObject::CLIPPING_VISIBILITY_CRITERIA)
+    {
+        uint32 startNode = object->GetTreeNodeIndex();
+        if ((!startNode) && (!worldBox.IsInside(object->GetWorldBoundingBox())))
+            return; //object is out of world - leave it in root node
+
+        uint32 targetNode = FindObjectAddNode(startNode, object->GetWorldBoundingBox());
+        if (startNode != targetNode)
+        {
+            //remove from base
+            int32 objIndex = FindNodeObject(startNode, object);
+            DVASSERT(objIndex != -1);
+            SwapRemoveNodeObject(startNode, static_cast<uint32>(objIndex));
+            //and add to target
+            AddNodeObject(targetNode, object);
+            object->SetTreeNodeIndex(targetNode);
         }
     }
 }
 
+void QuadTree::SetUpdateTimeBudget(int64 budgetUs)
+{
+    updateTimeBudgetUs = budgetUs;
+}
+
 void QuadTree::DebugDraw(const Matrix4& cameraMatrix, RenderHelper* renderHelper)
 {
 #if (DAVA_DEBUG_DRAW_OCTREE)
@@ -739,13 +970,14 @@ void QuadTree::DebugDraw(const Matrix4& cameraMatrix, RenderHelper* renderHelper
 #endif
 }
 
-void QuadTree::DebugDrawNode(uint16 nodeId)
+void QuadTree::DebugDrawNode(uint32 nodeId)
 {
 #if (DAVA_DEBUG_DRAW_OCTREE)
     RenderSystem2D::Instance()->SetColor(0.2f, 0.2f, 1.0f, 1.0f);
-    for (int32 i = 0, size = static_cast<int32>(nodes[nodeId].objects.size()); i < size; ++i)
+    RenderObject* const* objects = GetNodeObjects(nodes[nodeId]);
+    for (uint32 i = 0; i < nodes[nodeId].objectsCount; ++i)
     {
-        RenderHelper::Instance()->DrawBox(nodes[nodeId].objects[i]->GetWorldBoundingBox(), 1.0f, debugDrawStateHandle);
+        RenderHelper::Instance()->DrawBox(objects[i]->GetWorldBoundingBox(), 1.0f, debugDrawStateHandle);
     }
     RenderSystem2D::Instance()->SetColor(0.2f, 1.0f, 0.2f, 1.0f);
     RenderHelper::Instance()->DrawBox(nodes[nodeId].bbox, 1.0f, debugDrawStateHandle);
@@ -2,6 +2,7 @@
 
 #include "Base/BaseObject.h"
 #include "Math/AABBox3.h"
+#include "Render/Highlevel/Frustum.h"
 #include "Render/Highlevel/RenderHierarchy.h"
 #include "Render/UniqueStateSet.h"
 
@@ -9,14 +10,14 @@
 
 namespace DAVA
 {
-class Frustum;
 class RenderObject;
 class QuadTree : public RenderHierarchy
 {
 public:
-    enum : uint16
+    enum : uint32
     {
-        INVALID_TREE_NODE_INDEX = static_cast<uint16>(-1)
+        INVALID_TREE_NODE_INDEX = static_cast<uint32>(-1),
+        INVALID_TREE_DIRTY_INDEX = static_cast<uint32>(-1)
     };
 
 public:
@@ -26,6 +27,7 @@ public:
     void RemoveRenderObject(RenderObject* renderObject) override;
     void ObjectUpdated(RenderObject* renderObject) override;
     void Clip(Camera* camera, Vector<RenderObject*>& visibilityArray, uint32 visibilityCriteria) override;
+    void ClipMultiple(const Vector<ClipRequest>& requests) override;
     void GetAllObjectsInBBox(const AABBox3& bbox, Vector<RenderObject*>& visibilityArray) override;
     bool RayTrace(const Ray3& ray, RayTraceCollision& collision,
                   const Vector<RenderObject*>& ignoreObjects) override;
@@ -35,6 +37,10 @@ public:
     void PrepareForShutdown() override;
 
     void Update() override;
+
+    /** Set how much time `Update` can spend on rebalancing of dirty nodes and objects per frame, in microseconds. */
+    void SetUpdateTimeBudget(int64 budgetUs);
+
     void DebugDraw(const Matrix4& cameraMatrix, RenderHelper* renderHelper) override;
 
     struct QuadTreeNode // still basic implementation - later move it to more compact
@@ -47,50 +53,87 @@ public:
             NODE_RT = 3,
             NODE_NONE = 4
         };
-        uint16 parent;
-        uint16 children[4]; // think about allocating and freeing at groups of for
+        uint32 parent;
+        uint32 children[4]; // think about allocating and freeing at groups of for
         AABBox3 bbox;
 
         const static uint16 NUM_CHILD_NODES_MASK = 0x07;
         const static uint16 DIRTY_Z_MASK = 0x08;
         const static uint16 NODE_DEPTH_MASK = 0xFF00;
         const static uint16 NODE_DEPTH_OFFSET = 8;
-        const static uint16 START_CLIP_PLANE_MASK = 0xF0;
-        const static uint16 START_CLIP_PLANE_OFFSET = 4;
         uint16 nodeInfo; // format : ddddddddddzccñ where c - numChildNodes, z - dirtyZ, d - depth
-        Vector<RenderObject*> objects;
+        uint8 startClipPlane; // plane that culled node last time, checked first
+
+        // node objects are stored in the tree objects pool: range [objectsOffset, objectsOffset + objectsCapacity).
+        // Range is kept when node is reset, so reused nodes do not allocate again
+        uint32 objectsOffset = 0;
+        uint32 objectsCapacity = 0;
+        uint32 objectsCount = 0;
+
         QuadTreeNode();
         void Reset();
     };
 
 private:
+    // clipping reads only tree and context, so several cameras can be clipped concurrently.
+    // Per-node and per-object start clipping planes are only a coherency hint: they are read and written
+    // only when `updateStartClipPlanes` is set, which is allowed for at most one concurrent clipping.
+    struct ClipContext
+    {
+        const Frustum* frustum = nullptr;
+        uint32 visibilityCriteria = 0;
+        bool updateStartClipPlanes = false;
+    };
+
     bool CheckObjectFitNode(const AABBox3& objBox, const AABBox3& nodeBox);
     bool CheckBoxIntersectBranch(const AABBox3& objBox, float32 xmin, float32 ymin, float32 xmax, float32 ymax);
     bool CheckBoxIntersectChild(const AABBox3& objBox, const AABBox3& nodeBox, QuadTreeNode::eNodeType nodeType); //assuming it already fit parent!
     void UpdateChildBox(AABBox3& parentBox, QuadTreeNode::eNodeType childType);
     void UpdateParentBox(AABBox3& childBox, QuadTreeNode::eNodeType childType);
 
-    void ProcessNodeClipping(uint16 nodeId, uint8 clippingFlags, Vector<RenderObject*>& visibilityArray);
-    void GetObjects(uint16 nodeId, const AABBox3& bbox, Vector<RenderObject*>& visibilityArray);
-    void RecalculateNodeZLimits(uint16 nodeId);
-    void MarkNodeDirty(uint16 nodeId);
+    RenderObject* const* GetNodeObjects(const QuadTreeNode& node) const;
+    const AABBox3Block* GetNodeObjectsBounds(const QuadTreeNode& node) const;
+    int32 FindNodeObject(uint32 nodeId, RenderObject* object) const;
+    void ReserveNodeObjects(uint32 nodeId, uint32 count);
+    uint32 AllocateObjectsRange(uint32 capacity);
+
+    void AddNodeObject(uint32 nodeId, RenderObject* object);
+    void EraseNodeObject(uint32 nodeId, uint32 index); // keeps order of objects
+    void SwapRemoveNodeObject(uint32 nodeId, uint32 index);
+    void UpdateNodeObjectBounds(uint32 nodeId, RenderObject* object);
+
+    void ProcessNodeClipping(const ClipContext& context, uint32 nodeId, uint8 clippingFlags, Vector<RenderObject*>& visibilityArray);
+    void GetObjects(uint32 nodeId, const AABBox3& bbox, Vector<RenderObject*>& visibilityArray);
+    void RecalculateNodeZLimits(uint32 nodeId);
+    void MarkNodeDirty(uint32 nodeId);
     void MarkObjectDirty(RenderObject* object);
-    void DebugDrawNode(uint16 nodeId);
+    void UpdateDirtyObject(RenderObject* object);
+    void DebugDrawNode(uint32 nodeId);
     void BroadPhaseCollisions(const Ray3& rayInWorldSpace, Vector<BroadPhaseCollision>& broadPhaseCollisions);
 
-    uint16 FindObjectAddNode(uint16 startNodeId, const AABBox3& objBox);
+    uint32 FindObjectAddNode(uint32 startNodeId, const AABBox3& objBox);
 
 private:
-    static const int32 RECALCULATE_Z_PER_FRAME = 10;
-    static const int32 RECALCULATE_OBJECTS_PER_FRAME = 10;
+    // `Update` always processes at least this number of dirty nodes and objects, then continues while time budget allows.
+    // Time is checked right after the minimum is processed and then every UPDATE_TIME_CHECK_PERIOD items
+    static const uint32 MIN_RECALCULATE_Z_PER_FRAME = 10;
+    static const uint32 MIN_RECALCULATE_OBJECTS_PER_FRAME = 10;
+    static const uint32 UPDATE_TIME_CHECK_PERIOD = 16;
+    static const int64 DEFAULT_UPDATE_TIME_BUDGET_US = 250;
 
     Vector<BroadPhaseCollision> broadPhaseCollisions;
     Vector<QuadTreeNode> nodes;
     Vector<uint32> emptyNodes;
-    List<int32> dirtyZNodes;
-    List<RenderObject*> dirtyObjects;
+    Vector<uint32> dirtyZNodes;
+    Vector<RenderObject*> dirtyObjects; // removed objects are replaced with nullptr, objects know their position (see RenderObject::GetTreeDirtyIndex)
     List<RenderObject*> worldInitObjects;
-    std::queue<uint16> broadPhaseQueue;
+    std::queue<uint32> broadPhaseQueue;
+
+    // objects of all nodes in one buffer. Node capacities are powers of two multiplied by AABBox3Block::SIZE,
+    // so every node range starts at the beginning of a bounds block
+    Vector<RenderObject*> objectsPool;
+    Vector<AABBox3Block> objectsBoundsPool; // world bounding boxes of objects in SoA blocks, for batched clipping
+    Vector<Vector<uint32>> freeObjectsRanges; // offsets of released ranges by capacity class
 
 #if (DAVA_DEBUG_DRAW_OCTREE)
     UniqueHandle debugDrawStateHandle = InvalidUniqueHandle;
@@ -98,10 +141,8 @@ private:
 
     AABBox3 worldBox;
     int32 maxTreeDepth = 0;
-    Frustum* currFrustum = nullptr;
-    Camera* currCamera = nullptr;
-    uint32 currVisibilityCriteria = 0;
     uint32 localRayBoxTraceCount = 0;
+    int64 updateTimeBudgetUs = DEFAULT_UPDATE_TIME_BUDGET_US;
     bool worldInitialized = false;
     bool preparedForShutdown = false;
 };
@@ -1098,6 +1098,15 @@ bool NMaterial::PreBuildMaterial(const FastName& passName)
     return res;
 }
 
+bool NMaterial::IsPreBuilt(const FastName& passName, bool& result) const
+{
+    if (needRebuildVariants || needRebuildBindings || needRebuildTextures || (activeVariantName != passName))
+        return false;
+
+    result = (activeVariantInstance != nullptr) && (activeVariantInstance->shader->IsValid());
+    return true;
+}
+
 NMaterial* NMaterial::Clone()
 {
     DAVA_MEMORY_PROFILER_CLASS_ALLOC_SCOPE();
@@ -183,6 +183,10 @@ public:
     // later add engine flags here
     bool PreBuildMaterial(const FastName& passName);
 
+    // returns true if PreBuildMaterial(passName) would not modify material, in this case `result` is set to its return value
+    // does not modify material, so it can be called concurrently from several threads
+    bool IsPreBuilt(const FastName& passName, bool& result) const;
+
     // RHI_COMPLETE - it's temporary solution to avoid FX loading and shaders compilation after loading
     void PreCacheFX();
     void PreCacheFXWithFlags(const UnorderedMap<FastName, int32>& extraFlags, const FastName& extraFxName = FastName());
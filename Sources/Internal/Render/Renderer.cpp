@@ -303,6 +303,9 @@ void RenderStats::Reset()
     visibleRenderObjects = 0U;
     occludedRenderObjects = 0U;
 
+    updatedSkeletons = 0U;
+    updatedJoints = 0U;
+
     visibilityQueryResults.clear();
 }
 
@@ -94,6 +94,9 @@ struct RenderStats
     uint32 visibleRenderObjects = 0U;
     uint32 occludedRenderObjects = 0U;
 
+    uint32 updatedSkeletons = 0U;
+    uint32 updatedJoints = 0U;
+
     UnorderedMap<FastName, uint32> visibilityQueryResults = UnorderedMap<FastName, uint32>(16);
 };
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Base/BaseTypes.h"
+#include "Debug/DVAssert.h"
 
 const DAVA::uint32 InvalidUniqueHandle = -1;
 
@@ -4,6 +4,8 @@
 #include "Base/FastName.h"
 #include "Reflection/Reflection.h"
 #include "Entity/Component.h"
+#include "Scene3D/SkeletonAnimation/MotionLodInterpolator.h"
+#include "Scene3D/SkeletonAnimation/SkeletonPose.h"
 
 namespace DAVA
 {
@@ -58,6 +60,9 @@ protected:
     SimpleMotion* simpleMotion = nullptr;
     uint32 simpleMotionRepeatsCount = 0;
 
+    //animation lod: poses are evaluated once per update period of skeleton lod and interpolated in between
+    MotionLodInterpolator lodInterpolator;
+
     DAVA_VIRTUAL_REFLECTION(MotionComponent, Component);
 
     friend class MotionSystem;
@@ -1,4 +1,5 @@
 #include "Scene3D/Components/SkeletonComponent.h"
+#include "Render/Highlevel/SkinnedMesh.h"
 #include "Scene3D/Entity.h"
 #include "Scene3D/Components/ComponentHelpers.h"
 #include "Scene3D/Systems/EventSystem.h"
@@ -38,6 +39,11 @@ bool SkeletonComponent::Joint::operator==(const Joint& other) const
     bindTransformInv == other.bindTransformInv;
 }
 
+bool SkeletonComponent::AnimationLod::operator==(const AnimationLod& other) const
+{
+    return updatePeriod == other.updatePeriod && jointLevelsCount == other.jointLevelsCount;
+}
+
 void SkeletonComponent::SetJoints(const Vector<Joint>& config)
 {
     jointsArray = config;
@@ -69,29 +75,55 @@ void SkeletonComponent::ApplyPose(const SkeletonPose& pose)
     uint32 minJoints = Min(GetJointsCount(), pose.GetJointsCount());
     for (uint32 j = 0; j < minJoints; ++j)
     {
-        const JointTransform& poseTransform = pose.GetJointTransform(j);
+        JointTransform poseTransform = pose.GetJointTransform(j);
 
         if (poseTransform.IsEmpty())
             continue;
 
-        JointTransform& transform = localSpaceTransforms[j];
-
         if (poseTransform.HasPosition())
-            transform.SetPosition(poseTransform.GetPosition());
+            localSpaceTransforms.SetPosition(j, poseTransform.GetPosition());
         if (poseTransform.HasOrientation())
-            transform.SetOrientation(poseTransform.GetOrientation());
+            localSpaceTransforms.SetOrientation(j, poseTransform.GetOrientation());
         if (poseTransform.HasScale())
-            transform.SetScale(poseTransform.GetScale());
+            localSpaceTransforms.SetScale(j, poseTransform.GetScale());
 
-        SetJointTransform(j, transform);
+        SetJointUpdated(j);
     }
 }
 
+void SkeletonComponent::SetAnimationLod(int32 lodLayer, const AnimationLod& lod)
+{
+    DVASSERT(0 <= lodLayer && lodLayer < LodComponent::MAX_LOD_LAYERS);
+    DVASSERT(lod.updatePeriod > 0);
+    animationLods[lodLayer] = lod;
+}
+
+const SkeletonComponent::AnimationLod& SkeletonComponent::GetCurrentAnimationLod() const
+{
+    LodComponent* lodComponent = (GetEntity() != nullptr) ? GetLodComponent(GetEntity()) : nullptr;
+    int32 lodLayer = (lodComponent != nullptr) ? lodComponent->GetCurrentLod() : LodComponent::INVALID_LOD_LAYER;
+    return animationLods[(lodLayer == LodComponent::INVALID_LOD_LAYER) ? 0 : lodLayer];
+}
+
+bool SkeletonComponent::IsAnimationVisible() const
+{
+    if (invisibleUpdate == INVISIBLE_UPDATE_FULL || GetEntity() == nullptr)
+        return true;
+
+    RenderObject* ro = GetRenderObject(GetEntity());
+    if (ro != nullptr && ro->GetType() == RenderObject::TYPE_SKINNED_MESH)
+        return static_cast<SkinnedMesh*>(ro)->IsVisibleSinceUpdate();
+
+    return true;
+}
+
 Component* SkeletonComponent::Clone(Entity* toEntity)
 {
     SkeletonComponent* newComponent = new SkeletonComponent();
     newComponent->SetEntity(toEntity);
     newComponent->SetJoints(jointsArray);
+    newComponent->animationLods = animationLods;
+    newComponent->invisibleUpdate = invisibleUpdate;
     return newComponent;
 }
 
@@ -116,6 +148,16 @@ void SkeletonComponent::Serialize(KeyedArchive* archive, SerializationContext* s
     }
 
     archive->SetArchive("joints", jointsArch);
+
+    for (int32 i = 0; i < LodComponent::MAX_LOD_LAYERS; ++i)
+    {
+        if (!(animationLods[i] == AnimationLod()))
+        {
+            archive->SetUInt32(Format("animationLod%d.updatePeriod", i), animationLods[i].updatePeriod);
+            archive->SetUInt32(Format("animationLod%d.jointLevelsCount", i), animationLods[i].jointLevelsCount);
+        }
+    }
+    archive->SetUInt32("invisibleUpdate", invisibleUpdate);
 }
 
 void SkeletonComponent::Deserialize(KeyedArchive* archive, SerializationContext* serializationContext)
@@ -139,6 +181,13 @@ void SkeletonComponent::Deserialize(KeyedArchive* archive, SerializationContext*
         joint.bindTransformInv = jointArch->GetMatrix4("joint.invBindPose");
     }
 
+    for (int32 i = 0; i < LodComponent::MAX_LOD_LAYERS; ++i)
+    {
+        animationLods[i].updatePeriod = Max(archive->GetUInt32(Format("animationLod%d.updatePeriod", i), 1), 1u);
+        animationLods[i].jointLevelsCount = archive->GetUInt32(Format("animationLod%d.jointLevelsCount", i), ALL_JOINT_LEVELS);
+    }
+    invisibleUpdate = eInvisibleUpdate(Min(archive->GetUInt32("invisibleUpdate", INVISIBLE_UPDATE_FULL), uint32(INVISIBLE_UPDATE_COUNT) - 1));
+
     UpdateJointsMap();
     UpdateDefaultPose();
 }
@@ -161,4 +210,4 @@ bool AnyCompare<SkeletonComponent::Joint>::IsEqual(const Any& v1, const Any& v2)
 {
     return v1.Get<SkeletonComponent::Joint>() == v2.Get<SkeletonComponent::Joint>();
 }
-}
\ No newline at end of file
+}
\ No newline at end of file
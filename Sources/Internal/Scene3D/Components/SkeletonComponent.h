@@ -8,6 +8,7 @@
 #include "Math/AABBox3.h"
 #include "Reflection/Reflection.h"
 #include "Scene3D/Entity.h"
+#include "Scene3D/Lod/LodComponent.h"
 #include "Scene3D/SceneFile/SerializationContext.h"
 #include "Scene3D/SkeletonAnimation/JointTransform.h"
 #include "Scene3D/SkeletonAnimation/SkeletonPose.h"
@@ -39,6 +40,30 @@ public:
         DAVA_VIRTUAL_REFLECTION(Joint, InspBase);
     };
 
+    const static uint32 ALL_JOINT_LEVELS = 0xffffffff;
+
+    /**
+        Animation level of detail. Selected by current lod layer of entity (see LodComponent),
+        layer 0 is used for entities without LodComponent. Default values keep full quality.
+    */
+    struct AnimationLod
+    {
+        uint32 updatePeriod = 1; //!< Pose is evaluated once per `updatePeriod` frames, evaluated poses are interpolated in between.
+        uint32 jointLevelsCount = ALL_JOINT_LEVELS; //!< Only joints with hierarchy depth less than this value are updated, deeper joints rigidly follow nearest updated parent.
+
+        bool operator==(const AnimationLod& other) const;
+    };
+
+    /** Update mode of skeleton which skinned mesh did not pass visibility tests since last update. */
+    enum eInvisibleUpdate : uint32
+    {
+        INVISIBLE_UPDATE_FULL = 0, //!< Skeleton is updated regardless of visibility.
+        INVISIBLE_UPDATE_ROOT_MOTION, //!< Motions time and root offset are updated, pose is not evaluated and joints are not updated.
+        INVISIBLE_UPDATE_FREEZE, //!< Motions are paused and joints are not updated.
+
+        INVISIBLE_UPDATE_COUNT
+    };
+
     SkeletonComponent() = default;
     ~SkeletonComponent() = default;
 
@@ -48,8 +73,10 @@ public:
 
     void SetJoints(const Vector<Joint>& config);
 
-    const JointTransform& GetJointTransform(uint32 jointIndex) const;
-    const JointTransform& GetJointObjectSpaceTransform(uint32 jointIndex) const;
+    JointTransform GetJointTransform(uint32 jointIndex) const;
+    JointTransform GetJointObjectSpaceTransform(uint32 jointIndex) const;
+    /** Joint bounding box in object space of last update, empty if joint has no bounding box. */
+    const AABBox3& GetJointObjectSpaceBox(uint32 jointIndex) const;
 
     const SkeletonPose& GetDefaultPose() const;
     void ApplyPose(const SkeletonPose& pose);
@@ -59,6 +86,22 @@ public:
     void SetJointOrientation(uint32 jointIndex, const Quaternion& orientation);
     void SetJointScale(uint32 jointIndex, float32 scale);
 
+    /** Set animation lod for lod layer `lodLayer`. The behavior is undefined unless `lodLayer` is in [0, LodComponent::MAX_LOD_LAYERS) range. */
+    void SetAnimationLod(int32 lodLayer, const AnimationLod& lod);
+    const AnimationLod& GetAnimationLod(int32 lodLayer) const;
+
+    /** Return animation lod for current lod layer of entity. */
+    const AnimationLod& GetCurrentAnimationLod() const;
+
+    void SetInvisibleUpdate(eInvisibleUpdate mode);
+    eInvisibleUpdate GetInvisibleUpdate() const;
+
+    /**
+        Return whether skeleton should be animated this frame: skinned mesh of entity passed visibility tests since last skeleton update,
+        or skeleton is updated regardless of visibility. Skeleton without skinned mesh is always animated.
+    */
+    bool IsAnimationVisible() const;
+
     Component* Clone(Entity* toEntity) override;
     void Serialize(KeyedArchive* archive, SerializationContext* serializationContext) override;
     void Deserialize(KeyedArchive* archive, SerializationContext* serializationContext) override;
@@ -79,17 +122,26 @@ private:
     const static uint32 FLAG_MARKED_FOR_UPDATED = INFO_FLAG_BASE << 1;
 
     Vector<uint32> jointInfo; //flags and parent
+    //joints sorted by hierarchy depth, joints of the same level are independent and processed in batches
+    Vector<uint32> levelJoints;
+    Vector<uint32> levelOffsets;
     //transforms info
-    Vector<JointTransform> localSpaceTransforms;
-    Vector<JointTransform> objectSpaceTransforms;
-    Vector<JointTransform> finalTransforms;
+    SkeletonPose localSpaceTransforms;
+    SkeletonPose objectSpaceTransforms;
     //bind pose
-    Vector<JointTransform> inverseBindTransforms;
+    SkeletonPose inverseBindTransforms;
+    //skinning palette in shader layout: (position, scale) and orientation of final transforms
+    Vector<Vector4> finalPositionsScales;
+    Vector<Vector4> finalOrientations;
     //bounding boxes
     Vector<AABBox3> objectSpaceBoxes;
 
     UnorderedMap<FastName, uint32> jointMap;
 
+    Array<AnimationLod, LodComponent::MAX_LOD_LAYERS> animationLods;
+    eInvisibleUpdate invisibleUpdate = INVISIBLE_UPDATE_FULL;
+    uint32 updatedJointLevels = 0; //hierarchy levels updated on last update, deeper joints are outdated; 0 after rebuild
+
     uint32 startJoint = 0u; //first joint in the list that was updated this frame - cache this value to optimize processing
     bool configUpdated = true;
     bool drawSkeleton = false;
@@ -119,40 +171,62 @@ inline const SkeletonComponent::Joint& SkeletonComponent::GetJoint(uint32 jointI
     return jointsArray[jointIndex];
 }
 
-inline const JointTransform& SkeletonComponent::GetJointTransform(uint32 jointIndex) const
+inline JointTransform SkeletonComponent::GetJointTransform(uint32 jointIndex) const
 {
     DVASSERT(jointIndex < GetJointsCount());
-    return localSpaceTransforms[jointIndex];
+    return localSpaceTransforms.GetJointTransform(jointIndex);
+}
+
+inline JointTransform SkeletonComponent::GetJointObjectSpaceTransform(uint32 jointIndex) const
+{
+    DVASSERT(jointIndex < objectSpaceTransforms.GetJointsCount());
+    return objectSpaceTransforms.GetJointTransform(jointIndex);
 }
 
-inline const JointTransform& SkeletonComponent::GetJointObjectSpaceTransform(uint32 jointIndex) const
+inline const AABBox3& SkeletonComponent::GetJointObjectSpaceBox(uint32 jointIndex) const
 {
-    DVASSERT(jointIndex < objectSpaceTransforms.size());
-    return objectSpaceTransforms[jointIndex];
+    DVASSERT(jointIndex < uint32(objectSpaceBoxes.size()));
+    return objectSpaceBoxes[jointIndex];
 }
 
 inline void SkeletonComponent::SetJointTransform(uint32 jointIndex, const JointTransform& transform)
 {
     SetJointUpdated(jointIndex);
-    localSpaceTransforms[jointIndex] = transform;
+    localSpaceTransforms.SetTransform(jointIndex, transform);
 }
 
 inline void SkeletonComponent::SetJointPosition(uint32 jointIndex, const Vector3& position)
 {
     SetJointUpdated(jointIndex);
-    localSpaceTransforms[jointIndex].SetPosition(position);
+    localSpaceTransforms.SetPosition(jointIndex, position);
 }
 
 inline void SkeletonComponent::SetJointOrientation(uint32 jointIndex, const Quaternion& orientation)
 {
     SetJointUpdated(jointIndex);
-    localSpaceTransforms[jointIndex].SetOrientation(orientation);
+    localSpaceTransforms.SetOrientation(jointIndex, orientation);
 }
 
 inline void SkeletonComponent::SetJointScale(uint32 jointIndex, float32 scale)
 {
     SetJointUpdated(jointIndex);
-    localSpaceTransforms[jointIndex].SetScale(scale);
+    localSpaceTransforms.SetScale(jointIndex, scale);
+}
+
+inline const SkeletonComponent::AnimationLod& SkeletonComponent::GetAnimationLod(int32 lodLayer) const
+{
+    DVASSERT(0 <= lodLayer && lodLayer < LodComponent::MAX_LOD_LAYERS);
+    return animationLods[lodLayer];
+}
+
+inline void SkeletonComponent::SetInvisibleUpdate(eInvisibleUpdate mode)
+{
+    invisibleUpdate = mode;
+}
+
+inline SkeletonComponent::eInvisibleUpdate SkeletonComponent::GetInvisibleUpdate() const
+{
+    return invisibleUpdate;
 }
 
 inline void SkeletonComponent::SetJointUpdated(uint32 jointIndex)
@@ -10,6 +10,7 @@
 #include "Core/PerformanceSettings.h"
 #include "Debug/ProfilerCPU.h"
 #include "Debug/ProfilerMarkerNames.h"
+#include "Entity/ComponentUtils.h"
 #include "Scene3D/Systems/EventSystem.h"
 
 namespace DAVA
@@ -17,6 +18,8 @@ namespace DAVA
 LodSystem::LodSystem(Scene* scene)
     : SceneSystem(scene)
 {
+    SetProcessComponentsAccess(ComponentUtils::MakeMask<TransformComponent>(), ComponentUtils::MakeMask<LodComponent, ParticleEffectComponent, RenderComponent>());
+
     scene->GetEventSystem()->RegisterSystemForEvent(this, EventSystem::START_PARTICLE_EFFECT);
     scene->GetEventSystem()->RegisterSystemForEvent(this, EventSystem::STOP_PARTICLE_EFFECT);
     scene->GetEventSystem()->RegisterSystemForEvent(this, EventSystem::LOD_DISTANCE_CHANGED);
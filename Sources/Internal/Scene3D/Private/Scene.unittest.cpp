@@ -2,6 +2,8 @@
 #include "Scene3D/Scene.h"
 #include "Entity/SceneSystem.h"
 #include "Entity/SingletonComponent.h"
+#include "Scene3D/Components/RenderComponent.h"
+#include "Scene3D/Components/TransformComponent.h"
 
 using namespace DAVA;
 
@@ -69,4 +71,63 @@ DAVA_TESTCLASS (SceneTest)
         scene->RemoveSingletonComponent(myComponent);
         TEST_VERIFY(scene->GetSingletonComponent<MyComponent>() == nullptr);
     }
+
+    DAVA_TEST (ArchetypeQuery)
+    {
+        Scene* scene = new Scene(0);
+        SCOPE_EXIT
+        {
+            SafeRelease(scene);
+        };
+
+        auto verifyQuery = [scene](uint32 expectedWithRender) {
+            uint32 count = 0;
+            scene->Query<TransformComponent, RenderComponent>().ForEach([&count](Entity* e, TransformComponent* tc, RenderComponent* rc) {
+                TEST_VERIFY(e->GetComponent<TransformComponent>() == tc);
+                TEST_VERIFY(e->GetComponent<RenderComponent>() == rc);
+                ++count;
+            });
+            TEST_VERIFY(count == expectedWithRender);
+        };
+
+        // entities added before storage is enabled
+        const uint32 entitiesCount = 300;
+        Vector<Entity*> entities;
+        for (uint32 i = 0; i < entitiesCount; ++i)
+        {
+            Entity* e = new Entity();
+            if (i % 2 == 0)
+            {
+                e->AddComponent(new RenderComponent());
+            }
+            scene->AddNode(e);
+            entities.push_back(e);
+            e->Release();
+        }
+
+        scene->SetArchetypeStorageEnabled(true);
+        TEST_VERIFY(scene->Query<TransformComponent>().GetEntitiesCount() == entitiesCount);
+        verifyQuery(entitiesCount / 2);
+
+        // entities added after storage is enabled
+        Entity* child = new Entity();
+        child->AddComponent(new RenderComponent());
+        entities[1]->AddNode(child);
+        child->Release();
+        verifyQuery(entitiesCount / 2 + 1);
+
+        // change components
+        entities[0]->RemoveComponent<RenderComponent>();
+        entities[3]->AddComponent(new RenderComponent());
+        verifyQuery(entitiesCount / 2 + 1);
+
+        // remove entities, including one with child
+        scene->RemoveNode(entities[1]);
+        scene->RemoveNode(entities[2]);
+        TEST_VERIFY(scene->Query<TransformComponent>().GetEntitiesCount() == entitiesCount - 2);
+        verifyQuery(entitiesCount / 2 - 1);
+
+        scene->SetArchetypeStorageEnabled(false);
+        TEST_VERIFY(scene->IsArchetypeStorageEnabled() == false);
+    }
 };
\ No newline at end of file
@@ -4,7 +4,9 @@
 #include "Debug/ProfilerCPU.h"
 #include "Debug/ProfilerMarkerNames.h"
 #include "Entity/ComponentUtils.h"
+#include "Engine/Engine.h"
 #include "FileSystem/FileSystem.h"
+#include "Job/JobManager.h"
 #include "Render/3D/StaticMesh.h"
 #include "Render/Highlevel/Landscape.h"
 #include "Render/Highlevel/Light.h"
@@ -475,6 +477,7 @@ Scene::~Scene()
 
     cache.ClearAll();
 
+    SafeDelete(archetypeStorage);
     SafeDelete(eventSystem);
     SafeDelete(renderSystem);
 }
@@ -493,6 +496,11 @@ void Scene::RegisterEntity(Entity* entity)
     {
         system->RegisterEntity(entity);
     }
+
+    if (archetypeStorage != nullptr)
+    {
+        archetypeStorage->AddEntity(entity);
+    }
 }
 
 void Scene::UnregisterEntity(Entity* entity)
@@ -517,6 +525,11 @@ void Scene::UnregisterEntity(Entity* entity)
     {
         system->UnregisterEntity(entity);
     }
+
+    if (archetypeStorage != nullptr)
+    {
+        archetypeStorage->RemoveEntity(entity);
+    }
 }
 
 void Scene::RegisterEntitiesInSystemRecursively(SceneSystem* system, Entity* entity)
@@ -526,6 +539,16 @@ void Scene::RegisterEntitiesInSystemRecursively(SceneSystem* system, Entity* ent
         RegisterEntitiesInSystemRecursively(system, entity->GetChild(i));
 }
 
+void Scene::RegisterEntitiesInArchetypeStorageRecursively(Entity* entity)
+{
+    for (int32 i = 0, sz = entity->GetChildrenCount(); i < sz; ++i)
+    {
+        Entity* child = entity->GetChild(i);
+        archetypeStorage->AddEntity(child);
+        RegisterEntitiesInArchetypeStorageRecursively(child);
+    }
+}
+
 void Scene::RegisterComponent(Entity* entity, Component* component)
 {
     DVASSERT(entity && component);
@@ -534,6 +557,11 @@ void Scene::RegisterComponent(Entity* entity, Component* component)
     {
         systems[k]->RegisterComponent(entity, component);
     }
+
+    if (archetypeStorage != nullptr)
+    {
+        archetypeStorage->InvalidateEntity(entity);
+    }
 }
 
 void Scene::UnregisterComponent(Entity* entity, Component* component)
@@ -544,6 +572,11 @@ void Scene::UnregisterComponent(Entity* entity, Component* component)
     {
         systems[k]->UnregisterComponent(entity, component);
     }
+
+    if (archetypeStorage != nullptr)
+    {
+        archetypeStorage->InvalidateEntity(entity);
+    }
 }
 
 void Scene::AddSystem(SceneSystem* sceneSystem, const ComponentMask& componentMask, uint32 processFlags /*= 0*/, SceneSystem* insertBeforeSceneForProcess /* = nullptr */, SceneSystem* insertBeforeSceneForInput /* = nullptr*/, SceneSystem* insertBeforeSceneForFixedProcess)
@@ -690,24 +723,33 @@ void Scene::Update(float32 timeElapsed)
         fixedUpdate.lastTime -= fixedUpdate.constantTime;
     }
 
-    for (SceneSystem* system : systemsToProcess)
+    if (parallelProcessEnabled)
     {
-        if ((systemsMask & SCENE_SYSTEM_UPDATEBLE_FLAG) && system == transformSystem)
-        {
-            updatableSystem->UpdatePreTransform(timeElapsed);
-            transformSystem->Process(timeElapsed);
-            updatableSystem->UpdatePostTransform(timeElapsed);
-        }
-        else if (system == lodSystem)
+        JobManager* jobManager = GetEngineContext()->jobManager;
+
+        // consecutive systems with declared access are gathered into task graph,
+        // any other system waits for them and is processed on this thread
+        for (SceneSystem* system : systemsToProcess)
         {
-            if (Renderer::GetOptions()->IsOptionEnabled(RenderOptions::UPDATE_LODS))
+            if (system->IsProcessComponentsAccessDeclared())
+            {
+                processGraph.AddTask([this, system, timeElapsed]() { ProcessSystem(system, timeElapsed); },
+                                     system->GetProcessReadComponents(), system->GetProcessWriteComponents());
+            }
+            else
             {
-                lodSystem->Process(timeElapsed);
+                ExecuteProcessGraph(jobManager);
+                ProcessSystem(system, timeElapsed);
             }
         }
-        else
+
+        ExecuteProcessGraph(jobManager);
+    }
+    else
+    {
+        for (SceneSystem* system : systemsToProcess)
         {
-            system->Process(timeElapsed);
+            ProcessSystem(system, timeElapsed);
         }
     }
 
@@ -726,6 +768,70 @@ void Scene::Update(float32 timeElapsed)
     sceneGlobalTime += timeElapsed;
 }
 
+void Scene::ProcessSystem(SceneSystem* system, float32 timeElapsed)
+{
+    if ((systemsMask & SCENE_SYSTEM_UPDATEBLE_FLAG) && system == transformSystem)
+    {
+        updatableSystem->UpdatePreTransform(timeElapsed);
+        transformSystem->Process(timeElapsed);
+        updatableSystem->UpdatePostTransform(timeElapsed);
+    }
+    else if (system == lodSystem)
+    {
+        if (Renderer::GetOptions()->IsOptionEnabled(RenderOptions::UPDATE_LODS))
+        {
+            lodSystem->Process(timeElapsed);
+        }
+    }
+    else
+    {
+        system->Process(timeElapsed);
+    }
+}
+
+void Scene::ExecuteProcessGraph(JobManager* jobManager)
+{
+    if (!processGraph.IsEmpty())
+    {
+        // systems in graph may query archetype storage concurrently, so it should be synced beforehand
+        if (archetypeStorage != nullptr)
+        {
+            archetypeStorage->Sync();
+        }
+
+        processGraph.Execute(jobManager);
+        processGraph.Clear();
+    }
+}
+
+void Scene::SetParallelProcessEnabled(bool enabled)
+{
+    parallelProcessEnabled = enabled;
+}
+
+bool Scene::IsParallelProcessEnabled() const
+{
+    return parallelProcessEnabled;
+}
+
+void Scene::SetArchetypeStorageEnabled(bool enabled)
+{
+    if (enabled && archetypeStorage == nullptr)
+    {
+        archetypeStorage = new ArchetypeStorage();
+        RegisterEntitiesInArchetypeStorageRecursively(this);
+    }
+    else if (!enabled)
+    {
+        SafeDelete(archetypeStorage);
+    }
+}
+
+bool Scene::IsArchetypeStorageEnabled() const
+{
+    return (archetypeStorage != nullptr);
+}
+
 void Scene::Draw()
 {
     DAVA_PROFILER_CPU_SCOPE(ProfilerCPUMarkerName::SCENE_DRAW)
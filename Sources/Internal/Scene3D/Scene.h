@@ -3,8 +3,10 @@
 #include "Base/BaseMath.h"
 #include "Base/BaseTypes.h"
 #include "Base/Observer.h"
+#include "Entity/EntityQuery.h"
 #include "Entity/SceneSystem.h"
 #include "Entity/SingletonComponent.h"
+#include "Job/TaskGraph.h"
 #include "Render/Highlevel/Camera.h"
 #include "Render/Highlevel/Light.h"
 #include "Reflection/Reflection.h"
@@ -206,6 +208,30 @@ public:
 
     virtual void Update(float32 timeElapsed);
     virtual void Draw();
+
+    /**
+        \brief Enable or disable concurrent processing of systems on worker threads.
+               Only systems with declared components access (see SceneSystem::SetProcessComponentsAccess) are processed concurrently,
+               other systems are processed on the calling thread in usual order and act as synchronization points.
+     */
+    void SetParallelProcessEnabled(bool enabled);
+    bool IsParallelProcessEnabled() const;
+
+    /**
+        \brief Enable or disable archetype storage, which groups scene entities by components into packed chunks.
+               Storage is required for `Query`. Enabling storage registers all entities which are already in scene.
+     */
+    void SetArchetypeStorageEnabled(bool enabled);
+    bool IsArchetypeStorageEnabled() const;
+
+    /**
+        \brief Return query over all scene entities which have components of all types `T...`.
+               Archetype storage should be enabled with `SetArchetypeStorageEnabled`.
+               Can be called concurrently from systems processed in parallel (see `SetParallelProcessEnabled`): storage is synced
+               before they are run and only read by queries. Entities and components should not be added or removed meanwhile.
+     */
+    template <typename... T>
+    EntityQuery<T...> Query();
     void SceneDidLoaded() override;
 
     Camera* GetCamera(int32 n);
@@ -260,14 +286,22 @@ public: // deprecated methods
 
 protected:
     void RegisterEntitiesInSystemRecursively(SceneSystem* system, Entity* entity);
+    void RegisterEntitiesInArchetypeStorageRecursively(Entity* entity);
 
     bool RemoveSystem(Vector<SceneSystem*>& storage, SceneSystem* system);
+    void ProcessSystem(SceneSystem* system, float32 timeElapsed);
+    void ExecuteProcessGraph(JobManager* jobManager);
 
     uint32 systemsMask;
     uint32 maxEntityIDCounter;
 
     float32 sceneGlobalTime = 0.f;
 
+    bool parallelProcessEnabled = false;
+    TaskGraph processGraph;
+
+    ArchetypeStorage* archetypeStorage = nullptr;
+
     Vector<Camera*> cameras;
 
     NMaterial* sceneGlobalMaterial;
@@ -321,6 +355,13 @@ T* Scene::GetSingletonComponent()
     return res;
 }
 
+template <typename... T>
+EntityQuery<T...> Scene::Query()
+{
+    DVASSERT(archetypeStorage != nullptr, "Archetype storage should be enabled to use queries");
+    return EntityQuery<T...>(archetypeStorage);
+}
+
 int32 Scene::GetCameraCount()
 {
     return static_cast<int32>(cameras.size());
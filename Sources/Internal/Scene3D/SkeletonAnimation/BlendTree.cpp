@@ -49,7 +49,7 @@ float32 BlendTree::EvaluatePhaseDuration(uint32 phaseIndex, const Vector<const f
     return duration;
 }
 
-void BlendTree::EvaluateRootOffset(uint32 phaseIndex0, float32 phase0, uint32 phaseIndex1, float32 phase1, const Vector<const float32*>& parameters, Vector3* outOffset)
+void BlendTree::EvaluateRootOffset(uint32 phaseIndex0, float32 phase0, uint32 phaseIndex1, float32 phase1, const Vector<const float32*>& parameters, Vector3* outOffset) const
 {
     EvaluateRecursive(phaseIndex0, phase0, phaseIndex1, phase1, nodes.front(), parameters, nullptr, nullptr, outOffset);
 }
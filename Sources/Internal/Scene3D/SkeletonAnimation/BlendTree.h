@@ -43,9 +43,10 @@ public:
     void BindSkeleton(const SkeletonComponent* skeleton);
     void BindRootNode(const FastName& rootNodeID);
 
+    // Evaluation functions do not modify blend tree, so one tree can be evaluated for several skeletons concurrently
     void EvaluatePose(uint32 phaseIndex, float32 phase, const Vector<const float32*>& parameters, SkeletonPose* outPose) const;
     float32 EvaluatePhaseDuration(uint32 phaseIndex, const Vector<const float32*>& parameters) const;
-    void EvaluateRootOffset(uint32 phaseIndex0, float32 phase0, uint32 phaseIndex1, float32 phase1, const Vector<const float32*>& parameters, Vector3* outOffset);
+    void EvaluateRootOffset(uint32 phaseIndex0, float32 phase0, uint32 phaseIndex1, float32 phase1, const Vector<const float32*>& parameters, Vector3* outOffset) const;
 
     const Vector<FastName>& GetParameterIDs() const;
     const Vector<MarkerInfo>& GetMarkersInfo() const;
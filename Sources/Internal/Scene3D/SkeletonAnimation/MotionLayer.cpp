@@ -32,7 +32,7 @@ void MotionLayer::TriggerEvent(const FastName& trigger)
     }
 }
 
-void MotionLayer::Update(float32 dTime)
+void MotionLayer::Update(float32 dTime, bool evaluatePose)
 {
     if (pendingMotion != nullptr)
     {
@@ -99,15 +99,29 @@ void MotionLayer::Update(float32 dTime)
 
     //////////////////////////////////////////////////////////////////////////
 
-    currentPose.Reset();
-    if (nextMotion != nullptr) //transition is active
+    if (evaluatePose)
     {
-        motionTransition.Evaluate(&currentPose, &currentRootOffsetDelta);
+        currentPose.Reset();
+        if (nextMotion != nullptr) //transition is active
+        {
+            motionTransition.Evaluate(&currentPose, &currentRootOffsetDelta);
+        }
+        else
+        {
+            currentMotion->EvaluatePose(&currentPose);
+            currentMotion->GetRootOffsetDelta(&currentRootOffsetDelta);
+        }
     }
     else
     {
-        currentMotion->EvaluatePose(&currentPose);
-        currentMotion->GetRootOffsetDelta(&currentRootOffsetDelta);
+        if (nextMotion != nullptr) //transition is active
+        {
+            motionTransition.EvaluateRootOffset(&currentRootOffsetDelta);
+        }
+        else
+        {
+            currentMotion->GetRootOffsetDelta(&currentRootOffsetDelta);
+        }
     }
 
     //////////////////////////////////////////////////////////////////////////
@@ -125,7 +139,7 @@ void MotionLayer::Update(float32 dTime)
 
     currentRootOffsetDelta *= rootExtractionMask;
 
-    if (rootNodeJointIndex != SkeletonComponent::INVALID_JOINT_INDEX)
+    if (evaluatePose && rootNodeJointIndex != SkeletonComponent::INVALID_JOINT_INDEX)
     {
         Vector3 rootPosition = currentPose.GetJointTransform(rootNodeJointIndex).GetPosition();
         rootPosition *= rootResetMask;
@@ -42,7 +42,11 @@ public:
 
     void TriggerEvent(const FastName& trigger); //TODO: *Skinning* make adequate naming
 
-    void Update(float32 dTime);
+    /**
+        Advance motions by `dTime`, collect reached markers and ended motions, evaluate root offset.
+        Pose is evaluated only if `evaluatePose` is true, otherwise current pose keeps value of last evaluation.
+    */
+    void Update(float32 dTime, bool evaluatePose = true);
 
     void BindSkeleton(const SkeletonComponent* skeleton);
 
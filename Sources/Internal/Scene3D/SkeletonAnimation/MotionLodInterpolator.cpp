@@ -0,0 +1,83 @@
+#include "Scene3D/SkeletonAnimation/MotionLodInterpolator.h"
+
+namespace DAVA
+{
+bool MotionLodInterpolator::Advance(uint32 updatePeriod_, float32 dTime, float32* evaluationTime)
+{
+    DVASSERT(updatePeriod_ > 0);
+
+    elapsedTime += dTime;
+    if (updatePeriod_ > 1 && updatePeriod_ == updatePeriod && hasPose && ++frame < updatePeriod)
+    {
+        UpdateFrame();
+        return false;
+    }
+
+    *evaluationTime = elapsedTime;
+    elapsedTime = 0.f;
+    frame = 0;
+    periodChanged = (updatePeriod != updatePeriod_);
+    updatePeriod = updatePeriod_;
+    return true;
+}
+
+void MotionLodInterpolator::SetEvaluated(const SkeletonPose* evaluatedPose, const Vector3& evaluatedRootOffsetDelta)
+{
+    if (evaluatedPose != nullptr && updatePeriod > 1)
+    {
+        // blend between two last evaluated poses, there is nothing to blend from after period change
+        if (hasPose && !periodChanged)
+            std::swap(previousPose, targetPose);
+        else
+            previousPose = *evaluatedPose;
+
+        targetPose = *evaluatedPose;
+        hasPose = true;
+    }
+    else
+    {
+        // poses evaluated every frame are applied as is
+        hasPose = false;
+    }
+
+    // root offset is spread only over frames which are skipped till next evaluation,
+    // offset which is not applied yet (e.g. period is changed in the middle) is applied with the new one
+    rootOffsetPending += evaluatedRootOffsetDelta;
+    rootOffsetFrames = hasPose ? updatePeriod : 1;
+
+    UpdateFrame();
+}
+
+void MotionLodInterpolator::UpdateFrame()
+{
+    if (hasPose)
+    {
+        float32 factor = float32(frame + 1) / float32(updatePeriod);
+        pose = previousPose;
+        pose.Lerp(targetPose, factor);
+    }
+
+    if (rootOffsetFrames > 0)
+    {
+        rootOffsetDelta = rootOffsetPending / float32(rootOffsetFrames);
+        rootOffsetPending -= rootOffsetDelta;
+        --rootOffsetFrames;
+    }
+    else
+    {
+        rootOffsetDelta = Vector3();
+    }
+}
+
+void MotionLodInterpolator::Reset()
+{
+    rootOffsetPending = Vector3();
+    rootOffsetDelta = Vector3();
+    rootOffsetFrames = 0;
+    elapsedTime = 0.f;
+    updatePeriod = 1;
+    frame = 0;
+    periodChanged = false;
+    hasPose = false;
+}
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Math/Vector.h"
+#include "Scene3D/SkeletonAnimation/SkeletonPose.h"
+
+namespace DAVA
+{
+/**
+    Animation lod state of motions: pose and root offset are evaluated once per `updatePeriod` frames.
+
+    Frames till next evaluation blend from previously evaluated pose to the last evaluated one, and root offset
+    evaluated for the whole accumulated time is spread evenly over the same frames. So root motion stays in sync
+    with pose, both are shown `updatePeriod - 1` frames behind evaluated time.
+    Usage, every frame:
+    \code
+    float32 evaluationTime = 0.f;
+    if (interpolator.Advance(updatePeriod, dTime, &evaluationTime))
+    {
+        // evaluate motions for `evaluationTime`
+        interpolator.SetEvaluated(&pose, rootOffsetDelta);
+    }
+    // apply interpolator.GetRootOffsetDelta() and interpolator.GetPose() if interpolator.HasPose(), evaluated pose otherwise
+    \endcode
+*/
+class MotionLodInterpolator
+{
+public:
+    /**
+        Accumulate `dTime` and return true if motions should be evaluated this frame. In this case `evaluationTime`
+        is set to time accumulated since last evaluation and `SetEvaluated` should be called.
+        Changed `updatePeriod` causes evaluation right away.
+    */
+    bool Advance(uint32 updatePeriod, float32 dTime, float32* evaluationTime);
+
+    /**
+        Set pose and root offset evaluated for time returned by `Advance`.
+        `pose` is nullptr if only root offset was evaluated, next frames are evaluated until pose is set.
+    */
+    void SetEvaluated(const SkeletonPose* pose, const Vector3& rootOffsetDelta);
+
+    /**
+        Interpolated pose of current frame. Exists only if update period is above one and evaluated pose was set,
+        otherwise evaluated pose should be applied as is.
+    */
+    const SkeletonPose& GetPose() const;
+    bool HasPose() const;
+
+    /** Part of evaluated root offset which corresponds to current frame. */
+    const Vector3& GetRootOffsetDelta() const;
+
+    void Reset();
+
+private:
+    void UpdateFrame();
+
+    SkeletonPose previousPose;
+    SkeletonPose targetPose;
+    SkeletonPose pose;
+
+    Vector3 rootOffsetPending;
+    Vector3 rootOffsetDelta;
+    uint32 rootOffsetFrames = 0;
+
+    float32 elapsedTime = 0.f;
+    uint32 updatePeriod = 1;
+    uint32 frame = 0;
+    bool periodChanged = false;
+    bool hasPose = false;
+};
+
+inline const SkeletonPose& MotionLodInterpolator::GetPose() const
+{
+    DVASSERT(hasPose);
+    return pose;
+}
+
+inline bool MotionLodInterpolator::HasPose() const
+{
+    return hasPose;
+}
+
+inline const Vector3& MotionLodInterpolator::GetRootOffsetDelta() const
+{
+    return rootOffsetDelta;
+}
+}
@@ -127,9 +127,7 @@ void MotionTransition::Evaluate(SkeletonPose* outPose, Vector3* outOffset)
             Vector3 dstOffset;
             dstMotion->GetRootOffsetDelta(&dstOffset);
 
-            Interpolation::Func func = transitionInfo->func;
-            float32 lerpFactor = inversed ? (1.f - func(1.f - transitionPhase)) : func(transitionPhase);
-
+            float32 lerpFactor = GetLerpFactor();
             outPose->Lerp(workPose, lerpFactor);
             outOffset->Lerp(*outOffset, dstOffset, lerpFactor);
         }
@@ -141,6 +139,38 @@ void MotionTransition::Evaluate(SkeletonPose* outPose, Vector3* outOffset)
     }
 }
 
+void MotionTransition::EvaluateRootOffset(Vector3* outOffset)
+{
+    if (IsStarted())
+    {
+        if (transitionInfo->type == MotionTransitionInfo::TYPE_REPLACE)
+        {
+            dstMotion->GetRootOffsetDelta(outOffset);
+        }
+        else
+        {
+            if (srcFrozen)
+                *outOffset = frozenOffset;
+            else
+                srcMotion->GetRootOffsetDelta(outOffset);
+
+            Vector3 dstOffset;
+            dstMotion->GetRootOffsetDelta(&dstOffset);
+            outOffset->Lerp(*outOffset, dstOffset, GetLerpFactor());
+        }
+    }
+    else
+    {
+        srcMotion->GetRootOffsetDelta(outOffset);
+    }
+}
+
+float32 MotionTransition::GetLerpFactor() const
+{
+    Interpolation::Func func = transitionInfo->func;
+    return inversed ? (1.f - func(1.f - transitionPhase)) : func(transitionPhase);
+}
+
 bool MotionTransition::CanBeInterrupted(const MotionTransitionInfo* other, const Motion* newSrcMotion, const Motion* newDstMotion) const
 {
     DVASSERT(other != nullptr);
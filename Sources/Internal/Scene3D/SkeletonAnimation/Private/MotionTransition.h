@@ -59,6 +59,7 @@ public:
 
     void Update(float32 dTime);
     void Evaluate(SkeletonPose* outPose, Vector3* outOffset);
+    void EvaluateRootOffset(Vector3* outOffset); //the same offset as `Evaluate` without pose evaluation
 
     bool IsComplete() const;
     bool IsStarted() const;
@@ -67,6 +68,8 @@ public:
     void Interrupt(const MotionTransitionInfo* other, Motion* srcMotion, Motion* dstMotion);
 
 protected:
+    float32 GetLerpFactor() const;
+
     const MotionTransitionInfo* transitionInfo = nullptr;
 
     Motion* srcMotion = nullptr;
@@ -73,7 +73,7 @@ void SkeletonAnimation::BindRootNode(const FastName& rootNodeID)
     }
 }
 
-void SkeletonAnimation::EvaluatePose(float32 animationLocalTime, SkeletonPose* outPose)
+void SkeletonAnimation::EvaluatePose(float32 animationLocalTime, SkeletonPose* outPose) const
 {
     if (animationClips.empty())
         return;
@@ -81,7 +81,7 @@ void SkeletonAnimation::EvaluatePose(float32 animationLocalTime, SkeletonPose* o
     DVASSERT(outPose);
     outPose->SetJointCount(maxJointIndex + 1);
 
-    SkeletonAnimationClip* clip = FindClip(animationLocalTime);
+    const SkeletonAnimationClip* clip = FindClip(animationLocalTime);
 
     uint32 boundTrackCount = uint32(clip->boundTracks.size());
     for (uint32 t = 0; t < boundTrackCount; ++t)
@@ -93,13 +93,13 @@ void SkeletonAnimation::EvaluatePose(float32 animationLocalTime, SkeletonPose* o
     }
 }
 
-void SkeletonAnimation::EvaluateRootOffset(float32 animationLocalTime0, float32 animationLocalTime1, Vector3* offset)
+void SkeletonAnimation::EvaluateRootOffset(float32 animationLocalTime0, float32 animationLocalTime1, Vector3* offset) const
 {
     if (animationClips.empty())
         return;
 
-    SkeletonAnimationClip* clip0 = FindClip(animationLocalTime0);
-    SkeletonAnimationClip* clip1 = FindClip(animationLocalTime1);
+    const SkeletonAnimationClip* clip0 = FindClip(animationLocalTime0);
+    const SkeletonAnimationClip* clip1 = FindClip(animationLocalTime1);
 
     if (animationLocalTime0 > animationLocalTime1 || clip0 != clip1)
     {
@@ -122,7 +122,7 @@ void SkeletonAnimation::EvaluateRootOffset(float32 animationLocalTime0, float32
     }
 }
 
-void SkeletonAnimation::EvaluateRootPosition(float32 animationLocalTime, Vector3* offset)
+void SkeletonAnimation::EvaluateRootPosition(float32 animationLocalTime, Vector3* offset) const
 {
     if (animationClips.empty())
         return;
@@ -174,7 +174,7 @@ JointTransform SkeletonAnimation::EvaluateJointTransform(float32 time, const Ani
     return transform;
 }
 
-void SkeletonAnimation::EvaluateRootPosition(SkeletonAnimationClip* clip, float32 animationLocalTime, Vector3* outPosition)
+void SkeletonAnimation::EvaluateRootPosition(const SkeletonAnimationClip* clip, float32 animationLocalTime, Vector3* outPosition) const
 {
     DVASSERT(clip != nullptr);
 
@@ -184,7 +184,7 @@ void SkeletonAnimation::EvaluateRootPosition(SkeletonAnimationClip* clip, float3
     }
 }
 
-SkeletonAnimation::SkeletonAnimationClip* SkeletonAnimation::FindClip(float32 animationTime)
+const SkeletonAnimation::SkeletonAnimationClip* SkeletonAnimation::FindClip(float32 animationTime) const
 {
     DVASSERT(!animationClips.empty());
 
@@ -198,7 +198,7 @@ SkeletonAnimation::SkeletonAnimationClip* SkeletonAnimation::FindClip(float32 an
     return &(*found);
 }
 
-float32 SkeletonAnimation::GetClipLocalTime(SkeletonAnimationClip* clip, float32 animationLocalTime)
+float32 SkeletonAnimation::GetClipLocalTime(const SkeletonAnimationClip* clip, float32 animationLocalTime) const
 {
     return clip->clipStartTimestamp + animationLocalTime - clip->animationStartTimestamp;
 }
@@ -18,9 +18,11 @@ public:
     void BindSkeleton(const SkeletonComponent* skeleton);
     void BindRootNode(const FastName& rootNodeID);
 
-    void EvaluatePose(float32 animationLocalTime, SkeletonPose* outPose);
-    void EvaluateRootPosition(float32 animationLocalTime, Vector3* offset);
-    void EvaluateRootOffset(float32 animationLocalTime0, float32 animationLocalTime1, Vector3* offset);
+    // Evaluation does not modify animation and bound clips, so the same animation
+    // can be evaluated for several skeletons from different threads
+    void EvaluatePose(float32 animationLocalTime, SkeletonPose* outPose) const;
+    void EvaluateRootPosition(float32 animationLocalTime, Vector3* offset) const;
+    void EvaluateRootOffset(float32 animationLocalTime0, float32 animationLocalTime1, Vector3* offset) const;
 
     float32 GetDuration() const;
 
@@ -40,9 +42,9 @@ protected:
     };
 
     static JointTransform EvaluateJointTransform(float32 time, const AnimationTrack* track);
-    void EvaluateRootPosition(SkeletonAnimationClip* clip, float32 animationLocalTime, Vector3* outPosition);
-    SkeletonAnimationClip* FindClip(float32 animationTime);
-    float32 GetClipLocalTime(SkeletonAnimationClip* clip, float32 animationLocalTime);
+    void EvaluateRootPosition(const SkeletonAnimationClip* clip, float32 animationLocalTime, Vector3* outPosition) const;
+    const SkeletonAnimationClip* FindClip(float32 animationTime) const;
+    float32 GetClipLocalTime(const SkeletonAnimationClip* clip, float32 animationLocalTime) const;
 
     Vector<SkeletonAnimationClip> animationClips;
     uint32 maxJointIndex = 0;
@@ -8,6 +8,22 @@ SkeletonPose::SkeletonPose(uint32 jointCount)
     SetJointCount(jointCount);
 }
 
+void SkeletonPose::SetJointCount(uint32 jointCount)
+{
+    positions.resize(jointCount, Vector3());
+    orientations.resize(jointCount, Quaternion());
+    scales.resize(jointCount, 1.f);
+    flags.resize(jointCount, 0);
+}
+
+void SkeletonPose::Reset()
+{
+    std::fill(positions.begin(), positions.end(), Vector3());
+    std::fill(orientations.begin(), orientations.end(), Quaternion());
+    std::fill(scales.begin(), scales.end(), 1.f);
+    std::fill(flags.begin(), flags.end(), uint8(0));
+}
+
 void SkeletonPose::Add(const SkeletonPose& other)
 {
     uint32 jointCount = other.GetJointsCount();
@@ -15,8 +31,8 @@ void SkeletonPose::Add(const SkeletonPose& other)
 
     for (uint32 j = 0; j < jointCount; ++j)
     {
-        const JointTransform& transform0 = GetJointTransform(j);
-        const JointTransform& transform1 = other.GetJointTransform(j);
+        JointTransform transform0 = GetJointTransform(j);
+        JointTransform transform1 = other.GetJointTransform(j);
         SetTransform(j, transform0.AppendTransform(transform1));
     }
 }
@@ -28,8 +44,8 @@ void SkeletonPose::Diff(const SkeletonPose& other)
 
     for (uint32 j = 0; j < jointCount; ++j)
     {
-        const JointTransform& transform0 = GetJointTransform(j);
-        const JointTransform& transform1 = other.GetJointTransform(j);
+        JointTransform transform0 = GetJointTransform(j);
+        JointTransform transform1 = other.GetJointTransform(j);
         SetTransform(j, transform0.GetInverse().AppendTransform(transform1));
     }
 }
@@ -39,11 +55,18 @@ void SkeletonPose::Override(const SkeletonPose& other)
     uint32 jointCount = other.GetJointsCount();
     SetJointCount(Max(GetJointsCount(), jointCount));
 
+    //copy only components present in `other`, the same as JointTransform::Override
     for (uint32 j = 0; j < jointCount; ++j)
     {
-        const JointTransform& transform0 = GetJointTransform(j);
-        const JointTransform& transform1 = other.GetJointTransform(j);
-        SetTransform(j, JointTransform::Override(transform0, transform1));
+        uint8 otherFlags = other.flags[j];
+        if (otherFlags & JointTransform::FLAG_POSITION)
+            positions[j] = other.positions[j];
+        if (otherFlags & JointTransform::FLAG_ORIENTATION)
+            orientations[j] = other.orientations[j];
+        if (otherFlags & JointTransform::FLAG_SCALE)
+            scales[j] = other.scales[j];
+
+        flags[j] |= otherFlags;
     }
 }
 
@@ -54,10 +77,10 @@ void SkeletonPose::Lerp(const SkeletonPose& other, float32 factor)
 
     for (uint32 j = 0; j < jointCount; ++j)
     {
-        const JointTransform& transform0 = GetJointTransform(j);
-        const JointTransform& transform1 = other.GetJointTransform(j);
+        JointTransform transform0 = GetJointTransform(j);
+        JointTransform transform1 = other.GetJointTransform(j);
         SetTransform(j, JointTransform::Lerp(transform0, transform1, factor));
     }
 }
 
-} //ns
\ No newline at end of file
+} //ns
@@ -1,10 +1,15 @@
 #pragma once
 
 #include "Base/BaseTypes.h"
+#include "Debug/DVAssert.h"
 #include "Scene3D/SkeletonAnimation/JointTransform.h"
 
 namespace DAVA
 {
+/**
+    Set of joint transforms stored as structure of arrays: positions, orientations and scales are in separate
+    contiguous arrays, so batch operations over joints can process several joints at once.
+*/
 class SkeletonPose
 {
 public:
@@ -21,7 +26,18 @@ public:
     void SetOrientation(uint32 jointIndex, const Quaternion& orientation);
     void SetScale(uint32 jointIndex, float32 scale);
 
-    const JointTransform& GetJointTransform(uint32 jointIndex) const;
+    JointTransform GetJointTransform(uint32 jointIndex) const;
+
+    const Vector3& GetPosition(uint32 jointIndex) const;
+    const Quaternion& GetOrientation(uint32 jointIndex) const;
+    float32 GetScale(uint32 jointIndex) const;
+
+    Vector3* GetPositions();
+    Quaternion* GetOrientations();
+    float32* GetScales();
+    const Vector3* GetPositions() const;
+    const Quaternion* GetOrientations() const;
+    const float32* GetScales() const;
 
     void Add(const SkeletonPose& other);
     void Diff(const SkeletonPose& other);
@@ -29,23 +45,15 @@ public:
     void Lerp(const SkeletonPose& other, float32 factor);
 
 private:
-    Vector<JointTransform> jointTransforms;
+    Vector<Vector3> positions;
+    Vector<Quaternion> orientations;
+    Vector<float32> scales;
+    Vector<uint8> flags; // JointTransform::eTransformFlag
 };
 
-inline void SkeletonPose::SetJointCount(uint32 jointCount)
-{
-    jointTransforms.resize(jointCount, JointTransform());
-}
-
 inline uint32 SkeletonPose::GetJointsCount() const
 {
-    return uint32(jointTransforms.size());
-}
-
-inline void SkeletonPose::Reset()
-{
-    for (JointTransform& t : jointTransforms)
-        t.Reset();
+    return uint32(flags.size());
 }
 
 inline void SkeletonPose::SetTransform(uint32 jointIndex, const JointTransform& transform)
@@ -53,7 +61,10 @@ inline void SkeletonPose::SetTransform(uint32 jointIndex, const JointTransform&
     if (GetJointsCount() <= jointIndex)
         SetJointCount(jointIndex + 1);
 
-    jointTransforms[jointIndex] = transform;
+    positions[jointIndex] = transform.position;
+    orientations[jointIndex] = transform.orientation;
+    scales[jointIndex] = transform.scale;
+    flags[jointIndex] = transform.flags;
 }
 
 inline void SkeletonPose::SetPosition(uint32 jointIndex, const Vector3& position)
@@ -61,7 +72,8 @@ inline void SkeletonPose::SetPosition(uint32 jointIndex, const Vector3& position
     if (GetJointsCount() <= jointIndex)
         SetJointCount(jointIndex + 1);
 
-    jointTransforms[jointIndex].SetPosition(position);
+    positions[jointIndex] = position;
+    flags[jointIndex] |= JointTransform::FLAG_POSITION;
 }
 
 inline void SkeletonPose::SetOrientation(uint32 jointIndex, const Quaternion& orientation)
@@ -69,7 +81,8 @@ inline void SkeletonPose::SetOrientation(uint32 jointIndex, const Quaternion& or
     if (GetJointsCount() <= jointIndex)
         SetJointCount(jointIndex + 1);
 
-    jointTransforms[jointIndex].SetOrientation(orientation);
+    orientations[jointIndex] = orientation;
+    flags[jointIndex] |= JointTransform::FLAG_ORIENTATION;
 }
 
 inline void SkeletonPose::SetScale(uint32 jointIndex, float32 scale)
@@ -77,17 +90,69 @@ inline void SkeletonPose::SetScale(uint32 jointIndex, float32 scale)
     if (GetJointsCount() <= jointIndex)
         SetJointCount(jointIndex + 1);
 
-    jointTransforms[jointIndex].SetScale(scale);
+    scales[jointIndex] = scale;
+    flags[jointIndex] |= JointTransform::FLAG_SCALE;
 }
 
-inline const JointTransform& SkeletonPose::GetJointTransform(uint32 jointIndex) const
+inline JointTransform SkeletonPose::GetJointTransform(uint32 jointIndex) const
 {
-    static JointTransform emptyTransform;
-
+    JointTransform transform;
     if (jointIndex < GetJointsCount())
-        return jointTransforms[jointIndex];
-    else
-        return emptyTransform;
+    {
+        transform.position = positions[jointIndex];
+        transform.orientation = orientations[jointIndex];
+        transform.scale = scales[jointIndex];
+        transform.flags = flags[jointIndex];
+    }
+    return transform;
+}
+
+inline const Vector3& SkeletonPose::GetPosition(uint32 jointIndex) const
+{
+    DVASSERT(jointIndex < GetJointsCount());
+    return positions[jointIndex];
+}
+
+inline const Quaternion& SkeletonPose::GetOrientation(uint32 jointIndex) const
+{
+    DVASSERT(jointIndex < GetJointsCount());
+    return orientations[jointIndex];
+}
+
+inline float32 SkeletonPose::GetScale(uint32 jointIndex) const
+{
+    DVASSERT(jointIndex < GetJointsCount());
+    return scales[jointIndex];
+}
+
+inline Vector3* SkeletonPose::GetPositions()
+{
+    return positions.data();
+}
+
+inline Quaternion* SkeletonPose::GetOrientations()
+{
+    return orientations.data();
+}
+
+inline float32* SkeletonPose::GetScales()
+{
+    return scales.data();
+}
+
+inline const Vector3* SkeletonPose::GetPositions() const
+{
+    return positions.data();
+}
+
+inline const Quaternion* SkeletonPose::GetOrientations() const
+{
+    return orientations.data();
+}
+
+inline const float32* SkeletonPose::GetScales() const
+{
+    return scales.data();
 }
 
-} //ns
\ No newline at end of file
+} //ns
@@ -0,0 +1,147 @@
+#include "UnitTests/UnitTests.h"
+
+#include "Scene3D/SkeletonAnimation/MotionLodInterpolator.h"
+#include "Scene3D/SkeletonAnimation/SkeletonPose.h"
+
+DAVA_TESTCLASS (MotionLodInterpolatorTest)
+{
+    DAVA::SkeletonPose MakePose(DAVA::float32 x)
+    {
+        DAVA::SkeletonPose pose;
+        pose.SetPosition(0, DAVA::Vector3(x, 0.f, 0.f));
+        return pose;
+    }
+
+    bool IsPoseAt(const DAVA::MotionLodInterpolator& interpolator, DAVA::float32 x)
+    {
+        return interpolator.HasPose() && std::abs(interpolator.GetPose().GetPosition(0).x - x) < 1e-5f;
+    }
+
+    bool IsRootOffsetDelta(const DAVA::MotionLodInterpolator& interpolator, DAVA::float32 x)
+    {
+        return std::abs(interpolator.GetRootOffsetDelta().x - x) < 1e-5f;
+    }
+
+    DAVA_TEST (UpdatePeriodTest)
+    {
+        using namespace DAVA;
+
+        const uint32 period = 3;
+        const float32 dTime = 0.1f;
+
+        MotionLodInterpolator interpolator;
+        float32 evaluationTime = 0.f;
+
+        // first frame is evaluated, there is no previous pose to blend from
+        TEST_VERIFY(interpolator.Advance(period, dTime, &evaluationTime));
+        TEST_VERIFY(std::abs(evaluationTime - dTime) < 1e-5f);
+        SkeletonPose pose0 = MakePose(0.f);
+        interpolator.SetEvaluated(&pose0, Vector3(3.f, 0.f, 0.f));
+        TEST_VERIFY(IsPoseAt(interpolator, 0.f));
+        TEST_VERIFY(IsRootOffsetDelta(interpolator, 1.f));
+
+        // skipped frames keep root motion going
+        for (uint32 frame = 1; frame < period; ++frame)
+        {
+            TEST_VERIFY(!interpolator.Advance(period, dTime, &evaluationTime));
+            TEST_VERIFY(IsPoseAt(interpolator, 0.f));
+            TEST_VERIFY(IsRootOffsetDelta(interpolator, 1.f));
+        }
+
+        // next evaluation covers time of whole period, pose is blended from previous evaluated pose
+        // and root offset is spread over the same frames
+        TEST_VERIFY(interpolator.Advance(period, dTime, &evaluationTime));
+        TEST_VERIFY(std::abs(evaluationTime - dTime * period) < 1e-5f);
+        SkeletonPose pose1 = MakePose(3.f);
+        interpolator.SetEvaluated(&pose1, Vector3(6.f, 0.f, 0.f));
+        TEST_VERIFY(IsPoseAt(interpolator, 1.f));
+        TEST_VERIFY(IsRootOffsetDelta(interpolator, 2.f));
+
+        for (uint32 frame = 1; frame < period; ++frame)
+        {
+            TEST_VERIFY(!interpolator.Advance(period, dTime, &evaluationTime));
+            TEST_VERIFY(IsPoseAt(interpolator, 1.f + float32(frame)));
+            TEST_VERIFY(IsRootOffsetDelta(interpolator, 2.f));
+        }
+
+        // blend goes from the last evaluated pose, not from interpolated one
+        TEST_VERIFY(interpolator.Advance(period, dTime, &evaluationTime));
+        SkeletonPose pose2 = MakePose(9.f);
+        interpolator.SetEvaluated(&pose2, Vector3());
+        TEST_VERIFY(IsPoseAt(interpolator, 5.f));
+        TEST_VERIFY(IsRootOffsetDelta(interpolator, 0.f));
+    }
+
+    DAVA_TEST (UpdatePeriodChangeTest)
+    {
+        using namespace DAVA;
+
+        const float32 dTime = 0.1f;
+
+        MotionLodInterpolator interpolator;
+        float32 evaluationTime = 0.f;
+
+        TEST_VERIFY(interpolator.Advance(4, dTime, &evaluationTime));
+        SkeletonPose pose0 = MakePose(0.f);
+        interpolator.SetEvaluated(&pose0, Vector3(4.f, 0.f, 0.f));
+        TEST_VERIFY(IsRootOffsetDelta(interpolator, 1.f));
+
+        TEST_VERIFY(!interpolator.Advance(4, dTime, &evaluationTime));
+        TEST_VERIFY(IsRootOffsetDelta(interpolator, 1.f));
+
+        // changed period is evaluated right away for accumulated time, the rest of root offset is not lost
+        TEST_VERIFY(interpolator.Advance(1, dTime, &evaluationTime));
+        TEST_VERIFY(std::abs(evaluationTime - dTime * 2.f) < 1e-5f);
+        SkeletonPose pose1 = MakePose(2.f);
+        interpolator.SetEvaluated(&pose1, Vector3(1.f, 0.f, 0.f));
+        TEST_VERIFY(!interpolator.HasPose());
+        TEST_VERIFY(IsRootOffsetDelta(interpolator, 3.f));
+
+        // every frame is evaluated with period of one
+        TEST_VERIFY(interpolator.Advance(1, dTime, &evaluationTime));
+        TEST_VERIFY(std::abs(evaluationTime - dTime) < 1e-5f);
+        interpolator.SetEvaluated(&pose1, Vector3(1.f, 0.f, 0.f));
+        TEST_VERIFY(IsRootOffsetDelta(interpolator, 1.f));
+
+        // period is increased again, nothing to blend from
+        TEST_VERIFY(interpolator.Advance(2, dTime, &evaluationTime));
+        SkeletonPose pose2 = MakePose(4.f);
+        interpolator.SetEvaluated(&pose2, Vector3(2.f, 0.f, 0.f));
+        TEST_VERIFY(IsPoseAt(interpolator, 4.f));
+        TEST_VERIFY(IsRootOffsetDelta(interpolator, 1.f));
+    }
+
+    DAVA_TEST (RootOffsetOnlyTest)
+    {
+        using namespace DAVA;
+
+        const float32 dTime = 0.1f;
+
+        MotionLodInterpolator interpolator;
+        float32 evaluationTime = 0.f;
+
+        // without pose every frame is evaluated and root offset is applied as is
+        for (uint32 frame = 0; frame < 3; ++frame)
+        {
+            TEST_VERIFY(interpolator.Advance(2, dTime, &evaluationTime));
+            TEST_VERIFY(std::abs(evaluationTime - dTime) < 1e-5f);
+            interpolator.SetEvaluated(nullptr, Vector3(2.f, 0.f, 0.f));
+            TEST_VERIFY(!interpolator.HasPose());
+            TEST_VERIFY(IsRootOffsetDelta(interpolator, 2.f));
+        }
+
+        // pose is evaluated again, e.g. skeleton became visible
+        TEST_VERIFY(interpolator.Advance(2, dTime, &evaluationTime));
+        SkeletonPose pose = MakePose(1.f);
+        interpolator.SetEvaluated(&pose, Vector3(2.f, 0.f, 0.f));
+        TEST_VERIFY(IsPoseAt(interpolator, 1.f));
+        TEST_VERIFY(IsRootOffsetDelta(interpolator, 1.f));
+
+        TEST_VERIFY(!interpolator.Advance(2, dTime, &evaluationTime));
+        TEST_VERIFY(IsRootOffsetDelta(interpolator, 1.f));
+
+        interpolator.Reset();
+        TEST_VERIFY(!interpolator.HasPose());
+        TEST_VERIFY(IsRootOffsetDelta(interpolator, 0.f));
+    }
+};
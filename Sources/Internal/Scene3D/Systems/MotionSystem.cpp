@@ -10,6 +10,7 @@
 #include "Scene3D/Systems/EventSystem.h"
 #include "Scene3D/Systems/GlobalEventSystem.h"
 #include "Scene3D/SkeletonAnimation/MotionLayer.h"
+#include "Scene3D/SkeletonAnimation/MotionLodInterpolator.h"
 #include "Scene3D/SkeletonAnimation/SimpleMotion.h"
 
 namespace DAVA
@@ -85,6 +86,7 @@ void MotionSystem::Process(float32 timeElapsed)
 
             FindAndRemoveExchangingWithLast(activeComponents, motionComponent);
             activeComponents.emplace_back(motionComponent);
+            motionComponent->lodInterpolator.Reset();
 
             SkeletonPose defaultPose = skeleton->GetDefaultPose();
             SimpleMotion* simpleMotion = motionComponent->simpleMotion;
@@ -131,15 +133,37 @@ void MotionSystem::UpdateMotionLayers(MotionComponent* motionComponent, float32
     SkeletonComponent* skeleton = GetSkeletonComponent(motionComponent->GetEntity());
     if (skeleton != nullptr && (motionComponent->GetMotionLayersCount() != 0 || (motionComponent->simpleMotion != nullptr && motionComponent->simpleMotion->IsPlaying())))
     {
-        dTime *= motionComponent->playbackRate;
-        SkeletonPose resultPose = skeleton->GetDefaultPose();
+        //invisible skeleton is paused or only advances motions and root offset
+        bool visible = skeleton->IsAnimationVisible();
+        if (!visible && skeleton->GetInvisibleUpdate() == SkeletonComponent::INVISIBLE_UPDATE_FREEZE)
+        {
+            motionComponent->rootOffsetDelta = Vector3();
+            return;
+        }
+
+        //motions are advanced by time accumulated since last evaluation
+        MotionLodInterpolator& lodInterpolator = motionComponent->lodInterpolator;
+        uint32 updatePeriod = visible ? skeleton->GetCurrentAnimationLod().updatePeriod : 1;
+        if (!lodInterpolator.Advance(updatePeriod, dTime * motionComponent->playbackRate, &dTime))
+        {
+            motionComponent->rootOffsetDelta = lodInterpolator.GetRootOffsetDelta();
+            skeleton->ApplyPose(lodInterpolator.GetPose());
+            return;
+        }
+
+        Vector3 rootOffsetDelta;
+        SkeletonPose resultPose;
+        if (visible)
+        {
+            resultPose = skeleton->GetDefaultPose();
+        }
 
         uint32 motionLayersCount = motionComponent->GetMotionLayersCount();
         for (uint32 l = 0; l < motionLayersCount; ++l)
         {
             MotionLayer* motionLayer = motionComponent->GetMotionLayer(l);
 
-            motionLayer->Update(dTime);
+            motionLayer->Update(dTime, visible);
 
             for (const auto& motionEnd : motionLayer->GetEndedMotions())
                 motionSingleComponent->animationEnd.insert(MotionSingleComponent::AnimationInfo(motionComponent, motionLayer->GetName(), motionEnd));
@@ -153,7 +177,7 @@ void MotionSystem::UpdateMotionLayers(MotionComponent* motionComponent, float32
             {
             case MotionLayer::BLEND_OVERRIDE:
                 resultPose.Override(pose);
-                motionComponent->rootOffsetDelta = motionLayer->GetCurrentRootOffsetDelta();
+                rootOffsetDelta = motionLayer->GetCurrentRootOffsetDelta();
                 break;
             case MotionLayer::BLEND_ADD:
                 resultPose.Add(pose);
@@ -173,10 +197,15 @@ void MotionSystem::UpdateMotionLayers(MotionComponent* motionComponent, float32
             if (!simpleMotion->IsPlaying())
                 motionSingleComponent->simpleMotionFinished.emplace_back(motionComponent);
 
-            simpleMotion->EvaluatePose(&resultPose);
+            if (visible)
+                simpleMotion->EvaluatePose(&resultPose);
         }
 
-        skeleton->ApplyPose(resultPose);
+        //with update period above one pose and root offset are spread over frames till next evaluation
+        lodInterpolator.SetEvaluated(visible ? &resultPose : nullptr, rootOffsetDelta);
+        motionComponent->rootOffsetDelta = lodInterpolator.GetRootOffsetDelta();
+        if (visible)
+            skeleton->ApplyPose(lodInterpolator.HasPose() ? lodInterpolator.GetPose() : resultPose);
     }
 }
 }
\ No newline at end of file
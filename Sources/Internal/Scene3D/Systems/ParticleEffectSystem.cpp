@@ -9,9 +9,12 @@
 #include "Particles/ParticlesRandom.h"
 #include "Particles/ParticleForces.h"
 #include "Particles/ParticleForce.h"
+#include "Particles/ParticleSimulation.h"
+#include "Concurrency/LockGuard.h"
+#include "Concurrency/Thread.h"
+#include "Job/ParallelFor.h"
 #include "Scene3D/Systems/EventSystem.h"
 #include "Time/SystemTimer.h"
-#include "Utils/Random.h"
 #include "Core/PerformanceSettings.h"
 #include "Scene3D/Components/ComponentHelpers.h"
 #include "Scene3D/Lod/LodComponent.h"
@@ -30,6 +33,9 @@ namespace DAVA
 {
 namespace ParticleEffectSystemDetails
 {
+// Number of effects updated by single job
+const uint32 EFFECTS_GRAIN_SIZE = 4;
+
 Matrix3 GenerateEmitterRotationMatrix(Vector3 vector, float32 power)
 {
     Vector3 axis(vector.y, -vector.x, 0);
@@ -41,18 +47,31 @@ Matrix3 GenerateEmitterRotationMatrix(Vector3 vector, float32 power)
 }
 }
 
-NMaterial* ParticleEffectSystem::AcquireMaterial(const MaterialData& materialData)
+NMaterial* ParticleEffectSystem::FindMaterial(const MaterialData& materialData)
 {
-    if (materialData.texture == nullptr) //for superemitter particles eg
-        return nullptr;
-
+    // lock protects lookups of superemitters started during concurrent update from materials created on main thread
+    LockGuard<Mutex> lock(particlesMaterialsMutex);
     for (auto& particlesMaterial : particlesMaterials)
     {
         if (particlesMaterial.first == materialData)
             return particlesMaterial.second;
     }
+    return nullptr;
+}
+
+NMaterial* ParticleEffectSystem::AcquireMaterial(const MaterialData& materialData)
+{
+    if (materialData.texture == nullptr) //for superemitter particles eg
+        return nullptr;
+
+    // material creation changes materials graph, it is allowed only on main thread
+    DVASSERT(Thread::IsMainThread());
 
-    NMaterial* material = new NMaterial();
+    NMaterial* material = FindMaterial(materialData);
+    if (material != nullptr)
+        return material;
+
+    material = new NMaterial();
     material->SetParent(particleBaseMaterial);
 
     if (materialData.enableFrameBlend)
@@ -111,11 +130,13 @@ NMaterial* ParticleEffectSystem::AcquireMaterial(const MaterialData& materialDat
 
     material->AddTexture(NMaterialTextureName::TEXTURE_ALBEDO, materialData.texture);
     material->AddFlag(NMaterialFlagName::FLAG_BLENDING, materialData.blending);
-
-    particlesMaterials.push_back(std::make_pair(materialData, material));
-
     material->PreBuildMaterial(PASS_FORWARD);
 
+    {
+        LockGuard<Mutex> lock(particlesMaterialsMutex);
+        particlesMaterials.push_back(std::make_pair(materialData, material));
+    }
+
     return material;
 }
 
@@ -203,6 +224,50 @@ void ParticleEffectSystem::PrebuildMaterials(ParticleEffectComponent* component)
     }
 }
 
+ParticleEffectSystem::MaterialData ParticleEffectSystem::MakeMaterialData(ParticleLayer* layer) const
+{
+    DAVA::Texture* flowmap = layer->flowmap.get() != nullptr ? layer->flowmap->GetTexture(0) : nullptr;
+    DAVA::Texture* noise = layer->noise.get() != nullptr ? layer->noise->GetTexture(0) : nullptr;
+    DAVA::Texture* alphaRemap = layer->alphaRemapSprite.get() != nullptr ? layer->alphaRemapSprite->GetTexture(0) : nullptr;
+    ParticleEffectSystem::MaterialData matData = {};
+    matData.texture = layer->sprite->GetTexture(0);
+    matData.enableFog = layer->enableFog;
+    matData.enableFrameBlend = layer->enableFrameBlend && layer->type != ParticleLayer::TYPE_PARTICLE_STRIPE;
+    matData.flowmap = flowmap;
+    matData.enableFlowAnimation = layer->enableFlowAnimation;
+    matData.enableFlow = layer->enableFlow;
+    matData.enableNoise = layer->enableNoise;
+    matData.noise = noise;
+    matData.useFresnelToAlpha = layer->useFresnelToAlpha;
+    matData.blending = layer->blending;
+    matData.enableAlphaRemap = layer->enableAlphaRemap;
+    matData.alphaRemapTexture = alphaRemap;
+    matData.usePerspectiveMapping = layer->usePerspectiveMapping && layer->type == ParticleLayer::TYPE_PARTICLE_STRIPE;
+    matData.useThreePointGradient = layer->useThreePointGradient;
+    uintptr_t layerIdPtr = reinterpret_cast<uintptr_t>(layer);
+    matData.layerId = static_cast<uint64>(layerIdPtr);
+    return matData;
+}
+
+void ParticleEffectSystem::PrepareEmitter(ParticleEmitter* emitter, uint32 bakeResolution)
+{
+    for (ParticleLayer* layer : emitter->layers)
+    {
+        layer->BakePropertyLines(bakeResolution);
+
+        if (layer->type == ParticleLayer::TYPE_SUPEREMITTER_PARTICLES)
+        {
+            ParticleEmitter* innerEmitter = (layer->innerEmitter != nullptr) ? layer->innerEmitter->GetEmitter() : nullptr;
+            if (innerEmitter != nullptr)
+                PrepareEmitter(innerEmitter, bakeResolution);
+        }
+        else if (layer->sprite)
+        {
+            AcquireMaterial(MakeMaterialData(layer));
+        }
+    }
+}
+
 void ParticleEffectSystem::RunEmitter(ParticleEffectComponent* effect, ParticleEmitter* emitter, const Vector3& spawnPosition, int32 positionSource)
 {
     for (ParticleLayer* layer : emitter->layers)
@@ -219,37 +284,35 @@ void ParticleEffectSystem::RunEmitter(ParticleEffectComponent* effect, ParticleE
         group.positionSource = positionSource;
         group.loopLayerStartTime = group.layer->startTime;
         group.loopDuration = group.layer->endTime;
+        group.randomIndexOffset = effect->effectData.random.Rand();
 
         if (layer->sprite && (layer->type != ParticleLayer::TYPE_SUPEREMITTER_PARTICLES))
         {
-            DAVA::Texture* flowmap = layer->flowmap.get() != nullptr ? layer->flowmap->GetTexture(0) : nullptr;
-            DAVA::Texture* noise = layer->noise.get() != nullptr ? layer->noise->GetTexture(0) : nullptr;
-            DAVA::Texture* alphaRemap = layer->alphaRemapSprite.get() != nullptr ? layer->alphaRemapSprite->GetTexture(0) : nullptr;
-            ParticleEffectSystem::MaterialData matData = {};
-            matData.texture = layer->sprite->GetTexture(0);
-            matData.enableFog = layer->enableFog;
-            matData.enableFrameBlend = layer->enableFrameBlend && layer->type != ParticleLayer::TYPE_PARTICLE_STRIPE;
-            matData.flowmap = flowmap;
-            matData.enableFlowAnimation = layer->enableFlowAnimation;
-            matData.enableFlow = layer->enableFlow;
-            matData.enableNoise = layer->enableNoise;
-            matData.noise = noise;
-            matData.useFresnelToAlpha = layer->useFresnelToAlpha;
-            matData.blending = layer->blending;
-            matData.enableAlphaRemap = layer->enableAlphaRemap;
-            matData.alphaRemapTexture = alphaRemap;
-            matData.usePerspectiveMapping = layer->usePerspectiveMapping && layer->type == ParticleLayer::TYPE_PARTICLE_STRIPE;
-            matData.useThreePointGradient = layer->useThreePointGradient;
-            uintptr_t layerIdPtr = reinterpret_cast<uintptr_t>(layer);
-            matData.layerId = static_cast<uint64>(layerIdPtr);
-
-            group.material = AcquireMaterial(matData);
+            // emitters may be started by superemitter particles during concurrent update, so material is only looked up here.
+            // Materials are created in advance by PrepareEmitter, missing ones are created on main thread by AcquirePendingMaterials
+            group.material = FindMaterial(MakeMaterialData(layer));
+            if (group.material == nullptr)
+                effect->effectData.hasPendingMaterials = true;
         }
 
         effect->effectData.groups.push_back(group);
     }
 }
 
+void ParticleEffectSystem::AcquirePendingMaterials(ParticleEffectComponent* effect)
+{
+    if (!effect->effectData.hasPendingMaterials)
+        return;
+
+    for (ParticleGroup& group : effect->effectData.groups)
+    {
+        ParticleLayer* layer = group.layer;
+        if (group.material == nullptr && layer->sprite && (layer->type != ParticleLayer::TYPE_SUPEREMITTER_PARTICLES))
+            group.material = AcquireMaterial(MakeMaterialData(layer));
+    }
+    effect->effectData.hasPendingMaterials = false;
+}
+
 void ParticleEffectSystem::RunEffect(ParticleEffectComponent* effect)
 {
     if (QualitySettingsSystem::Instance()->IsOptionEnabled(QualitySettingsSystem::QUALITY_OPTION_DISABLE_EFFECTS))
@@ -267,6 +330,14 @@ void ParticleEffectSystem::RunEffect(ParticleEffectComponent* effect)
         effect->effectData.infoSources.resize(1);
     }
 
+    effect->effectData.random.Seed(ParticlesRandom::MakeEffectSeed());
+
+    uint32 bakeResolution = QualitySettingsSystem::Instance()->GetParticlesQualitySettings().GetPropertyLinesBakeResolution();
+    for (const auto& instance : effect->emitterInstances)
+    {
+        PrepareEmitter(instance->GetEmitter(), bakeResolution);
+    }
+
     for (const auto& instance : effect->emitterInstances)
     {
         RunEmitter(effect, instance->GetEmitter(), instance->GetSpawnPosition());
@@ -279,6 +350,8 @@ void ParticleEffectSystem::RunEffect(ParticleEffectComponent* effect)
     {
         SimulateEffect(effect);
     }
+
+    AcquirePendingMaterials(effect);
 }
 
 void ParticleEffectSystem::AddToActive(ParticleEffectComponent* effect)
@@ -405,10 +478,10 @@ void ParticleEffectSystem::Process(float32 timeElapsed)
     float32 speedMult = 1.0f + (perfSettings->GetPsPerformanceSpeedMult() - 1.0f) * (1 - currPSValue);
     float32 shortEffectTime = timeElapsed * speedMult;
 
-    size_t componentsCount = activeComponents.size();
-    for (size_t i = 0; i < componentsCount; i++)
+    // effects are started and seeded in order on main thread, so update result does not depend on job scheduling
+    updatedComponents.clear();
+    for (ParticleEffectComponent* effect : activeComponents)
     {
-        ParticleEffectComponent* effect = activeComponents[i];
         if (effect->activeLodLevel != effect->desiredLodLevel)
             UpdateActiveLod(effect);
         if (effect->state == ParticleEffectComponent::STATE_STARTING)
@@ -416,9 +489,30 @@ void ParticleEffectSystem::Process(float32 timeElapsed)
             RunEffect(effect);
         }
 
+        if (!effect->isPaused)
+            updatedComponents.push_back(effect);
+    }
+
+    uint32 updatedCount = static_cast<uint32>(updatedComponents.size());
+    ParallelFor(0u, updatedCount, ParticleEffectSystemDetails::EFFECTS_GRAIN_SIZE, [&](uint32 begin, uint32 end) {
+        UpdateScratch* scratch = AcquireScratch();
+        for (uint32 i = begin; i < end; ++i)
+        {
+            ParticleEffectComponent* effect = updatedComponents[i];
+            UpdateEffect(effect, timeElapsed * effect->playbackSpeed, shortEffectTime * effect->playbackSpeed, *scratch);
+        }
+        ReleaseScratch(scratch);
+    });
+
+    for (ParticleEffectComponent* effect : updatedComponents)
+        AcquirePendingMaterials(effect);
+
+    size_t componentsCount = activeComponents.size();
+    for (size_t i = 0; i < componentsCount; i++)
+    {
+        ParticleEffectComponent* effect = activeComponents[i];
         if (effect->isPaused)
             continue;
-        UpdateEffect(effect, timeElapsed * effect->playbackSpeed, shortEffectTime * effect->playbackSpeed);
 
         bool effectEnded = effect->stopWhenEmpty ? effect->effectData.groups.empty() : (effect->time > effect->effectDuration);
         if (effectEnded)
@@ -474,42 +568,55 @@ void ParticleEffectSystem::UpdateActiveLod(ParticleEffectComponent* effect)
             ParticleGroup& group = *it;
             if (group.layer->degradeStrategy == ParticleLayer::DEGRADE_REMOVE)
             {
-                Particle* current = group.head;
-                while (current)
-                {
-                    Particle* next = current->next;
-                    delete current;
-                    current = next;
-                }
-                group.head = nullptr;
+                group.particles.Clear();
             }
             else if (group.layer->degradeStrategy == ParticleLayer::DEGRADE_CUT_PARTICLES)
             {
-                Particle* current = group.head;
-                Particle* prev = nullptr;
-                int32 i = 0;
-                while (current)
+                for (uint32 i = group.particles.GetCount(); i-- > 0;)
                 {
-                    Particle* next = current->next;
                     if (i % 2) //cut every second particle
                     {
-                        delete current;
+                        group.particles.Remove(i);
                         group.activeParticleCount--;
-                        if (prev)
-                            prev->next = next;
-                        else
-                            group.head = next;
                     }
-                    prev = current;
-                    current = next;
-                    i++;
                 }
             }
         }
     }
 }
 
+ParticleEffectSystem::UpdateScratch* ParticleEffectSystem::AcquireScratch()
+{
+    LockGuard<Mutex> lock(scratchPoolMutex);
+    if (scratchPool.empty())
+        return new UpdateScratch();
+
+    UpdateScratch* scratch = scratchPool.back().release();
+    scratchPool.pop_back();
+    return scratch;
+}
+
+void ParticleEffectSystem::ReleaseScratch(UpdateScratch* scratch)
+{
+    LockGuard<Mutex> lock(scratchPoolMutex);
+    statistics.emitNs += scratch->statistics.emitNs;
+    statistics.simulationNs += scratch->statistics.simulationNs;
+    statistics.forcesNs += scratch->statistics.forcesNs;
+    statistics.particlesEmitted += scratch->statistics.particlesEmitted;
+    statistics.particlesSimulated += scratch->statistics.particlesSimulated;
+    scratch->statistics = Statistics();
+
+    scratchPool.emplace_back(scratch);
+}
+
 void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32 deltaTime, float32 shortEffectTime)
+{
+    UpdateScratch* scratch = AcquireScratch();
+    UpdateEffect(effect, deltaTime, shortEffectTime, *scratch);
+    ReleaseScratch(scratch);
+}
+
+void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32 deltaTime, float32 shortEffectTime, UpdateScratch& scratch)
 {
     effect->time += deltaTime;
     const Matrix4* worldTransformPtr;
@@ -526,8 +633,9 @@ void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32
 
     AABBox3 bbox;
     List<ParticleGroup>::iterator it = effect->effectData.groups.begin();
-    Random* random = GetEngineContext()->random;
+    ParticlesRandom::Generator& random = effect->effectData.random;
     bool isInverseCalculated = false;
+    Matrix4 invWorld;
     while (it != effect->effectData.groups.end())
     {
         ParticleGroup& group = *it;
@@ -543,41 +651,40 @@ void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32
         if ((!group.finishingGroup) && (group.layer->isLooped) && (currLoopTime > group.loopDuration)) //restart loop
         {
             group.loopStartTime = group.time;
-            group.loopLayerStartTime = group.layer->deltaTime + group.layer->deltaVariation * static_cast<float32>(random->RandFloat());
-            group.loopDuration = group.loopLayerStartTime + (group.layer->endTime - group.layer->startTime) + group.layer->loopVariation * static_cast<float32>(random->RandFloat());
+            group.loopLayerStartTime = group.layer->deltaTime + group.layer->deltaVariation * random.RandFloat();
+            group.loopDuration = group.loopLayerStartTime + (group.layer->endTime - group.layer->startTime) + group.layer->loopVariation * random.RandFloat();
             currLoopTime = 0;
         }
 
-        //prepare forces as they will now actually change in time even for already generated particles
-        static Vector<Vector3> currSimplifiedForceValues;
-        int32 simplifiedForcesCount;
+        int64 simulationStart = statisticsEnabled ? SystemTimer::GetNs() : 0;
+        uint64 forcesNsStart = scratch.statistics.forcesNs;
 
-        static Vector<ParticleForce*> effectAlignCurrForces;
-        static Vector<ParticleForce*> worldAlignCurrForces;
+        //prepare forces as they will now actually change in time even for already generated particles
+        int32 simplifiedForcesCount = 0;
         uint32 forcesCountWorldAlign = 0;
         uint32 effectAlignForcesCount = 0;
 
-        static Matrix4 invWorld;
-        if (group.head)
+        if (!group.particles.IsEmpty())
         {
             simplifiedForcesCount = static_cast<int32>(group.layer->GetSimplifiedParticleForces().size());
             if (simplifiedForcesCount)
             {
-                currSimplifiedForceValues.resize(simplifiedForcesCount);
+                scratch.simplifiedForceValues.resize(simplifiedForcesCount);
                 for (int32 i = 0; i < simplifiedForcesCount; ++i)
                 {
                     if (group.layer->GetSimplifiedParticleForces()[i]->force)
-                        currSimplifiedForceValues[i] = group.layer->GetSimplifiedParticleForces()[i]->force->GetValue(currLoopTime);
+                        scratch.simplifiedForceValues[i] = group.layer->GetSimplifiedParticleForces()[i]->force->Sample(currLoopTime);
                     else
-                        currSimplifiedForceValues[i] = Vector3(0, 0, 0);
+                        scratch.simplifiedForceValues[i] = Vector3(0, 0, 0);
                 }
             }
 
             uint32 allForcesCount = static_cast<uint32>(group.layer->GetParticleForces().size());
             if (allForcesCount > 0)
             {
-                effectAlignCurrForces.resize(allForcesCount);
-                worldAlignCurrForces.resize(allForcesCount);
+                scratch.effectAlignForces.resize(allForcesCount);
+                scratch.worldAlignForces.resize(allForcesCount);
+                scratch.worldAlignForcesPositions.resize(allForcesCount);
                 for (uint32 i = 0; i < allForcesCount; ++i)
                 {
                     DAVA::ParticleForce* currForce = group.layer->GetParticleForces()[i];
@@ -586,13 +693,13 @@ void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32
 
                     if (currForce->worldAlign)
                     {
-                        currForce->worldPosition = currForce->position + worldTransformPtr->GetTranslationVector(); // Ignore emitter rotation.
-                        worldAlignCurrForces[forcesCountWorldAlign] = currForce;
+                        scratch.worldAlignForcesPositions[forcesCountWorldAlign] = currForce->position + worldTransformPtr->GetTranslationVector(); // Ignore emitter rotation.
+                        scratch.worldAlignForces[forcesCountWorldAlign] = currForce;
                         ++forcesCountWorldAlign;
                     }
                     else
                     {
-                        effectAlignCurrForces[effectAlignForcesCount] = currForce;
+                        scratch.effectAlignForces[effectAlignForcesCount] = currForce;
                         ++effectAlignForcesCount;
                         if (!isInverseCalculated)
                         {
@@ -604,71 +711,84 @@ void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32
             }
         }
 
-        Particle* current = group.head;
-        Particle* prev = nullptr;
+        if (statisticsEnabled)
+            scratch.statistics.forcesNs += SystemTimer::GetNs() - simulationStart;
 
-        while (current)
-        {
-            current->life += dt;
-            if (current->life >= current->lifeTime)
-            {
-                Particle* next = current->next;
-                if (prev == nullptr)
-                    group.head = next;
-                else
-                    prev->next = next;
-                delete current;
-                current = next;
-                continue;
-            }
-            group.activeParticleCount++;
+        ParticleStorage& particles = group.particles;
+        ParticleSimulation::AdvanceLife(particles, dt);
+        ParticleSimulation::RemoveDeadParticles(particles);
 
-            float32 overLifeTime = current->life / current->lifeTime;
+        uint32 particlesCount = particles.GetCount();
+        group.activeParticleCount = static_cast<int32>(particlesCount);
 
-            if (group.layer->type != ParticleLayer::TYPE_PARTICLE_STRIPE)
-            {
-                UpdateRegularParticleData(effect, current, group, overLifeTime, simplifiedForcesCount, currSimplifiedForceValues, dt, bbox, effectAlignCurrForces, effectAlignForcesCount, worldAlignCurrForces, forcesCountWorldAlign, *worldTransformPtr, invWorld, currLoopTimeNormalized);
-            }
+        Vector<float32>& particlesOverLife = scratch.particlesOverLife;
+        particlesOverLife.resize(particlesCount);
+        ParticleSimulation::CalculateOverLife(particles, particlesOverLife.data());
 
-            if (group.layer->type == ParticleLayer::TYPE_SUPEREMITTER_PARTICLES)
+        if (particlesCount > 0 && group.layer->type != ParticleLayer::TYPE_PARTICLE_STRIPE)
+        {
+            UpdateRegularParticlesData(effect, group, scratch, simplifiedForcesCount, dt, bbox, effectAlignForcesCount, forcesCountWorldAlign, *worldTransformPtr, invWorld, currLoopTimeNormalized);
+        }
+
+        if (group.layer->type == ParticleLayer::TYPE_SUPEREMITTER_PARTICLES)
+        {
+            for (uint32 i = 0; i < particlesCount; ++i)
             {
-                effect->effectData.infoSources[current->positionTarget].position = current->position;
-                effect->effectData.infoSources[current->positionTarget].size = current->currSize;
+                effect->effectData.infoSources[particles.positionTarget[i]].position = particles.GetPosition(i);
+                effect->effectData.infoSources[particles.positionTarget[i]].size = particles.currSize[i];
             }
+        }
 
-            if (group.layer->enableNoise && group.layer->noise.get() != nullptr)
+        if (group.layer->enableNoise && group.layer->noise.get() != nullptr)
+        {
+            for (uint32 i = 0; i < particlesCount; ++i)
             {
+                float32 overLifeTime = particlesOverLife[i];
                 if (group.layer->noiseScaleOverLife != nullptr)
-                    current->currNoiseScale = current->baseNoiseScale * group.layer->noiseScaleOverLife->GetValue(overLifeTime);
+                    particles.currNoiseScale[i] = particles.baseNoiseScale[i] * group.layer->noiseScaleOverLife->Sample(overLifeTime);
 
                 DAVA::float32 overLifeScale = 1.0f;
                 if (group.layer->noiseUScrollSpeedOverLife != nullptr)
                 {
-                    overLifeScale = group.layer->noiseUScrollSpeedOverLife->GetValue(overLifeTime);
+                    overLifeScale = group.layer->noiseUScrollSpeedOverLife->Sample(overLifeTime);
                 }
-                current->currNoiseUOffset += current->baseNoiseUScrollSpeed * overLifeScale * deltaTime;
+                particles.currNoiseUOffset[i] += particles.baseNoiseUScrollSpeed[i] * overLifeScale * deltaTime;
 
                 overLifeScale = 1.0f;
                 if (group.layer->noiseVScrollSpeedOverLife != nullptr)
                 {
-                    overLifeScale = group.layer->noiseVScrollSpeedOverLife->GetValue(overLifeTime);
+                    overLifeScale = group.layer->noiseVScrollSpeedOverLife->Sample(overLifeTime);
                 }
-                current->currNoiseVOffset += current->baseNoiseVScrollSpeed * overLifeScale * deltaTime;
+                particles.currNoiseVOffset[i] += particles.baseNoiseVScrollSpeed[i] * overLifeScale * deltaTime;
             }
+        }
 
-            if (group.layer->enableAlphaRemap && group.layer->alphaRemapSprite.get() != nullptr && group.layer->alphaRemapOverLife != nullptr)
+        if (group.layer->enableAlphaRemap && group.layer->alphaRemapSprite.get() != nullptr && group.layer->alphaRemapOverLife != nullptr)
+        {
+            for (uint32 i = 0; i < particlesCount; ++i)
             {
-                float32 lookup = overLifeTime * group.layer->alphaRemapLoopCount;
+                float32 lookup = particlesOverLife[i] * group.layer->alphaRemapLoopCount;
                 float32 intPart;
-                current->alphaRemap = group.layer->alphaRemapOverLife->GetValue(modff(lookup, &intPart));
+                particles.alphaRemap[i] = group.layer->alphaRemapOverLife->Sample(modff(lookup, &intPart));
             }
+        }
 
-            if (group.layer->type == ParticleLayer::TYPE_PARTICLE_STRIPE)
-                UpdateStripe(current, effect->effectData, group, deltaTime, bbox, currSimplifiedForceValues, simplifiedForcesCount, group.layer->IsLodActive(effect->activeLodLevel));
-
-            prev = current;
-            current = current->next;
+        if (group.layer->type == ParticleLayer::TYPE_PARTICLE_STRIPE)
+        {
+            for (uint32 i = 0; i < particlesCount; ++i)
+            {
+                UpdateStripe(particles.GetPosition(i), particles.GetSpeed(i), effect->effectData, group, deltaTime, bbox, scratch.simplifiedForceValues, simplifiedForcesCount, group.layer->IsLodActive(effect->activeLodLevel));
+            }
         }
+        int64 emitStart = 0;
+        uint16 particlesGenerated = group.particlesGenerated;
+        if (statisticsEnabled)
+        {
+            emitStart = SystemTimer::GetNs();
+            scratch.statistics.simulationNs += (emitStart - simulationStart) - (scratch.statistics.forcesNs - forcesNsStart);
+            scratch.statistics.particlesSimulated += particlesCount;
+        }
+
         bool allowParticleGeneration = !group.finishingGroup;
         allowParticleGeneration &= (currLoopTime > group.loopLayerStartTime);
         allowParticleGeneration &= group.visibleLod;
@@ -676,13 +796,13 @@ void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32
         {
             if (group.layer->type == ParticleLayer::TYPE_SINGLE_PARTICLE || group.layer->type == ParticleLayer::TYPE_PARTICLE_STRIPE)
             {
-                if (!group.head)
+                if (group.particles.IsEmpty())
                 {
-                    current = GenerateNewParticle(effect, group, currLoopTime, *worldTransformPtr);
+                    uint32 index = GenerateNewParticle(effect, group, currLoopTime, *worldTransformPtr);
                     if (group.layer->GetInheritPosition())
-                        AddParticleToBBox(current->position + effect->effectData.infoSources[group.positionSource].position, current->currRadius, bbox);
+                        AddParticleToBBox(group.particles.GetPosition(index) + effect->effectData.infoSources[group.positionSource].position, group.particles.currRadius[index], bbox);
                     else
-                        AddParticleToBBox(current->position, current->currRadius, bbox);
+                        AddParticleToBBox(group.particles.GetPosition(index), group.particles.currRadius[index], bbox);
                 }
             }
             else
@@ -690,25 +810,31 @@ void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32
                 float32 newParticles = 0.0f;
 
                 if (group.layer->number)
-                    newParticles = group.layer->number->GetValue(currLoopTime);
+                    newParticles = group.layer->number->Sample(currLoopTime);
                 if (group.layer->numberVariation)
-                    newParticles += group.layer->numberVariation->GetValue(currLoopTime) * static_cast<float32>(random->RandFloat());
+                    newParticles += group.layer->numberVariation->Sample(currLoopTime) * random.RandFloat();
                 newParticles *= dt;
                 group.particlesToGenerate += newParticles;
 
                 while (group.particlesToGenerate >= 1.0f)
                 {
                     group.particlesToGenerate -= 1.0f;
-                    current = GenerateNewParticle(effect, group, currLoopTime, *worldTransformPtr);
+                    uint32 index = GenerateNewParticle(effect, group, currLoopTime, *worldTransformPtr);
                     if (group.layer->GetInheritPosition())
-                        AddParticleToBBox(current->position + effect->effectData.infoSources[group.positionSource].position, current->currRadius, bbox);
+                        AddParticleToBBox(group.particles.GetPosition(index) + effect->effectData.infoSources[group.positionSource].position, group.particles.currRadius[index], bbox);
                     else
-                        AddParticleToBBox(current->position, current->currRadius, bbox);
+                        AddParticleToBBox(group.particles.GetPosition(index), group.particles.currRadius[index], bbox);
                 }
             }
         }
 
-        if (group.finishingGroup && (group.head == nullptr))
+        if (statisticsEnabled)
+        {
+            scratch.statistics.emitNs += SystemTimer::GetNs() - emitStart;
+            scratch.statistics.particlesEmitted += static_cast<uint16>(group.particlesGenerated - particlesGenerated);
+        }
+
+        if (group.finishingGroup && group.particles.IsEmpty())
         {
             DAVA::SafeRelease(group.emitter);
             DAVA::SafeRelease(group.layer);
@@ -727,12 +853,12 @@ void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32
     effect->effectRenderObject->SetAABBox(bbox);
 }
 
-void ParticleEffectSystem::UpdateStripe(Particle* particle, ParticleEffectData& effectData, ParticleGroup& group, float32 dt, AABBox3& bbox, const Vector<Vector3>& currForceValues, int32 forcesCount, bool isActive)
+void ParticleEffectSystem::UpdateStripe(const Vector3& particlePosition, const Vector3& particleSpeed, ParticleEffectData& effectData, ParticleGroup& group, float32 dt, AABBox3& bbox, const Vector<Vector3>& currForceValues, int32 forcesCount, bool isActive)
 {
     ParticleLayer* layer = group.layer;
     StripeData& data = group.stripe;
     Vector3 prevBasePosition = data.baseNode.position;
-    data.baseNode.position = particle->position;
+    data.baseNode.position = particlePosition;
     data.isActive = isActive;
 
     if (layer->GetInheritPosition())
@@ -745,7 +871,7 @@ void ParticleEffectSystem::UpdateStripe(Particle* particle, ParticleEffectData&
         data.baseNode.position = effectData.infoSources[group.positionSource].position;
     }
 
-    data.baseNode.speed = particle->speed;
+    data.baseNode.speed = particleSpeed;
 
     bool shouldInsert = data.stripeNodes.empty() || (data.baseNode.position - data.stripeNodes.front().position).SquareLength() > layer->stripeVertexSpawnStep * layer->stripeVertexSpawnStep;
 
@@ -772,7 +898,7 @@ void ParticleEffectSystem::UpdateStripe(Particle* particle, ParticleEffectData&
 
         float32 currVelocityOverLife = 1.0f;
         if (layer->velocityOverLife)
-            currVelocityOverLife = layer->velocityOverLife->GetValue(overLife);
+            currVelocityOverLife = layer->velocityOverLife->Sample(overLife);
         nodeIter->position += nodeIter->speed * (currVelocityOverLife * dt);
 
         if (nodeIter == data.stripeNodes.begin())
@@ -783,7 +909,7 @@ void ParticleEffectSystem::UpdateStripe(Particle* particle, ParticleEffectData&
             Vector3 acceleration;
             for (int32 i = 0; i < forcesCount; ++i)
             {
-                acceleration += (layer->GetSimplifiedParticleForces()[i]->forceOverLife) ? (currForceValues[i] * layer->GetSimplifiedParticleForces()[i]->forceOverLife->GetValue(overLife)) : currForceValues[i];
+                acceleration += (layer->GetSimplifiedParticleForces()[i]->forceOverLife) ? (currForceValues[i] * layer->GetSimplifiedParticleForces()[i]->forceOverLife->Sample(overLife)) : currForceValues[i];
             }
             nodeIter->speed += acceleration * dt;
         }
@@ -814,7 +940,7 @@ void ParticleEffectSystem::UpdateStripe(Particle* particle, ParticleEffectData&
         else
         {
             float32 delta = (data.baseNode.position - prevBasePosition).Length();
-            if (particle->speed.DotProduct(data.baseNode.position - prevBasePosition) <= 0)
+            if (particleSpeed.DotProduct(data.baseNode.position - prevBasePosition) <= 0)
             {
                 data.uvOffset -= delta;
             }
@@ -833,107 +959,109 @@ void ParticleEffectSystem::AddParticleToBBox(const Vector3& position, float radi
     bbox.AddPoint(position + sz);
 }
 
-Particle* ParticleEffectSystem::GenerateNewParticle(ParticleEffectComponent* effect, ParticleGroup& group, float32 currLoopTime, const Matrix4& worldTransform)
+uint32 ParticleEffectSystem::GenerateNewParticle(ParticleEffectComponent* effect, ParticleGroup& group, float32 currLoopTime, const Matrix4& worldTransform)
 {
-    Particle* particle = new Particle();
+    ParticlesRandom::Generator& random = effect->effectData.random;
+    Particle newParticle;
+    Particle* particle = &newParticle;
     particle->life = 0.0f;
 
     particle->color = Color();
     if (group.layer->colorRandom)
     {
-        particle->color = group.layer->colorRandom->GetValue(static_cast<float32>(GetEngineContext()->random->RandFloat()));
+        particle->color = group.layer->colorRandom->Sample(random.RandFloat());
     }
     if (group.emitter->colorOverLife)
     {
-        particle->color *= group.emitter->colorOverLife->GetValue(group.time);
+        particle->color *= group.emitter->colorOverLife->Sample(group.time);
     }
 
     particle->lifeTime = 0.0f;
     if (group.layer->life)
-        particle->lifeTime += group.layer->life->GetValue(currLoopTime);
+        particle->lifeTime += group.layer->life->Sample(currLoopTime);
     if (group.layer->lifeVariation)
-        particle->lifeTime += (group.layer->lifeVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
+        particle->lifeTime += (group.layer->lifeVariation->Sample(currLoopTime) * random.RandFloat());
 
     // Flow.
     particle->baseFlowSpeed = 0.0f;
     if (group.layer->flowSpeed)
-        particle->baseFlowSpeed += group.layer->flowSpeed->GetValue(currLoopTime);
+        particle->baseFlowSpeed += group.layer->flowSpeed->Sample(currLoopTime);
     if (group.layer->flowSpeedVariation)
-        particle->baseFlowSpeed += (group.layer->flowSpeedVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
+        particle->baseFlowSpeed += (group.layer->flowSpeedVariation->Sample(currLoopTime) * random.RandFloat());
     particle->currFlowSpeed = particle->baseFlowSpeed;
 
     particle->baseFlowOffset = 0.0f;
     if (group.layer->flowOffset)
-        particle->baseFlowOffset += group.layer->flowOffset->GetValue(currLoopTime);
+        particle->baseFlowOffset += group.layer->flowOffset->Sample(currLoopTime);
     if (group.layer->flowOffsetVariation)
-        particle->baseFlowOffset += (group.layer->flowOffsetVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
+        particle->baseFlowOffset += (group.layer->flowOffsetVariation->Sample(currLoopTime) * random.RandFloat());
     particle->currFlowOffset = particle->baseFlowOffset;
 
     // Noise.
     particle->baseNoiseScale = 0.0f;
     if (group.layer->noiseScale)
-        particle->baseNoiseScale += group.layer->noiseScale->GetValue(currLoopTime);
+        particle->baseNoiseScale += group.layer->noiseScale->Sample(currLoopTime);
     if (group.layer->noiseScaleVariation)
-        particle->baseNoiseScale += (group.layer->noiseScaleVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
+        particle->baseNoiseScale += (group.layer->noiseScaleVariation->Sample(currLoopTime) * random.RandFloat());
     particle->currNoiseScale = particle->baseNoiseScale;
 
     particle->baseNoiseUScrollSpeed = 0.0f;
     if (group.layer->noiseUScrollSpeed)
-        particle->baseNoiseUScrollSpeed += group.layer->noiseUScrollSpeed->GetValue(currLoopTime);
+        particle->baseNoiseUScrollSpeed += group.layer->noiseUScrollSpeed->Sample(currLoopTime);
     if (group.layer->noiseUScrollSpeedVariation)
-        particle->baseNoiseUScrollSpeed += (group.layer->noiseUScrollSpeedVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
+        particle->baseNoiseUScrollSpeed += (group.layer->noiseUScrollSpeedVariation->Sample(currLoopTime) * random.RandFloat());
     particle->currNoiseUOffset = particle->baseNoiseUScrollSpeed;
 
     particle->baseNoiseVScrollSpeed = 0.0f;
     if (group.layer->noiseVScrollSpeed)
-        particle->baseNoiseVScrollSpeed += group.layer->noiseVScrollSpeed->GetValue(currLoopTime);
+        particle->baseNoiseVScrollSpeed += group.layer->noiseVScrollSpeed->Sample(currLoopTime);
     if (group.layer->noiseVScrollSpeedVariation)
-        particle->baseNoiseVScrollSpeed += (group.layer->noiseVScrollSpeedVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
+        particle->baseNoiseVScrollSpeed += (group.layer->noiseVScrollSpeedVariation->Sample(currLoopTime) * random.RandFloat());
     particle->currNoiseVOffset = particle->baseNoiseVScrollSpeed;
 
     // size
     particle->baseSize = Vector2(1.0f, 1.0f);
     if (group.layer->size)
-        particle->baseSize = group.layer->size->GetValue(currLoopTime);
+        particle->baseSize = group.layer->size->Sample(currLoopTime);
     if (group.layer->sizeVariation)
-        particle->baseSize += (group.layer->sizeVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
+        particle->baseSize += (group.layer->sizeVariation->Sample(currLoopTime) * random.RandFloat());
     particle->baseSize *= effect->effectData.infoSources[group.positionSource].size;
 
     particle->currSize = particle->baseSize;
     if (group.layer->sizeOverLifeXY)
-        particle->currSize *= group.layer->sizeOverLifeXY->GetValue(0);
+        particle->currSize *= group.layer->sizeOverLifeXY->Sample(0);
     Vector2 pivotSize = particle->currSize * group.layer->layerPivotSizeOffsets;
     particle->currRadius = pivotSize.Length();
 
     particle->angle = 0.0f;
     particle->spin = 0.0f;
     if (group.layer->angle)
-        particle->angle = DegToRad(group.layer->angle->GetValue(currLoopTime));
+        particle->angle = DegToRad(group.layer->angle->Sample(currLoopTime));
     if (group.layer->angleVariation)
-        particle->angle += DegToRad(group.layer->angleVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
+        particle->angle += DegToRad(group.layer->angleVariation->Sample(currLoopTime) * random.RandFloat());
     if (group.layer->spin)
-        particle->spin = DegToRad(group.layer->spin->GetValue(currLoopTime));
+        particle->spin = DegToRad(group.layer->spin->Sample(currLoopTime));
     if (group.layer->spinVariation)
-        particle->spin += DegToRad(group.layer->spinVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
+        particle->spin += DegToRad(group.layer->spinVariation->Sample(currLoopTime) * random.RandFloat());
     if (group.layer->randomSpinDirection)
     {
-        int32 dir = Rand() & 1;
+        int32 dir = random.Rand() & 1;
         particle->spin *= (dir)*2 - 1;
     }
     particle->frame = 0;
     particle->animTime = 0;
     if (group.layer->randomFrameOnStart && group.layer->sprite)
     {
-        particle->frame = static_cast<int32>(static_cast<float32>(GetEngineContext()->random->RandFloat()) * static_cast<float32>(group.layer->sprite->GetFrameCount()));
+        particle->frame = static_cast<int32>(random.RandFloat() * static_cast<float32>(group.layer->sprite->GetFrameCount()));
     }
 
-    PrepareEmitterParameters(particle, group, worldTransform);
+    PrepareEmitterParameters(particle, group, worldTransform, random);
 
     float32 vel = 0.0f;
     if (group.layer->velocity)
-        vel += group.layer->velocity->GetValue(currLoopTime);
+        vel += group.layer->velocity->Sample(currLoopTime);
     if (group.layer->velocityVariation)
-        vel += (group.layer->velocityVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
+        vel += (group.layer->velocityVariation->Sample(currLoopTime) * random.RandFloat());
     particle->speed *= vel;
 
     if (!group.layer->GetInheritPosition()) //just generate at correct position
@@ -941,9 +1069,6 @@ Particle* ParticleEffectSystem::GenerateNewParticle(ParticleEffectComponent* eff
         particle->position += effect->effectData.infoSources[group.positionSource].position;
     }
 
-    particle->next = group.head;
-    group.head = particle;
-    group.activeParticleCount++;
     if (group.layer->type == ParticleLayer::TYPE_SUPEREMITTER_PARTICLES)
     {
         ParentInfo info;
@@ -951,94 +1076,177 @@ Particle* ParticleEffectSystem::GenerateNewParticle(ParticleEffectComponent* eff
         info.size = particle->currSize;
         effect->effectData.infoSources.push_back(info);
         particle->positionTarget = static_cast<int32>(effect->effectData.infoSources.size() - 1);
+    }
+
+    uint32 index = group.particles.Add(newParticle);
+    group.activeParticleCount++;
+
+    if (group.layer->type == ParticleLayer::TYPE_SUPEREMITTER_PARTICLES)
+    {
         ParticleEmitter* innerEmitter = group.layer->innerEmitter->GetEmitter();
         if (innerEmitter)
             RunEmitter(effect, innerEmitter, Vector3(0, 0, 0), particle->positionTarget);
     }
 
     group.particlesGenerated++;
-    return particle;
+    return index;
 }
 
-void ParticleEffectSystem::UpdateRegularParticleData(ParticleEffectComponent* effect, Particle* particle, const ParticleGroup& group, float32 overLife, int32 simplifiedForcesCount, Vector<Vector3>& currSimplifiedForceValues, float32 dt, AABBox3& bbox, const Vector<ParticleForce*>& effectAlignForces, uint32 effectAlignForcesCount, const Vector<ParticleForce*>& worldAlignForces, uint32 worldAlignForcesCount, const Matrix4& world, const Matrix4& invWorld, float32 layerOverLife)
+void ParticleEffectSystem::UpdateRegularParticlesData(ParticleEffectComponent* effect, ParticleGroup& group, UpdateScratch& scratch, int32 simplifiedForcesCount, float32 dt, AABBox3& bbox, uint32 effectAlignForcesCount, uint32 worldAlignForcesCount, const Matrix4& world, const Matrix4& invWorld, float32 layerOverLife)
 {
-    float32 currVelocityOverLife = 1.0f;
+    ParticleStorage& particles = group.particles;
+    uint32 count = particles.GetCount();
+    const float32* overLife = scratch.particlesOverLife.data();
+    ParticlesRandom::Generator& random = effect->effectData.random;
+
+    Vector<Vector3>& particlesPrevPosition = scratch.particlesPrevPosition;
+    Vector<float32>& particlesTimeScale = scratch.particlesTimeScale;
+    Vector<float32>& particlesSpinScale = scratch.particlesSpinScale;
+    Vector<float32>& particlesForceScale = scratch.particlesForceScale;
+    Vector<float32>& particlesAccelerationX = scratch.particlesAccelerationX;
+    Vector<float32>& particlesAccelerationY = scratch.particlesAccelerationY;
+    Vector<float32>& particlesAccelerationZ = scratch.particlesAccelerationZ;
+
+    bool hasComplexForces = (worldAlignForcesCount > 0) || (effectAlignForcesCount > 0) || group.layer->applyGlobalForces;
+    if (hasComplexForces)
+    {
+        particlesPrevPosition.resize(count);
+        for (uint32 i = 0; i < count; ++i)
+            particlesPrevPosition[i] = particles.GetPosition(i);
+    }
+
     if (group.layer->velocityOverLife)
-        currVelocityOverLife = group.layer->velocityOverLife->GetValue(overLife);
-    Vector3 prevParticlePosition = particle->position;
-    particle->position += particle->speed * (currVelocityOverLife * dt);
+    {
+        particlesTimeScale.resize(count);
+        for (uint32 i = 0; i < count; ++i)
+            particlesTimeScale[i] = group.layer->velocityOverLife->Sample(overLife[i]) * dt;
+        ParticleSimulation::IntegratePositions(particles, particlesTimeScale.data());
+    }
+    else
+    {
+        ParticleSimulation::IntegratePositions(particles, dt);
+    }
 
-    float32 currSpinOverLife = 1.0f;
     if (group.layer->spinOverLife)
-        currSpinOverLife = group.layer->spinOverLife->GetValue(overLife);
-    particle->angle += particle->spin * currSpinOverLife * dt;
-
-    Vector3 acceleration(0.0f, 0.0f, 0.0f);
-    for (int32 i = 0; i < simplifiedForcesCount; ++i)
     {
-        acceleration += (group.layer->GetSimplifiedParticleForces()[i]->forceOverLife) ? (currSimplifiedForceValues[i] * group.layer->GetSimplifiedParticleForces()[i]->forceOverLife->GetValue(overLife)) : currSimplifiedForceValues[i];
+        particlesSpinScale.resize(count);
+        for (uint32 i = 0; i < count; ++i)
+            particlesSpinScale[i] = group.layer->spinOverLife->Sample(overLife[i]);
+        ParticleSimulation::IntegrateAngles(particles, particlesSpinScale.data(), dt);
+    }
+    else
+    {
+        ParticleSimulation::IntegrateAngles(particles, dt);
     }
 
-    for (uint32 i = 0; i < worldAlignForcesCount; ++i)
-        ParticleForces::ApplyForce(worldAlignForces[i], particle->speed, particle->position, dt, overLife, layerOverLife, Vector3(0.0f, 0.0f, -1.0f), particle, prevParticlePosition, worldAlignForces[i]->worldPosition);
+    int64 forcesStart = statisticsEnabled ? SystemTimer::GetNs() : 0;
+    if (simplifiedForcesCount > 0)
+    {
+        particlesAccelerationX.assign(count, 0.0f);
+        particlesAccelerationY.assign(count, 0.0f);
+        particlesAccelerationZ.assign(count, 0.0f);
+        for (int32 f = 0; f < simplifiedForcesCount; ++f)
+        {
+            PropertyLine<float32>* forceOverLife = group.layer->GetSimplifiedParticleForces()[f]->forceOverLife.Get();
+            if (forceOverLife)
+            {
+                particlesForceScale.resize(count);
+                for (uint32 i = 0; i < count; ++i)
+                    particlesForceScale[i] = forceOverLife->Sample(overLife[i]);
+                ParticleSimulation::AccumulateForce(particlesAccelerationX.data(), particlesAccelerationY.data(), particlesAccelerationZ.data(), count, scratch.simplifiedForceValues[f], particlesForceScale.data());
+            }
+            else
+            {
+                ParticleSimulation::AccumulateForce(particlesAccelerationX.data(), particlesAccelerationY.data(), particlesAccelerationZ.data(), count, scratch.simplifiedForceValues[f]);
+            }
+        }
+    }
 
-    if (effectAlignForcesCount > 0)
+    if (hasComplexForces)
     {
-        Vector3 effectSpacePosition;
-        Vector3 prevEffectSpacePosition;
-        Vector3 effectSpaceSpeed;
-        effectSpacePosition = particle->position * invWorld;
-        effectSpaceSpeed = particle->speed * Matrix3(invWorld);
-        if (group.layer->GetPlaneCollisiontForcesCount() > 0)
-            prevEffectSpacePosition = prevParticlePosition * invWorld;
+        Vector3 effectDown = -Vector3(invWorld._20, invWorld._21, invWorld._22);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            Vector3 position = particles.GetPosition(i);
+            Vector3 speed = particles.GetSpeed(i);
+            const Vector3& prevParticlePosition = particlesPrevPosition[i];
+
+            for (uint32 f = 0; f < worldAlignForcesCount; ++f)
+                ParticleForces::ApplyForce(scratch.worldAlignForces[f], speed, position, dt, overLife[i], layerOverLife, Vector3(0.0f, 0.0f, -1.0f), particles, i, prevParticlePosition, scratch.worldAlignForcesPositions[f], random);
+
+            if (effectAlignForcesCount > 0)
+            {
+                Vector3 effectSpacePosition;
+                Vector3 prevEffectSpacePosition;
+                Vector3 effectSpaceSpeed;
+                effectSpacePosition = position * invWorld;
+                effectSpaceSpeed = speed * Matrix3(invWorld);
+                if (group.layer->GetPlaneCollisiontForcesCount() > 0)
+                    prevEffectSpacePosition = prevParticlePosition * invWorld;
+
+                for (uint32 f = 0; f < effectAlignForcesCount; ++f)
+                    ParticleForces::ApplyForce(scratch.effectAlignForces[f], effectSpaceSpeed, effectSpacePosition, dt, overLife[i], layerOverLife, effectDown, particles, i, prevEffectSpacePosition, scratch.effectAlignForces[f]->position, random);
+
+                speed = effectSpaceSpeed * Matrix3(world);
+                if (group.layer->GetAlterPositionForcesCount() > 0)
+                    position = effectSpacePosition * world;
+            }
 
-        for (uint32 i = 0; i < effectAlignForcesCount; ++i)
-            ParticleForces::ApplyForce(effectAlignForces[i], effectSpaceSpeed, effectSpacePosition, dt, overLife, layerOverLife, -Vector3(invWorld._20, invWorld._21, invWorld._22), particle, prevEffectSpacePosition, effectAlignForces[i]->position);
+            if (group.layer->applyGlobalForces)
+                ApplyGlobalForces(particles, i, speed, position, dt, overLife[i], layerOverLife, prevParticlePosition, random);
 
-        particle->speed = effectSpaceSpeed * Matrix3(world);
-        if (group.layer->GetAlterPositionForcesCount() > 0)
-            particle->position = effectSpacePosition * world;
+            particles.SetPosition(i, position);
+            particles.SetSpeed(i, speed);
+        }
     }
 
-    if (group.layer->applyGlobalForces)
-        ApplyGlobalForces(particle, dt, overLife, layerOverLife, prevParticlePosition);
+    if (simplifiedForcesCount > 0)
+        ParticleSimulation::ApplyAcceleration(particles, particlesAccelerationX.data(), particlesAccelerationY.data(), particlesAccelerationZ.data(), dt);
 
-    particle->speed += acceleration * dt;
+    if (statisticsEnabled)
+        scratch.statistics.forcesNs += SystemTimer::GetNs() - forcesStart;
 
     if (group.layer->sizeOverLifeXY)
     {
-        particle->currSize = particle->baseSize * group.layer->sizeOverLifeXY->GetValue(overLife);
-        Vector2 pivotSize = particle->currSize * group.layer->layerPivotSizeOffsets;
-        particle->currRadius = pivotSize.Length();
+        for (uint32 i = 0; i < count; ++i)
+        {
+            particles.currSize[i] = particles.baseSize[i] * group.layer->sizeOverLifeXY->Sample(overLife[i]);
+            Vector2 pivotSize = particles.currSize[i] * group.layer->layerPivotSizeOffsets;
+            particles.currRadius[i] = pivotSize.Length();
+        }
     }
     if (group.layer->GetInheritPosition())
-        AddParticleToBBox(particle->position + effect->effectData.infoSources[group.positionSource].position, particle->currRadius, bbox);
+        ParticleSimulation::AddParticlesToBBox(particles, effect->effectData.infoSources[group.positionSource].position, bbox);
     else
-        AddParticleToBBox(particle->position, particle->currRadius, bbox);
+        ParticleSimulation::AddParticlesToBBox(particles, Vector3(0.0f, 0.0f, 0.0f), bbox);
 
     if (group.layer->frameOverLifeEnabled && group.layer->sprite)
     {
-        float32 animDelta = group.layer->frameOverLifeFPS;
-        if (group.layer->animSpeedOverLife)
-            animDelta *= group.layer->animSpeedOverLife->GetValue(overLife);
-        particle->animTime += animDelta * dt;
-
-        while (particle->animTime > 1.0f)
+        int32 frameCount = group.layer->sprite->GetFrameCount();
+        for (uint32 i = 0; i < count; ++i)
         {
-            particle->frame++;
-            particle->animTime -= 1.0f;
-            if (particle->frame >= group.layer->sprite->GetFrameCount())
+            float32 animDelta = group.layer->frameOverLifeFPS;
+            if (group.layer->animSpeedOverLife)
+                animDelta *= group.layer->animSpeedOverLife->Sample(overLife[i]);
+            particles.animTime[i] += animDelta * dt;
+
+            while (particles.animTime[i] > 1.0f)
             {
-                if (group.layer->loopSpriteAnimation)
-                    particle->frame = 0;
-                else
-                    particle->frame = group.layer->sprite->GetFrameCount() - 1;
+                particles.frame[i]++;
+                particles.animTime[i] -= 1.0f;
+                if (particles.frame[i] >= frameCount)
+                {
+                    if (group.layer->loopSpriteAnimation)
+                        particles.frame[i] = 0;
+                    else
+                        particles.frame[i] = frameCount - 1;
+                }
             }
         }
     }
 }
 
-void ParticleEffectSystem::ApplyGlobalForces(Particle* particle, float32 dt, float32 overLife, float32 layerOverLife, Vector3 prevParticlePosition)
+void ParticleEffectSystem::ApplyGlobalForces(ParticleStorage& particles, uint32 index, Vector3& speed, Vector3& position, float32 dt, float32 overLife, float32 layerOverLife, const Vector3& prevParticlePosition, ParticlesRandom::Generator& random)
 {
     for (auto& forcePair : globalForces)
     {
@@ -1049,8 +1257,8 @@ void ParticleEffectSystem::ApplyGlobalForces(Particle* particle, float32 dt, flo
         for (ParticleForce* force : forcePair.second.worldAlignForces)
         {
             Vector3 forceWorldPosition = worldTransformPtr->GetTranslationVector() + force->position;
-            if (force->isInfinityRange || (forceWorldPosition - particle->position).SquareLength() < force->GetSquaredRadius())
-                ParticleForces::ApplyForce(force, particle->speed, particle->position, dt, overLife, layerOverLife, Vector3(0.0f, 0.0f, -1.0f), particle, prevParticlePosition, forceWorldPosition);
+            if (force->isInfinityRange || (forceWorldPosition - position).SquareLength() < force->GetSquaredRadius())
+                ParticleForces::ApplyForce(force, speed, position, dt, overLife, layerOverLife, Vector3(0.0f, 0.0f, -1.0f), particles, index, prevParticlePosition, forceWorldPosition, random);
         }
 
         if (!forcePair.second.effectAlignForces.empty())
@@ -1064,7 +1272,7 @@ void ParticleEffectSystem::ApplyGlobalForces(Particle* particle, float32 dt, flo
                     break;
                 }
                 Vector3 forceWorldPosition = worldTransformPtr->GetTranslationVector() + force->position; // Do not rotate global forces if force position is not zero.
-                float32 sqrDist = (forceWorldPosition - particle->position).SquareLength();
+                float32 sqrDist = (forceWorldPosition - position).SquareLength();
                 if (sqrDist < force->GetSquaredRadius())
                 {
                     inForceBoundingSphere = true;
@@ -1076,36 +1284,35 @@ void ParticleEffectSystem::ApplyGlobalForces(Particle* particle, float32 dt, flo
 
             Matrix4 invWorld = GetInverseWithRemovedScale(*worldTransformPtr);
 
-            Vector3 effectSpacePosition = particle->position * invWorld;
+            Vector3 effectSpacePosition = position * invWorld;
             Vector3 prevEffectSpacePosition = prevParticlePosition * invWorld;
-            Vector3 effectSpaceSpeed = particle->speed * Matrix3(invWorld);
+            Vector3 effectSpaceSpeed = speed * Matrix3(invWorld);
             bool transformPosition = false;
             for (ParticleForce* force : forcePair.second.effectAlignForces)
             {
                 if (force->CanAlterPosition())
                     transformPosition = true;
-                ParticleForces::ApplyForce(force, effectSpaceSpeed, effectSpacePosition, dt, overLife, layerOverLife, -Vector3(invWorld._20, invWorld._21, invWorld._22), particle, prevEffectSpacePosition, force->position);
+                ParticleForces::ApplyForce(force, effectSpaceSpeed, effectSpacePosition, dt, overLife, layerOverLife, -Vector3(invWorld._20, invWorld._21, invWorld._22), particles, index, prevEffectSpacePosition, force->position, random);
             }
-            particle->speed = effectSpaceSpeed * Matrix3(*worldTransformPtr);
+            speed = effectSpaceSpeed * Matrix3(*worldTransformPtr);
             if (transformPosition)
-                particle->position = effectSpacePosition * (*worldTransformPtr);
+                position = effectSpacePosition * (*worldTransformPtr);
         }
     }
 }
 
-void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, ParticleGroup& group, const Matrix4& worldTransform)
+void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, ParticleGroup& group, const Matrix4& worldTransform, ParticlesRandom::Generator& random)
 {
     //calculate position new particle position in emitter space (for point leave it V3(0,0,0))
-    uintptr_t uptr = reinterpret_cast<uintptr_t>(&group);
-    uint32 offset = static_cast<uint32>(uptr);
-    uint32 ind = group.particlesGenerated + offset;
+    uint32 ind = group.particlesGenerated + group.randomIndexOffset;
+    particle->randomIndex = ind;
 
     // In VanDerCorput random we use different bases to avoid diagonal patterns.
     if (group.emitter->emitterType == ParticleEmitter::EMITTER_RECT)
     {
         if (group.emitter->size)
         {
-            Vector3 currSize = group.emitter->size->GetValue(group.time);
+            Vector3 currSize = group.emitter->size->Sample(group.time);
             particle->position = Vector3(currSize.x * (ParticlesRandom::VanDerCorputRnd(ind, 3) - 0.5f), currSize.y * (ParticlesRandom::VanDerCorputRnd(ind, 2) - 0.5f), currSize.z * (ParticlesRandom::VanDerCorputRnd(ind, 5) - 0.5f));
         }
     }
@@ -1113,18 +1320,18 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
     {
         float32 curRadius = 1.0f;
         if (group.emitter->radius)
-            curRadius = group.emitter->radius->GetValue(group.time);
+            curRadius = group.emitter->radius->Sample(group.time);
 
         float32 angleBase = 0;
         float32 angleVariation = PI_2;
         if (group.emitter->emissionAngle)
-            angleBase = DegToRad(group.emitter->emissionAngle->GetValue(group.time));
+            angleBase = DegToRad(group.emitter->emissionAngle->Sample(group.time));
         if (group.emitter->emissionAngleVariation)
-            angleVariation = DegToRad(group.emitter->emissionAngleVariation->GetValue(group.time));
+            angleVariation = DegToRad(group.emitter->emissionAngleVariation->Sample(group.time));
 
         float32 curAngle = angleBase + angleVariation * ParticlesRandom::VanDerCorputRnd(ind, 3);
         if (group.emitter->emitterType == ParticleEmitter::EMITTER_ONCIRCLE_VOLUME)
-            curRadius *= std::sqrt(static_cast<float32>(GetEngineContext()->random->RandFloat())); // Better distribution on circle.
+            curRadius *= std::sqrt(random.RandFloat()); // Better distribution on circle.
         float32 sinAngle = 0.0f;
         float32 cosAngle = 0.0f;
         SinCosFast(curAngle, sinAngle, cosAngle);
@@ -1134,7 +1341,7 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
     //current emission vector and it's length
     Vector3 currEmissionVector(0, 0, 1);
     if (group.emitter->emissionVector)
-        currEmissionVector = group.emitter->emissionVector->GetValue(group.time);
+        currEmissionVector = group.emitter->emissionVector->Sample(group.time);
     float32 currEmissionPower = currEmissionVector.Length();
 
     Vector3 currVelVector = currEmissionVector;
@@ -1142,7 +1349,7 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
     bool hasCustomEmissionVector = group.emitter->emissionVelocityVector != nullptr;
     if (hasCustomEmissionVector)
     {
-        currVelVector = group.emitter->emissionVelocityVector->GetValue(group.time);
+        currVelVector = group.emitter->emissionVelocityVector->Sample(group.time);
         currVelPower = currVelVector.Length();
     }
     //calculate speed in emitter space not transformed by emission vector yet
@@ -1159,7 +1366,7 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
     {
         if (group.emitter->emissionRange)
         {
-            float32 theta = ParticlesRandom::VanDerCorputRnd(ind, 3) * DegToRad(group.emitter->emissionRange->GetValue(group.time)) * 0.5f;
+            float32 theta = ParticlesRandom::VanDerCorputRnd(ind, 3) * DegToRad(group.emitter->emissionRange->Sample(group.time)) * 0.5f;
             float32 phi = ParticlesRandom::VanDerCorputRnd(ind, 4) * PI_2;
             particle->speed = Vector3(currVelPower * cos(phi) * sin(theta), currVelPower * sin(phi) * sin(theta), currVelPower * cos(theta));
         }
@@ -1235,8 +1442,10 @@ void ParticleEffectSystem::SimulateEffect(ParticleEffectComponent* effect)
     static const float32 particleSystemFps = 30.0f;
     static const float32 delta = 0.0333f;
     uint32 frames = static_cast<uint32>(effect->GetStartFromTime() * particleSystemFps);
+    UpdateScratch* scratch = AcquireScratch();
     for (uint32 i = 0; i < frames; ++i)
-        UpdateEffect(effect, delta, delta);
+        UpdateEffect(effect, delta, delta, *scratch);
+    ReleaseScratch(scratch);
 }
 
 void ParticleEffectSystem::ExtractGlobalForces(ParticleEffectComponent* effect)
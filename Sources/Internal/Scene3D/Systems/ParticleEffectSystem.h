@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Base/BaseTypes.h"
+#include "Concurrency/Mutex.h"
 #include "Entity/SceneSystem.h"
 #include "Scene3D/Components/ParticleEffectComponent.h"
 
@@ -83,28 +84,80 @@ public:
 
     void PrebuildMaterials(ParticleEffectComponent* component);
 
+    /** Time spent in effects update phases, collected only while enabled with `SetStatisticsEnabled`. */
+    struct Statistics
+    {
+        uint64 emitNs = 0; // generation of new particles
+        uint64 simulationNs = 0; // life and over-life values of existing particles, without forces
+        uint64 forcesNs = 0; // sampling and applying forces to existing particles
+        uint64 particlesEmitted = 0;
+        uint64 particlesSimulated = 0;
+    };
+
+    inline void SetStatisticsEnabled(bool enabled);
+    inline const Statistics& GetStatistics() const;
+    inline void ResetStatistics();
+
 protected:
+    /**
+        Temporary values used while effect is updated.
+        Effects are updated concurrently, every job takes its own scratch from `scratchPool`.
+    */
+    struct UpdateScratch
+    {
+        // Per-particle values of the group being updated
+        Vector<float32> particlesOverLife;
+        Vector<float32> particlesTimeScale;
+        Vector<float32> particlesSpinScale;
+        Vector<float32> particlesForceScale;
+        Vector<float32> particlesAccelerationX;
+        Vector<float32> particlesAccelerationY;
+        Vector<float32> particlesAccelerationZ;
+        Vector<Vector3> particlesPrevPosition;
+
+        // Forces of the group being updated
+        Vector<Vector3> simplifiedForceValues;
+        Vector<ParticleForce*> effectAlignForces;
+        Vector<ParticleForce*> worldAlignForces;
+        Vector<Vector3> worldAlignForcesPositions;
+
+        Statistics statistics;
+    };
+
     void RunEffect(ParticleEffectComponent* effect);
     void AddToActive(ParticleEffectComponent* effect);
     void RemoveFromActive(ParticleEffectComponent* effect);
 
     void UpdateActiveLod(ParticleEffectComponent* effect);
     void UpdateEffect(ParticleEffectComponent* effect, float32 deltaTime, float32 shortEffectTime);
-    Particle* GenerateNewParticle(ParticleEffectComponent* effect, ParticleGroup& group, float32 currLoopTime, const Matrix4& worldTransform);
-    void UpdateRegularParticleData(ParticleEffectComponent* effect, Particle* particle, const ParticleGroup& group, float32 overLife, int32 simplifiedForcesCount, Vector<Vector3>& currSimplifiedForceValues, float32 dt, AABBox3& bbox, const Vector<ParticleForce*>& effectAlignForces, uint32 effectAlignForcesCount, const Vector<ParticleForce*>& worldAlignForces, uint32 worldAlignForcesCount, const Matrix4& world, const Matrix4& invWorld, float32 layerOverLife);
+    void UpdateEffect(ParticleEffectComponent* effect, float32 deltaTime, float32 shortEffectTime, UpdateScratch& scratch);
+    uint32 GenerateNewParticle(ParticleEffectComponent* effect, ParticleGroup& group, float32 currLoopTime, const Matrix4& worldTransform);
+    void UpdateRegularParticlesData(ParticleEffectComponent* effect, ParticleGroup& group, UpdateScratch& scratch, int32 simplifiedForcesCount, float32 dt, AABBox3& bbox, uint32 effectAlignForcesCount, uint32 worldAlignForcesCount, const Matrix4& world, const Matrix4& invWorld, float32 layerOverLife);
 
-    void PrepareEmitterParameters(Particle* particle, ParticleGroup& group, const Matrix4& worldTransform);
+    void PrepareEmitterParameters(Particle* particle, ParticleGroup& group, const Matrix4& worldTransform, ParticlesRandom::Generator& random);
     void AddParticleToBBox(const Vector3& position, float radius, AABBox3& bbox);
 
     void RunEmitter(ParticleEffectComponent* effect, ParticleEmitter* emitter, const Vector3& spawnPosition, int32 positionSource = 0);
 
 private:
-    void ApplyGlobalForces(Particle* particle, float32 dt, float32 overLife, float32 layerOverLife, Vector3 prevParticlePosition);
-    void UpdateStripe(Particle* particle, ParticleEffectData& effectData, ParticleGroup& group, float32 dt, AABBox3& bbox, const Vector<Vector3>& currForceValues, int32 forcesCount, bool isActive);
+    void ApplyGlobalForces(ParticleStorage& particles, uint32 index, Vector3& speed, Vector3& position, float32 dt, float32 overLife, float32 layerOverLife, const Vector3& prevParticlePosition, ParticlesRandom::Generator& random);
+    void UpdateStripe(const Vector3& particlePosition, const Vector3& particleSpeed, ParticleEffectData& effectData, ParticleGroup& group, float32 dt, AABBox3& bbox, const Vector<Vector3>& currForceValues, int32 forcesCount, bool isActive);
     void SimulateEffect(ParticleEffectComponent* effect);
+    /** Bake property lines and acquire materials of all layers of `emitter` and its inner emitters, so they are only read during concurrent update. */
+    void PrepareEmitter(ParticleEmitter* emitter, uint32 bakeResolution);
+    MaterialData MakeMaterialData(ParticleLayer* layer) const;
+    /** Create materials of groups started during concurrent update, main thread only. */
+    void AcquirePendingMaterials(ParticleEffectComponent* effect);
+
+    UpdateScratch* AcquireScratch();
+    void ReleaseScratch(UpdateScratch* scratch);
 
     Map<String, float32> globalExternalValues;
     Vector<ParticleEffectComponent*> activeComponents;
+    Vector<ParticleEffectComponent*> updatedComponents;
+
+    Vector<std::unique_ptr<UpdateScratch>> scratchPool;
+    Mutex scratchPoolMutex;
 
     struct EffectGlobalForcesData
     {
@@ -117,11 +170,18 @@ private:
 private: //materials stuff
     NMaterial* particleBaseMaterial;
     Vector<std::pair<MaterialData, NMaterial*>> particlesMaterials;
+    Mutex particlesMaterialsMutex;
     Map<ParticleEffectComponent*, EffectGlobalForcesData> globalForces;
+    /** Lookup of created material, safe to call from any thread. */
+    NMaterial* FindMaterial(const MaterialData& materialData);
+    /** Lookup or creation of material, main thread only. */
     NMaterial* AcquireMaterial(const MaterialData& materialData);
 
     bool allowLodDegrade;
     bool is2DMode;
+
+    Statistics statistics;
+    bool statisticsEnabled = false;
 };
 
 inline const Vector<std::pair<ParticleEffectSystem::MaterialData, NMaterial*>>& ParticleEffectSystem::GetMaterialInstances() const
@@ -138,4 +198,19 @@ inline bool ParticleEffectSystem::GetAllowLodDegrade() const
 {
     return allowLodDegrade;
 }
+
+inline void ParticleEffectSystem::SetStatisticsEnabled(bool enabled)
+{
+    statisticsEnabled = enabled;
+}
+
+inline const ParticleEffectSystem::Statistics& ParticleEffectSystem::GetStatistics() const
+{
+    return statistics;
+}
+
+inline void ParticleEffectSystem::ResetStatistics()
+{
+    statistics = Statistics();
+}
 };
\ No newline at end of file
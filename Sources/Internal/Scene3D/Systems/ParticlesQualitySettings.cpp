@@ -242,6 +242,27 @@ void ParticlesQualitySettings::LoadFromYaml(const YamlNode* rootNode)
             }
         }
     }
+
+    propertyLinesQuality = PropertyLinesQuality::ACCURATE;
+    const YamlNode* propertyLinesNode = settingsNode->Get("propertyLines");
+    if (propertyLinesNode != nullptr && propertyLinesNode->GetType() == YamlNode::TYPE_STRING)
+    {
+        const String& quality = propertyLinesNode->AsString();
+        if (quality == "performance")
+        {
+            propertyLinesQuality = PropertyLinesQuality::PERFORMANCE;
+        }
+        else
+        {
+            DVASSERT(quality == "accurate", Format("Unknown particles property lines quality %s", quality.c_str()).c_str());
+        }
+    }
+
+    const YamlNode* lookupResolutionNode = settingsNode->Get("propertyLinesLookupResolution");
+    if (lookupResolutionNode != nullptr && lookupResolutionNode->GetType() == YamlNode::TYPE_STRING)
+    {
+        SetPropertyLinesLookupResolution(lookupResolutionNode->AsUInt32());
+    }
 }
 
 size_t ParticlesQualitySettings::GetQualitiesCount() const
@@ -319,6 +340,32 @@ void ParticlesQualitySettings::RemoveTag(const FastName& tag)
     }
 }
 
+ParticlesQualitySettings::PropertyLinesQuality ParticlesQualitySettings::GetPropertyLinesQuality() const
+{
+    return propertyLinesQuality;
+}
+
+void ParticlesQualitySettings::SetPropertyLinesQuality(PropertyLinesQuality quality)
+{
+    propertyLinesQuality = quality;
+}
+
+uint32 ParticlesQualitySettings::GetPropertyLinesLookupResolution() const
+{
+    return propertyLinesLookupResolution;
+}
+
+void ParticlesQualitySettings::SetPropertyLinesLookupResolution(uint32 resolution)
+{
+    DVASSERT(resolution > 1);
+    propertyLinesLookupResolution = Max(resolution, 2u);
+}
+
+uint32 ParticlesQualitySettings::GetPropertyLinesBakeResolution() const
+{
+    return (propertyLinesQuality == PropertyLinesQuality::PERFORMANCE) ? propertyLinesLookupResolution : 0;
+}
+
 const ParticlesQualitySettings::FilepathSelector* ParticlesQualitySettings::GetOrCreateFilepathSelector()
 {
     if (nullptr == filepathSelector)
@@ -65,6 +65,13 @@ public:
         Vector<QualitySheet> actualSheets;
     };
 
+    /** How particle property lines are sampled during simulation, see `PropertyLine::Bake`. */
+    enum class PropertyLinesQuality : uint8
+    {
+        ACCURATE, // lines are interpolated between their keys exactly
+        PERFORMANCE // lines are sampled from fixed resolution lookup tables
+    };
+
     ParticlesQualitySettings();
     ~ParticlesQualitySettings();
 
@@ -91,12 +98,21 @@ public:
 
     const FilepathSelector* GetOrCreateFilepathSelector();
 
+    PropertyLinesQuality GetPropertyLinesQuality() const;
+    void SetPropertyLinesQuality(PropertyLinesQuality quality);
+    uint32 GetPropertyLinesLookupResolution() const;
+    void SetPropertyLinesLookupResolution(uint32 resolution);
+    /** Resolution particle property lines should be baked with for current property lines quality. */
+    uint32 GetPropertyLinesBakeResolution() const;
+
 private:
     Vector<FastName> qualities;
     int32 defaultQualityIndex = -1;
     int32 currentQualityIndex = -1;
     Vector<QualitySheet> qualitySheets;
     Set<FastName> tagsCloud;
+    PropertyLinesQuality propertyLinesQuality = PropertyLinesQuality::ACCURATE;
+    uint32 propertyLinesLookupResolution = 64;
 
     std::unique_ptr<FilepathSelector> filepathSelector;
 };
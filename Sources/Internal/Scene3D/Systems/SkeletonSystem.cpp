@@ -3,11 +3,17 @@
 #include "Animation/AnimationTrack.h"
 #include "Debug/ProfilerCPU.h"
 #include "Debug/ProfilerMarkerNames.h"
+#include "Entity/ComponentUtils.h"
+#include "Job/ParallelFor.h"
+#include "Math/SSE/SSEMath.h"
 #include "Render/Highlevel/SkinnedMesh.h"
+#include "Render/Renderer.h"
 #include "Scene3D/Entity.h"
 #include "Scene3D/Components/ComponentHelpers.h"
+#include "Scene3D/Components/RenderComponent.h"
 #include "Scene3D/Components/SkeletonComponent.h"
 #include "Scene3D/Components/TransformComponent.h"
+#include "Scene3D/Lod/LodComponent.h"
 #include "Scene3D/SkeletonAnimation/JointTransform.h"
 #include "Scene3D/Scene.h"
 #include "Scene3D/Systems/EventSystem.h"
@@ -16,9 +22,195 @@
 
 namespace DAVA
 {
+namespace SkeletonSystemDetails
+{
+// Number of skeletons processed by single job
+const uint32 SKELETONS_GRAIN_SIZE = 4;
+
+// Number of joints processed at once by batch functions
+const uint32 JOINTS_BATCH_SIZE = 4;
+
+#if defined(__DAVAENGINE_SSE2__)
+// Transforms of four joints, one joint per lane
+struct TransformLanes
+{
+    __m128 px, py, pz;
+    __m128 qx, qy, qz, qw;
+    __m128 s;
+};
+
+inline TransformLanes LoadTransforms(const SkeletonPose& pose, const uint32* joints)
+{
+    const Vector3* p = pose.GetPositions();
+    const Quaternion* q = pose.GetOrientations();
+    const float32* s = pose.GetScales();
+
+    TransformLanes r;
+    r.px = _mm_setr_ps(p[joints[0]].x, p[joints[1]].x, p[joints[2]].x, p[joints[3]].x);
+    r.py = _mm_setr_ps(p[joints[0]].y, p[joints[1]].y, p[joints[2]].y, p[joints[3]].y);
+    r.pz = _mm_setr_ps(p[joints[0]].z, p[joints[1]].z, p[joints[2]].z, p[joints[3]].z);
+    r.s = _mm_setr_ps(s[joints[0]], s[joints[1]], s[joints[2]], s[joints[3]]);
+
+    r.qx = _mm_loadu_ps(q[joints[0]].data);
+    r.qy = _mm_loadu_ps(q[joints[1]].data);
+    r.qz = _mm_loadu_ps(q[joints[2]].data);
+    r.qw = _mm_loadu_ps(q[joints[3]].data);
+    _MM_TRANSPOSE4_PS(r.qx, r.qy, r.qz, r.qw);
+
+    return r;
+}
+
+inline void StoreTransforms(const TransformLanes& t, const uint32* joints, SkeletonPose* pose)
+{
+    Vector3* p = pose->GetPositions();
+    Quaternion* q = pose->GetOrientations();
+    float32* s = pose->GetScales();
+
+    alignas(16) float32 x[4], y[4], z[4], scale[4];
+    _mm_store_ps(x, t.px);
+    _mm_store_ps(y, t.py);
+    _mm_store_ps(z, t.pz);
+    _mm_store_ps(scale, t.s);
+
+    __m128 q0 = t.qx, q1 = t.qy, q2 = t.qz, q3 = t.qw;
+    _MM_TRANSPOSE4_PS(q0, q1, q2, q3);
+    _mm_storeu_ps(q[joints[0]].data, q0);
+    _mm_storeu_ps(q[joints[1]].data, q1);
+    _mm_storeu_ps(q[joints[2]].data, q2);
+    _mm_storeu_ps(q[joints[3]].data, q3);
+
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        p[joints[i]] = Vector3(x[i], y[i], z[i]);
+        s[joints[i]] = scale[i];
+    }
+}
+
+inline __m128 Negate(__m128 v)
+{
+    return _mm_xor_ps(v, _mm_set1_ps(-0.f));
+}
+
+// Same operations in the same order as `p + q.ApplyToVectorFast(v) * s` (see JointTransform::ApplyToPoint)
+inline void ApplyToPoint(const TransformLanes& t, __m128 vx, __m128 vy, __m128 vz, __m128& outX, __m128& outY, __m128& outZ)
+{
+    __m128 two = _mm_set1_ps(2.f);
+    __m128 tx = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(t.qy, vz), _mm_mul_ps(vy, t.qz)));
+    __m128 ty = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(t.qz, vx), _mm_mul_ps(t.qx, vz)));
+    __m128 tz = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(t.qx, vy), _mm_mul_ps(t.qy, vx)));
+
+    __m128 rx = _mm_add_ps(_mm_add_ps(vx, _mm_mul_ps(t.qw, tx)), _mm_sub_ps(_mm_mul_ps(t.qy, tz), _mm_mul_ps(ty, t.qz)));
+    __m128 ry = _mm_add_ps(_mm_add_ps(vy, _mm_mul_ps(t.qw, ty)), _mm_sub_ps(_mm_mul_ps(t.qz, tx), _mm_mul_ps(t.qx, tz)));
+    __m128 rz = _mm_add_ps(_mm_add_ps(vz, _mm_mul_ps(t.qw, tz)), _mm_sub_ps(_mm_mul_ps(t.qx, ty), _mm_mul_ps(t.qy, tx)));
+
+    outX = _mm_add_ps(t.px, _mm_mul_ps(rx, t.s));
+    outY = _mm_add_ps(t.py, _mm_mul_ps(ry, t.s));
+    outZ = _mm_add_ps(t.pz, _mm_mul_ps(rz, t.s));
+}
+
+// Same operations in the same order as JointTransform::AppendTransform for transforms with orientation
+inline TransformLanes AppendTransform(const TransformLanes& t0, const TransformLanes& t1)
+{
+    TransformLanes r;
+    ApplyToPoint(t0, t1.px, t1.py, t1.pz, r.px, r.py, r.pz);
+    r.s = _mm_mul_ps(t0.s, t1.s);
+
+    //see Quaternion::Mul
+    __m128 half = _mm_set1_ps(0.5f);
+    __m128 A = _mm_mul_ps(_mm_add_ps(t0.qw, t0.qx), _mm_add_ps(t1.qw, t1.qx));
+    __m128 B = _mm_mul_ps(_mm_sub_ps(t0.qz, t0.qy), _mm_sub_ps(t1.qy, t1.qz));
+    __m128 C = _mm_mul_ps(_mm_sub_ps(t0.qx, t0.qw), _mm_add_ps(t1.qy, t1.qz));
+    __m128 D = _mm_mul_ps(_mm_add_ps(t0.qy, t0.qz), _mm_sub_ps(t1.qx, t1.qw));
+    __m128 E = _mm_mul_ps(_mm_add_ps(t0.qx, t0.qz), _mm_add_ps(t1.qx, t1.qy));
+    __m128 F = _mm_mul_ps(_mm_sub_ps(t0.qx, t0.qz), _mm_sub_ps(t1.qx, t1.qy));
+    __m128 G = _mm_mul_ps(_mm_add_ps(t0.qw, t0.qy), _mm_sub_ps(t1.qw, t1.qz));
+    __m128 H = _mm_mul_ps(_mm_sub_ps(t0.qw, t0.qy), _mm_add_ps(t1.qw, t1.qz));
+
+    r.qw = _mm_add_ps(B, _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_sub_ps(Negate(E), F), G), H), half));
+    r.qx = _mm_sub_ps(A, _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(E, F), G), H), half));
+    r.qy = _mm_add_ps(Negate(C), _mm_mul_ps(_mm_sub_ps(_mm_add_ps(_mm_sub_ps(E, F), G), H), half));
+    r.qz = _mm_add_ps(Negate(D), _mm_mul_ps(_mm_add_ps(_mm_sub_ps(_mm_sub_ps(E, F), G), H), half));
+
+    return r;
+}
+
+// Bounding box of eight transformed corners of `boxes`, the same as JointTransform::ApplyToAABBox
+inline void ApplyToAABBoxes(const TransformLanes& t, const AABBox3* const* boxes, __m128* outMin, __m128* outMax)
+{
+    __m128 minX = _mm_setr_ps(boxes[0]->min.x, boxes[1]->min.x, boxes[2]->min.x, boxes[3]->min.x);
+    __m128 minY = _mm_setr_ps(boxes[0]->min.y, boxes[1]->min.y, boxes[2]->min.y, boxes[3]->min.y);
+    __m128 minZ = _mm_setr_ps(boxes[0]->min.z, boxes[1]->min.z, boxes[2]->min.z, boxes[3]->min.z);
+    __m128 maxX = _mm_setr_ps(boxes[0]->max.x, boxes[1]->max.x, boxes[2]->max.x, boxes[3]->max.x);
+    __m128 maxY = _mm_setr_ps(boxes[0]->max.y, boxes[1]->max.y, boxes[2]->max.y, boxes[3]->max.y);
+    __m128 maxZ = _mm_setr_ps(boxes[0]->max.z, boxes[1]->max.z, boxes[2]->max.z, boxes[3]->max.z);
+
+    for (uint32 corner = 0; corner < 8; ++corner)
+    {
+        __m128 x, y, z;
+        ApplyToPoint(t, (corner & 1) ? maxX : minX, (corner & 2) ? maxY : minY, (corner & 4) ? maxZ : minZ, x, y, z);
+
+        if (corner == 0)
+        {
+            outMin[0] = outMax[0] = x;
+            outMin[1] = outMax[1] = y;
+            outMin[2] = outMax[2] = z;
+        }
+        else
+        {
+            outMin[0] = _mm_min_ps(outMin[0], x);
+            outMin[1] = _mm_min_ps(outMin[1], y);
+            outMin[2] = _mm_min_ps(outMin[2], z);
+            outMax[0] = _mm_max_ps(outMax[0], x);
+            outMax[1] = _mm_max_ps(outMax[1], y);
+            outMax[2] = _mm_max_ps(outMax[2], z);
+        }
+    }
+}
+#endif
+
+// Collects joints and calls `fn` for every full batch, incomplete batch is padded with copies of the last joint
+class JointsBatch
+{
+public:
+    JointsBatch(SkeletonComponent* skeleton_, void (*fn_)(SkeletonComponent*, const uint32*, uint32))
+        : skeleton(skeleton_)
+        , fn(fn_)
+    {
+    }
+
+    void Add(uint32 joint)
+    {
+        joints[count++] = joint;
+        if (count == JOINTS_BATCH_SIZE)
+            Flush();
+    }
+
+    void Flush()
+    {
+        if (count == 0)
+            return;
+
+        for (uint32 i = count; i < JOINTS_BATCH_SIZE; ++i)
+            joints[i] = joints[count - 1];
+
+        fn(skeleton, joints, JOINTS_BATCH_SIZE);
+        count = 0;
+    }
+
+private:
+    SkeletonComponent* skeleton;
+    void (*fn)(SkeletonComponent*, const uint32*, uint32);
+    uint32 joints[JOINTS_BATCH_SIZE];
+    uint32 count = 0;
+};
+}
+
 SkeletonSystem::SkeletonSystem(Scene* scene)
     : SceneSystem(scene)
 {
+    // LodComponent is read by SkeletonComponent::GetCurrentAnimationLod
+    SetProcessComponentsAccess(ComponentUtils::MakeMask<TransformComponent, LodComponent>(), ComponentUtils::MakeMask<SkeletonComponent, RenderComponent>());
+
     scene->GetEventSystem()->RegisterSystemForEvent(this, EventSystem::SKELETON_CONFIG_CHANGED);
 }
 
@@ -72,29 +264,60 @@ void SkeletonSystem::Process(float32 timeElapsed)
     UpdateTestSkeletons();
 #endif
 
-    for (int32 i = 0, sz = static_cast<int32>(entities.size()); i < sz; ++i)
-    {
-        SkeletonComponent* component = GetSkeletonComponent(entities[i]);
+    processSkeletons.clear();
 
-        if (component != nullptr)
+    Scene* scene = GetScene();
+    if (scene->IsArchetypeStorageEnabled())
+    {
+        scene->Query<SkeletonComponent>().ForEach([this](Entity* entity, SkeletonComponent* component) {
+            processSkeletons.emplace_back(entity, component);
+        });
+    }
+    else
+    {
+        for (Entity* entity : entities)
         {
-            if (component->configUpdated)
+            SkeletonComponent* component = GetSkeletonComponent(entity);
+            if (component != nullptr)
             {
-                RebuildSkeleton(GetSkeletonComponent(entities[i]));
+                processSkeletons.emplace_back(entity, component);
             }
+        }
+    }
 
-            if (component->startJoint != SkeletonComponent::INVALID_JOINT_INDEX)
-            {
-                UpdateJointTransforms(component);
-                RenderObject* ro = GetRenderObject(entities[i]);
-                if (ro != nullptr && (RenderObject::TYPE_SKINNED_MESH == ro->GetType()))
-                {
-                    UpdateSkinnedMesh(component, static_cast<SkinnedMesh*>(ro));
-                }
-            }
+    // every skeleton touches only own component and render object
+    uint32 skeletonsCount = uint32(processSkeletons.size());
+    updatedMeshes.assign(skeletonsCount, nullptr);
+    updatedJoints.assign(skeletonsCount, 0);
+    ParallelFor(0, skeletonsCount, SkeletonSystemDetails::SKELETONS_GRAIN_SIZE, [this](uint32 begin, uint32 end) {
+        for (uint32 i = begin; i < end; ++i)
+        {
+            updatedMeshes[i] = ProcessSkeleton(processSkeletons[i].first, processSkeletons[i].second, &updatedJoints[i]);
+        }
+    });
+
+    RenderSystem* renderSystem = scene->GetRenderSystem();
+    for (SkinnedMesh* skinnedMesh : updatedMeshes)
+    {
+        if (skinnedMesh != nullptr)
+        {
+            renderSystem->MarkForUpdate(skinnedMesh);
         }
     }
 
+    updatedSkeletonsCount = 0;
+    updatedJointsCount = 0;
+    for (uint32 jointsCount : updatedJoints)
+    {
+        updatedSkeletonsCount += (jointsCount != 0) ? 1 : 0;
+        updatedJointsCount += jointsCount;
+    }
+
+#if defined(__DAVAENGINE_RENDERSTATS__)
+    Renderer::GetRenderStats().updatedSkeletons += updatedSkeletonsCount;
+    Renderer::GetRenderStats().updatedJoints += updatedJointsCount;
+#endif
+
     DrawSkeletons(GetScene()->renderSystem->GetDebugDrawer());
 }
 
@@ -110,7 +333,7 @@ void SkeletonSystem::DrawSkeletons(RenderHelper* drawer)
             Vector<Vector3> positions(component->GetJointsCount());
             for (uint32 i = 0; i < component->GetJointsCount(); ++i)
             {
-                positions[i] = component->objectSpaceTransforms[i].GetPosition() * worldTransform;
+                positions[i] = component->objectSpaceTransforms.GetPosition(i) * worldTransform;
             }
 
             const Vector<SkeletonComponent::Joint>& joints = component->jointsArray;
@@ -123,9 +346,10 @@ void SkeletonSystem::DrawSkeletons(RenderHelper* drawer)
                     drawer->DrawArrow(positions[cfg.parentIndex], positions[i], arrowLength, Color(1.0f, 0.5f, 0.0f, 1.0), RenderHelper::eDrawType::DRAW_WIRE_NO_DEPTH);
                 }
 
-                Vector3 xAxis = component->objectSpaceTransforms[i].ApplyToPoint(Vector3(1.f, 0.f, 0.f)) * worldTransform;
-                Vector3 yAxis = component->objectSpaceTransforms[i].ApplyToPoint(Vector3(0.f, 1.f, 0.f)) * worldTransform;
-                Vector3 zAxis = component->objectSpaceTransforms[i].ApplyToPoint(Vector3(0.f, 0.f, 1.f)) * worldTransform;
+                JointTransform objectSpaceTransform = component->objectSpaceTransforms.GetJointTransform(i);
+                Vector3 xAxis = objectSpaceTransform.ApplyToPoint(Vector3(1.f, 0.f, 0.f)) * worldTransform;
+                Vector3 yAxis = objectSpaceTransform.ApplyToPoint(Vector3(0.f, 1.f, 0.f)) * worldTransform;
+                Vector3 zAxis = objectSpaceTransform.ApplyToPoint(Vector3(0.f, 0.f, 1.f)) * worldTransform;
 
                 drawer->DrawLine(positions[i], xAxis, Color::Red, RenderHelper::eDrawType::DRAW_WIRE_NO_DEPTH);
                 drawer->DrawLine(positions[i], yAxis, Color::Green, RenderHelper::eDrawType::DRAW_WIRE_NO_DEPTH);
@@ -137,38 +361,77 @@ void SkeletonSystem::DrawSkeletons(RenderHelper* drawer)
     }
 }
 
-void SkeletonSystem::UpdateJointTransforms(SkeletonComponent* skeleton)
+SkinnedMesh* SkeletonSystem::ProcessSkeleton(Entity* entity, SkeletonComponent* component, uint32* outUpdatedJoints)
+{
+    *outUpdatedJoints = 0;
+
+    if (component->configUpdated)
+    {
+        RebuildSkeleton(component);
+    }
+
+    //visibility is checked once per update, mesh will be marked visible again by render passes
+    bool visible = component->IsAnimationVisible();
+
+    RenderObject* ro = GetRenderObject(entity);
+    SkinnedMesh* skinnedMesh = (ro != nullptr && RenderObject::TYPE_SKINNED_MESH == ro->GetType()) ? static_cast<SkinnedMesh*>(ro) : nullptr;
+    if (skinnedMesh != nullptr)
+    {
+        skinnedMesh->ResetVisibleSinceUpdate();
+    }
+
+    //joints of invisible skeleton stay marked for update until it becomes visible
+    //skeleton is always updated after rebuild to initialize joints and bounding box
+    if (visible || component->updatedJointLevels == 0)
+    {
+        *outUpdatedJoints = UpdateJointTransforms(component, component->GetCurrentAnimationLod().jointLevelsCount);
+        if (*outUpdatedJoints != 0 && skinnedMesh != nullptr)
+        {
+            UpdateSkinnedMeshData(component, skinnedMesh);
+            return skinnedMesh;
+        }
+    }
+
+    return nullptr;
+}
+
+uint32 SkeletonSystem::UpdateJointTransforms(SkeletonComponent* skeleton, uint32 jointLevelsCount)
 {
+    using namespace SkeletonSystemDetails;
+
     DVASSERT(!skeleton->configUpdated);
 
+    uint32 levelsCount = uint32(skeleton->levelOffsets.size()) - 1;
+    if (levelsCount == 0)
+    {
+        skeleton->startJoint = SkeletonComponent::INVALID_JOINT_INDEX;
+        return 0;
+    }
+
+    //first update after rebuild is complete
+    uint32 updatedLevels = (skeleton->updatedJointLevels == 0) ? levelsCount : Clamp(jointLevelsCount, 1u, levelsCount);
+
+    //joints of levels which were skipped on previous updates are outdated
+    for (uint32 level = skeleton->updatedJointLevels; level < updatedLevels; ++level)
+    {
+        for (uint32 i = skeleton->levelOffsets[level]; i < skeleton->levelOffsets[level + 1]; ++i)
+        {
+            skeleton->SetJointUpdated(skeleton->levelJoints[i]);
+        }
+    }
+    skeleton->updatedJointLevels = updatedLevels;
+
+    if (skeleton->startJoint == SkeletonComponent::INVALID_JOINT_INDEX)
+        return 0;
+
+    //mark joints which should be updated this frame, parents are always before children
+    uint32 startJoint = skeleton->startJoint;
     uint32 count = skeleton->GetJointsCount();
-    for (uint32 currJoint = skeleton->startJoint; currJoint < count; ++currJoint)
+    for (uint32 currJoint = startJoint; currJoint < count; ++currJoint)
     {
         uint32 parentJoint = skeleton->jointInfo[currJoint] & SkeletonComponent::INFO_PARENT_MASK;
         if ((skeleton->jointInfo[currJoint] & SkeletonComponent::FLAG_MARKED_FOR_UPDATED) || ((parentJoint != SkeletonComponent::INVALID_JOINT_INDEX) && (skeleton->jointInfo[parentJoint] & SkeletonComponent::FLAG_UPDATED_THIS_FRAME)))
         {
-            //calculate object space transforms
-            if (parentJoint == SkeletonComponent::INVALID_JOINT_INDEX) //root
-            {
-                skeleton->objectSpaceTransforms[currJoint] = skeleton->localSpaceTransforms[currJoint]; //just copy
-            }
-            else
-            {
-                skeleton->objectSpaceTransforms[currJoint] = skeleton->objectSpaceTransforms[parentJoint].AppendTransform(skeleton->localSpaceTransforms[currJoint]);
-            }
-
-            //calculate final transform including bindTransform
-            skeleton->finalTransforms[currJoint] = skeleton->objectSpaceTransforms[currJoint].AppendTransform(skeleton->inverseBindTransforms[currJoint]);
-
-            if (!skeleton->jointsArray[currJoint].bbox.IsEmpty())
-            {
-                skeleton->objectSpaceBoxes[currJoint] = skeleton->objectSpaceTransforms[currJoint].ApplyToAABBox(skeleton->jointsArray[currJoint].bbox);
-            }
-            else
-            {
-                skeleton->objectSpaceBoxes[currJoint].Empty();
-            }
-
             //  add [was updated]  remove [marked for update]
             skeleton->jointInfo[currJoint] &= ~SkeletonComponent::FLAG_MARKED_FOR_UPDATED;
             skeleton->jointInfo[currJoint] |= SkeletonComponent::FLAG_UPDATED_THIS_FRAME;
@@ -179,10 +442,72 @@ void SkeletonSystem::UpdateJointTransforms(SkeletonComponent* skeleton)
             skeleton->jointInfo[currJoint] &= ~SkeletonComponent::FLAG_UPDATED_THIS_FRAME;
         }
     }
+
+    auto isUpdated = [skeleton, startJoint](uint32 joint) {
+        return joint >= startJoint && (skeleton->jointInfo[joint] & SkeletonComponent::FLAG_UPDATED_THIS_FRAME) != 0;
+    };
+
+    //calculate object space transforms level by level, joints of one level are independent
+    for (uint32 level = 0; level < updatedLevels; ++level)
+    {
+        const uint32* levelBegin = skeleton->levelJoints.data() + skeleton->levelOffsets[level];
+        const uint32* levelEnd = skeleton->levelJoints.data() + skeleton->levelOffsets[level + 1];
+
+        if (level == 0) //roots
+        {
+            for (const uint32* joint = levelBegin; joint != levelEnd; ++joint)
+            {
+                if (isUpdated(*joint))
+                    skeleton->objectSpaceTransforms.SetTransform(*joint, skeleton->localSpaceTransforms.GetJointTransform(*joint)); //just copy
+            }
+        }
+        else
+        {
+            JointsBatch batch(skeleton, &SkeletonSystem::ConcatenateJoints);
+            for (const uint32* joint = levelBegin; joint != levelEnd; ++joint)
+            {
+                if (isUpdated(*joint))
+                    batch.Add(*joint);
+            }
+            batch.Flush();
+        }
+    }
+
+    //calculate final transforms including bindTransform and bounding boxes
+    uint32 updatedJointsCount = 0;
+    const uint32* updatedLevelsEnd = skeleton->levelJoints.data() + skeleton->levelOffsets[updatedLevels];
+    JointsBatch batch(skeleton, &SkeletonSystem::FinalizeJoints);
+    for (const uint32* joint = skeleton->levelJoints.data(); joint != updatedLevelsEnd; ++joint)
+    {
+        if (isUpdated(*joint))
+        {
+            batch.Add(*joint);
+            ++updatedJointsCount;
+        }
+    }
+    batch.Flush();
+
+    //deeper joints keep bind pose relative to nearest updated parent, so they share its skinning transform
+    //their object space transforms and bounding boxes keep values of last update
+    const uint32* levelsEnd = skeleton->levelJoints.data() + skeleton->levelJoints.size();
+    for (const uint32* joint = updatedLevelsEnd; joint != levelsEnd; ++joint)
+    {
+        uint32 parentJoint = skeleton->jointInfo[*joint] & SkeletonComponent::INFO_PARENT_MASK;
+        skeleton->finalPositionsScales[*joint] = skeleton->finalPositionsScales[parentJoint];
+        skeleton->finalOrientations[*joint] = skeleton->finalOrientations[parentJoint];
+    }
+
     skeleton->startJoint = SkeletonComponent::INVALID_JOINT_INDEX;
+    return updatedJointsCount;
 }
 
 void SkeletonSystem::UpdateSkinnedMesh(SkeletonComponent* skeleton, SkinnedMesh* skinnedMeshObject)
+{
+    UpdateSkinnedMeshData(skeleton, skinnedMeshObject);
+    GetScene()->GetRenderSystem()->MarkForUpdate(skinnedMeshObject);
+}
+
+void SkeletonSystem::UpdateSkinnedMeshData(SkeletonComponent* skeleton, SkinnedMesh* skinnedMeshObject)
 {
     DVASSERT(!skeleton->configUpdated);
 
@@ -197,24 +522,126 @@ void SkeletonSystem::UpdateSkinnedMesh(SkeletonComponent* skeleton, SkinnedMesh*
         }
     }
 
-    skinnedMeshObject->UpdateJointTransforms(skeleton->finalTransforms);
+    skinnedMeshObject->UpdateJointTransforms(skeleton->finalPositionsScales, skeleton->finalOrientations);
     skinnedMeshObject->SetBoundingBox(resBox); //TODO: *Skinning* decide on bbox calculation
+}
 
-    GetScene()->GetRenderSystem()->MarkForUpdate(skinnedMeshObject);
+// Calculate object space transforms of `count` joints, parents should be already calculated
+void SkeletonSystem::ConcatenateJoints(SkeletonComponent* skeleton, const uint32* joints, uint32 count)
+{
+#if defined(__DAVAENGINE_SSE2__)
+    using namespace SkeletonSystemDetails;
+    DVASSERT(count == JOINTS_BATCH_SIZE);
+
+    uint32 parents[JOINTS_BATCH_SIZE];
+    for (uint32 i = 0; i < JOINTS_BATCH_SIZE; ++i)
+        parents[i] = skeleton->jointInfo[joints[i]] & SkeletonComponent::INFO_PARENT_MASK;
+
+    TransformLanes parent = LoadTransforms(skeleton->objectSpaceTransforms, parents);
+    TransformLanes local = LoadTransforms(skeleton->localSpaceTransforms, joints);
+    StoreTransforms(AppendTransform(parent, local), joints, &skeleton->objectSpaceTransforms);
+#else
+    for (uint32 i = 0; i < count; ++i)
+    {
+        uint32 joint = joints[i];
+        uint32 parent = skeleton->jointInfo[joint] & SkeletonComponent::INFO_PARENT_MASK;
+        JointTransform parentTransform = skeleton->objectSpaceTransforms.GetJointTransform(parent);
+        skeleton->objectSpaceTransforms.SetTransform(joint, parentTransform.AppendTransform(skeleton->localSpaceTransforms.GetJointTransform(joint)));
+    }
+#endif
+}
+
+// Calculate skinning palette and object space bounding boxes of `count` joints
+void SkeletonSystem::FinalizeJoints(SkeletonComponent* skeleton, const uint32* joints, uint32 count)
+{
+#if defined(__DAVAENGINE_SSE2__)
+    using namespace SkeletonSystemDetails;
+    DVASSERT(count == JOINTS_BATCH_SIZE);
+
+    TransformLanes object = LoadTransforms(skeleton->objectSpaceTransforms, joints);
+    TransformLanes inverseBind = LoadTransforms(skeleton->inverseBindTransforms, joints);
+    TransformLanes final = AppendTransform(object, inverseBind);
+
+    //(position, scale) and orientation rows as shader expects
+    __m128 p0 = final.px, p1 = final.py, p2 = final.pz, p3 = final.s;
+    _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+    __m128 q0 = final.qx, q1 = final.qy, q2 = final.qz, q3 = final.qw;
+    _MM_TRANSPOSE4_PS(q0, q1, q2, q3);
+
+    Vector4* positionsScales = skeleton->finalPositionsScales.data();
+    Vector4* orientations = skeleton->finalOrientations.data();
+    _mm_storeu_ps(positionsScales[joints[0]].data, p0);
+    _mm_storeu_ps(positionsScales[joints[1]].data, p1);
+    _mm_storeu_ps(positionsScales[joints[2]].data, p2);
+    _mm_storeu_ps(positionsScales[joints[3]].data, p3);
+    _mm_storeu_ps(orientations[joints[0]].data, q0);
+    _mm_storeu_ps(orientations[joints[1]].data, q1);
+    _mm_storeu_ps(orientations[joints[2]].data, q2);
+    _mm_storeu_ps(orientations[joints[3]].data, q3);
+
+    const AABBox3* boxes[4];
+    for (uint32 i = 0; i < 4; ++i)
+        boxes[i] = &skeleton->jointsArray[joints[i]].bbox;
+
+    __m128 boxMin[3], boxMax[3];
+    ApplyToAABBoxes(object, boxes, boxMin, boxMax);
+
+    alignas(16) float32 minCoords[3][4];
+    alignas(16) float32 maxCoords[3][4];
+    for (uint32 c = 0; c < 3; ++c)
+    {
+        _mm_store_ps(minCoords[c], boxMin[c]);
+        _mm_store_ps(maxCoords[c], boxMax[c]);
+    }
+
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        AABBox3& box = skeleton->objectSpaceBoxes[joints[i]];
+        if (boxes[i]->IsEmpty())
+        {
+            box.Empty();
+        }
+        else
+        {
+            box.min = Vector3(minCoords[0][i], minCoords[1][i], minCoords[2][i]);
+            box.max = Vector3(maxCoords[0][i], maxCoords[1][i], maxCoords[2][i]);
+        }
+    }
+#else
+    for (uint32 i = 0; i < count; ++i)
+    {
+        uint32 joint = joints[i];
+        JointTransform objectTransform = skeleton->objectSpaceTransforms.GetJointTransform(joint);
+        JointTransform finalTransform = objectTransform.AppendTransform(skeleton->inverseBindTransforms.GetJointTransform(joint));
+
+        skeleton->finalPositionsScales[joint] = Vector4(Vector3(finalTransform.GetPosition().data), finalTransform.GetScale());
+        skeleton->finalOrientations[joint] = Vector4(finalTransform.GetOrientation().data);
+
+        const AABBox3& bbox = skeleton->jointsArray[joint].bbox;
+        if (!bbox.IsEmpty())
+            skeleton->objectSpaceBoxes[joint] = objectTransform.ApplyToAABBox(bbox);
+        else
+            skeleton->objectSpaceBoxes[joint].Empty();
+    }
+#endif
 }
 
 void SkeletonSystem::RebuildSkeleton(SkeletonComponent* skeleton)
 {
     skeleton->configUpdated = false;
 
-    size_t jointsCount = skeleton->jointsArray.size();
+    uint32 jointsCount = uint32(skeleton->jointsArray.size());
     skeleton->jointInfo.resize(jointsCount);
-    skeleton->localSpaceTransforms.resize(jointsCount);
-    skeleton->objectSpaceTransforms.resize(jointsCount);
-    skeleton->finalTransforms.resize(jointsCount);
-    skeleton->inverseBindTransforms.resize(jointsCount);
+    skeleton->localSpaceTransforms.SetJointCount(jointsCount);
+    skeleton->objectSpaceTransforms.SetJointCount(jointsCount);
+    skeleton->inverseBindTransforms.SetJointCount(jointsCount);
+    skeleton->finalPositionsScales.resize(jointsCount);
+    skeleton->finalOrientations.resize(jointsCount);
     skeleton->objectSpaceBoxes.resize(jointsCount);
 
+    Vector<uint32> jointLevels(jointsCount);
+    uint32 levelsCount = 0;
+
     DVASSERT(skeleton->jointsArray.size() < SkeletonComponent::INFO_PARENT_MASK);
     for (uint32 i = 0, sz = static_cast<int32>(skeleton->jointsArray.size()); i < sz; ++i)
     {
@@ -226,20 +653,43 @@ void SkeletonSystem::RebuildSkeleton(SkeletonComponent* skeleton)
         JointTransform localTransform;
         localTransform.Construct(skeleton->jointsArray[i].bindTransform);
 
-        skeleton->localSpaceTransforms[i] = localTransform;
+        skeleton->localSpaceTransforms.SetTransform(i, localTransform);
         if (skeleton->jointsArray[i].parentIndex == SkeletonComponent::INVALID_JOINT_INDEX)
         {
-            skeleton->objectSpaceTransforms[i] = localTransform;
+            skeleton->objectSpaceTransforms.SetTransform(i, localTransform);
+            jointLevels[i] = 0;
         }
         else
         {
-            skeleton->objectSpaceTransforms[i] = skeleton->objectSpaceTransforms[skeleton->jointsArray[i].parentIndex].AppendTransform(localTransform);
+            JointTransform parentTransform = skeleton->objectSpaceTransforms.GetJointTransform(skeleton->jointsArray[i].parentIndex);
+            skeleton->objectSpaceTransforms.SetTransform(i, parentTransform.AppendTransform(localTransform));
+            jointLevels[i] = jointLevels[skeleton->jointsArray[i].parentIndex] + 1;
         }
+        levelsCount = Max(levelsCount, jointLevels[i] + 1);
+
+        skeleton->inverseBindTransforms.SetTransform(i, JointTransform(skeleton->jointsArray[i].bindTransformInv));
+    }
+
+    //counting sort of joints by level, joints of one level keep index order
+    skeleton->levelOffsets.assign(levelsCount + 1, 0);
+    for (uint32 i = 0; i < jointsCount; ++i)
+    {
+        skeleton->levelOffsets[jointLevels[i] + 1]++;
+    }
+    for (uint32 level = 0; level < levelsCount; ++level)
+    {
+        skeleton->levelOffsets[level + 1] += skeleton->levelOffsets[level];
+    }
 
-        skeleton->inverseBindTransforms[i].Construct(skeleton->jointsArray[i].bindTransformInv);
+    skeleton->levelJoints.resize(jointsCount);
+    Vector<uint32> levelFill(skeleton->levelOffsets.begin(), skeleton->levelOffsets.end() - 1);
+    for (uint32 i = 0; i < jointsCount; ++i)
+    {
+        skeleton->levelJoints[levelFill[jointLevels[i]]++] = i;
     }
 
     skeleton->startJoint = 0;
+    skeleton->updatedJointLevels = 0;
 }
 
 void SkeletonSystem::UpdateTestSkeletons(float32 timeElapsed)
@@ -27,16 +27,46 @@ public:
     void UpdateSkinnedMesh(SkeletonComponent* skeleton, SkinnedMesh* skinnedMeshObject);
     void DrawSkeletons(RenderHelper* drawer);
 
+    // Counters of last `Process` call
+    uint32 GetUpdatedSkeletonsCount() const;
+    uint32 GetUpdatedJointsCount() const;
+
 private:
-    void UpdateJointTransforms(SkeletonComponent* skeleton);
+    // Update joints and skinning palette according to animation lod, return skinned mesh which should be marked for update in render system
+    SkinnedMesh* ProcessSkeleton(Entity* entity, SkeletonComponent* component, uint32* outUpdatedJoints);
+    // Update joints with hierarchy depth less than `jointLevelsCount`, return number of updated joints
+    uint32 UpdateJointTransforms(SkeletonComponent* skeleton, uint32 jointLevelsCount);
+    void UpdateSkinnedMeshData(SkeletonComponent* skeleton, SkinnedMesh* skinnedMeshObject);
+
+    // Batch functions process SkeletonSystemDetails::JOINTS_BATCH_SIZE joints at once
+    static void ConcatenateJoints(SkeletonComponent* skeleton, const uint32* joints, uint32 count);
+    static void FinalizeJoints(SkeletonComponent* skeleton, const uint32* joints, uint32 count);
 
     void RebuildSkeleton(SkeletonComponent* skeleton);
 
     void UpdateTestSkeletons(float32 timeElapsed);
 
     Vector<Entity*> entities;
+
+    // Skeletons are independent, they are processed in parallel
+    Vector<std::pair<Entity*, SkeletonComponent*>> processSkeletons;
+    Vector<SkinnedMesh*> updatedMeshes;
+    Vector<uint32> updatedJoints;
+
+    uint32 updatedSkeletonsCount = 0;
+    uint32 updatedJointsCount = 0;
 };
 
+inline uint32 SkeletonSystem::GetUpdatedSkeletonsCount() const
+{
+    return updatedSkeletonsCount;
+}
+
+inline uint32 SkeletonSystem::GetUpdatedJointsCount() const
+{
+    return updatedJointsCount;
+}
+
 } //ns
 
 #endif
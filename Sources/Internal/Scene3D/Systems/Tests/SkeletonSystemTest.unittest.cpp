@@ -0,0 +1,381 @@
+#include "UnitTests/UnitTests.h"
+
+#include "Base/RefPtr.h"
+#include "Engine/Engine.h"
+#include "Logger/Logger.h"
+#include "Math/Matrix4.h"
+#include "Render/Highlevel/RenderBatch.h"
+#include "Render/Highlevel/SkinnedMesh.h"
+#include "Scene3D/Components/RenderComponent.h"
+#include "Scene3D/Components/SkeletonComponent.h"
+#include "Scene3D/Entity.h"
+#include "Scene3D/Scene.h"
+#include "Scene3D/Systems/SkeletonSystem.h"
+#include "Time/SystemTimer.h"
+#include "Utils/Random.h"
+
+DAVA_TESTCLASS (SkeletonSystemTest)
+{
+    DAVA::Vector<DAVA::SkeletonComponent::Joint> MakeRandomJoints(DAVA::uint32 jointsCount)
+    {
+        using namespace DAVA;
+
+        Random* random = GetEngineContext()->random;
+
+        Vector<SkeletonComponent::Joint> joints(jointsCount);
+        for (uint32 j = 0; j < jointsCount; ++j)
+        {
+            SkeletonComponent::Joint& joint = joints[j];
+            joint.parentIndex = (j == 0) ? SkeletonComponent::INVALID_JOINT_INDEX : random->Rand(j - 1);
+            joint.name = FastName(Format("joint%u", j));
+            joint.uid = joint.name;
+
+            Matrix4 rotation = Matrix4::MakeRotation(Vector3(0.3f, 0.2f, 1.f), static_cast<float32>(random->RandFloat()) * PI_2);
+            Matrix4 translation = Matrix4::MakeTranslation(Vector3(random->RandFloat32InBounds(-1.f, 1.f), random->RandFloat32InBounds(-1.f, 1.f), random->RandFloat32InBounds(0.f, 1.f)));
+            joint.bindTransform = rotation * translation;
+            joint.bindTransform.GetInverse(joint.bindTransformInv);
+
+            if (j % 3 != 0)
+                joint.bbox = AABBox3(Vector3(-0.1f, -0.1f, 0.f), Vector3(0.1f, 0.1f, 0.5f));
+        }
+        return joints;
+    }
+
+    void AnimateJoints(DAVA::SkeletonComponent * skeleton, DAVA::uint32 step)
+    {
+        using namespace DAVA;
+
+        Random* random = GetEngineContext()->random;
+        for (uint32 j = 0; j < skeleton->GetJointsCount(); j += step)
+        {
+            Vector3 axis(random->RandFloat32InBounds(-1.f, 1.f), random->RandFloat32InBounds(-1.f, 1.f), 1.f);
+            axis.Normalize();
+
+            Quaternion orientation;
+            orientation.Construct(axis, static_cast<float32>(random->RandFloat()) * PI);
+
+            skeleton->SetJointOrientation(j, orientation);
+            skeleton->SetJointPosition(j, Vector3(random->RandFloat32InBounds(-1.f, 1.f), 0.f, 0.5f));
+            skeleton->SetJointScale(j, random->RandFloat32InBounds(0.5f, 1.5f));
+        }
+    }
+
+    // Object space transforms calculated joint by joint with JointTransform
+    bool VerifyObjectSpaceTransforms(const DAVA::SkeletonComponent* skeleton)
+    {
+        using namespace DAVA;
+
+        const float32 epsilon = 1e-4f;
+
+        uint32 jointsCount = skeleton->GetJointsCount();
+        Vector<JointTransform> expected(jointsCount);
+        bool allEqual = true;
+        for (uint32 j = 0; j < jointsCount; ++j)
+        {
+            uint32 parent = skeleton->GetJoint(j).parentIndex;
+            if (parent == SkeletonComponent::INVALID_JOINT_INDEX)
+                expected[j] = skeleton->GetJointTransform(j);
+            else
+                expected[j] = expected[parent].AppendTransform(skeleton->GetJointTransform(j));
+
+            JointTransform actual = skeleton->GetJointObjectSpaceTransform(j);
+            allEqual &= (actual.GetPosition() - expected[j].GetPosition()).Length() < epsilon;
+            allEqual &= std::abs(actual.GetScale() - expected[j].GetScale()) < epsilon;
+            for (uint32 c = 0; c < 4; ++c)
+            {
+                allEqual &= std::abs(actual.GetOrientation().data[c] - expected[j].GetOrientation().data[c]) < epsilon;
+            }
+        }
+        return allEqual;
+    }
+
+    bool IsEqual(const DAVA::Vector3& v0, const DAVA::Vector3& v1, DAVA::float32 epsilon)
+    {
+        return (v0 - v1).Length() < epsilon * DAVA::Max(1.f, v1.Length());
+    }
+
+    // Skinning palette and bounding boxes calculated joint by joint with JointTransform
+    bool VerifyFinalTransforms(const DAVA::SkeletonComponent* skeleton, DAVA::SkinnedMesh* skinnedMesh, DAVA::RenderBatch* batch)
+    {
+        using namespace DAVA;
+
+        const float32 epsilon = 1e-4f;
+
+        uint32 jointsCount = skeleton->GetJointsCount();
+        const SkinnedMesh::JointTargetsData& palette = skinnedMesh->GetJointTargetsData(batch);
+        if (palette.jointsDataCount != jointsCount)
+            return false;
+
+        Vector<JointTransform> objectTransforms(jointsCount);
+        AABBox3 expectedMeshBox;
+        bool allEqual = true;
+        for (uint32 j = 0; j < jointsCount; ++j)
+        {
+            const SkeletonComponent::Joint& joint = skeleton->GetJoint(j);
+            if (joint.parentIndex == SkeletonComponent::INVALID_JOINT_INDEX)
+                objectTransforms[j] = skeleton->GetJointTransform(j);
+            else
+                objectTransforms[j] = objectTransforms[joint.parentIndex].AppendTransform(skeleton->GetJointTransform(j));
+
+            JointTransform finalTransform = objectTransforms[j].AppendTransform(JointTransform(joint.bindTransformInv));
+            allEqual &= IsEqual(Vector3(palette.positions[j].data), finalTransform.GetPosition(), epsilon);
+            allEqual &= std::abs(palette.positions[j].w - finalTransform.GetScale()) < epsilon * Max(1.f, finalTransform.GetScale());
+            for (uint32 c = 0; c < 4; ++c)
+            {
+                allEqual &= std::abs(palette.quaternions[j].data[c] - finalTransform.GetOrientation().data[c]) < epsilon;
+            }
+
+            const AABBox3& box = skeleton->GetJointObjectSpaceBox(j);
+            if (joint.bbox.IsEmpty())
+            {
+                allEqual &= box.IsEmpty();
+            }
+            else
+            {
+                AABBox3 expectedBox = objectTransforms[j].ApplyToAABBox(joint.bbox);
+                allEqual &= IsEqual(box.min, expectedBox.min, epsilon) && IsEqual(box.max, expectedBox.max, epsilon);
+                expectedMeshBox.AddAABBox(expectedBox);
+            }
+        }
+
+        const AABBox3& meshBox = skinnedMesh->GetBoundingBox();
+        allEqual &= IsEqual(meshBox.min, expectedMeshBox.min, epsilon) && IsEqual(meshBox.max, expectedMeshBox.max, epsilon);
+        return allEqual;
+    }
+
+    DAVA_TEST (BatchedJointsUpdateTest)
+    {
+        using namespace DAVA;
+
+        RefPtr<Scene> scene;
+        scene.ConstructInplace();
+
+        // several skeletons to have several jobs, different sizes to have incomplete joint batches
+        Vector<SkeletonComponent*> skeletons;
+        for (uint32 i = 0; i < 16; ++i)
+        {
+            ScopedPtr<Entity> entity(new Entity());
+            SkeletonComponent* skeleton = new SkeletonComponent();
+            skeleton->SetJoints(MakeRandomJoints(20 + i * 3));
+            entity->AddComponent(skeleton);
+            scene->AddNode(entity);
+            skeletons.push_back(skeleton);
+        }
+
+        scene->Update(0.f);
+        for (SkeletonComponent* skeleton : skeletons)
+        {
+            TEST_VERIFY(VerifyObjectSpaceTransforms(skeleton));
+        }
+
+        // all joints are animated
+        for (SkeletonComponent* skeleton : skeletons)
+        {
+            AnimateJoints(skeleton, 1);
+        }
+        scene->Update(0.f);
+        for (SkeletonComponent* skeleton : skeletons)
+        {
+            TEST_VERIFY(VerifyObjectSpaceTransforms(skeleton));
+        }
+
+        // only some joints are changed, their children should be updated too
+        for (SkeletonComponent* skeleton : skeletons)
+        {
+            AnimateJoints(skeleton, 7);
+        }
+        scene->Update(0.f);
+        for (SkeletonComponent* skeleton : skeletons)
+        {
+            TEST_VERIFY(VerifyObjectSpaceTransforms(skeleton));
+        }
+    }
+
+    DAVA_TEST (FinalizeJointsTest)
+    {
+        using namespace DAVA;
+
+        RefPtr<Scene> scene;
+        scene.ConstructInplace();
+
+        // all joints are palette targets of one batch, joints count is not multiple of batch size
+        const uint32 jointsCount = 30;
+        ScopedPtr<SkinnedMesh> skinnedMesh(new SkinnedMesh());
+        ScopedPtr<RenderBatch> batch(new RenderBatch());
+        SkinnedMesh::JointTargets targets(jointsCount);
+        for (uint32 j = 0; j < jointsCount; ++j)
+            targets[j] = int32(j);
+        skinnedMesh->SetJointTargets(batch, targets);
+
+        ScopedPtr<Entity> entity(new Entity());
+        entity->AddComponent(new RenderComponent(skinnedMesh));
+        SkeletonComponent* skeleton = new SkeletonComponent();
+        skeleton->SetJoints(MakeRandomJoints(jointsCount));
+        entity->AddComponent(skeleton);
+        scene->AddNode(entity);
+
+        scene->Update(0.f);
+        TEST_VERIFY(VerifyFinalTransforms(skeleton, skinnedMesh, batch));
+
+        AnimateJoints(skeleton, 1);
+        scene->Update(0.f);
+        TEST_VERIFY(VerifyFinalTransforms(skeleton, skinnedMesh, batch));
+
+        AnimateJoints(skeleton, 7);
+        scene->Update(0.f);
+        TEST_VERIFY(VerifyFinalTransforms(skeleton, skinnedMesh, batch));
+    }
+
+    DAVA_TEST (AnimationLodJointLevelsTest)
+    {
+        using namespace DAVA;
+
+        RefPtr<Scene> scene;
+        scene.ConstructInplace();
+
+        ScopedPtr<Entity> entity(new Entity());
+        SkeletonComponent* skeleton = new SkeletonComponent();
+        skeleton->SetJoints(MakeRandomJoints(40));
+        entity->AddComponent(skeleton);
+        scene->AddNode(entity);
+
+        // entity without LodComponent uses animation lod of layer 0
+        SkeletonComponent::AnimationLod lod;
+        lod.jointLevelsCount = 2;
+        skeleton->SetAnimationLod(0, lod);
+
+        // first update after rebuild is complete
+        scene->Update(0.f);
+        TEST_VERIFY(scene->skeletonSystem->GetUpdatedJointsCount() == skeleton->GetJointsCount());
+
+        uint32 jointsCount = skeleton->GetJointsCount();
+        Vector<uint32> jointLevels(jointsCount, 0);
+        uint32 shallowJointsCount = 0;
+        for (uint32 j = 0; j < jointsCount; ++j)
+        {
+            uint32 parent = skeleton->GetJoint(j).parentIndex;
+            jointLevels[j] = (parent == SkeletonComponent::INVALID_JOINT_INDEX) ? 0 : jointLevels[parent] + 1;
+            shallowJointsCount += (jointLevels[j] < lod.jointLevelsCount) ? 1 : 0;
+        }
+
+        // only joints of two first levels are updated
+        AnimateJoints(skeleton, 1);
+        scene->Update(0.f);
+        TEST_VERIFY(scene->skeletonSystem->GetUpdatedSkeletonsCount() == 1);
+        TEST_VERIFY(scene->skeletonSystem->GetUpdatedJointsCount() == shallowJointsCount);
+
+        JointTransform root = skeleton->GetJointTransform(0);
+        JointTransform rootObjectSpace = skeleton->GetJointObjectSpaceTransform(0);
+        TEST_VERIFY((root.GetPosition() - rootObjectSpace.GetPosition()).Length() < 1e-5f);
+
+        // nothing changed, nothing is updated
+        scene->Update(0.f);
+        TEST_VERIFY(scene->skeletonSystem->GetUpdatedSkeletonsCount() == 0);
+        TEST_VERIFY(scene->skeletonSystem->GetUpdatedJointsCount() == 0);
+
+        // outdated joints are updated when lod allows more levels
+        skeleton->SetAnimationLod(0, SkeletonComponent::AnimationLod());
+        scene->Update(0.f);
+        TEST_VERIFY(scene->skeletonSystem->GetUpdatedJointsCount() == jointsCount - shallowJointsCount);
+        TEST_VERIFY(VerifyObjectSpaceTransforms(skeleton));
+    }
+
+    DAVA_TEST (InvisibleUpdateTest)
+    {
+        using namespace DAVA;
+
+        const SkeletonComponent::eInvisibleUpdate modes[] = {
+            SkeletonComponent::INVISIBLE_UPDATE_FULL,
+            SkeletonComponent::INVISIBLE_UPDATE_ROOT_MOTION,
+            SkeletonComponent::INVISIBLE_UPDATE_FREEZE
+        };
+
+        for (SkeletonComponent::eInvisibleUpdate mode : modes)
+        {
+            RefPtr<Scene> scene;
+            scene.ConstructInplace();
+
+            ScopedPtr<Entity> entity(new Entity());
+            ScopedPtr<SkinnedMesh> skinnedMesh(new SkinnedMesh());
+            entity->AddComponent(new RenderComponent(skinnedMesh));
+            SkeletonComponent* skeleton = new SkeletonComponent();
+            skeleton->SetJoints(MakeRandomJoints(20));
+            skeleton->SetInvisibleUpdate(mode);
+            entity->AddComponent(skeleton);
+            scene->AddNode(entity);
+
+            // mesh is visible until first update, visibility is reset by update
+            scene->Update(0.f);
+            TEST_VERIFY(scene->skeletonSystem->GetUpdatedJointsCount() == skeleton->GetJointsCount());
+            TEST_VERIFY(skinnedMesh->IsVisibleSinceUpdate() == false);
+            TEST_VERIFY(skeleton->IsAnimationVisible() == (mode == SkeletonComponent::INVISIBLE_UPDATE_FULL));
+
+            // joints of invisible skeleton are updated only with full update
+            AnimateJoints(skeleton, 1);
+            scene->Update(0.f);
+            if (mode == SkeletonComponent::INVISIBLE_UPDATE_FULL)
+            {
+                TEST_VERIFY(scene->skeletonSystem->GetUpdatedJointsCount() == skeleton->GetJointsCount());
+                TEST_VERIFY(VerifyObjectSpaceTransforms(skeleton));
+            }
+            else
+            {
+                TEST_VERIFY(scene->skeletonSystem->GetUpdatedSkeletonsCount() == 0);
+                TEST_VERIFY(scene->skeletonSystem->GetUpdatedJointsCount() == 0);
+            }
+
+            // joints changed while invisible are updated once mesh passes visibility test of render pass
+            skinnedMesh->PrepareToRender(nullptr);
+            TEST_VERIFY(skeleton->IsAnimationVisible());
+            scene->Update(0.f);
+            if (mode != SkeletonComponent::INVISIBLE_UPDATE_FULL)
+            {
+                TEST_VERIFY(scene->skeletonSystem->GetUpdatedJointsCount() == skeleton->GetJointsCount());
+            }
+            TEST_VERIFY(VerifyObjectSpaceTransforms(skeleton));
+        }
+    }
+
+    DAVA_TEST (SkeletonsUpdatePerformance)
+    {
+// used only for manual performance testing
+// change to `#if 1` to run this test
+#if 0
+        using namespace DAVA;
+
+        for (uint32 skeletonsCount : { 100, 500 })
+        {
+            RefPtr<Scene> scene;
+            scene.ConstructInplace();
+
+            Vector<SkeletonComponent*> skeletons;
+            for (uint32 i = 0; i < skeletonsCount; ++i)
+            {
+                ScopedPtr<Entity> entity(new Entity());
+                SkeletonComponent* skeleton = new SkeletonComponent();
+                skeleton->SetJoints(MakeRandomJoints(64));
+                entity->AddComponent(skeleton);
+                scene->AddNode(entity);
+                skeletons.push_back(skeleton);
+            }
+            scene->Update(0.f);
+
+            const uint32 frames = 50;
+            int64 time = 0;
+            for (uint32 frame = 0; frame < frames; ++frame)
+            {
+                for (SkeletonComponent* skeleton : skeletons)
+                {
+                    AnimateJoints(skeleton, 1);
+                }
+
+                int64 begin = SystemTimer::GetUs();
+                scene->skeletonSystem->Process(0.f);
+                time += SystemTimer::GetUs() - begin;
+            }
+
+            Logger::Info("SkeletonSystem: %u skeletons of 64 joints updated in %lld us", skeletonsCount, time / frames);
+        }
+#endif
+    }
+};
@@ -0,0 +1,85 @@
+#include "UnitTests/UnitTests.h"
+
+#include "Base/RefPtr.h"
+#include "Engine/Engine.h"
+#include "Math/Matrix4.h"
+#include "Scene3D/Entity.h"
+#include "Scene3D/Scene.h"
+#include "Utils/Random.h"
+
+DAVA_TESTCLASS (TransformSystemTest)
+{
+    DAVA::Matrix4 MakeRandomTransform()
+    {
+        using namespace DAVA;
+
+        Random* random = GetEngineContext()->random;
+        Matrix4 rotation = Matrix4::MakeRotation(Vector3(0.f, 0.f, 1.f), static_cast<float32>(random->RandFloat()) * PI_2);
+        Matrix4 translation = Matrix4::MakeTranslation(Vector3(random->RandFloat32InBounds(-10.f, 10.f), random->RandFloat32InBounds(-10.f, 10.f), random->RandFloat32InBounds(-10.f, 10.f)));
+        return rotation * translation;
+    }
+
+    DAVA_TEST (HierarchyUpdateTest)
+    {
+        using namespace DAVA;
+
+        RefPtr<Scene> scene;
+        scene.ConstructInplace();
+
+        // wide hierarchy to have several jobs per level
+        const uint32 rootsCount = 8;
+        const uint32 childrenCount = 64;
+        const uint32 grandChildrenCount = 8;
+
+        Vector<Entity*> leaves;
+        for (uint32 i = 0; i < rootsCount; ++i)
+        {
+            ScopedPtr<Entity> root(new Entity());
+            root->SetLocalTransform(MakeRandomTransform());
+            scene->AddNode(root);
+
+            for (uint32 j = 0; j < childrenCount; ++j)
+            {
+                ScopedPtr<Entity> child(new Entity());
+                child->SetLocalTransform(MakeRandomTransform());
+                root->AddNode(child);
+
+                for (uint32 k = 0; k < grandChildrenCount; ++k)
+                {
+                    ScopedPtr<Entity> grandChild(new Entity());
+                    grandChild->SetLocalTransform(MakeRandomTransform());
+                    child->AddNode(grandChild);
+                    leaves.push_back(grandChild);
+                }
+            }
+        }
+
+        scene->Update(0.f);
+
+        auto verifyLeaves = [&leaves]() {
+            bool allEqual = true;
+            for (Entity* leaf : leaves)
+            {
+                Entity* child = leaf->GetParent();
+                Entity* root = child->GetParent();
+
+                // same multiplication order as in serial update, result should be bit-identical
+                Matrix4 rootWorld = root->GetLocalTransform() * root->GetParent()->GetWorldTransform();
+                Matrix4 childWorld = child->GetLocalTransform() * rootWorld;
+                Matrix4 leafWorld = leaf->GetLocalTransform() * childWorld;
+                allEqual &= (Memcmp(&leafWorld, &leaf->GetWorldTransform(), sizeof(Matrix4)) == 0);
+            }
+            return allEqual;
+        };
+        TEST_VERIFY(verifyLeaves());
+
+        // change transforms in the middle of hierarchy only
+        for (uint32 i = 0; i < leaves.size(); i += grandChildrenCount * 3)
+        {
+            leaves[i]->GetParent()->SetLocalTransform(MakeRandomTransform());
+        }
+
+        scene->Update(0.f);
+        TEST_VERIFY(verifyLeaves());
+    }
+};
@@ -8,9 +8,17 @@
 #include "Scene3D/Components/SingleComponents/TransformSingleComponent.h"
 #include "Debug/ProfilerCPU.h"
 #include "Debug/ProfilerMarkerNames.h"
+#include "Engine/Engine.h"
+#include "Job/ParallelFor.h"
 
 namespace DAVA
 {
+namespace TransformSystemDetails
+{
+// Minimal number of nodes of one hierarchy level processed by single job
+const uint32 LEVEL_GRAIN_SIZE = 256;
+}
+
 TransformSystem::TransformSystem(Scene* scene)
     : SceneSystem(scene)
 {
@@ -40,24 +48,54 @@ void TransformSystem::Process(float32 timeElapsed)
     passedNodes = 0;
     multipliedNodes = 0;
 
+    updateNodes.clear();
+
     uint32 size = static_cast<uint32>(updatableEntities.size());
     for (uint32 i = 0; i < size; ++i)
     {
         FindNodeThatRequireUpdate(updatableEntities[i]);
     }
     updatableEntities.clear();
+
+    if (updateNodes.empty())
+    {
+        return;
+    }
+
+    SortNodesByLevels();
+    worldMatrices.resize(updateNodes.size());
+
+    // Nodes of one level depend only on nodes of previous levels,
+    // so every level can be processed in parallel
+    JobManager* jobManager = GetEngineContext()->jobManager;
+    uint32 levelsCount = static_cast<uint32>(levelOffsets.size()) - 1;
+    for (uint32 level = 0; level < levelsCount; ++level)
+    {
+        ParallelFor(jobManager, levelOffsets[level], levelOffsets[level + 1], TransformSystemDetails::LEVEL_GRAIN_SIZE, [this](uint32 begin, uint32 end) {
+            UpdateWorldTransforms(begin, end);
+        });
+    }
+
+    // Notify about changes in order of hierarchy traversal
+    for (const UpdateNode& node : updateNodes)
+    {
+        if (node.transform->parentMatrix)
+        {
+            tsc->worldTransformChanged.Push(node.entity);
+            multipliedNodes++;
+        }
+    }
 }
 
 void TransformSystem::FindNodeThatRequireUpdate(Entity* entity)
 {
-    static const uint32 STACK_SIZE = 5000;
-    uint32 stackPosition = 0;
-    Entity* stack[STACK_SIZE];
-    stack[stackPosition++] = entity;
+    traverseStack.clear();
+    traverseStack.push_back(entity);
 
-    while (stackPosition > 0)
+    while (!traverseStack.empty())
     {
-        Entity* entity = stack[--stackPosition];
+        Entity* entity = traverseStack.back();
+        traverseStack.pop_back();
 
         if (entity->GetFlags() & Entity::TRANSFORM_NEED_UPDATE)
         {
@@ -74,56 +112,108 @@ void TransformSystem::FindNodeThatRequireUpdate(Entity* entity)
                 Entity* childEntity = entity->GetChild(i);
                 if (childEntity->GetFlags() & Entity::TRANSFORM_DIRTY)
                 {
-                    DVASSERT(stackPosition < STACK_SIZE - 1);
-                    stack[stackPosition++] = childEntity;
+                    traverseStack.push_back(childEntity);
                 }
             }
         }
     }
-    DVASSERT(stackPosition == 0);
 }
 
 void TransformSystem::TransformAllChildEntities(Entity* entity)
 {
-    static const uint32 STACK_SIZE = 5000;
-    uint32 stackPosition = 0;
-    Entity* stack[STACK_SIZE];
-    stack[stackPosition++] = entity;
+    // Only collect nodes here, world transforms are calculated later level by level
+    transformStack.clear();
+    transformStack.emplace_back(entity, -1);
+
+    while (!transformStack.empty())
+    {
+        Entity* entity = transformStack.back().first;
+        int32 parentNode = transformStack.back().second;
+        transformStack.pop_back();
+
+        UpdateNode node;
+        node.entity = entity;
+        node.transform = entity->GetComponent<TransformComponent>();
+        node.parentNode = parentNode;
+        node.depth = (parentNode < 0) ? 0 : updateNodes[parentNode].depth + 1;
+
+        int32 nodeIndex = static_cast<int32>(updateNodes.size());
+        updateNodes.push_back(node);
+
+        entity->RemoveFlag(Entity::TRANSFORM_NEED_UPDATE | Entity::TRANSFORM_DIRTY);
+
+        uint32 size = entity->GetChildrenCount();
+        for (uint32 i = 0; i < size; ++i)
+        {
+            transformStack.emplace_back(entity->GetChild(i), nodeIndex);
+        }
+    }
+}
+
+void TransformSystem::SortNodesByLevels()
+{
+    uint32 levelsCount = 0;
+    for (const UpdateNode& node : updateNodes)
+    {
+        levelsCount = Max(levelsCount, node.depth + 1);
+    }
+
+    // counting sort by depth, keeps traversal order inside a level
+    levelOffsets.assign(levelsCount + 1, 0);
+    for (const UpdateNode& node : updateNodes)
+    {
+        levelOffsets[node.depth + 1]++;
+    }
+    for (uint32 level = 0; level < levelsCount; ++level)
+    {
+        levelOffsets[level + 1] += levelOffsets[level];
+    }
+
+    uint32 nodesCount = static_cast<uint32>(updateNodes.size());
+    levelNodes.resize(nodesCount);
+    for (uint32 i = 0; i < nodesCount; ++i)
+    {
+        levelNodes[levelOffsets[updateNodes[i].depth]++] = i;
+    }
 
-    int32 localMultiplied = 0;
+    // after filling each offset points to the beginning of the next level
+    for (uint32 level = levelsCount; level > 0; --level)
+    {
+        levelOffsets[level] = levelOffsets[level - 1];
+    }
+    levelOffsets[0] = 0;
+}
 
-    while (stackPosition > 0)
+void TransformSystem::UpdateWorldTransforms(uint32 levelBegin, uint32 levelEnd)
+{
+    for (uint32 i = levelBegin; i < levelEnd; ++i)
     {
-        Entity* entity = stack[--stackPosition];
+        uint32 nodeIndex = levelNodes[i];
+        const UpdateNode& node = updateNodes[nodeIndex];
+        TransformComponent* transform = node.transform;
+        Matrix4& worldMatrix = worldMatrices[nodeIndex];
 
-        TransformComponent* transform = entity->GetComponent<TransformComponent>();
         if (transform->parentMatrix)
         {
-            AnimationComponent* animComp = GetAnimationComponent(entity);
-            localMultiplied++;
+            // parent updated this frame has its world transform in previous level
+            const Matrix4& parentMatrix = (node.parentNode < 0) ? *(transform->parentMatrix) : worldMatrices[node.parentNode];
+
+            AnimationComponent* animComp = GetAnimationComponent(node.entity);
             if (animComp)
             {
-                transform->worldMatrix = animComp->animationTransform * transform->localMatrix * *(transform->parentMatrix);
+                worldMatrix = animComp->animationTransform * transform->localMatrix * parentMatrix;
             }
             else
             {
-                transform->worldMatrix = transform->localMatrix * *(transform->parentMatrix);
+                worldMatrix = transform->localMatrix * parentMatrix;
             }
-            TransformSingleComponent* tsc = GetScene()->transformSingleComponent;
-            tsc->worldTransformChanged.Push(entity);
+            transform->worldMatrix = worldMatrix;
         }
-
-        entity->RemoveFlag(Entity::TRANSFORM_NEED_UPDATE | Entity::TRANSFORM_DIRTY);
-
-        uint32 size = entity->GetChildrenCount();
-        for (uint32 i = 0; i < size; ++i)
+        else
         {
-            DVASSERT(stackPosition < STACK_SIZE - 1);
-            stack[stackPosition++] = entity->GetChild(i);
+            worldMatrix = transform->worldMatrix;
         }
     }
-    DVASSERT(stackPosition == 0);
-    multipliedNodes += localMultiplied;
 }
 
 void TransformSystem::EntityNeedUpdate(Entity* entity)
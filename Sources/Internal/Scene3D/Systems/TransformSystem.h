@@ -10,6 +10,7 @@ namespace DAVA
 {
 class Entity;
 class Transform;
+class TransformComponent;
 
 class TransformSystem : public SceneSystem
 {
@@ -23,12 +24,35 @@ public:
     void Process(float32 timeElapsed) override;
 
 private:
+    /*
+        Entity which world transform should be recalculated.
+        `parentNode` is index of parent node in `updateNodes`, or -1 if parent world transform is not changed this frame.
+        `depth` is a depth of node relative to topmost updated entity of its hierarchy.
+    */
+    struct UpdateNode
+    {
+        Entity* entity;
+        TransformComponent* transform;
+        int32 parentNode;
+        uint32 depth;
+    };
+
     Vector<Entity*> updatableEntities;
 
+    // Nodes in order of hierarchy traversal, world transforms are calculated level by level
+    Vector<UpdateNode> updateNodes;
+    Vector<uint32> levelNodes;
+    Vector<uint32> levelOffsets;
+    Vector<Matrix4> worldMatrices;
+    Vector<Entity*> traverseStack;
+    Vector<std::pair<Entity*, int32>> transformStack;
+
     void EntityNeedUpdate(Entity* entity);
     void HierarchicAddToUpdate(Entity* entity);
     void FindNodeThatRequireUpdate(Entity* entity);
     void TransformAllChildEntities(Entity* entity);
+    void SortNodesByLevels();
+    void UpdateWorldTransforms(uint32 levelBegin, uint32 levelEnd);
 
     int32 passedNodes;
     int32 multipliedNodes;
@@ -10,6 +10,7 @@
 #include "Math/Math2D.h"
 #include "Debug/ProfilerCPU.h"
 #include "Debug/ProfilerMarkerNames.h"
+#include "Entity/ComponentUtils.h"
 #include "Render/Renderer.h"
 
 namespace DAVA
@@ -32,6 +33,8 @@ WaveSystem::WaveSystem(Scene* scene)
     :
     SceneSystem(scene)
 {
+    SetProcessComponentsAccess(ComponentMask(), ComponentUtils::MakeMask<WaveComponent>());
+
     RenderOptions* options = Renderer::GetOptions();
     options->AddObserver(this);
     HandleEvent(options);